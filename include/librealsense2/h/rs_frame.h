@@ -225,6 +225,18 @@ rs2_vertex* rs2_get_frame_vertices(const rs2_frame* frame, rs2_error** error);
 */
 void rs2_export_to_ply(const rs2_frame* frame, const char* fname, rs2_frame* texture, rs2_error** error);
 
+/**
+* When called on Points frame type, this method saves the point cloud to a PLY or PCD file, as selected by the file name
+* extension (".pcd" for PCD, PLY otherwise). PLY files include the mesh faces of dense point clouds and of sparse point
+* clouds with pixel indices. The call only reads the frames, so it may be made from a background thread.
+* \param[in] frame       Points frame
+* \param[in] fname       The name for the file
+* \param[in] texture     Texture frame, or null to save uncolored points
+* \param[in] binary      Non-zero to write the data in binary form, zero for ASCII
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_export_to_file(const rs2_frame* frame, const char* fname, rs2_frame* texture, int binary, rs2_error** error);
+
 /**
 * When called on Points frame type, this method returns a pointer to an array of texture coordinates per vertex
 * Each coordinate represent a (u,v) pair within [0,1] range, to be mapped to texture image
@@ -242,6 +254,15 @@ rs2_pixel* rs2_get_frame_texture_coordinates(const rs2_frame* frame, rs2_error**
 */
 int rs2_get_frame_points_count(const rs2_frame* frame, rs2_error** error);
 
+/**
+* When called on Points frame type, this method returns a pointer to the index of the depth pixel each vertex was computed from
+* Only sparse pointclouds (see RS2_OPTION_SPARSE_POINTCLOUD) carry pixel indices
+* \param[in] frame       Points frame
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                Pointer to an array of pixel indices, or null if the frame has none. Lifetime is managed by the frame
+*/
+const int* rs2_get_frame_pixel_indices(const rs2_frame* frame, rs2_error** error);
+
 /**
 * Returns the stream profile that was used to start the stream of this frame
 * \param[in] frame       frame reference, owned by the user
@@ -111,6 +111,9 @@ extern "C" {
         RS2_OPTION_AUTO_GAIN_LIMIT, /**< Set and get auto gain limits ranging from 16 to 248. Default is 0 which means full gain. If the requested gain limit is less than 16, it will be set to 16. If the requested gain limit is greater than 248, it will be set to 248. Setting will not take effect until next streaming session. */
         RS2_OPTION_AUTO_RX_SENSITIVITY, /**< Enable receiver sensitivity according to ambient light, bounded by the Receiver Gain control. */
         RS2_OPTION_TRANSMITTER_FREQUENCY, /**<changes the transmitter frequencies increasing effective range over sharpness. */
+        RS2_OPTION_HISTOGRAM_UPDATE_INTERVAL, /**< Number of frames between updates of the depth colorizer's equalization histogram */
+        RS2_OPTION_PROCESSING_TIME, /**< Average time in milliseconds a processing block takes per frame. Read-only */
+        RS2_OPTION_SPARSE_POINTCLOUD, /**< Pointcloud output holds only the valid points: 0 - off, 1 - on, 2 - on, with the depth pixel index of each point */
         RS2_OPTION_COUNT /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
     } rs2_option;
 
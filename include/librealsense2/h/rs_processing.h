@@ -35,6 +35,17 @@ rs2_processing_block* rs2_create_colorizer(rs2_error** error);
 */
 rs2_processing_block* rs2_create_sync_processing_block(rs2_error** error);
 
+/**
+* Retrieve the frame counters of the stream matchers of a sync processing block, all taken at once
+* \param[in]  block      sync processing block, created by rs2_create_sync_processing_block
+* \param[out] stats      array receiving up to 'capacity' entries, one per stream matcher; may be null when capacity is 0
+* \param[in]  capacity   number of entries the array holds
+* \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                number of stream matchers the syncer created so far. When larger than capacity, only the
+*                        first 'capacity' entries were written: call again with an array that large.
+*/
+int rs2_get_sync_stats(const rs2_processing_block* block, rs2_sync_stats* stats, int capacity, rs2_error** error);
+
 /**
 * Creates Point-Cloud processing block. This block accepts depth frames and outputs Points frames
 * In addition, given non-depth frame, the block will align texture coordinate to the non-depth stream
@@ -265,6 +276,17 @@ rs2_processing_block* rs2_create_hdr_merge_processing_block(rs2_error** error);
 */
 rs2_processing_block* rs2_create_sequence_id_filter(rs2_error** error);
 
+/**
+* Creates a processing block that runs the given filters in sequence and publishes a single output frame.
+* Filters that support it (spatial, temporal, hole filling) process the frame in place, so frames are allocated
+* only by the filters that change the frame layout (decimation, disparity transform).
+* The filters remain owned by the caller; their options and state are shared with the fused block.
+* \param[in] blocks  The filters, in processing order
+* \param[in] count   Number of filters
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_fused_processing_block(rs2_processing_block** blocks, int count, rs2_error** error);
+
 /**
 * Retrieve processing block specific information, like name.
 * \param[in]  block     The processing block
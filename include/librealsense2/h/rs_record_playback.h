@@ -71,6 +71,36 @@ void rs2_record_device_resume(const rs2_device* device, rs2_error** error);
 */
 const char* rs2_record_device_filename(const rs2_device* device, rs2_error** error);
 
+/**
+* Encodes the depth and 16 bit infrared frames recorded from now on with RVL, a lossless depth codec that typically
+* shrinks depth images several times more than the file's chunk compression. Other streams and metadata are not affected.
+* Files recorded with the codec require a library version that can decode it.
+* \param[in]  device    A recording device
+* \param[in]  enable    Set to 1 to encode depth and infrared frames with RVL, 0 to record them as is
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_enable_depth_codec(const rs2_device* device, int enable, rs2_error** error);
+
+/**
+* Caps the frame data that the recording device holds in memory while waiting for it to be written to the file.
+* Frames that arrive when the cap is reached are dropped, and the recording continues with the following frames.
+* \param[in]  device    A recording device
+* \param[in]  bytes     The maximum size of frame data waiting to be written, in bytes
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_max_cached_size(const rs2_device* device, unsigned long long bytes, rs2_error** error);
+
+/**
+* Retrieves the state of the recording device writer
+* \param[in]  device                  A recording device
+* \param[out] queued_bytes            The frame data waiting to be written, in bytes
+* \param[out] dropped_frames          The number of frames dropped since recording started, as the writer fell behind
+* \param[out] megabytes_per_second    The average frame data written per second since recording started, in MB
+* \param[out] error                   If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_get_statistics(const rs2_device* device, unsigned long long* queued_bytes, unsigned long long* dropped_frames,
+    double* megabytes_per_second, rs2_error** error);
+
 /**
 * Creates a playback device to play the content of the given file
 * \param[in]  file      Path to the file to play
@@ -103,6 +133,43 @@ unsigned long long int rs2_playback_get_duration(const rs2_device* device, rs2_e
  */
 void rs2_playback_seek(const rs2_device* device, long long int time, rs2_error** error);
 
+/**
+ * Set the playback to the time point of a specific frame of one of the recorded streams
+ * The frames of each stream are indexed the first time the stream is seeked, without reading their data.
+ * \param[in] device        A playback device.
+ * \param[in] stream        The stream type of the frame
+ * \param[in] index         The stream index of the frame
+ * \param[in] frame_number  The frame number to which playback should seek
+ * \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_seek_to_frame(const rs2_device* device, rs2_stream stream, int index, unsigned long long int frame_number, rs2_error** error);
+
+/**
+ * Enable or disable keeping the frame numbers index of the played file in a file next to it (<file>.idx)
+ * When enabled, the index file is read instead of the recorded frames on later frame seeks of the same file.
+ * \param[in] device        A playback device.
+ * \param[in] enable        Indicates if the index file should be used, 0 means false, otherwise true
+ * \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_device_set_index_cache(const rs2_device* device, int enable, rs2_error** error);
+
+/**
+ * Set the amount of frame data the playback may read and decompress ahead of the played frames
+ * Reading ahead runs on a separate thread, and keeps the real time pacing and pause and resume behavior.
+ * \param[in] device        A playback device.
+ * \param[in] bytes         The memory budget of the frames read ahead, 0 disables reading ahead
+ * \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_device_set_prefetch_budget(const rs2_device* device, unsigned long long int bytes, rs2_error** error);
+
+/**
+ * Get the amount of frame data the playback may read and decompress ahead of the played frames
+ * \param[in] device        A playback device.
+ * \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return The memory budget of the frames read ahead, in bytes
+ */
+unsigned long long int rs2_playback_device_get_prefetch_budget(const rs2_device* device, rs2_error** error);
+
 /**
  * Gets the current position of the playback in the file in terms of time. Units are expressed in nanoseconds
  * \param[in] device     A playback device
@@ -150,6 +217,36 @@ void rs2_playback_device_set_real_time(const rs2_device* device, int real_time,
  */
 int rs2_playback_device_is_real_time(const rs2_device* device, rs2_error** error);
 
+/**
+ * Set the playback to work in batch mode, for offline processing of recorded data
+ *
+ * In batch mode, playback plays the file as fast as the application handles the frames. It works in non real time,
+ * and in addition never drops frames when the application holds on to many of them: the frames read from the file
+ * are limited by the queues the application reads them from, instead of by a fixed pool.
+ * Setting the playback to real time ends batch mode.
+ * \param[in] device A playback device
+ * \param[in] batch  Indicates if batch mode is requested, 0 means false, otherwise true
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_device_set_batch_mode(const rs2_device* device, int batch, rs2_error** error);
+
+/**
+ * Indicates if playback is in batch mode
+ * \param[in] device A playback device
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return True iff playback is in batch mode. 0 means false, otherwise true
+ */
+int rs2_playback_device_is_batch_mode(const rs2_device* device, rs2_error** error);
+
+/**
+ * Retrieves the rate at which the playback delivered frames since it was last started, excluding paused periods
+ * \param[in] device A playback device
+ * \param[out] frames_per_second     The number of frames delivered per second
+ * \param[out] megabytes_per_second  The frame data delivered per second, in MB
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_device_get_throughput(const rs2_device* device, double* frames_per_second, double* megabytes_per_second, rs2_error** error);
+
 /**
  * Register to receive callback from playback device upon its status changes
  *
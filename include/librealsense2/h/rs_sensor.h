@@ -277,6 +277,26 @@ void rs2_set_notifications_callback(const rs2_sensor* sensor, rs2_notification_c
 */
 void rs2_set_notifications_callback_cpp(const rs2_sensor* sensor, rs2_notifications_callback* callback, rs2_error** error);
 
+/**
+* set the allocator used for the data buffers of the frames produced by the sensor
+* The allocator is used from the next time the sensor is started, and is kept alive for as long as any frame it allocated exists.
+* Frame buffers are not zero-initialized. Must be called while the sensor is not streaming.
+* \param[in] sensor         the sensor
+* \param[in] on_allocate    function returning a buffer of the requested size in bytes, or null on failure. Pass null to restore the default allocator
+* \param[in] on_deallocate  function releasing a buffer previously returned by on_allocate
+* \param[in] user           caller-defined argument, passed to both functions
+* \param[out] error         if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_set_frame_buffer_allocator(const rs2_sensor* sensor, rs2_frame_buffer_allocate_ptr on_allocate, rs2_frame_buffer_deallocate_ptr on_deallocate, void* user, rs2_error** error);
+
+/**
+* set the allocator used for the data buffers of the frames produced by the sensor
+* \param[in] sensor      the sensor
+* \param[in] allocator   allocator object, released by the library once no frame uses it anymore. Pass null to restore the default allocator
+* \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_set_frame_buffer_allocator_cpp(const rs2_sensor* sensor, rs2_frame_buffer_allocator* allocator, rs2_error** error);
+
 /**
 * retrieve description from notification handle
 * \param[in] notification      handle returned from a callback
@@ -663,6 +683,13 @@ void rs2_set_motion_device_intrinsics(const rs2_sensor* sensor, const rs2_stream
 */
 float rs2_get_max_usable_depth_range(rs2_sensor const * sensor, rs2_error** error);
 
+/** Retrieve the frame buffer recycling counters of a sensor
+* \param[in]  sensor     the sensor to query
+* \param[out] stats      receives the counters, summed over all the frame types the sensor produces
+* \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_get_frame_pool_stats(rs2_sensor const * sensor, rs2_frame_pool_stats * stats, rs2_error** error);
+
 #ifdef __cplusplus
 }
 #endif
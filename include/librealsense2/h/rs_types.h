@@ -149,6 +149,26 @@ typedef struct rs2_pose
     unsigned int    mapper_confidence;    /**< Pose map confidence 0x0 - Failed, 0x1 - Low, 0x2 - Medium, 0x3 - High                                      */
 } rs2_pose;
 
+/** \brief Frame buffer recycling counters, accumulated over the frame archives of a sensor */
+typedef struct rs2_frame_pool_stats
+{
+    unsigned long long hits;        /**< Frame allocations served from a recycled buffer                   */
+    unsigned long long misses;      /**< Frame allocations that required a new buffer                      */
+    unsigned long long trimmed;     /**< Recycled buffers released after staying unused for too long       */
+    unsigned long long bytes_held;  /**< Bytes currently held by recycled buffers awaiting reuse           */
+} rs2_frame_pool_stats;
+
+/** \brief Counters of the frames a syncer received from one of the streams (or stream groups) it synchronizes */
+typedef struct rs2_sync_stats
+{
+    char               name[64];        /**< Name of the stream matcher, e.g. "Depth/0" or "(FN: Depth/0 Infrared/1)", truncated */
+    unsigned long long frames;          /**< Frames queued for matching                                               */
+    unsigned long long published;       /**< Frames released as part of a frameset                                    */
+    unsigned long long dropped;         /**< Frames discarded while waiting: queue overflow, inactive stream or stop  */
+    double             average_wait_ms; /**< How long the published frames waited for their partners, on average     */
+    double             max_wait_ms;     /**< How long a published frame waited for its partners, at most             */
+} rs2_sync_stats;
+
 /** \brief Severity of the librealsense logger. */
 typedef enum rs2_log_severity {
     RS2_LOG_SEVERITY_DEBUG, /**< Detailed information about ordinary operations */
@@ -285,6 +305,7 @@ typedef struct rs2_options_list rs2_options_list;
 typedef struct rs2_devices_changed_callback rs2_devices_changed_callback;
 typedef struct rs2_notification rs2_notification;
 typedef struct rs2_notifications_callback rs2_notifications_callback;
+typedef struct rs2_frame_buffer_allocator rs2_frame_buffer_allocator;
 typedef struct rs2_firmware_log_message rs2_firmware_log_message;
 typedef struct rs2_firmware_log_parsed_message rs2_firmware_log_parsed_message;
 typedef struct rs2_firmware_log_parser rs2_firmware_log_parser;
@@ -296,6 +317,8 @@ typedef void (*rs2_devices_changed_callback_ptr)(rs2_device_list*, rs2_device_li
 typedef void (*rs2_frame_callback_ptr)(rs2_frame*, void*);
 typedef void (*rs2_frame_processor_callback_ptr)(rs2_frame*, rs2_source*, void*);
 typedef void(*rs2_update_progress_callback_ptr)(const float, void*);
+typedef void* (*rs2_frame_buffer_allocate_ptr)(unsigned int size, void*);
+typedef void (*rs2_frame_buffer_deallocate_ptr)(void* buffer, unsigned int size, void*);
 
 typedef double      rs2_time_t;     /**< Timestamp format. units are milliseconds */
 typedef long long   rs2_metadata_type; /**< Metadata attribute type is defined as 64 bit signed integer*/
@@ -113,7 +113,8 @@ namespace rs2
             auto width = profile.width(), height = profile.height();
             static const auto threshold = get_option(OPTION_PLY_THRESHOLD);
             std::vector<std::array<size_t, 3>> faces;
-            if (mesh)
+            // Faces connect neighboring pixels, which needs a vertex per pixel; sparse pointclouds are saved as vertices
+            if (mesh && p.size() == size_t(width) * height)
             {
                 for (size_t x = 0; x < width - 1; ++x) {
                     for (size_t y = 0; y < height - 1; ++y) {
@@ -786,6 +786,20 @@ namespace rs2
             error::handle(e);
         }
         /**
+        * Export the point cloud to a PLY or PCD file, as selected by the file name extension (".pcd" for PCD, PLY otherwise)
+        * \param[in] string fname - file name to be saved
+        * \param[in] video_frame texture - the texture for the points, or an empty frame for uncolored points
+        * \param[in] bool binary - save the data in binary form, rather than ASCII
+        */
+        void export_to_file(const std::string& fname, video_frame texture, bool binary = true)
+        {
+            rs2_frame* ptr = nullptr;
+            std::swap(texture.frame_ref, ptr);
+            rs2_error* e = nullptr;
+            rs2_export_to_file(get(), fname.c_str(), ptr, binary ? 1 : 0, &e);
+            error::handle(e);
+        }
+        /**
         * Retrieve the texture coordinates (uv map) for the point cloud
         * \return texture_coordinate* - pointer of texture coordinates.
         */
@@ -797,6 +811,18 @@ namespace rs2
             return (const texture_coordinate*)res;
         }
 
+        /**
+        * Retrieve the index of the depth pixel each vertex was computed from
+        * \return const int* - pointer to the pixel indices, or null unless the pointcloud is sparse with pixel indices
+        */
+        const int* get_pixel_indices() const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_frame_pixel_indices(get(), &e);
+            error::handle(e);
+            return res;
+        }
+
         size_t size() const
         {
             return _size;
@@ -653,6 +653,27 @@ namespace rs2
         {
             _sync.invoke(std::move(f));
         }
+
+        /**
+        * Retrieve the frame counters of the streams the syncer synchronizes
+        * \return  per stream matcher: frames queued, published and dropped, and how long published frames waited
+        */
+        std::vector<rs2_sync_stats> get_stats() const
+        {
+            // The syncer may create matchers between the calls, so ask again until the array holds them all
+            std::vector<rs2_sync_stats> stats;
+            for (;;)
+            {
+                rs2_error* e = nullptr;
+                auto count = rs2_get_sync_stats(_sync.get(), stats.data(), static_cast<int>(stats.size()), &e);
+                error::handle(e);
+
+                bool complete = size_t(count) <= stats.size();
+                stats.resize(count);
+                if (complete)
+                    return stats;
+            }
+        }
     private:
         asynchronous_syncer _sync;
         frame_queue _results;
@@ -1179,5 +1200,35 @@ namespace rs2
             return block;
         }
     };
+
+    class fused_filter : public filter
+    {
+    public:
+        /**
+        * Create a processing block that runs the given filters in sequence and publishes a single frame.
+        * Spatial, temporal and hole filling filters process the frame in place instead of allocating
+        * and copying a frame each. The filters keep their options and state.
+        * \param[in] filters - the filters, in processing order
+        */
+        fused_filter(std::initializer_list<std::reference_wrapper<const filter>> filters) : filter(init(filters), 1) {}
+
+    private:
+        friend class context;
+
+        std::shared_ptr<rs2_processing_block> init(std::initializer_list<std::reference_wrapper<const filter>> filters)
+        {
+            std::vector<rs2_processing_block*> blocks;
+            for (auto&& f : filters)
+                blocks.push_back(f.get().get());
+
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_fused_processing_block(blocks.data(), static_cast<int>(blocks.size()), &e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
 }
 #endif // LIBREALSENSE_RS2_PROCESSING_HPP
@@ -96,6 +96,53 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Sets the playback to the time point of a specific frame of one of the recorded streams
+        * \param[in] stream        The stream type of the frame
+        * \param[in] index         The stream index of the frame
+        * \param[in] frame_number  The frame number to which playback should seek
+        */
+        void seek_to_frame(rs2_stream stream, int index, unsigned long long frame_number)
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_seek_to_frame(_dev.get(), stream, index, frame_number, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Enables keeping the frame numbers index of the played file in a file next to it, for later frame seeks
+        * \param[in] enable  True to read and write the index file
+        */
+        void set_index_cache(bool enable)
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_device_set_index_cache(_dev.get(), enable ? 1 : 0, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Sets the amount of frame data the playback may read and decompress ahead of the played frames
+        * \param[in] bytes  The memory budget of the frames read ahead, 0 disables reading ahead
+        */
+        void set_prefetch_budget(unsigned long long bytes)
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_device_set_prefetch_budget(_dev.get(), bytes, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Retrieves the amount of frame data the playback may read and decompress ahead of the played frames
+        * \return The memory budget of the frames read ahead, in bytes
+        */
+        unsigned long long get_prefetch_budget() const
+        {
+            rs2_error* e = nullptr;
+            auto bytes = rs2_playback_device_get_prefetch_budget(_dev.get(), &e);
+            error::handle(e);
+            return bytes;
+        }
+
         /**
         * Indicates if playback is in real time mode or non real time
         * \return True iff playback is in real time mode
@@ -126,6 +173,46 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Indicates if playback is in batch mode
+        * \return True iff playback is in batch mode
+        */
+        bool is_batch_mode() const
+        {
+            rs2_error* e = nullptr;
+            bool batch = rs2_playback_device_is_batch_mode(_dev.get(), &e) != 0;
+            error::handle(e);
+            return batch;
+        }
+
+        /**
+        * Set the playback to work in batch mode, for offline processing of recorded data
+        *
+        * In batch mode, playback plays the file as fast as the application handles the frames. It works in non real
+        * time, and in addition never drops frames when the application holds on to many of them.
+        * Setting the playback to real time ends batch mode.
+        * \param[in] batch  Indicates if batch mode is requested
+        */
+        void set_batch_mode(bool batch) const
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_device_set_batch_mode(_dev.get(), (batch ? 1 : 0), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Retrieves the rate at which the playback delivered frames since it was last started, excluding paused periods
+        * \return The number of frames and the MB of frame data delivered per second
+        */
+        std::pair<double, double> get_throughput() const
+        {
+            rs2_error* e = nullptr;
+            double frames_per_second = 0, megabytes_per_second = 0;
+            rs2_playback_device_get_throughput(_dev.get(), &frames_per_second, &megabytes_per_second, &e);
+            error::handle(e);
+            return std::make_pair(frames_per_second, megabytes_per_second);
+        }
+
         /**
         * Set the playing speed
         * \param[in] speed  Indicates a multiplication of the speed to play (e.g: 1 = normal, 0.5 twice as slow)
@@ -266,6 +353,48 @@ namespace rs2
             error::handle(e);
             return filename;
         }
+
+        /**
+        * Encodes the depth and 16 bit infrared frames recorded from now on with RVL, a lossless depth codec
+        * \param[in] enable  True to encode depth and infrared frames with RVL, false to record them as is
+        */
+        void enable_depth_codec(bool enable)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_enable_depth_codec(_dev.get(), (enable ? 1 : 0), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Caps the frame data held in memory while waiting to be written. Frames arriving beyond it are dropped.
+        * \param[in] bytes  The maximum size of frame data waiting to be written, in bytes
+        */
+        void set_max_cached_size(unsigned long long bytes)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_max_cached_size(_dev.get(), bytes, &e);
+            error::handle(e);
+        }
+
+        struct statistics
+        {
+            unsigned long long queued_bytes;
+            unsigned long long dropped_frames;
+            double megabytes_per_second;
+        };
+
+        /**
+        * Retrieves the state of the writer: the frame data waiting to be written, the frames dropped since recording
+        * started and the average write rate
+        */
+        statistics get_statistics() const
+        {
+            rs2_error* e = nullptr;
+            statistics stats{};
+            rs2_record_device_get_statistics(_dev.get(), &stats.queued_bytes, &stats.dropped_frames, &stats.megabytes_per_second, &e);
+            error::handle(e);
+            return stats;
+        }
     protected:
         explicit recorder(std::shared_ptr<rs2_device> dev) : device(dev)
         {
@@ -98,6 +98,21 @@ namespace rs2
         void release() override { delete this; }
     };
 
+    template<class A, class D>
+    class frame_buffer_allocator : public rs2_frame_buffer_allocator
+    {
+        A on_allocate_function;
+        D on_deallocate_function;
+    public:
+        frame_buffer_allocator(A on_allocate, D on_deallocate)
+            : on_allocate_function(on_allocate), on_deallocate_function(on_deallocate) {}
+
+        void* allocate(unsigned int size) override { return on_allocate_function(size); }
+        void deallocate(void* buffer, unsigned int size) override { on_deallocate_function(buffer, size); }
+
+        void release() override { delete this; }
+    };
+
 
     class sensor : public options
     {
@@ -212,6 +227,31 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * set the allocator for the data buffers of the frames produced by the sensor
+        * takes effect the next time the sensor is started; frame buffers are not zero-initialized
+        * \param[in] allocate     callable with signature void*(unsigned int size), returning null on failure
+        * \param[in] deallocate   callable with signature void(void* buffer, unsigned int size)
+        */
+        template<class A, class D>
+        void set_frame_buffer_allocator(A allocate, D deallocate) const
+        {
+            rs2_error* e = nullptr;
+            rs2_set_frame_buffer_allocator_cpp(_sensor.get(),
+                new frame_buffer_allocator<A, D>(std::move(allocate), std::move(deallocate)), &e);
+            error::handle(e);
+        }
+
+        /**
+        * restore the default frame buffer allocator
+        */
+        void reset_frame_buffer_allocator() const
+        {
+            rs2_error* e = nullptr;
+            rs2_set_frame_buffer_allocator_cpp(_sensor.get(), nullptr, &e);
+            error::handle(e);
+        }
+
         /**
         * Retrieves the list of stream profiles supported by the sensor.
         * \return   list of stream profiles that given sensor can provide
@@ -295,6 +335,19 @@ namespace rs2
             return results;
         }
 
+        /**
+        * Retrieve the frame buffer recycling counters of the sensor
+        * \return  hits, misses, trimmed buffers and bytes held, summed over all the frame types of the sensor
+        */
+        rs2_frame_pool_stats get_frame_pool_stats() const
+        {
+            rs2_error* e = nullptr;
+            rs2_frame_pool_stats stats;
+            rs2_get_frame_pool_stats(_sensor.get(), &stats, &e);
+            error::handle(e);
+            return stats;
+        }
+
         sensor& operator=(const std::shared_ptr<rs2_sensor> other)
         {
             options::operator=(other);
@@ -43,6 +43,14 @@ struct rs2_notifications_callback
     virtual                                 ~rs2_notifications_callback() {}
 };
 
+struct rs2_frame_buffer_allocator
+{
+    virtual void*                           allocate(unsigned int size) = 0;
+    virtual void                            deallocate(void* buffer, unsigned int size) = 0;
+    virtual void                            release() = 0;
+    virtual                                 ~rs2_frame_buffer_allocator() {}
+};
+
 typedef void ( *log_callback_function_ptr )(rs2_log_severity severity, rs2_log_message const * msg );
 
 struct rs2_software_device_destruction_callback
@@ -85,19 +85,22 @@ namespace librealsense
         virtual frame_interface* publish_frame(frame_interface* frame) = 0;
         virtual void unpublish_frame(frame_interface* frame) = 0;
         virtual void keep_frame(frame_interface* frame) = 0;
+
+        virtual rs2_frame_pool_stats get_pool_stats() const = 0;
         virtual ~archive_interface() = default;
     };
 
     std::shared_ptr<archive_interface> make_archive(rs2_extension type,
         std::atomic<uint32_t>* in_max_frame_queue_size,
         std::shared_ptr<platform::time_service> ts,
-        std::shared_ptr<metadata_parser_map> parsers);
+        std::shared_ptr<metadata_parser_map> parsers,
+        frame_buffer_allocator_ptr allocator = nullptr);
 
     // Define a movable but explicitly noncopyable buffer type to hold our frame data
     class LRS_EXTENSION_API frame : public frame_interface
     {
     public:
-        std::vector<byte> data;
+        frame_buffer data;
         frame_additional_data additional_data;
         std::shared_ptr<metadata_parser_map> metadata_parsers = nullptr;
         explicit frame() : ref_count(0), owner(nullptr), on_release(),_kept(false) {}
@@ -182,6 +185,8 @@ namespace librealsense
         std::shared_ptr<stream_profile_interface> stream;
     };
 
+    // Holds the vertices, followed by their texture coordinates. A dense frame has a vertex per depth
+    // pixel; a sparse one only the valid vertices, optionally followed by the depth pixel index of each.
     class points : public frame
     {
     public:
@@ -189,6 +194,14 @@ namespace librealsense
         void export_to_ply(const std::string& fname, const frame_holder& texture);
         size_t get_vertex_count() const;
         float2* get_texture_coordinates();
+        int* get_pixel_indices();
+
+        // Shrinks the frame to its first 'count' vertices and texture coordinates, which must already be
+        // packed at the start of both arrays, and adds a pixel index channel when 'pixel_indices' is given
+        void make_sparse(size_t count, const int* pixel_indices);
+
+    private:
+        bool _has_pixel_indices = false;
     };
 
     MAP_EXTENSION(RS2_EXTENSION_POINTS, librealsense::points);
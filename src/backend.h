@@ -173,6 +173,8 @@ namespace librealsense
             const void *    pixels;
             const void *    metadata;
             rs2_time_t      backend_time;
+            bool            retainable;     // pixels stay valid until the frame continuation is invoked,
+                                            // so consumers may wrap them instead of copying
         };
 
         typedef std::function<void(stream_profile, frame_object, std::function<void()>)> frame_callback;
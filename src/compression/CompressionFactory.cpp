@@ -5,10 +5,11 @@
 #include "JpegCompression.h"
 #include "Lz4Compression.h"
 #include "RvlCompression.h"
+#include "SliceCompression.h"
 
 std::shared_ptr<ICompression> CompressionFactory::getObject(int t_width, int t_height, rs2_format t_format, rs2_stream t_streamType, int t_bpp)
 {
-    ZipMethod zipMeth;
+    ZipMethod zipMeth = ZipMethod::gzip;
     if(t_streamType == RS2_STREAM_COLOR || t_streamType == RS2_STREAM_INFRARED)
     {
         zipMeth = ZipMethod::jpeg;
@@ -21,22 +22,35 @@ std::shared_ptr<ICompression> CompressionFactory::getObject(int t_width, int t_h
     {
         return nullptr;
     }
+    return getObject(t_width, t_height, t_format, zipMeth, t_bpp);
+}
 
-    switch(zipMeth)
+std::shared_ptr<ICompression> CompressionFactory::getObject(int t_width, int t_height, rs2_format t_format, ZipMethod t_zipMethod, int t_bpp, int t_slicesCount)
+{
+    ZipMethod zipMeth = t_zipMethod;
+    if(zipMeth != ZipMethod::rvl && zipMeth != ZipMethod::jpeg && zipMeth != ZipMethod::lz)
     {
-    case ZipMethod::rvl:
-        return std::make_shared<RvlCompression>(t_width, t_height, t_format, t_bpp);
-        break;
-    case ZipMethod::jpeg:
-        return std::make_shared<JpegCompression>(t_width, t_height, t_format, t_bpp);
-        break;
-    case ZipMethod::lz:
-        return std::make_shared<Lz4Compression>(t_width, t_height, t_format, t_bpp);
-        break;
-    default:
         ERR << "unknown zip method";
         return nullptr;
     }
+
+    // Frames are compressed as slices, each by a codec of the zip method
+    return std::make_shared<SliceCompression>(t_width, t_height, t_format, t_bpp, [=](int t_sliceWidth, int t_sliceHeight) -> std::shared_ptr<ICompression> {
+        switch(zipMeth)
+        {
+        case ZipMethod::rvl:
+            return std::make_shared<RvlCompression>(t_sliceWidth, t_sliceHeight, t_format, t_bpp);
+            break;
+        case ZipMethod::jpeg:
+            return std::make_shared<JpegCompression>(t_sliceWidth, t_sliceHeight, t_format, t_bpp);
+            break;
+        case ZipMethod::lz:
+            return std::make_shared<Lz4Compression>(t_sliceWidth, t_sliceHeight, t_format, t_bpp);
+            break;
+        default:
+            return nullptr;
+        }
+    }, t_slicesCount);
 }
 
 bool& CompressionFactory::getIsEnabled()
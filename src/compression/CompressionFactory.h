@@ -18,6 +18,8 @@ class CompressionFactory
 {
 public:
     static std::shared_ptr<ICompression> getObject(int t_width, int t_height, rs2_format t_format, rs2_stream t_streamType, int t_bpp);
+    // Frames split into t_slicesCount slices, or when 0, as many as are compressed in parallel
+    static std::shared_ptr<ICompression> getObject(int t_width, int t_height, rs2_format t_format, ZipMethod t_zipMethod, int t_bpp, int t_slicesCount = 0);
     static bool isCompressionSupported(rs2_format t_format, rs2_stream t_streamType);
     static bool& getIsEnabled();
 };
@@ -181,8 +181,7 @@ int JpegCompression::decompressBuffer(unsigned char* t_buffer, int t_compressedS
     unsigned char* ptr = t_uncompressedBuf;
     unsigned char* data = t_buffer;
     unsigned int jpegHeader{}, res{};
-    jpeg_mem_src(&m_dinfo, data, t_compressedSize);
-    if(t_buffer != nullptr)
+    if(t_buffer != nullptr && t_compressedSize >= int(sizeof(unsigned int)))
     {
         memcpy(&jpegHeader, t_buffer, sizeof(unsigned int));
     }
@@ -191,12 +190,20 @@ int JpegCompression::decompressBuffer(unsigned char* t_buffer, int t_compressedS
         ERR << "Not a JPEG frame, skipping";
         return -1;
     }
+    jpeg_mem_src(&m_dinfo, data, t_compressedSize);
     res = jpeg_read_header(&m_dinfo, TRUE);
     if(!res)
     {
         ERR << "Cannot read JPEG header";
         return -1;
     }
+    if(m_dinfo.image_width != unsigned(m_width) || m_dinfo.image_height != unsigned(m_height))
+    {
+        // The rows are decompressed into buffers of the frame's size
+        ERR << "Unexpected JPEG frame size " << m_dinfo.image_width << "x" << m_dinfo.image_height;
+        jpeg_abort_decompress(&m_dinfo);
+        return -1;
+    }
     if(m_format == RS2_FORMAT_RGB8 || m_format == RS2_FORMAT_BGR8)
     {
         m_dinfo.out_color_space = JCS_RGB;
@@ -5,15 +5,14 @@
 
 #include "ICompression.h"
 
+#include <cstdint>
+
+// RVL (Run length, Variable Length) lossless depth compression, with the codec of src/rvl-codec.h that the
+// recorder uses too. The compressed frame is the size of the RVL data, then the data.
 class RvlCompression : public ICompression
 {
 public:
     RvlCompression(int t_width, int t_height, rs2_format t_format, int t_bpp);
     int compressBuffer(unsigned char* t_buffer, int t_size, unsigned char* t_compressedBuf);
     int decompressBuffer(unsigned char* t_buffer, int t_size, unsigned char* t_uncompressedBuf);
-
-private:
-    int encodeVLE(int value);
-    int decodeVLE();
-    int *m_pBuffer, m_word, m_nibblesWritten;
 };
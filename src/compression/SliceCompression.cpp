@@ -0,0 +1,222 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "SliceCompression.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+SliceCompression::SliceCompression(int t_width, int t_height, rs2_format t_format, int t_bpp, CodecFactory t_codecFactory, int t_slicesCount)
+    : ICompression(t_width, t_height, t_format, t_bpp)
+    , m_codecFactory(t_codecFactory)
+{
+    if(t_slicesCount == 0)
+    {
+        // More slices than threads only cost compression ratio
+        t_slicesCount = std::min<int>(WorkerPool::getInstance().getConcurrency(), m_height / MIN_SLICE_ROWS);
+        t_slicesCount = std::max(1, std::min(t_slicesCount, MAX_SLICES));
+    }
+    m_slicesCount = t_slicesCount;
+    if(!setSlicesCount(m_slicesCount))
+    {
+        ERR << "Failure creating the codecs of " << m_slicesCount << " slices";
+    }
+}
+
+int SliceCompression::getSliceRow(int t_slice, int t_slicesCount) const
+{
+    return int((long long)t_slice * m_height / t_slicesCount);
+}
+
+bool SliceCompression::setSlicesCount(int t_slicesCount)
+{
+    if(t_slicesCount < 1 || t_slicesCount > MAX_SLICES || t_slicesCount > m_height)
+    {
+        return false;
+    }
+    if(int(m_codecs.size()) == t_slicesCount)
+    {
+        return true;
+    }
+
+    m_codecs.clear();
+    for(int i = 0; i < t_slicesCount; i++)
+    {
+        std::shared_ptr<ICompression> codec = m_codecFactory(m_width, getSliceRow(i + 1, t_slicesCount) - getSliceRow(i, t_slicesCount));
+        if(codec == nullptr)
+        {
+            m_codecs.clear();
+            return false;
+        }
+        m_codecs.push_back(codec);
+    }
+    m_compressedSlices.clear();
+    m_compressedSizes.assign(t_slicesCount, 0);
+    return true;
+}
+
+bool SliceCompression::readContainer(unsigned char* t_buffer, int t_size, std::vector<unsigned char*>& t_slices)
+{
+    int fields[3] = {};
+    memcpy(fields, t_buffer, sizeof(fields));
+    int slicesCount = fields[2];
+    if(!setSlicesCount(slicesCount))
+    {
+        ERR << "Failure trying to decompress the frame, invalid slices count " << slicesCount;
+        return false;
+    }
+
+    int headerSize = int(sizeof(fields)) + slicesCount * int(sizeof(int));
+    if(t_size < headerSize)
+    {
+        ERR << "Failure trying to decompress the frame, truncated slices header";
+        return false;
+    }
+    t_slices.resize(slicesCount);
+    unsigned char* data = t_buffer + headerSize;
+    int remaining = t_size - headerSize;
+    for(int i = 0; i < slicesCount; i++)
+    {
+        memcpy(&m_compressedSizes[i], t_buffer + sizeof(fields) + i * sizeof(int), sizeof(int));
+        if(m_compressedSizes[i] < 0 || m_compressedSizes[i] > remaining)
+        {
+            ERR << "Failure trying to decompress the frame, truncated slice " << i;
+            return false;
+        }
+        t_slices[i] = data;
+        data += m_compressedSizes[i];
+        remaining -= m_compressedSizes[i];
+    }
+    if(remaining != 0)
+    {
+        ERR << "Failure trying to decompress the frame, " << remaining << " bytes past the slices";
+        return false;
+    }
+    return true;
+}
+
+int SliceCompression::compressBuffer(unsigned char* t_buffer, int t_size, unsigned char* t_compressedBuf)
+{
+    if(!setSlicesCount(m_slicesCount) || t_size < m_width * m_height * m_bpp)
+    {
+        ERR << "Failure trying to compress the frame, unexpected frame size " << t_size;
+        return -1;
+    }
+    int slicesCount = m_slicesCount;
+    if(slicesCount == 1)
+    {
+        // A single slice is the codec's data alone, which peers that predate slices decode
+        return m_codecs[0]->compressBuffer(t_buffer, t_size, t_compressedBuf);
+    }
+
+    // The codecs write their compressed size in front of the data, and may write past the size of
+    // incompressible data before they fail, so each slice is compressed into a buffer of twice its size
+    if(m_compressedSlices.empty())
+    {
+        for(int i = 0; i < slicesCount; i++)
+        {
+            int sliceSize = (getSliceRow(i + 1, slicesCount) - getSliceRow(i, slicesCount)) * m_width * m_bpp;
+            m_compressedSlices.emplace_back(2 * sliceSize + sizeof(int));
+        }
+    }
+
+    WorkerPool::getInstance().parallelFor(slicesCount, [&](int t_slice) {
+        int rowSize = m_width * m_bpp;
+        int sliceRow = getSliceRow(t_slice, slicesCount);
+        int sliceSize = (getSliceRow(t_slice + 1, slicesCount) - sliceRow) * rowSize;
+        m_compressedSizes[t_slice] = m_codecs[t_slice]->compressBuffer(t_buffer + sliceRow * rowSize, sliceSize, m_compressedSlices[t_slice].data());
+    });
+
+    int headerSize = (slicesCount + 3) * sizeof(int);
+    int compressedSize = headerSize;
+    for(int i = 0; i < slicesCount; i++)
+    {
+        if(m_compressedSizes[i] == -1)
+        {
+            return -1;
+        }
+        compressedSize += m_compressedSizes[i] - sizeof(int);
+    }
+    int compressWithHeaderSize = compressedSize + sizeof(compressedSize);
+    if(compressWithHeaderSize > t_size)
+    {
+        ERR << "Compression overflow, destination buffer is smaller than the compressed size";
+        return -1;
+    }
+
+    int fields[3] = {SLICES_MAGIC, SLICES_VERSION, slicesCount};
+    unsigned char* header = t_compressedBuf + sizeof(compressedSize);
+    unsigned char* data = header + headerSize;
+    memcpy(t_compressedBuf, &compressedSize, sizeof(compressedSize));
+    memcpy(header, fields, sizeof(fields));
+    for(int i = 0; i < slicesCount; i++)
+    {
+        int sliceCompressedSize = m_compressedSizes[i] - sizeof(int);
+        memcpy(header + sizeof(fields) + i * sizeof(int), &sliceCompressedSize, sizeof(int));
+        memcpy(data, m_compressedSlices[i].data() + sizeof(int), sliceCompressedSize);
+        data += sliceCompressedSize;
+    }
+    return compressWithHeaderSize;
+}
+
+int SliceCompression::decompressBuffer(unsigned char* t_buffer, int t_size, unsigned char* t_uncompressedBuf)
+{
+    if(t_size <= 0)
+    {
+        // No codec writes empty data, and some would read past it
+        ERR << "Failure trying to decompress the frame, no data.";
+        return -1;
+    }
+
+    int fields[2] = {};
+    if(t_size >= int(sizeof(fields) + sizeof(int)))
+    {
+        memcpy(fields, t_buffer, sizeof(fields));
+    }
+    if(fields[0] != SLICES_MAGIC)
+    {
+        // Not a container, the data of a single slice
+        if(!setSlicesCount(1))
+        {
+            return -1;
+        }
+        if(m_codecs[0]->decompressBuffer(t_buffer, t_size, t_uncompressedBuf) != m_width * m_height * m_bpp)
+        {
+            ERR << "Failure trying to decompress the frame.";
+            return -1;
+        }
+        return m_width * m_height * m_bpp;
+    }
+
+    if(fields[1] != SLICES_VERSION)
+    {
+        ERR << "Failure trying to decompress the frame, unsupported slices version " << fields[1];
+        return -1;
+    }
+
+    std::vector<unsigned char*> slices;
+    if(!readContainer(t_buffer, t_size, slices))
+    {
+        return -1;
+    }
+    int slicesCount = int(slices.size());
+
+    std::atomic<bool> failed(false);
+    WorkerPool::getInstance().parallelFor(slicesCount, [&](int t_slice) {
+        int rowSize = m_width * m_bpp;
+        int sliceRow = getSliceRow(t_slice, slicesCount);
+        int sliceSize = (getSliceRow(t_slice + 1, slicesCount) - sliceRow) * rowSize;
+        if(m_codecs[t_slice]->decompressBuffer(slices[t_slice], m_compressedSizes[t_slice], t_uncompressedBuf + sliceRow * rowSize) != sliceSize)
+        {
+            failed = true;
+        }
+    });
+    if(failed)
+    {
+        ERR << "Failure trying to decompress the frame.";
+        return -1;
+    }
+    return m_width * m_height * m_bpp;
+}
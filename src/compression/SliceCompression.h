@@ -0,0 +1,45 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "ICompression.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#define MAX_SLICES 8 // upper bound of the number of slices a frame is split into
+#define MIN_SLICE_ROWS 60 // frames are not split into slices of fewer rows
+#define SLICES_MAGIC 0x534c5352 // "RSLS", starts a frame of several slices
+#define SLICES_VERSION 1
+
+// Splits frames into horizontal slices, each compressed by a codec of its own, on the worker pool.
+// A frame of several slices is a container indexing them, so that they are decompressed in parallel too:
+//   [int SLICES_MAGIC][int SLICES_VERSION][int slices count][int compressed size of each slice]...[compressed slice]...
+// Slice i holds rows [i * height / count, (i + 1) * height / count). A frame of a single slice is the codec's
+// data alone, the format of peers that predate slices, so that they interoperate with a side compressing
+// whole frames; peers that predate slices cannot decode frames of several slices. Data that does not start
+// with SLICES_MAGIC is decompressed as a single slice. The decompressor follows the slices count of the container,
+// so the compressing and decompressing sides need not have the same number of cores.
+class SliceCompression : public ICompression
+{
+public:
+    typedef std::function<std::shared_ptr<ICompression>(int t_width, int t_height)> CodecFactory;
+
+    // Frames are compressed as t_slicesCount slices, or when 0, as many as the worker pool runs in parallel
+    SliceCompression(int t_width, int t_height, rs2_format t_format, int t_bpp, CodecFactory t_codecFactory, int t_slicesCount = 0);
+    int compressBuffer(unsigned char* t_buffer, int t_size, unsigned char* t_compressedBuf);
+    int decompressBuffer(unsigned char* t_buffer, int t_size, unsigned char* t_uncompressedBuf);
+
+private:
+    int getSliceRow(int t_slice, int t_slicesCount) const;
+    bool setSlicesCount(int t_slicesCount);
+    bool readContainer(unsigned char* t_buffer, int t_size, std::vector<unsigned char*>& t_slices);
+
+    CodecFactory m_codecFactory;
+    int m_slicesCount;
+    std::vector<std::shared_ptr<ICompression>> m_codecs;
+    std::vector<std::vector<unsigned char>> m_compressedSlices;
+    std::vector<int> m_compressedSizes;
+};
@@ -0,0 +1,108 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool(unsigned t_threadsCount)
+    : m_exit(false)
+{
+    for(unsigned i = 0; i < t_threadsCount; i++)
+    {
+        m_threads.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_exit = true;
+    }
+    m_jobsCv.notify_all();
+    for(auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+WorkerPool& WorkerPool::getInstance()
+{
+    static WorkerPool instance(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return instance;
+}
+
+unsigned WorkerPool::getConcurrency() const
+{
+    return unsigned(m_threads.size()) + 1;
+}
+
+void WorkerPool::parallelFor(int t_count, const std::function<void(int)>& t_task)
+{
+    if(t_count <= 0)
+    {
+        return;
+    }
+    if(t_count == 1 || m_threads.empty())
+    {
+        for(int i = 0; i < t_count; i++)
+        {
+            t_task(i);
+        }
+        return;
+    }
+
+    auto job = std::make_shared<Job>(t_count, t_task);
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_jobs.push_back(job);
+    }
+    m_jobsCv.notify_all();
+
+    runTasks(*job);
+
+    std::unique_lock<std::mutex> lk(m_mutex);
+    m_doneCv.wait(lk, [&]() { return job->m_done == job->m_count; });
+}
+
+void WorkerPool::runTasks(Job& t_job)
+{
+    int index;
+    while((index = t_job.m_next++) < t_job.m_count)
+    {
+        t_job.m_task(index);
+
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if(++t_job.m_done == t_job.m_count)
+        {
+            m_doneCv.notify_all();
+        }
+    }
+
+    // All the tasks are taken, no other thread needs to look at this job
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto it = std::find_if(m_jobs.begin(), m_jobs.end(), [&](const std::shared_ptr<Job>& job) { return job.get() == &t_job; });
+    if(it != m_jobs.end())
+    {
+        m_jobs.erase(it);
+    }
+}
+
+void WorkerPool::workerLoop()
+{
+    while(true)
+    {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lk(m_mutex);
+            m_jobsCv.wait(lk, [this]() { return m_exit || !m_jobs.empty(); });
+            if(m_exit)
+            {
+                return;
+            }
+            job = m_jobs.front();
+        }
+        runTasks(*job);
+    }
+}
@@ -0,0 +1,56 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Threads shared by all the compressors of the process, so that slices of frames of several streams
+// are spread over the same cores instead of each stream starting threads of its own.
+class WorkerPool
+{
+public:
+    explicit WorkerPool(unsigned t_threadsCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Runs t_task for each index in [0, t_count), on the pool threads and on the calling thread,
+    // and returns once all of them are done
+    void parallelFor(int t_count, const std::function<void(int)>& t_task);
+
+    // Number of threads parallelFor runs on, the calling thread included
+    unsigned getConcurrency() const;
+
+    // One thread per core, the calling thread being one of them
+    static WorkerPool& getInstance();
+
+private:
+    struct Job
+    {
+        Job(int t_count, const std::function<void(int)>& t_task) : m_count(t_count), m_task(t_task), m_next(0), m_done(0) {}
+
+        const int m_count;
+        const std::function<void(int)>& m_task;
+        std::atomic<int> m_next;
+        int m_done; // guarded by the pool mutex
+    };
+
+    void workerLoop();
+    void runTasks(Job& t_job);
+
+    std::vector<std::thread> m_threads;
+    std::deque<std::shared_ptr<Job>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_jobsCv;
+    std::condition_variable m_doneCv;
+    bool m_exit;
+};
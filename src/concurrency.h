@@ -3,62 +3,113 @@
 
 #pragma once
 #include <queue>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
 #include <thread>
 #include <atomic>
 #include <functional>
 #include <cassert>
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <exception>
+#include <cstdint>
+#include <new>
+#include <type_traits>
 
 const int QUEUE_MAX_SIZE = 10;
-// Simplest implementation of a blocking concurrent queue for thread messaging
+const unsigned int QUEUE_MAX_RING_SIZE = 1 << 16;  // Largest capacity kept in a ring of slots allocated up front
+
+// A bounded blocking concurrent queue for thread messaging.
+// Items live in a fixed ring of slots, each with a sequence number telling whether it is free for the
+// producer of a given round or holds an item for the consumer (a bounded MPMC ring, after D. Vyukov), so
+// enqueueing and dequeueing take no lock. Threads only touch the mutex to sleep while the queue is
+// empty (or full, for blocking_enqueue), and are only notified when someone actually sleeps.
+// Capacities larger than QUEUE_MAX_RING_SIZE (like the practically unbounded queues of the recorder and of
+// playback) would preallocate too many slots: their items are kept in a deque under a lock instead, which
+// grows as needed.
 template<class T>
 class single_consumer_queue
 {
-    std::deque<T> _queue;
+    // Items are constructed in a slot when enqueued and destroyed when dequeued, so T needs no default constructor
+    struct slot
+    {
+        std::atomic<size_t> seq;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        T * item() { return reinterpret_cast< T * >( &storage ); }
+    };
+
+    std::unique_ptr<slot[]> _slots;
+    unsigned int const _cap;
+    unsigned int const _ring;  // Number of slots (0 for a deque); the sequence numbers of a single slot cannot tell full from free
+
+    std::deque<T> _unbounded;  // The items, when the capacity is too large for a ring
+    mutable std::mutex _unbounded_mutex;
+    std::atomic<size_t> _head; // Next slot to dequeue
+    std::atomic<size_t> _tail; // Next slot to enqueue
+
+    std::atomic<bool> _accepting;
+    std::atomic<int> _pushing;  // Producers between checking _accepting and publishing their item; never held across callbacks
+
     mutable std::mutex _mutex;
     std::condition_variable _deq_cv; // not empty signal
     std::condition_variable _enq_cv; // not full signal
-
-    unsigned int const _cap;
-    bool _accepting;
+    std::condition_variable _push_cv; // last producer left, once stopped
+    std::atomic<int> _deq_waiters;
+    std::atomic<int> _enq_waiters;
 
     std::function<void(T const &)> const _on_drop_callback;
 
 public:
     explicit single_consumer_queue< T >( unsigned int cap = QUEUE_MAX_SIZE,
                                          std::function< void( T const & ) > on_drop_callback = nullptr )
-        : _cap( cap )
+        : _slots( cap > QUEUE_MAX_RING_SIZE ? nullptr : new slot[std::max( cap, 2u )] )
+        , _cap( std::max( cap, 1u ) )
+        , _ring( cap > QUEUE_MAX_RING_SIZE ? 0 : std::max( cap, 2u ) )
+        , _head( 0 )
+        , _tail( 0 )
         , _accepting( true )
+        , _pushing( 0 )
+        , _deq_waiters( 0 )
+        , _enq_waiters( 0 )
         , _on_drop_callback( on_drop_callback )
     {
+        for( size_t i = 0; i < _ring; ++i )
+            _slots[i].seq.store( i, std::memory_order_relaxed );
+    }
+
+    ~single_consumer_queue()
+    {
+        while( pop( []( T && ) {} ) )
+            ;
     }
 
     // Enqueue an item onto the queue.
     // If the queue grows beyond capacity, the front will be removed, losing whatever was there!
     void enqueue(T&& item)
     {
-        std::unique_lock<std::mutex> lock(_mutex);
-        if( ! _accepting )
+        for( ;; )
         {
-            if( _on_drop_callback )
-                _on_drop_callback( item );
-            return;
-        }
+            if( ! begin_push() )
+            {
+                if( _on_drop_callback )
+                    _on_drop_callback( item );
+                return;
+            }
 
-        _queue.push_back(std::move(item));
+            bool pushed = try_push( item );
+            end_push();
+            if( pushed )
+                break;
 
-        if( _queue.size() > _cap )
-        {
-            if( _on_drop_callback )
-                _on_drop_callback( _queue.front() );
-            _queue.pop_front();
+            // Only pushes hold up stop(), so the front is dropped (and the callback called) outside of one
+            drop_front();
         }
 
-        lock.unlock();
-
         // We pushed something -- let others know there's something to dequeue
-        _deq_cv.notify_one();
+        notify( _deq_cv, _deq_waiters );
     }
 
 
@@ -66,22 +117,26 @@ public:
     // Returns true if the enqueue succeeded
     bool blocking_enqueue(T&& item)
     {
-        std::unique_lock<std::mutex> lock(_mutex);
-        _enq_cv.wait( lock, [this]() {
-            return _queue.size() < _cap; } );
-        if( ! _accepting )
+        for( ;; )
         {
-            // We shouldn't be adding anything to the queue when we're stopping
-            if( _on_drop_callback )
-                _on_drop_callback( item );
-            return false;
-        }
+            if( ! begin_push() )
+            {
+                // We shouldn't be adding anything to the queue when we're stopping
+                if( _on_drop_callback )
+                    _on_drop_callback( item );
+                return false;
+            }
 
-        _queue.push_back(std::move(item));
-        lock.unlock();
+            bool pushed = try_push( item );
+            end_push();
+            if( pushed )
+                break;
+
+            wait_for_room();
+        }
 
         // We pushed something -- let another know there's something to dequeue
-        _deq_cv.notify_one();
+        notify( _deq_cv, _deq_waiters );
 
         return true;
     }
@@ -91,21 +146,20 @@ public:
     // Return true if an item was removed -- otherwise, false
     bool dequeue( T * item, unsigned int timeout_ms )
     {
-        std::unique_lock<std::mutex> lock(_mutex);
-        if( ! _deq_cv.wait_for( lock,
-                                std::chrono::milliseconds( timeout_ms ),
-                                [this]() { return ! _accepting || ! _queue.empty(); } )
-            || _queue.empty() )
+        if( ! try_dequeue( item ) )
         {
-            return false;
+            auto ready = [this]() { return ! _accepting || front_ready(); };
+            {
+                std::unique_lock< std::mutex > lock( _mutex );
+                bool woken = false;
+                park( _deq_waiters, [&]() {
+                    woken = _deq_cv.wait_for( lock, std::chrono::milliseconds( timeout_ms ), ready );
+                } );
+                if( ! woken )
+                    return false;
+            }
+            return try_dequeue( item );
         }
-
-        *item = std::move(_queue.front());
-        _queue.pop_front();
-
-        // We've made room -- let whoever is waiting for room know about it
-        _enq_cv.notify_one();
-
         return true;
     }
 
@@ -113,60 +167,218 @@ public:
     // Return true if an item was removed -- otherwise, false
     bool try_dequeue(T* item)
     {
-        std::lock_guard< std::mutex > lock( _mutex );
-        if( _queue.empty() )
+        if( ! pop( [item]( T && t ) { *item = std::move( t ); } ) )
             return false;
 
-        *item = std::move(_queue.front());
-        _queue.pop_front();
-
         // We've made room -- let whoever is waiting for room know about it
-        _enq_cv.notify_one();
+        notify( _enq_cv, _enq_waiters );
 
         return true;
     }
 
+    // Points at the front item without removing it. The pointer is valid until the item is dequeued, or
+    // dropped by an enqueue to a full queue, so peeking must not race with either.
     bool peek(T** item)
     {
-        std::lock_guard< std::mutex > lock( _mutex );
+        if( ! _ring )
+        {
+            std::lock_guard< std::mutex > lock( _unbounded_mutex );
+            if( _unbounded.empty() )
+                return false;
+
+            *item = &_unbounded.front();
+            return true;
+        }
 
-        if (_queue.empty())
+        auto pos = _head.load( std::memory_order_relaxed );
+        auto & s = _slots[pos % _ring];
+        if( s.seq.load( std::memory_order_acquire ) != pos + 1 )
             return false;
 
-        *item = &_queue.front();
+        *item = s.item();
         return true;
     }
 
     void stop()
     {
-        std::lock_guard< std::mutex > lock( _mutex );
-
         // We no longer accept any more items!
         _accepting = false;
 
+        // Let producers that got in before that finish, so nothing is left behind after clearing.
+        // They only copy their item into a slot, and the last one out wakes us.
+        {
+            std::unique_lock< std::mutex > lock( _mutex );
+            _push_cv.wait( lock, [this]() { return ! _pushing.load(); } );
+        }
+
         _clear();
     }
 
     void clear()
     {
-        std::lock_guard< std::mutex > lock( _mutex );
         _clear();
     }
 
 protected:
     void _clear()
     {
-        _queue.clear();
+        while( pop( []( T && ) {} ) )
+            ;
 
         // Wake up anyone who is waiting for room to enqueue, or waiting for something to dequeue -- there's nothing now
+        std::lock_guard< std::mutex > lock( _mutex );
         _enq_cv.notify_all();
         _deq_cv.notify_all();
     }
 
+    bool begin_push()
+    {
+        _pushing.fetch_add( 1 );
+        if( _accepting.load() )
+            return true;
+        end_push();
+        return false;
+    }
+
+    void end_push()
+    {
+        if( _pushing.fetch_sub( 1 ) == 1 && ! _accepting.load() )
+        {
+            std::lock_guard< std::mutex > lock( _mutex );
+            _push_cv.notify_all();
+        }
+    }
+
+    // Claims the tail slot and moves the item into it; fails, leaving the item intact, when the ring is full
+    bool try_push( T & item )
+    {
+        if( ! _ring )
+        {
+            std::lock_guard< std::mutex > lock( _unbounded_mutex );
+            if( _unbounded.size() >= _cap )
+                return false;
+
+            _unbounded.push_back( std::move( item ) );
+            return true;
+        }
+
+        auto pos = _tail.load( std::memory_order_relaxed );
+        for( ;; )
+        {
+            // A queue of one item has a spare slot, so it is full before the ring is
+            if( _ring != _cap && intptr_t( pos ) - intptr_t( _head.load( std::memory_order_acquire ) ) >= intptr_t( _cap ) )
+                return false;
+
+            auto & s = _slots[pos % _ring];
+            auto diff = intptr_t( s.seq.load( std::memory_order_acquire ) ) - intptr_t( pos );
+            if( diff == 0 )
+            {
+                if( _tail.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+                {
+                    new( s.item() ) T( std::move( item ) );
+                    s.seq.store( pos + 1, std::memory_order_release );
+                    return true;
+                }
+            }
+            else if( diff < 0 )
+                return false;
+            else
+                pos = _tail.load( std::memory_order_relaxed );
+        }
+    }
+
+    // Claims the head slot and hands its item to 'consume', freeing the slot for the producer of the next round
+    template< class Consume >
+    bool pop( Consume consume )
+    {
+        if( ! _ring )
+        {
+            std::unique_lock< std::mutex > lock( _unbounded_mutex );
+            if( _unbounded.empty() )
+                return false;
+
+            T item( std::move( _unbounded.front() ) );
+            _unbounded.pop_front();
+            lock.unlock();
+            consume( std::move( item ) );
+            return true;
+        }
+
+        auto pos = _head.load( std::memory_order_relaxed );
+        for( ;; )
+        {
+            auto & s = _slots[pos % _ring];
+            auto diff = intptr_t( s.seq.load( std::memory_order_acquire ) ) - intptr_t( pos + 1 );
+            if( diff == 0 )
+            {
+                if( _head.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+                {
+                    consume( std::move( *s.item() ) );
+                    s.item()->~T();
+                    s.seq.store( pos + _ring, std::memory_order_release );
+                    return true;
+                }
+            }
+            else if( diff < 0 )
+                return false;
+            else
+                pos = _head.load( std::memory_order_relaxed );
+        }
+    }
+
+    // Waits until a producer that found the queue full may try again, or the queue is stopped
+    void wait_for_room()
+    {
+        auto has_room = [this]() { return ! _accepting || size() < _cap; };
+        std::unique_lock< std::mutex > lock( _mutex );
+        park( _enq_waiters, [&]() { _enq_cv.wait( lock, has_room ); } );
+    }
+
+    // Makes room for a producer that found the ring full
+    void drop_front()
+    {
+        pop( [this]( T && item ) {
+            if( _on_drop_callback )
+                _on_drop_callback( item );
+        } );
+    }
+
+    bool front_ready() const
+    {
+        if( ! _ring )
+        {
+            std::lock_guard< std::mutex > lock( _unbounded_mutex );
+            return ! _unbounded.empty();
+        }
+
+        auto pos = _head.load( std::memory_order_relaxed );
+        return _slots[pos % _ring].seq.load( std::memory_order_acquire ) == pos + 1;
+    }
+
+    // Registers the caller as a sleeper around the wait, so notify() knows to take the mutex.
+    // Together with the fence in notify(), either the waiter sees the new state or the notifier sees the waiter.
+    template< class Wait >
+    void park( std::atomic< int > & waiters, Wait wait )
+    {
+        waiters.fetch_add( 1 );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        wait();
+        waiters.fetch_sub( 1 );
+    }
+
+    void notify( std::condition_variable & cv, std::atomic< int > & waiters )
+    {
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if( waiters.load( std::memory_order_relaxed ) )
+        {
+            std::lock_guard< std::mutex > lock( _mutex );
+            cv.notify_one();
+        }
+    }
+
 public:
     void start()
     {
-        std::lock_guard< std::mutex > lock( _mutex );
         _accepting = true;
     }
 
@@ -175,8 +387,15 @@ public:
 
     size_t size() const
     {
-        std::lock_guard< std::mutex > lock( _mutex );
-        return _queue.size();
+        if( ! _ring )
+        {
+            std::lock_guard< std::mutex > lock( _unbounded_mutex );
+            return _unbounded.size();
+        }
+
+        auto head = _head.load();
+        auto tail = _tail.load();
+        return tail > head ? std::min< size_t >( tail - head, _cap ) : 0;
     }
 
     bool empty() const { return ! size(); }
@@ -468,3 +687,150 @@ private:
     std::function<void()> _operation;
     std::shared_ptr<active_object<>> _watcher;
 };
+
+// A fixed set of worker threads used to split data-parallel work (e.g. the rows of an image)
+// between cores. The calling thread takes part in the work, so a pool of N workers runs on up
+// to N+1 cores.
+// Each parallel_for queues a job of its own. Workers help with the jobs in the order they were
+// queued, while every caller runs the chunks of its own job no worker has claimed yet, so concurrent
+// (and nested) calls share the pool, and a caller only ever waits for chunks already running.
+class thread_pool
+{
+public:
+    explicit thread_pool(size_t num_workers)
+        : _stopping(false)
+    {
+        for (size_t i = 0; i < num_workers; ++i)
+            _workers.emplace_back([this]() { worker_loop(); });
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _work_cv.notify_all();
+        for (auto&& t : _workers)
+            t.join();
+    }
+
+    size_t get_num_workers() const { return _workers.size(); }
+
+    // Splits [0, count) into chunks of up to 'grain' items and invokes task(begin, end) for
+    // each of them. Returns when all the chunks are done; an exception thrown by a task is
+    // rethrown here.
+    void parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& task)
+    {
+        if (!count)
+            return;
+        grain = std::max<size_t>(grain, 1);
+
+        if (_workers.empty() || count <= grain)
+        {
+            task(0, count);
+            return;
+        }
+
+        job j(task, count, grain);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _jobs.push_back(&j);
+        }
+        _work_cv.notify_all();
+
+        run_chunks(j);
+
+        // Every chunk is claimed: no worker picks the job up anymore, so only the ones running its chunks are waited for
+        std::unique_lock<std::mutex> lock(_mutex);
+        retire(j);
+        _done_cv.wait(lock, [&]() { return j.workers == 0; });
+        if (j.error)
+            std::rethrow_exception(j.error);
+    }
+
+    // The pool shared by the processing blocks of the library, sized to the machine.
+    // It is never destroyed: joining its workers while the library is unloaded (e.g. from DllMain) could deadlock.
+    static thread_pool& shared()
+    {
+        static thread_pool* pool = new thread_pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+        return *pool;
+    }
+
+private:
+    // A parallel_for call; it lives on the caller's stack until the call returns
+    struct job
+    {
+        job(const std::function<void(size_t, size_t)>& task, size_t count, size_t grain)
+            : task(task), count(count), grain(grain), next(0) {}
+
+        const std::function<void(size_t, size_t)>& task;
+        const size_t count;
+        const size_t grain;
+        std::atomic<size_t> next;
+        size_t workers = 0;             // Workers that picked the job up, guarded by _mutex
+        std::exception_ptr error;       // The first exception thrown by a task, guarded by _mutex
+    };
+
+    void run_chunks(job& j)
+    {
+        for (;;)
+        {
+            auto begin = j.next.fetch_add(j.grain);
+            if (begin >= j.count)
+                break;
+            try
+            {
+                j.task(begin, std::min(begin + j.grain, j.count));
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!j.error)
+                    j.error = std::current_exception();
+            }
+        }
+    }
+
+    // Takes a job with no chunks left to claim off the queue; called with _mutex held
+    void retire(job& j)
+    {
+        auto it = std::find(_jobs.begin(), _jobs.end(), &j);
+        if (it != _jobs.end())
+            _jobs.erase(it);
+    }
+
+    void worker_loop()
+    {
+        for (;;)
+        {
+            job* j;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _work_cv.wait(lock, [&]() { return _stopping || !_jobs.empty(); });
+                if (_stopping)
+                    return;
+                j = _jobs.front();
+                ++j->workers;
+            }
+
+            run_chunks(*j);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            retire(*j);
+            if (--j->workers == 0)
+                _done_cv.notify_all();
+        }
+    }
+
+    std::vector<std::thread> _workers;
+
+    std::mutex _mutex;
+    std::condition_variable _work_cv;
+    std::condition_variable _done_cv;
+    std::deque<job*> _jobs;             // Jobs that may still have chunks to claim, in the order they were queued
+    bool _stopping;
+};
@@ -26,6 +26,12 @@ namespace librealsense
             rs2_stream stream_type;
             uint32_t stream_index;
         };
+        // How the frames of a stream are encoded in the file, on top of the file's own compression
+        enum class frame_codec
+        {
+            raw,
+            rvl     // Lossless depth codec, for 16 bit single channel images
+        };
         inline bool operator==(const stream_identifier& lhs, const stream_identifier& rhs)
         {
             return lhs.device_index == rhs.device_index &&
@@ -330,6 +336,7 @@ namespace librealsense
             virtual void write_snapshot(const sensor_identifier& sensor_id, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) = 0;
             virtual void write_notification(const sensor_identifier& stream_id, const nanoseconds& timestamp, const notification& n) = 0;
             virtual const std::string& get_file_name() const = 0;
+            virtual void set_frame_codec(rs2_stream stream, frame_codec codec) = 0;
             virtual ~writer() = default;
         };
 
@@ -346,6 +353,11 @@ namespace librealsense
             virtual void disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) = 0;
             virtual const std::string& get_file_name() const = 0;
             virtual std::vector<std::shared_ptr<serialized_data>> fetch_last_frames(const nanoseconds& seek_time) = 0;
+            virtual nanoseconds query_frame_time(rs2_stream stream, uint32_t stream_index, unsigned long long frame_number) = 0;
+            virtual void enable_index_cache(bool enable) = 0;
+            virtual void set_unlimited_frame_pool(bool unlimited) = 0;
+            // Frames read ahead of playback, held on top of those the application and sensors hold
+            virtual void set_read_ahead_frames(uint32_t frames) = 0;
         };
     }
 }
@@ -110,10 +110,14 @@ bool dispatcher::flush()
     if( _was_stopped )
         return true;  // Nothing to do - so success (no timeout)
 
+    // The marker has to wait for room: enqueueing it into a full queue would drop the oldest pending
+    // action, i.e. the very one we're waiting on
     utilities::time::waiting_on< bool > invoked( false );
-    invoke( [invoked = invoked.in_thread()]( cancellable_timer ) {
-        invoked.signal( true );
-    } );
+    invoke(
+        [invoked = invoked.in_thread()]( cancellable_timer ) {
+            invoked.signal( true );
+        },
+        true );
     invoked.wait_until( std::chrono::seconds( 10 ), [&]() {
         return invoked || _was_stopped;
     } );
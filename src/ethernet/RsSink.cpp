@@ -119,6 +119,11 @@ void RsSink::afterGettingFrame(unsigned t_frameSize, unsigned t_numTruncatedByte
                     memcpy(m_to + sizeof(RsNetworkHeader), m_receiveBuffer + sizeof(RsNetworkHeader), sizeof(RsMetadataHeader));
                     this->m_rtpCallback->on_frame((u_int8_t*)m_to + sizeof(RsNetworkHeader), decompressedSize + sizeof(RsMetadataHeader), t_presentationTime);
                 }
+                else
+                {
+                    m_memPool->returnMem(m_to);
+                }
+                m_to = nullptr;
                 m_memPool->returnMem(m_receiveBuffer);
             }
             else
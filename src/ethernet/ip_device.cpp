@@ -34,7 +34,11 @@ ip_device::~ip_device()
     
     try
     {
-        is_device_alive = false;
+        {
+            std::lock_guard<std::mutex> lock(device_state_mutex);
+            is_device_alive = false;
+        }
+        device_state_cv.notify_all();
 
         if (sw_device_status_check.joinable())
         {
@@ -59,7 +63,7 @@ void ip_device::stop_sensor_streams(int sensor_index)
     for(long long int key : remote_sensors[sensor_index]->active_streams_keys)
     {
         DBG << "Stopping stream [uid:key] " << streams_collection[key].get()->m_rs_stream.uid << ":" << key << "]";
-        streams_collection[key].get()->is_enabled = false;
+        streams_collection[key].get()->disable();
         if(inject_frames_thread[key].joinable())
             inject_frames_thread[key].join();
     }
@@ -265,7 +269,9 @@ void ip_device::polling_state_loop()
         {
             ERR << e.what();
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(POLLING_SW_DEVICE_STATE_INTERVAL));
+        // The software sensors have no state change events, so they are polled; the device destruction is signalled
+        std::unique_lock<std::mutex> lock(device_state_mutex);
+        device_state_cv.wait_for(lock, std::chrono::milliseconds(POLLING_SW_DEVICE_STATE_INTERVAL), [this]() { return !is_device_alive; });
     }
 }
 
@@ -338,6 +344,8 @@ void ip_device::update_sensor_state(int sensor_index, std::vector<rs2::stream_pr
         }
 
         rtp_callbacks[requested_stream_key] = new rs_rtp_callback(streams_collection[requested_stream_key]);
+        // Enabled before the thread starts, so that stopping right after starting cannot be missed
+        streams_collection[requested_stream_key].get()->enable();
         remote_sensors[sensor_index]->rtsp_client->addStream(streams_collection[requested_stream_key].get()->m_rs_stream, rtp_callbacks[requested_stream_key]);
         inject_frames_thread[requested_stream_key] = std::thread(&ip_device::inject_frames_loop, this, streams_collection[requested_stream_key]);
         remote_sensors[sensor_index]->active_streams_keys.push_front(requested_stream_key);
@@ -358,8 +366,6 @@ void ip_device::inject_frames_loop(std::shared_ptr<rs_rtp_stream> rtp_stream)
 {
     try
     {
-        rtp_stream.get()->is_enabled = true;
-
         rtp_stream.get()->frame_data_buff.frame_number = 0;
 
         rtp_stream->frame_data_buff.bpp = getStreamProfileBpp(rtp_stream.get()->get_stream_profile().format());
@@ -369,26 +375,25 @@ void ip_device::inject_frames_loop(std::shared_ptr<rs_rtp_stream> rtp_stream)
         rs2_stream type = rtp_stream.get()->m_rs_stream.type;
         int sensor_id = stream_type_to_sensor_id(type);
 
-        while(rtp_stream.get()->is_enabled == true)
+        // Sleeps until a frame arrives, or the stream is stopped
+        Raw_Frame frame;
+        while(rtp_stream.get()->wait_frame(frame))
         {
-            if(rtp_stream.get()->queue_size() != 0)
-            {
-                Raw_Frame* frame = rtp_stream.get()->extract_frame();
-                rtp_stream.get()->frame_data_buff.pixels = frame->m_buffer;
+            // The pixels buffer is handed over to the injected frame, which returns it to the pool when released
+            rtp_stream.get()->frame_data_buff.pixels = frame.m_buffer;
 
-                rtp_stream.get()->frame_data_buff.timestamp = frame->m_metadata->data.timestamp;
+            rtp_stream.get()->frame_data_buff.timestamp = frame.m_metadata->data.timestamp;
 
-                rtp_stream.get()->frame_data_buff.frame_number++;
-                rtp_stream.get()->frame_data_buff.domain = frame->m_metadata->data.timestampDomain;
+            rtp_stream.get()->frame_data_buff.frame_number++;
+            rtp_stream.get()->frame_data_buff.domain = frame.m_metadata->data.timestampDomain;
 
-                remote_sensors[sensor_id]->sw_sensor->set_metadata(RS2_FRAME_METADATA_FRAME_TIMESTAMP, rtp_stream.get()->frame_data_buff.timestamp);
-                remote_sensors[sensor_id]->sw_sensor->set_metadata(RS2_FRAME_METADATA_ACTUAL_FPS, frame->m_metadata->data.actualFps);
-                remote_sensors[sensor_id]->sw_sensor->set_metadata(RS2_FRAME_METADATA_FRAME_COUNTER, rtp_stream.get()->frame_data_buff.frame_number);
-                remote_sensors[sensor_id]->sw_sensor->set_metadata(RS2_FRAME_METADATA_FRAME_EMITTER_MODE, 1);
+            remote_sensors[sensor_id]->sw_sensor->set_metadata(RS2_FRAME_METADATA_FRAME_TIMESTAMP, rtp_stream.get()->frame_data_buff.timestamp);
+            remote_sensors[sensor_id]->sw_sensor->set_metadata(RS2_FRAME_METADATA_ACTUAL_FPS, frame.m_metadata->data.actualFps);
+            remote_sensors[sensor_id]->sw_sensor->set_metadata(RS2_FRAME_METADATA_FRAME_COUNTER, rtp_stream.get()->frame_data_buff.frame_number);
+            remote_sensors[sensor_id]->sw_sensor->set_metadata(RS2_FRAME_METADATA_FRAME_EMITTER_MODE, 1);
 
-                remote_sensors[sensor_id]->sw_sensor->set_metadata(RS2_FRAME_METADATA_TIME_OF_ARRIVAL, std::chrono::duration<double, std::milli>(std::chrono::system_clock::now().time_since_epoch()).count());
-                remote_sensors[sensor_id]->sw_sensor->on_video_frame(rtp_stream.get()->frame_data_buff);
-            }
+            remote_sensors[sensor_id]->sw_sensor->set_metadata(RS2_FRAME_METADATA_TIME_OF_ARRIVAL, std::chrono::duration<double, std::milli>(std::chrono::system_clock::now().time_since_epoch()).count());
+            remote_sensors[sensor_id]->sw_sensor->on_video_frame(rtp_stream.get()->frame_data_buff);
         }
 
         rtp_stream.get()->reset_queue();
@@ -12,7 +12,10 @@
 #include <librealsense2/hpp/rs_internal.hpp>
 #include <librealsense2/rs.hpp>
 
+#include <atomic>
+#include <condition_variable>
 #include <list>
+#include <mutex>
 
 #define MAX_ACTIVE_STREAMS 4
 
@@ -38,7 +41,11 @@ public:
     ip_sensor* remote_sensors[NUM_OF_SENSORS];
 
 private:
-    bool is_device_alive;
+    std::atomic<bool> is_device_alive;
+
+    // Signals the device destruction to the state polling thread
+    std::mutex device_state_mutex;
+    std::condition_variable device_state_cv;
 
     //TODO: get smart ptr
     MemoryPool* memory_pool;
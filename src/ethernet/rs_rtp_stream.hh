@@ -11,21 +11,27 @@
 
 #include <NetdevLog.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+
 const int RTP_QUEUE_MAX_SIZE = 30;
 
+// Describes a received frame. Frames are queued by value, so receiving a frame allocates nothing.
+// The buffer is not owned: it comes from the memory pool, and goes back to it when the
+// injected frame is released, or when the frame is dropped (see rs_rtp_stream::release_frame)
 struct Raw_Frame
 {
+    Raw_Frame()
+        : m_metadata(nullptr)
+        , m_buffer(nullptr)
+        , m_size(0)
+        , m_timestamp(){};
     Raw_Frame(char* buffer, int size, struct timeval timestamp)
         : m_metadata((RsMetadataHeader*)buffer)
         , m_buffer(buffer + sizeof(RsMetadataHeader))
         , m_size(size)
         , m_timestamp(timestamp){};
-    Raw_Frame(const Raw_Frame&);
-    Raw_Frame& operator=(const Raw_Frame&);
-    ~Raw_Frame()
-    {
-        delete[] m_buffer;
-    };
 
     RsMetadataHeader* m_metadata;
     char* m_buffer;
@@ -60,16 +66,26 @@ public:
         return m_rs_stream.type;
     }
 
-    void insert_frame(Raw_Frame* new_raw_frame)
+    void insert_frame(const Raw_Frame& new_raw_frame)
     {
-        if(queue_size() > RTP_QUEUE_MAX_SIZE)
+        bool queued = false;
         {
-            ERR << "Queue is full. Dropping frame for: " << this->m_rs_stream.uid;
+            std::lock_guard<std::mutex> lock(this->stream_lock);
+            if(m_is_enabled && frames_queue.size() <= RTP_QUEUE_MAX_SIZE)
+            {
+                frames_queue.push(new_raw_frame);
+                queued = true;
+            }
+        }
+
+        if(!queued)
+        {
+            ERR << "Queue is full or stream is stopped. Dropping frame for: " << this->m_rs_stream.uid;
+            release_frame(new_raw_frame);
         }
         else
         {
-            std::lock_guard<std::mutex> lock(this->stream_lock);
-            frames_queue.push(new_raw_frame);
+            stream_cv.notify_one();
         }
     }
 
@@ -77,20 +93,41 @@ public:
     // the key is generated by RsRTSPClient::getStreamProfileUniqueKey function
     std::map<long long int, rs2_extrinsics> extrinsics_map;
 
-    Raw_Frame* extract_frame()
+    // Blocks until a frame arrives, and returns it; returns false once the stream is disabled
+    bool wait_frame(Raw_Frame& frame)
     {
-        std::lock_guard<std::mutex> lock(this->stream_lock);
-        Raw_Frame* frame = frames_queue.front();
+        std::unique_lock<std::mutex> lock(this->stream_lock);
+        stream_cv.wait(lock, [this]() { return !m_is_enabled || !frames_queue.empty(); });
+        if(!m_is_enabled)
+            return false;
+
+        frame = frames_queue.front();
         frames_queue.pop();
-        return frame;
+        return true;
+    }
+
+    void enable()
+    {
+        std::lock_guard<std::mutex> lock(this->stream_lock);
+        m_is_enabled = true;
+    }
+
+    // Wakes up the thread waiting for frames, so that it stops
+    void disable()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->stream_lock);
+            m_is_enabled = false;
+        }
+        stream_cv.notify_all();
     }
 
     void reset_queue()
     {
+        std::lock_guard<std::mutex> lock(this->stream_lock);
         while(!frames_queue.empty())
         {
-            Raw_Frame* frame = frames_queue.front();
-            get_memory_pool().returnMem((unsigned char*)frame->m_buffer - sizeof(RsFrameHeader));
+            release_frame(frames_queue.front());
             frames_queue.pop();
         }
         INF << "Frames queue cleaned for " << m_rs_stream.uid;
@@ -102,14 +139,18 @@ public:
         return (int)frames_queue.size();
     }
 
+    // Drops a frame that was not injected, returning its buffer to the pool
+    static void release_frame(const Raw_Frame& frame)
+    {
+        get_memory_pool().returnMem((unsigned char*)frame.m_buffer - sizeof(RsFrameHeader));
+    }
+
     static MemoryPool& get_memory_pool()
     {
-        static MemoryPool memory_pool_instance = MemoryPool();
+        static MemoryPool memory_pool_instance;
         return memory_pool_instance;
     }
 
-    bool is_enabled;
-
     rs2_video_stream m_rs_stream;
 
     rs2_software_video_frame frame_data_buff;
@@ -124,7 +165,11 @@ private:
 
     std::mutex stream_lock;
 
-    std::queue<Raw_Frame*> frames_queue;
+    std::condition_variable stream_cv;
+
+    bool m_is_enabled = false;
+
+    std::queue<Raw_Frame> frames_queue;
 
     std::vector<uint8_t> pixels_buff;
 };
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "archive.h"
+#include "frame-buffer-pool.h"
 
 namespace librealsense
 {
@@ -16,11 +17,11 @@ namespace librealsense
         std::shared_ptr<metadata_parser_map> _metadata_parsers = nullptr;
         callbacks_heap callback_inflight;
 
-        std::vector<T> freelist; // return frames here
+        frame_buffer_pool buffer_pool; // return frame buffers here
         std::atomic<bool> recycle_frames;
         int pending_frames = 0;
-        std::recursive_mutex mutex;
         std::shared_ptr<platform::time_service> _time_service;
+        frame_buffer_allocator_ptr _allocator;
 
         std::weak_ptr<sensor_interface> _sensor;
         std::shared_ptr<sensor_interface> get_sensor() const override { return _sensor.lock(); }
@@ -29,35 +30,15 @@ namespace librealsense
         T alloc_frame(const size_t size, const frame_additional_data& additional_data, bool requires_memory)
         {
             T backbuffer;
-            //const size_t size = modes[stream].get_image_size(stream);
-            {
-                std::lock_guard<std::recursive_mutex> guard(mutex);
-
-                if (requires_memory)
-                {
-                    // Attempt to obtain a buffer of the appropriate size from the freelist
-                    for (auto it = begin(freelist); it != end(freelist); ++it)
-                    {
-                        if (it->data.size() == size)
-                        {
-                            backbuffer = std::move(*it);
-                            freelist.erase(it);
-                            break;
-                        }
-                    }
-                }
 
-                // Discard buffers that have been in the freelist for longer than 1s
-                for (auto it = begin(freelist); it != end(freelist);)
-                {
-                    if (additional_data.timestamp > it->additional_data.timestamp + 1000) it = freelist.erase(it);
-                    else ++it;
-                }
-            }
+            // Discard buffers that have been in the pool for longer than 1s
+            buffer_pool.trim_if_due(additional_data.timestamp);
 
             if (requires_memory)
             {
-                backbuffer.data.resize(size, 0); // TODO: Allow users to provide a custom allocator for frame buffers
+                if (_allocator)
+                    backbuffer.data = frame_buffer(frame_data_allocator<byte>(_allocator));
+                buffer_pool.acquire(size, backbuffer.data);
             }
             backbuffer.additional_data = additional_data;
             return backbuffer;
@@ -65,8 +46,6 @@ namespace librealsense
 
         frame_interface* track_frame(T& f)
         {
-            std::unique_lock<std::recursive_mutex> lock(mutex);
-
             auto published_frame = f.publish(this->shared_from_this());
             if (published_frame)
             {
@@ -84,15 +63,13 @@ namespace librealsense
             {
                 auto f = (T*)frame;
                 log_frame_callback_end(f);
-                std::unique_lock<std::recursive_mutex> lock(mutex);
 
                 frame->keep();
 
                 if (recycle_frames)
                 {
-                    freelist.push_back(std::move(*f));
+                    buffer_pool.release(std::move(f->data), f->additional_data.timestamp);
                 }
-                lock.unlock();
 
                 if (f->is_fixed())
                     published_frames.deallocate(f);
@@ -159,14 +136,18 @@ namespace librealsense
 
         std::shared_ptr<metadata_parser_map> get_md_parsers() const override { return _metadata_parsers; };
 
+        rs2_frame_pool_stats get_pool_stats() const override { return buffer_pool.get_stats(); }
+
         friend class frame;
 
     public:
         explicit frame_archive(std::atomic<uint32_t>* in_max_frame_queue_size,
             std::shared_ptr<platform::time_service> ts,
-            std::shared_ptr<metadata_parser_map> parsers)
+            std::shared_ptr<metadata_parser_map> parsers,
+            frame_buffer_allocator_ptr allocator = nullptr)
             : max_frame_queue_size(in_max_frame_queue_size),
-            recycle_frames(true), mutex(), _time_service(ts),
+            recycle_frames(true), _time_service(ts),
+            _allocator(std::move(allocator)),
             _metadata_parsers(parsers)
         {
             published_frames_count = 0;
@@ -202,10 +183,10 @@ namespace librealsense
             // wait until user is done with all the stuff he chose to borrow
             callback_inflight.wait_until_empty();
 
-            {
-                std::lock_guard<std::recursive_mutex> guard(mutex);
-                freelist.clear();
-            }
+            buffer_pool.close();
+
+            LOG_DEBUG("Published frames heap of 0x" << std::hex << this << std::dec << ": " << published_frames.get_exhausted_count()
+                << " allocations found it full, " << published_frames.get_contention_count() << " slot claims were contended");
 
             pending_frames = published_frames.get_size();
             if (pending_frames > 0)
@@ -0,0 +1,271 @@
+/* License: Apache 2.0. See LICENSE file in root directory. */
+/* Copyright(c) 2021 Intel Corporation. All Rights Reserved. */
+#pragma once
+
+#include "types.h"
+
+#include <atomic>
+#include <vector>
+
+namespace librealsense
+{
+    // Recycles the data buffers of released frames so that an archive can reuse them
+    // for new frames of the same size class.
+    // The pool never takes a lock: each bucket is a fixed array of slots, and every slot
+    // is guarded by its own atomic state. A thread that finds a slot busy moves on to the
+    // next one, so push/pop never wait. When no buffer is found a new one is allocated,
+    // and when a bucket is full the returned buffer is simply released.
+    // A bucket's size class and the count of its users (threads inside it and full slots)
+    // share one atomic word, so a bucket goes back to the unused state, free for another
+    // size class, only through a single compare-exchange once nobody uses it.
+    // Buffers that were not reused for a while are trimmed, at most once per trim period,
+    // by whichever thread happens to notice the period has elapsed.
+    class frame_buffer_pool
+    {
+    public:
+        typedef frame_buffer buffer_type;
+
+        static const size_t MAX_BUCKETS = 4;
+        static const size_t SLOTS_PER_BUCKET = 16;
+        static const size_t SIZE_CLASS_GRANULARITY = 4096;
+        static constexpr double TRIM_PERIOD_MS = 1000.;
+
+        frame_buffer_pool()
+            : _closed(false), _hits(0), _misses(0), _trimmed(0), _bytes_held(0), _last_trim(0)
+        {
+            for (auto&& b : _buckets)
+            {
+                b.state = 0;
+                for (auto&& s : b.slots)
+                    s.state = slot_empty;
+            }
+        }
+
+        frame_buffer_pool(const frame_buffer_pool&) = delete;
+        frame_buffer_pool& operator=(const frame_buffer_pool&) = delete;
+
+        static size_t get_size_class(size_t size)
+        {
+            return (size + SIZE_CLASS_GRANULARITY - 1) / SIZE_CLASS_GRANULARITY * SIZE_CLASS_GRANULARITY;
+        }
+
+        // Fills buf with a buffer of exactly size bytes.
+        // Returns true when the buffer was recycled, false when it had to be allocated.
+        // Newly allocated buffers reserve their full size class so that they can later
+        // serve any request in that class without reallocating.
+        bool acquire(size_t size, buffer_type& buf)
+        {
+            auto size_class = get_size_class(size);
+            if (size_class)
+            {
+                for (auto&& b : _buckets)
+                {
+                    if (!enter(b, size_class))
+                        continue;
+
+                    for (auto&& s : b.slots)
+                    {
+                        int expected = slot_full;
+                        if (!s.state.compare_exchange_strong(expected, slot_busy, std::memory_order_acquire))
+                            continue;
+
+                        buf = std::move(s.data);
+                        s.state.store(slot_empty, std::memory_order_release);
+                        _bytes_held -= buf.capacity();
+                        leave(b);   // for the slot
+                        leave(b);
+
+                        buf.resize(size);
+                        ++_hits;
+                        return true;
+                    }
+                    leave(b);
+                }
+            }
+
+            buf.clear();
+            buf.reserve(size_class);
+            buf.resize(size);
+            ++_misses;
+            return false;
+        }
+
+        // Hands a buffer back to the pool. timestamp is used to age out idle buffers.
+        // Once the pool is closed the buffer is released instead.
+        void release(buffer_type&& buf, rs2_time_t timestamp)
+        {
+            auto size_class = get_size_class(buf.capacity());
+            if (!size_class || _closed)
+                return;
+
+            auto b = enter_bucket(size_class);
+            if (!b)
+                return;
+
+            for (auto&& s : b->slots)
+            {
+                int expected = slot_empty;
+                if (!s.state.compare_exchange_strong(expected, slot_busy, std::memory_order_acquire))
+                    continue;
+
+                _bytes_held += buf.capacity();
+                s.data = std::move(buf);
+                s.timestamp = timestamp;
+                // The slot keeps the bucket's use
+                s.state.store(slot_full);
+
+                // close() may have passed this slot while it was busy: whichever of the two sees the
+                // other takes the buffer back out
+                if (_closed)
+                    free_slot(*b, s, [](slot&) { return true; });
+                return;
+            }
+            leave(*b);
+        }
+
+        // Cheap enough to call on every allocation: only one caller per trim period
+        // actually scans the pool.
+        void trim_if_due(rs2_time_t now)
+        {
+            auto last = _last_trim.load(std::memory_order_relaxed);
+            if (std::abs(now - last) < TRIM_PERIOD_MS)
+                return;
+            if (_last_trim.compare_exchange_strong(last, now))
+                trim(now);
+        }
+
+        // Discards buffers that have been sitting in the pool for longer than one trim period
+        void trim(rs2_time_t now)
+        {
+            for_each_full_slot([&](slot& s) {
+                return now > s.timestamp + TRIM_PERIOD_MS;
+            });
+        }
+
+        void clear()
+        {
+            for_each_full_slot([](slot&) { return true; });
+        }
+
+        // Releases all the buffers, and any buffer returned from now on
+        void close()
+        {
+            _closed = true;
+            clear();
+        }
+
+        rs2_frame_pool_stats get_stats() const
+        {
+            rs2_frame_pool_stats stats;
+            stats.hits = _hits;
+            stats.misses = _misses;
+            stats.trimmed = _trimmed;
+            stats.bytes_held = _bytes_held;
+            return stats;
+        }
+
+    private:
+        enum slot_state { slot_empty, slot_busy, slot_full };
+
+        struct slot
+        {
+            std::atomic<int> state;
+            buffer_type data;
+            rs2_time_t timestamp = 0;
+        };
+
+        // The size class, shifted past the users count kept in the low bits
+        static const int USERS_BITS = 16;
+        static const uint64_t USERS_MASK = (uint64_t(1) << USERS_BITS) - 1;
+
+        struct bucket
+        {
+            std::atomic<uint64_t> state;
+            slot slots[SLOTS_PER_BUCKET];
+        };
+
+        static uint64_t class_of(uint64_t state) { return state >> USERS_BITS; }
+
+        // Counts one more user of a bucket of the size class; false if the bucket holds another one
+        static bool enter(bucket& b, size_t size_class)
+        {
+            auto state = b.state.load(std::memory_order_relaxed);
+            do
+            {
+                if (class_of(state) != size_class)
+                    return false;
+            } while (!b.state.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed));
+            return true;
+        }
+
+        // The last user to leave returns the bucket to the unused state
+        static void leave(bucket& b)
+        {
+            auto state = b.state.fetch_sub(1, std::memory_order_release) - 1;
+            if ((state & USERS_MASK) == 0)
+                b.state.compare_exchange_strong(state, 0);
+        }
+
+        // Enters a bucket of the size class, claiming an unused one if there is none
+        bucket* enter_bucket(size_t size_class)
+        {
+            for (auto&& b : _buckets)
+            {
+                if (enter(b, size_class))
+                    return &b;
+            }
+            for (auto&& b : _buckets)
+            {
+                uint64_t expected = 0;
+                if (b.state.compare_exchange_strong(expected, (uint64_t(size_class) << USERS_BITS) + 1, std::memory_order_acquire))
+                    return &b;
+                if (enter(b, size_class))
+                    return &b;
+            }
+            return nullptr;
+        }
+
+        // Releases the buffer of a full slot if pred returns true for it
+        template<class Pred>
+        void free_slot(bucket& b, slot& s, Pred pred)
+        {
+            int expected = slot_full;
+            if (!s.state.compare_exchange_strong(expected, slot_busy, std::memory_order_acquire))
+                return;
+
+            if (!pred(s))
+            {
+                s.state.store(slot_full, std::memory_order_release);
+                return;
+            }
+            _bytes_held -= s.data.capacity();
+            buffer_type().swap(s.data);
+            ++_trimmed;
+            s.state.store(slot_empty, std::memory_order_release);
+            leave(b);
+        }
+
+        // Releases the buffers of all full slots for which pred returns true
+        template<class Pred>
+        void for_each_full_slot(Pred pred)
+        {
+            for (auto&& b : _buckets)
+            {
+                for (auto&& s : b.slots)
+                {
+                    // Sequentially consistent, against the store of a releasing thread that then reads _closed
+                    if (s.state.load() == slot_full)
+                        free_slot(b, s, pred);
+                }
+            }
+        }
+
+        std::atomic<bool> _closed;
+        bucket _buckets[MAX_BUCKETS];
+        std::atomic<unsigned long long> _hits;
+        std::atomic<unsigned long long> _misses;
+        std::atomic<unsigned long long> _trimmed;
+        std::atomic<unsigned long long> _bytes_held;
+        std::atomic<rs2_time_t> _last_trim;
+    };
+}
@@ -272,16 +272,24 @@ namespace librealsense
                         glGenTextures(1, &hist_texture);
                         glBindTexture(GL_TEXTURE_2D, hist_texture);
 
+                        // Between histogram updates the texture is uploaded from the last computed histogram
+                        auto update_histogram_now = histogram_update_due(f);
                         if (disparity)
                         {
-                            update_histogram(_hist_data, reinterpret_cast<const float*>(f.get_data()), _width, _height);
-                            populate_floating_histogram(_fhist_data, _hist_data);
+                            if (update_histogram_now)
+                            {
+                                update_histogram(_hist_data, reinterpret_cast<const float*>(f.get_data()), _width, _height);
+                                populate_floating_histogram(_fhist_data, _hist_data);
+                            }
                             glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, MAX_DISPARITY, 1, 0, GL_RED, GL_FLOAT, _fhist_data);
                         }
                         else
                         {
-                            update_histogram(_hist_data, reinterpret_cast<const uint16_t*>(f.get_data()), _width, _height);
-                            populate_floating_histogram(_fhist_data, _hist_data);
+                            if (update_histogram_now)
+                            {
+                                update_histogram(_hist_data, reinterpret_cast<const uint16_t*>(f.get_data()), _width, _height);
+                                populate_floating_histogram(_fhist_data, _hist_data);
+                            }
                             glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, 0xFF, 0xFF, 0, GL_RED, GL_FLOAT, _fhist_data);
                         }
 
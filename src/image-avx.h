@@ -7,6 +7,9 @@
 
 #include "types.h"
 
+// Runtime check for AVX2 support (defined in proc/color-formats-converter.cpp)
+bool has_avx();
+
 namespace librealsense
 {
 #ifndef ANDROID
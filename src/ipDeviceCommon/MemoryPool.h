@@ -7,92 +7,76 @@
 
 #include <iostream>
 #include <mutex>
-#include <queue>
+#include <vector>
 
 #include "NetdevLog.h"
 
-#define POOL_SIZE 100
+// Maximum number of free buffers kept for reuse; buffers returned beyond it are freed
+#define POOL_SIZE 16
 
+// Pool of frame buffers (header + largest frame). Buffers are allocated on demand, and kept for reuse
+// once returned, so that streaming at a steady rate stops allocating after the first few frames.
 class MemoryPool
 {
 
 public:
-    MemoryPool()
-    {
-        // //alloc memory
-        // std::unique_lock<std::mutex> lk(m_mutex);
-        // for(int i = 0; i < POOL_SIZE; i++)
-        // {
-        //     unsigned char *mem = new unsigned char[sizeof(RsFrameHeader) + MAX_FRAME_SIZE]; //TODO:to use OutPacketBuffer::maxSize;
-        //     m_pool.push(mem);
-        // }
-        // lk.unlock();
-    }
+    MemoryPool() : m_allocated(0) {}
 
-    MemoryPool(const MemoryPool& obj)
-    {
-        m_pool = obj.m_pool;
-    }
-
-    MemoryPool& operator=(const MemoryPool&& obj)
-    {
-        m_pool = obj.m_pool;
-        return *this;
-    }
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
 
     unsigned char* getNextMem()
     {
-        // unsigned char* mem = nullptr;
-        // std::unique_lock<std::mutex> lk(m_mutex);
-        // if(!m_pool.empty())
-        // {
-        //     mem = m_pool.front();
-        //     m_pool.pop();
-        // }
-        // else
-        // {
-        //     ERR << "getNextMem: pool is empty";
-        // }
-        // lk.unlock();
-        // return mem;
-        return new unsigned char[sizeof(RsFrameHeader) + MAX_FRAME_SIZE]; 
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            if(!m_pool.empty())
+            {
+                unsigned char* mem = m_pool.back();
+                m_pool.pop_back();
+                return mem;
+            }
+            m_allocated++;
+        }
+        return new unsigned char[sizeof(RsFrameHeader) + MAX_FRAME_SIZE]; //TODO:to use OutPacketBuffer::maxSize;
     }
 
     void returnMem(unsigned char* t_mem)
     {
-        // if(t_mem != nullptr)
-        // {
-        //     std::unique_lock<std::mutex> lk(m_mutex);
-        //     m_pool.push(t_mem);
-        //     lk.unlock();
-        // }
-        // else
-        // {
-        //     ERR << "returnMem: invalid address";
-        // }
+        if(t_mem == nullptr)
+        {
+            ERR << "returnMem: invalid address";
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            if(m_pool.size() < POOL_SIZE)
+            {
+                m_pool.push_back(t_mem);
+                return;
+            }
+            m_allocated--;
+        }
         delete[] t_mem;
     }
 
+    // Number of buffers allocated by the pool and not freed yet, in use or free
+    size_t getAllocatedCount()
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        return m_allocated;
+    }
+
     ~MemoryPool()
     {
-        // std::unique_lock<std::mutex> lk(m_mutex);
-        // while(!m_pool.empty())
-        // {
-        //     unsigned char* mem = m_pool.front();
-        //     m_pool.pop();
-        //     if(mem != nullptr)
-        //     {
-        //         delete mem;
-        //     }
-        //     else
-        //     {
-        //         ERR << "~memory_pool: invalid address";
-        //     }
-        // }
-        // lk.unlock();
+        for(unsigned char* mem : m_pool)
+        {
+            delete[] mem;
+        }
     }
 
 private:
-    std::queue<unsigned char*> m_pool;
+    std::vector<unsigned char*> m_pool;
+    size_t m_allocated;
     std::mutex m_mutex;
 };
@@ -683,7 +683,8 @@ namespace librealsense
               _use_memory_map(use_memory_map),
               _fd(-1),
               _stop_pipe_fd{},
-              _buf_dispatch(use_memory_map)
+              _buf_dispatch(use_memory_map),
+              _retained_buffers(std::make_shared<retained_buffers>())
         {
             foreach_uvc_device([&info, this](const uvc_device_info& i, const std::string& name)
             {
@@ -844,11 +845,28 @@ namespace librealsense
 
             if (_callback)
             {
+                // Frames wrapping video buffers keep them mapped; give their owners a chance to release them
+                auto still_retained = _retained_buffers->wait_for_all(std::chrono::seconds(1));
+                if (still_retained)
+                    LOG_WARNING(still_retained << " video buffers of " << _name << " are still held by frames while closing");
+
                 // Release allocated buffers
                 allocate_io_buffers(0);
 
                 // Release IO
-                negotiate_kernel_buffers(0);
+                try
+                {
+                    negotiate_kernel_buffers(0);
+                }
+                catch (const std::exception& ex)
+                {
+                    // The kernel refuses to free buffers that are still mapped by retained frames.
+                    // They are unmapped once the last frame referencing them is released.
+                    if (!still_retained)
+                        throw;
+                    LOG_ERROR("Kernel buffers of " << _name << " were not released, " << still_retained
+                        << " are mapped by frames: " << ex.what());
+                }
 
                 _callback = nullptr;
             }
@@ -1093,9 +1111,15 @@ namespace librealsense
 
                                     if (buf_mgr.verify_vd_md_sync())
                                     {
+                                        // Consumers may hold on to the buffer until the continuation is invoked.
+                                        // At most half of the kernel queue is lent out so that streaming never starves.
+                                        auto retained = _retained_buffers;
+                                        fo.retainable = retained->lend(_buffers.size());
+
                                         //Invoke user callback and enqueue next frame
-                                        _callback(_profile, fo, [buf_mgr]() mutable {
+                                        _callback(_profile, fo, [buf_mgr, retained]() mutable {
                                             buf_mgr.request_next_frame();
+                                            retained->give_back();
                                         });
                                     }
                                     else
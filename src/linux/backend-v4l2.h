@@ -23,6 +23,8 @@
 #include <chrono>
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 #include <dirent.h>
 #include <fcntl.h>
@@ -151,6 +153,40 @@ namespace librealsense
             bool _must_enqueue = false;
         };
 
+        // Counts the video buffers lent out to frame callbacks. Consumers of a retainable frame keep its buffer
+        // until the frame continuation gives it back, possibly after the device was closed.
+        class retained_buffers
+        {
+        public:
+            // Lends a buffer of a kernel queue of queue_size buffers out. Returns whether the consumer may retain it:
+            // at most half of the queue is retained at a time, so that streaming never starves.
+            bool lend(size_t queue_size)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return ++_lent <= static_cast<int>(queue_size / 2);
+            }
+
+            void give_back()
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (--_lent == 0)
+                    _all_returned.notify_all();
+            }
+
+            // Waits up to the timeout for all the lent buffers to be given back; returns how many are still out
+            int wait_for_all(std::chrono::milliseconds timeout)
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _all_returned.wait_for(lock, timeout, [this]() { return _lent == 0; });
+                return _lent;
+            }
+
+        private:
+            std::mutex _mutex;
+            std::condition_variable _all_returned;
+            int _lent = 0;
+        };
+
         enum supported_kernel_buf_types : uint8_t
         {
             e_video_buf,
@@ -338,6 +374,7 @@ namespace librealsense
             int _max_fd = 0;                    // specifies the maximal pipe number the polling process will monitor
             std::vector<int>  _fds;             // list the file descriptors to be monitored during frames polling
             buffers_mgr     _buf_dispatch;      // Holder for partial (MD only) frames that shall be preserved between 'select' calls when polling v4l buffers
+            std::shared_ptr<retained_buffers> _retained_buffers;    // Video buffers currently handed out to frame callbacks
 
         private:
             int _fd = 0;          // prevent unintentional abuse in derived class
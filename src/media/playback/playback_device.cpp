@@ -23,6 +23,7 @@ playback_device::playback_device(std::shared_ptr<context> ctx, std::shared_ptr<d
     m_is_paused(false),
     m_sample_rate(1),
     m_real_time(true),
+    m_batch_mode(false),
     m_prev_timestamp(0),
     m_last_published_timestamp(0)
 {
@@ -31,7 +32,9 @@ playback_device::playback_device(std::shared_ptr<context> ctx, std::shared_ptr<d
         throw invalid_value_exception("null serializer");
     }
 
-    m_reader = serializer;
+    //Messages are read ahead of playback, so reading and decompressing overlap with pacing and dispatching
+    m_prefetcher = std::make_shared<prefetch_reader>(serializer, prefetch_reader::default_memory_budget);
+    m_reader = m_prefetcher;
     (*m_read_thread)->start();
 
     //Read header and build device from recorded device snapshot
@@ -292,6 +295,58 @@ void playback_device::seek_to_time(std::chrono::nanoseconds time)
     }
 }
 
+void playback_device::seek_to_frame(rs2_stream stream, uint32_t stream_index, unsigned long long frame_number)
+{
+    LOG_INFO("Request to seek to frame " << frame_number << " of " << stream << " " << stream_index);
+    //The reader is only used from the read thread, so the frame is looked up there
+    device_serializer::nanoseconds time(0);
+    std::exception_ptr error;
+    (*m_read_thread)->invoke([&](dispatcher::cancellable_timer t)
+    {
+        try
+        {
+            time = m_reader->query_frame_time(stream, stream_index, frame_number);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+    });
+    if ((*m_read_thread)->flush() == false)
+    {
+        LOG_ERROR("Error - timeout waiting for seek_to_frame, possible deadlock detected");
+        assert(0); //Detect this immediately in debug
+    }
+    if (error)
+        std::rethrow_exception(error);
+
+    seek_to_time(time);
+}
+
+void playback_device::set_index_cache(bool enable)
+{
+    (*m_read_thread)->invoke([this, enable](dispatcher::cancellable_timer t)
+    {
+        m_reader->enable_index_cache(enable);
+    });
+    if ((*m_read_thread)->flush() == false)
+    {
+        LOG_ERROR("Error - timeout waiting for set_index_cache, possible deadlock detected");
+        assert(0); //Detect this immediately in debug
+    }
+}
+
+void playback_device::set_prefetch_budget(size_t bytes)
+{
+    LOG_INFO("Set prefetch budget to " << bytes << " bytes");
+    m_prefetcher->set_memory_budget(bytes);
+}
+
+size_t playback_device::get_prefetch_budget() const
+{
+    return m_prefetcher->get_memory_budget();
+}
+
 rs2_playback_status playback_device::get_current_status() const
 {
     return m_is_started ?
@@ -321,6 +376,7 @@ void playback_device::pause()
             return;
 
         m_is_paused = true;
+        m_throughput.stop();
 
         if(m_is_started)
         {
@@ -358,6 +414,7 @@ void playback_device::resume()
         while (m_last_published_timestamp != device_serializer::nanoseconds(0) && !m_reader->read_next_data()->is<serialized_frame>());
 
         m_is_paused = false;
+        m_throughput.start();
         catch_up();
 
         try_looping();
@@ -373,6 +430,10 @@ void playback_device::resume()
 void playback_device::set_real_time(bool real_time)
 {
     LOG_INFO("Set real time to " << ((real_time) ? "True" : "False"));
+    if (real_time && m_batch_mode)
+    {
+        set_batch_mode(false);
+    }
     m_real_time = real_time;
 }
 
@@ -381,6 +442,85 @@ bool playback_device::is_real_time() const
     return m_real_time;
 }
 
+void playback_device::set_batch_mode(bool batch)
+{
+    LOG_INFO("Set batch mode to " << ((batch) ? "True" : "False"));
+    (*m_read_thread)->invoke([this, batch](dispatcher::cancellable_timer t)
+    {
+        //Batch mode plays as fast as the application consumes: frames are not paced, every queue on the way blocks
+        // instead of dropping (non real time), and frames are allocated even when the application holds many of them
+        m_batch_mode = batch;
+        if (batch)
+        {
+            m_real_time = false;
+        }
+        m_reader->set_unlimited_frame_pool(batch);
+    });
+    if ((*m_read_thread)->flush() == false)
+    {
+        LOG_ERROR("Error - timeout waiting for set_batch_mode, possible deadlock detected");
+        assert(0); //Detect this immediately in debug
+    }
+}
+
+bool playback_device::is_batch_mode() const
+{
+    return m_batch_mode;
+}
+
+void playback_device::get_throughput(double& frames_per_second, double& megabytes_per_second) const
+{
+    m_throughput.get(frames_per_second, megabytes_per_second);
+}
+
+void playback_throughput::reset()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _frames = 0;
+    _bytes = 0;
+    _played = std::chrono::high_resolution_clock::duration(0);
+    _started = std::chrono::high_resolution_clock::now();
+}
+
+void playback_throughput::start()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_running)
+    {
+        _started = std::chrono::high_resolution_clock::now();
+        _running = true;
+    }
+}
+
+void playback_throughput::stop()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_running)
+    {
+        _played += std::chrono::high_resolution_clock::now() - _started;
+        _running = false;
+    }
+}
+
+void playback_throughput::add_frame(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_frames;
+    _bytes += bytes;
+}
+
+void playback_throughput::get(double& frames_per_second, double& megabytes_per_second) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto played = _played;
+    if (_running)
+        played += std::chrono::high_resolution_clock::now() - _started;
+
+    auto seconds = std::chrono::duration<double>(played).count();
+    frames_per_second = seconds > 0 ? _frames / seconds : 0;
+    megabytes_per_second = seconds > 0 ? _bytes / seconds / (1024 * 1024) : 0;
+}
+
 platform::backend_device_group playback_device::get_device_data() const
 {
     return platform::backend_device_group({ platform::playback_device_info{ m_reader->get_file_name() } });
@@ -451,6 +591,11 @@ void playback_device::start()
         return; //nothing to do
 
     m_is_started = true;
+    m_throughput.reset();
+    if (!m_is_paused)
+    {
+        m_throughput.start();
+    }
     catch_up();
     try_looping();
     LOG_INFO("Playback started");
@@ -482,6 +627,10 @@ void playback_device::stop_internal()
 
     m_is_started = false;
     m_is_paused = false;
+    m_throughput.stop();
+    double fps, mbps;
+    m_throughput.get(fps, mbps);
+    LOG_INFO("Playback throughput: " << fps << " frames/sec, " << mbps << " MB/sec");
     for (auto sensor : m_sensors)
     {
         //sensor.second->flush_pending_frames();
@@ -636,6 +785,8 @@ void playback_device::try_looping()
                 }
 
 
+                m_throughput.add_frame(frame->frame->get_frame_data_size());
+
                 // Dispatch frame to the relevant sensor (see handle_frame definition for more
                 // details)
                 it->second->handle_frame(
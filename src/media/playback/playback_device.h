@@ -11,9 +11,29 @@
 #include "../../concurrency.h"
 #include "../../sensor.h"
 #include "playback_sensor.h"
+#include "prefetch_reader.h"
 
 namespace librealsense
 {
+    // Counts the frames and bytes dispatched while playing (not while paused or stopped)
+    class playback_throughput
+    {
+    public:
+        void reset();
+        void start();
+        void stop();
+        void add_frame(size_t bytes);
+        void get(double& frames_per_second, double& megabytes_per_second) const;
+
+    private:
+        mutable std::mutex _mutex;
+        uint64_t _frames = 0;
+        uint64_t _bytes = 0;
+        std::chrono::high_resolution_clock::duration _played{ 0 };
+        std::chrono::high_resolution_clock::time_point _started;
+        bool _running = false;
+    };
+
     class playback_device : public device_interface,
         public extendable_interface,
         public info_container
@@ -33,6 +53,10 @@ namespace librealsense
 
         void set_frame_rate(double rate);
         void seek_to_time(std::chrono::nanoseconds time);
+        void seek_to_frame(rs2_stream stream, uint32_t stream_index, unsigned long long frame_number);
+        void set_index_cache(bool enable);
+        void set_prefetch_budget(size_t bytes);
+        size_t get_prefetch_budget() const;
         rs2_playback_status get_current_status() const;
         uint64_t get_duration() const;
         void pause();
@@ -40,6 +64,9 @@ namespace librealsense
         void stop();
         void set_real_time(bool real_time);
         bool is_real_time() const;
+        void set_batch_mode(bool batch);
+        bool is_batch_mode() const;
+        void get_throughput(double& frames_per_second, double& megabytes_per_second) const;
         const std::string& get_file_name() const;
         uint64_t get_position() const;
         signal<playback_device, rs2_playback_status> playback_status_changed;
@@ -77,6 +104,7 @@ namespace librealsense
     private:
         lazy<std::shared_ptr<dispatcher>> m_read_thread;
         std::shared_ptr<context> m_context;
+        std::shared_ptr<prefetch_reader> m_prefetcher;
         std::shared_ptr<device_serializer::reader> m_reader;
         device_serializer::device_snapshot m_device_description;
         std::atomic_bool m_is_started;
@@ -87,6 +115,8 @@ namespace librealsense
         std::map<uint32_t, std::shared_ptr<playback_sensor>> m_active_sensors;
         std::atomic<double> m_sample_rate;
         std::atomic_bool m_real_time;
+        std::atomic_bool m_batch_mode;
+        playback_throughput m_throughput;
         device_serializer::nanoseconds m_prev_timestamp;
         std::vector<std::shared_ptr<lazy<rs2_extrinsics>>> m_extrinsics_fetchers;
         std::map<int, std::pair<uint32_t, rs2_extrinsics>> m_extrinsics_map;
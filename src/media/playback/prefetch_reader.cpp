@@ -0,0 +1,251 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "prefetch_reader.h"
+#include "../../types.h"
+
+namespace librealsense
+{
+    using namespace device_serializer;
+
+    prefetch_reader::prefetch_reader(std::shared_ptr<reader> reader, size_t memory_budget)
+        : _reader(reader),
+        _queued_bytes(0),
+        _queued_frames(0),
+        _memory_budget(memory_budget),
+        _reading(false),
+        _suspended(false),
+        _end_of_file(false),
+        _exit(false)
+    {
+        if (_reader == nullptr)
+        {
+            throw invalid_value_exception("null reader");
+        }
+        _reader->set_read_ahead_frames(_memory_budget ? max_prefetched_frames : 0);
+        _thread = std::thread([this]() { prefetch(); });
+    }
+
+    prefetch_reader::~prefetch_reader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _exit = true;
+        }
+        _cv.notify_all();
+        _thread.join();
+    }
+
+    bool prefetch_reader::is_full() const
+    {
+        return _memory_budget == 0 || _queued_bytes >= _memory_budget || _queued_frames >= max_prefetched_frames;
+    }
+
+    void prefetch_reader::prefetch()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            _cv.wait(lock, [this]() { return _exit || (!_suspended && !_reading && !_end_of_file && !is_full()); });
+            if (_exit)
+                return;
+
+            _reading = true;
+            lock.unlock();
+
+            std::shared_ptr<serialized_data> data;
+            std::exception_ptr error;
+            try
+            {
+                data = _reader->read_next_data();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            lock.lock();
+            _reading = false;
+            if (error)
+            {
+                // Reported by the read that reaches it, after the data read before it
+                _error = error;
+                _end_of_file = true;
+            }
+            else
+            {
+                size_t bytes = 0;
+                if (auto frame = data->as<serialized_frame>())
+                {
+                    bytes = frame->frame ? frame->frame->get_frame_data_size() : 0;
+                    ++_queued_frames;
+                }
+                _queued_bytes += bytes;
+                _end_of_file = data->is<serialized_end_of_file>();
+                _queue.emplace_back(std::move(data), bytes);
+            }
+            _cv.notify_all();
+        }
+    }
+
+    std::shared_ptr<serialized_data> prefetch_reader::read_next_data()
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [this]() { return !_queue.empty() || _end_of_file || (is_full() && !_reading); });
+
+            if (!_queue.empty())
+            {
+                auto data = std::move(_queue.front().first);
+                _queued_bytes -= _queue.front().second;
+                if (data->is<serialized_frame>())
+                    --_queued_frames;
+                _queue.pop_front();
+                _cv.notify_all();
+                return data;
+            }
+            if (_error)
+            {
+                auto error = _error;
+                _error = nullptr;
+                std::rethrow_exception(error);
+            }
+            if (_end_of_file)
+            {
+                return std::make_shared<serialized_end_of_file>();
+            }
+
+            // Read-ahead is disabled, and the prefetch thread is idle. The budget may be raised while
+            // reading here, so the prefetch thread is kept waiting until this read is done.
+            _reading = true;
+        }
+
+        std::shared_ptr<serialized_data> data;
+        try
+        {
+            data = _reader->read_next_data();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _reading = false;
+            _cv.notify_all();
+            throw;
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _reading = false;
+        }
+        _cv.notify_all();
+        return data;
+    }
+
+    template<class T>
+    auto prefetch_reader::suspended(bool discard, T action) -> decltype(action())
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _suspended = true;
+            _cv.wait(lock, [this]() { return !_reading; });
+            if (discard)
+            {
+                _queue.clear();
+                _queued_bytes = 0;
+                _queued_frames = 0;
+                _end_of_file = false;
+                _error = nullptr;
+            }
+        }
+
+        struct resume_on_exit
+        {
+            prefetch_reader* owner;
+            ~resume_on_exit()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(owner->_mutex);
+                    owner->_suspended = false;
+                }
+                owner->_cv.notify_all();
+            }
+        } resume{ this };
+
+        return action();
+    }
+
+    device_snapshot prefetch_reader::query_device_description(const nanoseconds& time)
+    {
+        return suspended(false, [&]() { return _reader->query_device_description(time); });
+    }
+
+    void prefetch_reader::seek_to_time(const nanoseconds& time)
+    {
+        suspended(true, [&]() { _reader->seek_to_time(time); });
+    }
+
+    nanoseconds prefetch_reader::query_duration() const
+    {
+        return _reader->query_duration();
+    }
+
+    void prefetch_reader::reset()
+    {
+        suspended(true, [&]() { _reader->reset(); });
+    }
+
+    void prefetch_reader::enable_stream(const std::vector<stream_identifier>& stream_ids)
+    {
+        suspended(true, [&]() { _reader->enable_stream(stream_ids); });
+    }
+
+    void prefetch_reader::disable_stream(const std::vector<stream_identifier>& stream_ids)
+    {
+        suspended(true, [&]() { _reader->disable_stream(stream_ids); });
+    }
+
+    const std::string& prefetch_reader::get_file_name() const
+    {
+        return _reader->get_file_name();
+    }
+
+    std::vector<std::shared_ptr<serialized_data>> prefetch_reader::fetch_last_frames(const nanoseconds& seek_time)
+    {
+        return suspended(false, [&]() { return _reader->fetch_last_frames(seek_time); });
+    }
+
+    nanoseconds prefetch_reader::query_frame_time(rs2_stream stream, uint32_t stream_index, unsigned long long frame_number)
+    {
+        return suspended(false, [&]() { return _reader->query_frame_time(stream, stream_index, frame_number); });
+    }
+
+    void prefetch_reader::enable_index_cache(bool enable)
+    {
+        suspended(false, [&]() { _reader->enable_index_cache(enable); });
+    }
+
+    void prefetch_reader::set_unlimited_frame_pool(bool unlimited)
+    {
+        suspended(false, [&]() { _reader->set_unlimited_frame_pool(unlimited); });
+    }
+
+    void prefetch_reader::set_read_ahead_frames(uint32_t frames)
+    {
+        suspended(false, [&]() { _reader->set_read_ahead_frames(frames); });
+    }
+
+    void prefetch_reader::set_memory_budget(size_t memory_budget)
+    {
+        set_read_ahead_frames(memory_budget ? max_prefetched_frames : 0);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _memory_budget = memory_budget;
+        }
+        _cv.notify_all();
+    }
+
+    size_t prefetch_reader::get_memory_budget() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _memory_budget;
+    }
+}
@@ -0,0 +1,72 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../../core/serialization.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace librealsense
+{
+    // Reads the next messages of a reader ahead of playback, on a thread of its own, so that reading,
+    // decompressing and building frames overlaps with pacing and dispatching them on the playback thread.
+    // Read-ahead is bounded by a memory budget (frame data bytes) and by a number of frames, which the
+    // reader's frame pool is grown by, so that the frames read ahead do not take from the frames the
+    // application and sensors may hold. A budget of 0 reads synchronously, like the wrapped reader.
+    // Calls that move the read position (seek, reset, enabling or disabling streams) discard what was
+    // read ahead; other calls that use the file only wait for the read in progress.
+    // All calls are expected from a single thread (the playback read thread).
+    class prefetch_reader : public device_serializer::reader
+    {
+    public:
+        prefetch_reader(std::shared_ptr<device_serializer::reader> reader, size_t memory_budget);
+        ~prefetch_reader();
+
+        device_serializer::device_snapshot query_device_description(const device_serializer::nanoseconds& time) override;
+        std::shared_ptr<device_serializer::serialized_data> read_next_data() override;
+        void seek_to_time(const device_serializer::nanoseconds& time) override;
+        device_serializer::nanoseconds query_duration() const override;
+        void reset() override;
+        void enable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        void disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        const std::string& get_file_name() const override;
+        std::vector<std::shared_ptr<device_serializer::serialized_data>> fetch_last_frames(const device_serializer::nanoseconds& seek_time) override;
+        device_serializer::nanoseconds query_frame_time(rs2_stream stream, uint32_t stream_index, unsigned long long frame_number) override;
+        void enable_index_cache(bool enable) override;
+        void set_unlimited_frame_pool(bool unlimited) override;
+        void set_read_ahead_frames(uint32_t frames) override;
+
+        void set_memory_budget(size_t memory_budget);
+        size_t get_memory_budget() const;
+
+        static const size_t default_memory_budget = 64 * 1024 * 1024;
+        static const size_t max_prefetched_frames = 16;
+
+    private:
+        // Runs action while the prefetch thread is idle, optionally dropping what it read ahead
+        template<class T>
+        auto suspended(bool discard, T action) -> decltype(action());
+
+        void prefetch();
+        bool is_full() const;
+
+        std::shared_ptr<device_serializer::reader> _reader;
+        mutable std::mutex _mutex;
+        std::condition_variable _cv;
+        std::deque<std::pair<std::shared_ptr<device_serializer::serialized_data>, size_t>> _queue;
+        size_t _queued_bytes;
+        size_t _queued_frames;
+        size_t _memory_budget;
+        bool _reading;
+        bool _suspended;
+        bool _end_of_file;
+        bool _exit;
+        std::exception_ptr _error;
+        std::thread _thread;
+    };
+}
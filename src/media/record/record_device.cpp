@@ -13,7 +13,11 @@ librealsense::record_device::record_device(std::shared_ptr<librealsense::device_
                                       std::shared_ptr<librealsense::device_serializer::writer> serializer):
     m_write_thread([](){return std::make_shared<dispatcher>(std::numeric_limits<unsigned int>::max());}),
     m_is_recording(true),
-    m_record_pause_time(0)
+    m_record_pause_time(0),
+    m_cached_data_size(0),
+    m_max_cached_data_size(MAX_CACHED_DATA_SIZE),
+    m_dropped_frames(0),
+    m_written_bytes(0)
 {
     if (device == nullptr)
     {
@@ -126,21 +130,32 @@ void librealsense::record_device::write_data(size_t sensor_index, librealsense::
         initialize_recording();
     });
 
-    //TODO: restore: uint64_t data_size = frame.frame->get_frame_data_size();
-    uint64_t cached_data_size = m_cached_data_size; //TODO: restore: (+ data_size)
-    if (cached_data_size > MAX_CACHED_DATA_SIZE)
+    // Frames wait for the write thread in memory, so beyond the cap they are dropped rather than queued.
+    // A drop loses only that frame; the sensor keeps recording once the writer catches up.
+    uint64_t data_size = frame ? frame.frame->get_frame_data_size() : 0;
+    auto cached_data_size = m_cached_data_size.fetch_add(data_size) + data_size;
+    if (cached_data_size > m_max_cached_data_size)
     {
-        LOG_WARNING("Recorder reached maximum cache size, frame dropped");
-        on_error("Recorder reached maximum cache size, frame dropped");
+        m_cached_data_size -= data_size;
+        if (m_dropped_frames++ == 0)
+            LOG_WARNING("Recorder reached maximum cache size, frame dropped");
+        else
+            LOG_DEBUG("Recorder reached maximum cache size, frame dropped");
         return;
     }
 
-    m_cached_data_size = cached_data_size;
     auto capture_time = get_capture_time();
     //TODO: remove usage of shared pointer when frame_holder is copyable
     auto frame_holder_ptr = std::make_shared<frame_holder>();
     *frame_holder_ptr = std::move(frame);
-    (*m_write_thread)->invoke([this, frame_holder_ptr, sensor_index, capture_time/*, data_size*/, on_error](dispatcher::cancellable_timer t) {
+    (*m_write_thread)->invoke([this, frame_holder_ptr, sensor_index, capture_time, data_size, on_error](dispatcher::cancellable_timer t) {
+        struct release_on_exit
+        {
+            std::atomic<uint64_t>& cached;
+            uint64_t size;
+            ~release_on_exit() { cached -= size; }
+        } release{ m_cached_data_size, data_size };
+
         if (m_is_recording == false)
         {
             return; //Recording is paused
@@ -164,7 +179,7 @@ void librealsense::record_device::write_data(size_t sensor_index, librealsense::
             auto stream_type = frame_holder_ptr->frame->get_stream()->get_stream_type();
             auto stream_index = static_cast<uint32_t>(frame_holder_ptr->frame->get_stream()->get_stream_index());
             m_ros_writer->write_frame({ device_index, static_cast<uint32_t>(sensor_index), stream_type, stream_index }, capture_time, std::move(*frame_holder_ptr));
-            //TODO: restore: std::lock_guard<std::mutex> locker(m_mutex);  m_cached_data_size -= data_size;
+            m_written_bytes += data_size;
         }
         catch(std::exception& e)
         {
@@ -426,7 +441,37 @@ void record_device::initialize_recording()
 {
     //Expected to be called once when recording to file actually starts
     m_capture_time_base = std::chrono::high_resolution_clock::now();
-    m_cached_data_size = 0;
+}
+
+void record_device::set_max_cached_data_size(uint64_t bytes)
+{
+    m_max_cached_data_size = bytes;
+}
+
+uint64_t record_device::get_max_cached_data_size() const
+{
+    return m_max_cached_data_size;
+}
+
+void record_device::set_frame_codec(rs2_stream stream, device_serializer::frame_codec codec)
+{
+    // The writer is only used from the write thread, and frames queued before this call keep the previous codec
+    (*m_write_thread)->invoke([this, stream, codec](dispatcher::cancellable_timer t)
+    {
+        m_ros_writer->set_frame_codec(stream, codec);
+    });
+}
+
+record_device::statistics record_device::get_statistics() const
+{
+    statistics stats;
+    stats.queued_bytes = m_cached_data_size;
+    stats.dropped_frames = m_dropped_frames;
+
+    // Capture time is read unsynchronized with pause/resume, which only skews the average slightly
+    auto seconds = std::chrono::duration<double>(get_capture_time()).count();
+    stats.megabytes_per_second = seconds > 0 ? m_written_bytes / seconds / (1024 * 1024) : 0;
+    return stats;
 }
 void record_device::stop_gracefully(to_string error_msg)
 {
@@ -11,6 +11,8 @@
 #include "sensor.h"
 #include "record_sensor.h"
 
+#include <atomic>
+
 namespace librealsense
 {
     class record_device : public device_interface,
@@ -48,6 +50,21 @@ namespace librealsense
         bool compress_while_record() const override { return true; }
         bool contradicts(const stream_profile_interface* a, const std::vector<stream_profile>& others) const override { return m_device->contradicts(a, others); }
 
+        struct statistics
+        {
+            uint64_t queued_bytes;          // Frame data waiting to be written
+            uint64_t dropped_frames;        // Frames dropped since recording started, as the queue was full
+            double megabytes_per_second;    // Average frame data write rate since recording started
+        };
+
+        // Caps the frame data waiting to be written; frames arriving beyond it are dropped
+        void set_max_cached_data_size(uint64_t bytes);
+        uint64_t get_max_cached_data_size() const;
+        statistics get_statistics() const;
+
+        // Selects how the frames of the stream type recorded from now on are encoded
+        void set_frame_codec(rs2_stream stream, device_serializer::frame_codec codec);
+
     private:
         template <typename T> void write_device_extension_changes(const T& ext);
         template <rs2_extension E, typename P> bool extend_to_aux(std::shared_ptr<P> p, void** ext);
@@ -76,7 +93,10 @@ namespace librealsense
         int m_on_notification_token;
         int m_on_frame_token;
         int m_on_extension_change_token;
-        uint64_t m_cached_data_size;
+        std::atomic<uint64_t> m_cached_data_size;
+        std::atomic<uint64_t> m_max_cached_data_size;
+        std::atomic<uint64_t> m_dropped_frames;
+        std::atomic<uint64_t> m_written_bytes;
         std::once_flag m_first_call_flag;
         void initialize_recording();
         void stop_gracefully(to_string error_msg);
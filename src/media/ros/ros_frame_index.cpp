@@ -0,0 +1,331 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "ros_frame_index.h"
+#include "sensor_msgs/Image.h"
+#include "sensor_msgs/Imu.h"
+#include "types.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+namespace librealsense
+{
+    namespace
+    {
+        const char cache_magic[8] = { 'R', 'S', 'F', 'I', 'D', 'X', '0', '2' };
+
+        // 64-bit FNV-1a, over the index records the bag already holds in memory
+        class fnv_hash
+        {
+        public:
+            void add(const void* data, size_t size)
+            {
+                auto bytes = static_cast<const uint8_t*>(data);
+                for (size_t i = 0; i < size; ++i)
+                    _value = (_value ^ bytes[i]) * 0x100000001b3ULL;
+            }
+            void add(const std::string& s)
+            {
+                add(s.data(), s.size());
+                add(uint32_t(s.size()));
+            }
+            template<class T>
+            void add(const T& value) { add(&value, sizeof(T)); }
+            uint64_t value() const { return _value; }
+        private:
+            uint64_t _value = 0xcbf29ce484222325ULL;
+        };
+
+        template<class T>
+        void write_value(std::ofstream& out, const T& value)
+        {
+            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<class T>
+        bool read_value(std::ifstream& in, T& value)
+        {
+            return bool(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+    }
+
+    ros_frame_index::ros_frame_index(const rosbag::Bag& file, const std::string& file_path)
+        : _file(file), _file_path(file_path), _cache_path(file_path + ".idx"), _cache_enabled(false), _cache_loaded(false)
+    {
+    }
+
+    void ros_frame_index::clear()
+    {
+        _topics.clear();
+        _cached_frame_numbers.clear();
+        _cache_loaded = false;
+    }
+
+    ros_frame_index::file_key ros_frame_index::get_file_key() const
+    {
+        // Files of the same size are told apart by their modification time and by a hash of the connection
+        // records and of the time and connection of every message, all from the bag's in-memory index
+        file_key key = {};
+        key.size = _file.getSize();
+
+        struct stat info;
+        if (stat(_file_path.c_str(), &info) == 0)
+            key.modified = int64_t(info.st_mtime);
+
+        fnv_hash hash;
+        rosbag::View view(_file);
+        for (auto&& connection : view.getConnections())
+        {
+            hash.add(connection->id);
+            hash.add(connection->topic);
+            hash.add(connection->datatype);
+            hash.add(connection->md5sum);
+        }
+        for (auto&& msg : view)
+        {
+            hash.add(msg.getTopic());
+            hash.add(msg.getTime().sec);
+            hash.add(msg.getTime().nsec);
+        }
+        key.index_hash = hash.value();
+        return key;
+    }
+
+    void ros_frame_index::enable_cache(bool enable)
+    {
+        _cache_enabled = enable;
+        if (!enable)
+            return;
+
+        // Topics indexed before the cache was enabled either take their frame numbers from it, or add theirs to it
+        load_cache();
+        bool resolved_topics = false;
+        for (auto&& kvp : _topics)
+        {
+            auto& index = kvp.second;
+            auto cached = _cached_frame_numbers.find(kvp.first);
+            if (index.by_frame_number.empty() && cached != _cached_frame_numbers.end() && cached->second.size() == index.messages.size())
+            {
+                index.frame_numbers = cached->second;
+                index.resolved.assign(index.messages.size(), true);
+                sort_by_frame_number(index);
+            }
+            resolved_topics |= !index.by_frame_number.empty();
+        }
+        if (resolved_topics)
+            save_cache();
+    }
+
+    ros_frame_index::topic_index& ros_frame_index::get_topic(const std::string& topic)
+    {
+        auto it = _topics.find(topic);
+        if (it != _topics.end())
+            return it->second;
+
+        auto& index = _topics[topic];
+        rosbag::View view(_file, rosbag::TopicQuery(topic));
+        for (auto&& msg : view)
+        {
+            if (!msg.isType<sensor_msgs::Image>() && !msg.isType<sensor_msgs::Imu>())
+                break;
+            index.messages.push_back(msg);
+        }
+        index.frame_numbers.resize(index.messages.size());
+        index.resolved.resize(index.messages.size(), false);
+        LOG_DEBUG("Indexed " << index.messages.size() << " frames of " << topic);
+
+        if (_cache_enabled && !index.messages.empty())
+        {
+            load_cache();
+            auto cached = _cached_frame_numbers.find(topic);
+            if (cached != _cached_frame_numbers.end() && cached->second.size() == index.messages.size())
+            {
+                index.frame_numbers = cached->second;
+                index.resolved.assign(index.messages.size(), true);
+                sort_by_frame_number(index);
+            }
+        }
+        return index;
+    }
+
+    bool ros_frame_index::find_last_frame(const std::string& topic, const rs2rosinternal::Time& start, const rs2rosinternal::Time& end,
+        const rosbag::MessageInstance*& msg)
+    {
+        auto& index = get_topic(topic);
+        auto it = std::upper_bound(index.messages.begin(), index.messages.end(), end, [](const rs2rosinternal::Time& t, const rosbag::MessageInstance& m)
+        {
+            return t < m.getTime();
+        });
+        if (it == index.messages.begin() || (it - 1)->getTime() < start)
+            return false;
+
+        msg = &*(it - 1);
+        return true;
+    }
+
+    uint32_t ros_frame_index::frame_number_at(topic_index& index, size_t position)
+    {
+        if (!index.resolved[position])
+        {
+            // Both Image and Imu messages start with a std_msgs/Header, whose first field is the sequence number.
+            // Only those 4 bytes are copied out; the bag still reads (and decompresses) the chunk holding the message.
+            uint8_t seq[sizeof(uint32_t)];
+            if (index.messages[position].readPrefix(seq, sizeof(seq)) < sizeof(seq))
+                throw io_exception(to_string() << "Invalid frame message in topic " << index.messages[position].getTopic());
+
+            std::memcpy(&index.frame_numbers[position], seq, sizeof(seq));
+            index.resolved[position] = true;
+        }
+        return index.frame_numbers[position];
+    }
+
+    void ros_frame_index::sort_by_frame_number(topic_index& index)
+    {
+        index.by_frame_number.resize(index.messages.size());
+        for (size_t i = 0; i < index.by_frame_number.size(); ++i)
+            index.by_frame_number[i] = i;
+        std::stable_sort(index.by_frame_number.begin(), index.by_frame_number.end(), [&](size_t a, size_t b)
+        {
+            return index.frame_numbers[a] < index.frame_numbers[b];
+        });
+    }
+
+    void ros_frame_index::resolve_all(topic_index& index)
+    {
+        for (size_t i = 0; i < index.messages.size(); ++i)
+            frame_number_at(index, i);
+        sort_by_frame_number(index);
+        if (_cache_enabled)
+            save_cache();
+    }
+
+    bool ros_frame_index::find_frame_number(const std::string& topic, unsigned long long frame_number, const rosbag::MessageInstance*& msg)
+    {
+        auto& index = get_topic(topic);
+        if (index.messages.empty() || frame_number > std::numeric_limits<uint32_t>::max())
+            return false;
+
+        auto number = static_cast<uint32_t>(frame_number);
+        if (index.by_frame_number.empty())
+        {
+            // Frame numbers usually grow with time, so a binary search over the time index reads only
+            // a logarithmic number of frame numbers. When it misses (e.g. the numbering restarted mid-file),
+            // the frame number of every message of the topic is read once, which reads every chunk the
+            // topic has messages in; with the cache enabled, later sessions skip that.
+            size_t first = 0, count = index.messages.size();
+            while (count > 0)
+            {
+                auto step = count / 2;
+                if (frame_number_at(index, first + step) < number)
+                {
+                    first += step + 1;
+                    count -= step + 1;
+                }
+                else
+                    count = step;
+            }
+            if (first < index.messages.size() && frame_number_at(index, first) == number)
+            {
+                msg = &index.messages[first];
+                return true;
+            }
+            resolve_all(index);
+        }
+
+        auto it = std::lower_bound(index.by_frame_number.begin(), index.by_frame_number.end(), number, [&](size_t position, uint32_t n)
+        {
+            return index.frame_numbers[position] < n;
+        });
+        if (it == index.by_frame_number.end() || index.frame_numbers[*it] != number)
+            return false;
+
+        msg = &index.messages[*it];
+        return true;
+    }
+
+    void ros_frame_index::load_cache()
+    {
+        if (_cache_loaded)
+            return;
+        _cache_loaded = true;
+
+        std::ifstream in(_cache_path, std::ios_base::in | std::ios_base::binary);
+        if (!in)
+            return;
+
+        char magic[sizeof(cache_magic)];
+        file_key key = {};
+        uint32_t topics = 0;
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, cache_magic, sizeof(magic)) != 0
+            || !read_value(in, key.size) || !read_value(in, key.modified) || !read_value(in, key.index_hash)
+            || !read_value(in, topics))
+        {
+            LOG_WARNING("Ignoring invalid frame index file " << _cache_path);
+            return;
+        }
+        auto file = get_file_key();
+        if (key.size != file.size || key.modified != file.modified || key.index_hash != file.index_hash)
+        {
+            LOG_INFO("Ignoring frame index file " << _cache_path << ", it was created for a different file");
+            return;
+        }
+
+        std::map<std::string, std::vector<uint32_t>> cached;
+        for (uint32_t t = 0; t < topics; ++t)
+        {
+            uint32_t name_length = 0, count = 0;
+            if (!read_value(in, name_length))
+                break;
+            std::string name(name_length, '\0');
+            if (!in.read(&name[0], name_length) || !read_value(in, count))
+                break;
+            std::vector<uint32_t> frame_numbers(count);
+            if (count && !in.read(reinterpret_cast<char*>(frame_numbers.data()), count * sizeof(uint32_t)))
+                break;
+            cached[name] = std::move(frame_numbers);
+        }
+        if (!in)
+        {
+            LOG_WARNING("Ignoring truncated frame index file " << _cache_path);
+            return;
+        }
+        _cached_frame_numbers = std::move(cached);
+    }
+
+    void ros_frame_index::save_cache() const
+    {
+        // Topics resolved now are merged with the ones the file already had
+        auto topics = _cached_frame_numbers;
+        for (auto&& kvp : _topics)
+        {
+            if (!kvp.second.by_frame_number.empty())
+                topics[kvp.first] = kvp.second.frame_numbers;
+        }
+
+        auto key = get_file_key();
+        std::ofstream out(_cache_path, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+        out.write(cache_magic, sizeof(cache_magic));
+        write_value(out, key.size);
+        write_value(out, key.modified);
+        write_value(out, key.index_hash);
+        write_value(out, uint32_t(topics.size()));
+        for (auto&& kvp : topics)
+        {
+            write_value(out, uint32_t(kvp.first.size()));
+            out.write(kvp.first.data(), kvp.first.size());
+            write_value(out, uint32_t(kvp.second.size()));
+            out.write(reinterpret_cast<const char*>(kvp.second.data()), kvp.second.size() * sizeof(uint32_t));
+        }
+        out.close();
+
+        // The index works without its cache, so failing to save it is not an error
+        if (!out)
+            LOG_WARNING("Failed to save frame index file " << _cache_path);
+    }
+}
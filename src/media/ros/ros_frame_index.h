@@ -0,0 +1,72 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "rosbag/view.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace librealsense
+{
+    // Index of the frame messages (Image and Imu) of a rosbag file, per topic, sorted by time.
+    // A topic is indexed the first time it is queried, from the bag's in-memory connection index, so no
+    // message data is read to build it. Each entry points straight at the chunk and offset of its message.
+    // Frame numbers are read from the message headers only when frame number lookups need them, copying
+    // just the sequence number out of the message (the chunk holding it is still read from the file).
+    // When enabled, the frame numbers of fully resolved topics are kept in a sidecar file next to the bag
+    // ("<file>.idx"), so later sessions with the same file can look up any frame without reading the file.
+    // The sidecar is only used for the file it was made for: same size, modification time and index records.
+    class ros_frame_index
+    {
+    public:
+        ros_frame_index(const rosbag::Bag& file, const std::string& file_path);
+
+        // Finds the last frame of the topic with a time within [start, end]
+        bool find_last_frame(const std::string& topic, const rs2rosinternal::Time& start, const rs2rosinternal::Time& end,
+            const rosbag::MessageInstance*& msg);
+
+        // Finds a frame of the topic with the given frame number. When the numbering restarted within the
+        // recording, the earliest of the matching frames is found once the topic frame numbers were all read.
+        bool find_frame_number(const std::string& topic, unsigned long long frame_number, const rosbag::MessageInstance*& msg);
+
+        void enable_cache(bool enable);
+
+        // Must be called when the bag is reopened, as the entries point into its connections
+        void clear();
+
+    private:
+        struct topic_index
+        {
+            std::vector<rosbag::MessageInstance> messages;
+            std::vector<uint32_t> frame_numbers;
+            std::vector<bool> resolved;
+            std::vector<size_t> by_frame_number;    // Positions sorted by frame number, once all are resolved
+        };
+
+        struct file_key
+        {
+            uint64_t size;
+            int64_t modified;
+            uint64_t index_hash;
+        };
+
+        file_key get_file_key() const;
+        topic_index& get_topic(const std::string& topic);
+        uint32_t frame_number_at(topic_index& index, size_t position);
+        void resolve_all(topic_index& index);
+        void sort_by_frame_number(topic_index& index);
+        void load_cache();
+        void save_cache() const;
+
+        const rosbag::Bag& _file;
+        std::string _file_path;
+        std::string _cache_path;
+        bool _cache_enabled;
+        bool _cache_loaded;
+        std::map<std::string, std::vector<uint32_t>> _cached_frame_numbers;
+        std::map<std::string, topic_index> _topics;
+    };
+}
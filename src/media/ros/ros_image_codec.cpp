@@ -0,0 +1,54 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "ros_image_codec.h"
+
+namespace librealsense
+{
+    namespace ros_image_codec
+    {
+        namespace
+        {
+            const char codec_separator[] = "; ";
+            const char rvl_name[] = "rvl";
+        }
+
+        std::string to_encoding(const std::string& encoding, device_serializer::frame_codec codec)
+        {
+            switch (codec)
+            {
+            case device_serializer::frame_codec::rvl: return encoding + codec_separator + rvl_name;
+            default: return encoding;
+            }
+        }
+
+        bool parse_encoding(const std::string& message_encoding, std::string& encoding, device_serializer::frame_codec& codec)
+        {
+            auto separator = message_encoding.find(codec_separator);
+            encoding = message_encoding.substr(0, separator);
+            if (separator == std::string::npos)
+            {
+                codec = device_serializer::frame_codec::raw;
+                return true;
+            }
+
+            auto name = message_encoding.substr(separator + sizeof(codec_separator) - 1);
+            if (name == rvl_name)
+            {
+                codec = device_serializer::frame_codec::rvl;
+                return true;
+            }
+            return false;
+        }
+
+        bool supports(device_serializer::frame_codec codec, rs2_format format)
+        {
+            switch (codec)
+            {
+            case device_serializer::frame_codec::raw: return true;
+            case device_serializer::frame_codec::rvl: return format == RS2_FORMAT_Z16 || format == RS2_FORMAT_Y16;
+            default: return false;
+            }
+        }
+    }
+}
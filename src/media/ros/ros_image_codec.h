@@ -0,0 +1,25 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../../core/serialization.h"
+
+#include <string>
+
+namespace librealsense
+{
+    // Image messages whose data is encoded with a codec carry it in their encoding field as
+    // "<encoding>; <codec>", the way ROS compressed depth images do (e.g. "mono16; rvl").
+    // Messages with a plain encoding hold raw pixels, so files recorded without a codec are unchanged.
+    namespace ros_image_codec
+    {
+        std::string to_encoding(const std::string& encoding, device_serializer::frame_codec codec);
+
+        // Splits a message encoding into the pixel encoding and the codec; returns false for an unknown codec
+        bool parse_encoding(const std::string& message_encoding, std::string& encoding, device_serializer::frame_codec& codec);
+
+        // Whether frames of the given format can be encoded with the codec
+        bool supports(device_serializer::frame_codec codec, rs2_format format);
+    }
+}
@@ -3,6 +3,8 @@
 
 #include <cstring>
 #include "ros_reader.h"
+#include "ros_image_codec.h"
+#include "rvl-codec.h"
 #include "ds5/ds5-device.h"
 #include "ivcam/sr300.h"
 #include "l500/l500-depth.h"
@@ -22,17 +24,33 @@ namespace librealsense
 {
     using namespace device_serializer;
 
+    // The allocator of a sensor_msgs::Image whose data is a frame_buffer, deserialized like any Image but
+    // then moved into the frame instead of copied. Everything else is allocated as usual.
+    struct frame_image_allocator
+    {
+        template<class T> struct rebind
+        {
+            typedef typename std::conditional<std::is_same<T, byte>::value, frame_data_allocator<byte>, std::allocator<T>>::type other;
+        };
+    };
+    typedef sensor_msgs::Image_<frame_image_allocator> frame_image;
+
     ros_reader::ros_reader(const std::string& file, const std::shared_ptr<context>& ctx) :
         m_metadata_parser_map(md_constant_parser::create_metadata_parser_map()),
         m_total_duration(0),
+        m_end_time(0),
         m_file_path(file),
         m_context(ctx),
-        m_version(0)
+        m_version(0),
+        m_frame_index(m_file, file),
+        m_unlimited_frame_pool(false),
+        m_read_ahead_frames(0)
     {
         try
         {
             reset(); //Note: calling a virtual function inside c'tor, safe while base function is pure virtual
             m_total_duration = get_file_duration(m_file, m_version);
+            m_end_time = get_file_end_time(m_file, m_version);
         }
         catch (const std::exception& e)
         {
@@ -94,7 +112,8 @@ namespace librealsense
 
     void ros_reader::seek_to_time(const nanoseconds& seek_time)
     {
-        if (seek_time > m_total_duration)
+        //Frame times count from the start of the recording, so the last frame is past the duration
+        if (seek_time > std::max(m_total_duration, m_end_time))
         {
             throw invalid_value_exception(to_string() << "Requested time is out of playback length. (Requested = " << seek_time.count() << ", Duration = " << m_total_duration.count() << ")");
         }
@@ -116,33 +135,76 @@ namespace librealsense
     std::vector<std::shared_ptr<serialized_data>> ros_reader::fetch_last_frames(const nanoseconds& seek_time)
     {
         std::vector<std::shared_ptr<serialized_data>> result;
-        rosbag::View view(m_file, FalseQuery());
         auto as_rostime = to_rostime(seek_time);
         auto start_time = to_rostime(get_static_file_info_timestamp());
 
+        //The frame index finds the last frame of each stream directly, instead of reading every message up to the seek time
+        std::map<device_serializer::stream_identifier, const rosbag::MessageInstance*> last_frames;
         for (auto topic : m_enabled_streams_topics)
         {
-            view.addQuery(m_file, rosbag::TopicQuery(topic), start_time, as_rostime);
-        }
-        std::map<device_serializer::stream_identifier, rs2rosinternal::Time> last_frames;
-        for (auto&& m : view)
-        {
-            if (m.isType<sensor_msgs::Image>() || m.isType<sensor_msgs::Imu>())
+            const rosbag::MessageInstance* msg = nullptr;
+            if (m_frame_index.find_last_frame(topic, start_time, as_rostime, msg))
             {
-                auto id = ros_topic::get_stream_identifier(m.getTopic());
-                last_frames[id] = m.getTime();
+                last_frames[ros_topic::get_stream_identifier(topic)] = msg;
             }
         }
         for (auto&& kvp : last_frames)
         {
-            auto topic = ros_topic::frame_data_topic(kvp.first);
-            rosbag::View view(m_file, rosbag::TopicQuery(topic), kvp.second, kvp.second);
-            auto msg = view.begin();
-            auto new_frame = create_frame(*msg);
+            auto new_frame = create_frame(*kvp.second);
             result.push_back(new_frame);
         }
         return result;
     }
+
+    nanoseconds ros_reader::query_frame_time(rs2_stream stream, uint32_t stream_index, unsigned long long frame_number)
+    {
+        if (m_version == legacy_file_format::file_version())
+        {
+            throw not_implemented_exception("Seeking to a frame number is not supported for this file version");
+        }
+
+        rosbag::View frames_view(m_file, FrameQuery());
+        for (auto&& connection : frames_view.getConnections())
+        {
+            auto stream_id = ros_topic::get_stream_identifier(connection->topic);
+            if (stream_id.stream_type != stream || stream_id.stream_index != stream_index)
+                continue;
+
+            const rosbag::MessageInstance* msg = nullptr;
+            if (m_frame_index.find_frame_number(connection->topic, frame_number, msg))
+            {
+                return to_nanoseconds(msg->getTime());
+            }
+        }
+        throw invalid_value_exception(to_string() << "Frame " << frame_number << " of stream " << get_string(stream) << " " << stream_index << " was not found in " << m_file_path);
+    }
+
+    void ros_reader::enable_index_cache(bool enable)
+    {
+        m_frame_index.enable_cache(enable);
+    }
+
+    void ros_reader::set_unlimited_frame_pool(bool unlimited)
+    {
+        m_unlimited_frame_pool = unlimited;
+        m_frame_source->set_max_publish_list_size(get_frame_pool_size());
+    }
+
+    void ros_reader::set_read_ahead_frames(uint32_t frames)
+    {
+        m_read_ahead_frames = frames;
+        m_frame_source->set_max_publish_list_size(get_frame_pool_size());
+    }
+
+    uint32_t ros_reader::get_frame_pool_size() const
+    {
+        //0 lets the frame archive allocate as many frames as requested, instead of failing the allocation
+        if (m_unlimited_frame_pool)
+            return 0;
+        //Frames read ahead do not take from what the application and sensors may hold
+        return (m_version == 1 ? 128 : 32) + m_read_ahead_frames;
+    }
+
     nanoseconds ros_reader::query_duration() const
     {
         return m_total_duration;
@@ -150,11 +212,12 @@ namespace librealsense
 
     void ros_reader::reset()
     {
+        m_frame_index.clear();
         m_file.close();
         m_file.open(m_file_path, rosbag::BagMode::Read);
         m_version = read_file_version(m_file);
         m_samples_view = nullptr;
-        m_frame_source = std::make_shared<frame_source>(m_version == 1 ? 128 : 32);
+        m_frame_source = std::make_shared<frame_source>(get_frame_pool_size());
         m_frame_source->init(m_metadata_parser_map);
         m_initial_device_description = read_device_description(get_static_file_info_timestamp(), true);
     }
@@ -285,18 +348,26 @@ namespace librealsense
         return std::make_shared<serialized_frame>(timestamp, stream_id, std::move(frame));
     }
 
-    nanoseconds ros_reader::get_file_duration(const rosbag::Bag& file, uint32_t version)
+    std::function<bool(rosbag::ConnectionInfo const* info)> ros_reader::get_frame_query(uint32_t version)
     {
-        std::function<bool(rosbag::ConnectionInfo const* info)> query;
         if (version == legacy_file_format::file_version())
-            query = legacy_file_format::FrameQuery();
-        else
-            query = FrameQuery();
-        rosbag::View all_frames_view(file, query);
+            return legacy_file_format::FrameQuery();
+        return FrameQuery();
+    }
+
+    nanoseconds ros_reader::get_file_duration(const rosbag::Bag& file, uint32_t version)
+    {
+        rosbag::View all_frames_view(file, get_frame_query(version));
         auto streaming_duration = all_frames_view.getEndTime() - all_frames_view.getBeginTime();
         return nanoseconds(streaming_duration.toNSec());
     }
 
+    nanoseconds ros_reader::get_file_end_time(const rosbag::Bag& file, uint32_t version)
+    {
+        rosbag::View all_frames_view(file, get_frame_query(version));
+        return to_nanoseconds(all_frames_view.getEndTime());
+    }
+
     void ros_reader::get_legacy_frame_metadata(const rosbag::Bag& bag,
         const device_serializer::stream_identifier& stream_id,
         const rosbag::MessageInstance &msg,
@@ -406,7 +477,7 @@ namespace librealsense
     frame_holder ros_reader::create_image_from_message(const rosbag::MessageInstance &image_data) const
     {
         LOG_DEBUG("Trying to create an image frame from message");
-        auto msg = instantiate_msg<sensor_msgs::Image>(image_data);
+        auto msg = instantiate_msg<frame_image>(image_data);
         frame_additional_data additional_data{};
         std::chrono::duration<double, std::milli> timestamp_ms(std::chrono::duration<double>(msg->header.stamp.toSec()));
         additional_data.timestamp = timestamp_ms.count();
@@ -428,8 +499,17 @@ namespace librealsense
             get_frame_metadata(m_file, info_topic, stream_id, image_data, additional_data);
         }
 
+        std::string encoding;
+        frame_codec codec;
+        if (!ros_image_codec::parse_encoding(msg->encoding, encoding, codec))
+        {
+            throw io_exception(to_string() << "Unsupported image encoding \"" << msg->encoding << "\" in " << image_data.getTopic());
+        }
+        auto data_size = codec == frame_codec::raw ? msg->data.size() : size_t(msg->step) * msg->height;
+
+        // Raw data moves in from the message, so only decoded frames need memory of their own
         frame_interface* frame = m_frame_source->alloc_frame((stream_id.stream_type == RS2_STREAM_DEPTH) ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME,
-            msg->data.size(), additional_data, true);
+            data_size, additional_data, codec != frame_codec::raw);
         if (frame == nullptr)
         {
             LOG_WARNING("Failed to allocate new frame");
@@ -438,13 +518,25 @@ namespace librealsense
         librealsense::video_frame* video_frame = static_cast<librealsense::video_frame*>(frame);
         video_frame->assign(msg->width, msg->height, msg->step, msg->step / msg->width * 8);
         rs2_format stream_format;
-        convert(msg->encoding, stream_format);
+        convert(encoding, stream_format);
         //attaching a temp stream to the frame. Playback sensor should assign the real stream
         frame->set_stream(std::make_shared<video_stream_profile>(platform::stream_profile{}));
         frame->get_stream()->set_format(stream_format);
         frame->get_stream()->set_stream_index(int(stream_id.stream_index));
         frame->get_stream()->set_stream_type(stream_id.stream_type);
-        video_frame->data = std::move(msg->data);
+        if (codec == frame_codec::rvl)
+        {
+            if (!rvl::decode(msg->data.data(), msg->data.size(), reinterpret_cast<uint16_t*>(video_frame->data.data()), data_size / sizeof(uint16_t)))
+            {
+                // Drops the frame rather than publishing it half decoded
+                librealsense::frame_holder corrupt{ video_frame };
+                throw io_exception(to_string() << "Corrupt RVL image data in " << image_data.getTopic());
+            }
+        }
+        else
+        {
+            video_frame->data = std::move(msg->data);
+        }
         librealsense::frame_holder fh{ video_frame };
         LOG_DEBUG("Created image frame: " << stream_id << " " << video_frame->get_width() << "x" << video_frame->get_height() << " " << stream_format);
 
@@ -5,6 +5,7 @@
 #include <core/serialization.h>
 #include "rosbag/view.h"
 #include "ros_file_format.h"
+#include "ros_frame_index.h"
 
 namespace librealsense
 {
@@ -18,6 +19,10 @@ namespace librealsense
         std::shared_ptr<serialized_data> read_next_data() override;
         void seek_to_time(const nanoseconds& seek_time) override;
         std::vector<std::shared_ptr<serialized_data>> fetch_last_frames(const nanoseconds& seek_time) override;
+        nanoseconds query_frame_time(rs2_stream stream, uint32_t stream_index, unsigned long long frame_number) override;
+        void enable_index_cache(bool enable) override;
+        void set_unlimited_frame_pool(bool unlimited) override;
+        void set_read_ahead_frames(uint32_t frames) override;
         nanoseconds query_duration() const override;
         void reset() override;
         virtual void enable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
@@ -27,9 +32,9 @@ namespace librealsense
     private:
 
         template <typename ROS_TYPE>
-        static typename ROS_TYPE::ConstPtr instantiate_msg(const rosbag::MessageInstance& msg)
+        static typename ROS_TYPE::Ptr instantiate_msg(const rosbag::MessageInstance& msg)
         {
-            typename ROS_TYPE::ConstPtr msg_instnance_ptr = msg.instantiate<ROS_TYPE>();
+            typename ROS_TYPE::Ptr msg_instnance_ptr = msg.instantiate<ROS_TYPE>();
             if (msg_instnance_ptr == nullptr)
             {
                 throw io_exception(to_string()
@@ -42,7 +47,10 @@ namespace librealsense
         }
 
         std::shared_ptr<serialized_frame> create_frame(const rosbag::MessageInstance& msg);
+        uint32_t get_frame_pool_size() const;
+        static std::function<bool(rosbag::ConnectionInfo const* info)> get_frame_query(uint32_t version);
         static nanoseconds get_file_duration(const rosbag::Bag& file, uint32_t version);
+        static nanoseconds get_file_end_time(const rosbag::Bag& file, uint32_t version);
         static void get_legacy_frame_metadata(const rosbag::Bag& bag,
             const device_serializer::stream_identifier& stream_id,
             const rosbag::MessageInstance &msg,
@@ -135,6 +143,7 @@ namespace librealsense
         std::shared_ptr<metadata_parser_map>    m_metadata_parser_map;
         device_snapshot                         m_initial_device_description;
         nanoseconds                             m_total_duration;
+        nanoseconds                             m_end_time;     // Time of the last frame
         std::string                             m_file_path;
         std::shared_ptr<frame_source>           m_frame_source;
         rosbag::Bag                             m_file;
@@ -143,5 +152,8 @@ namespace librealsense
         std::vector<std::string>                m_enabled_streams_topics;
         std::shared_ptr<context>                m_context;
         uint32_t                                m_version;
+        ros_frame_index                         m_frame_index;
+        bool                                    m_unlimited_frame_pool;
+        uint32_t                                m_read_ahead_frames;
     };
 }
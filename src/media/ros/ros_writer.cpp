@@ -12,9 +12,73 @@
 #include "proc/hdr-merge.h"
 #include "proc/sequence-id-filter.h"
 #include "ros_writer.h"
+#include "ros_image_codec.h"
+#include "rvl-codec.h"
 #include "l500/l500-motion.h"
 #include "l500/l500-depth.h"
 
+namespace librealsense
+{
+    // A sensor_msgs::Image whose pixels stay in the frame buffer: it is serialized exactly like an Image,
+    // with the pixels written straight from the frame into the bag's record buffer, instead of being copied
+    // into Image::data first
+    struct image_message_view
+    {
+        sensor_msgs::Image fields; // Everything but the data
+        const uint8_t* data;
+        uint32_t size;
+    };
+}
+
+namespace rs2rosinternal
+{
+    namespace message_traits
+    {
+        template<> struct IsMessage<librealsense::image_message_view> : TrueType {};
+        template<> struct MD5Sum<librealsense::image_message_view>
+        {
+            static const char* value() { return MD5Sum<sensor_msgs::Image>::value(); }
+            static const char* value(const librealsense::image_message_view&) { return value(); }
+        };
+        template<> struct DataType<librealsense::image_message_view>
+        {
+            static const char* value() { return DataType<sensor_msgs::Image>::value(); }
+            static const char* value(const librealsense::image_message_view&) { return value(); }
+        };
+        template<> struct Definition<librealsense::image_message_view>
+        {
+            static const char* value() { return Definition<sensor_msgs::Image>::value(); }
+            static const char* value(const librealsense::image_message_view&) { return value(); }
+        };
+    }
+
+    namespace serialization
+    {
+        template<> struct Serializer<librealsense::image_message_view>
+        {
+            template<typename Stream>
+            inline static void write(Stream& stream, const librealsense::image_message_view& m)
+            {
+                stream.next(m.fields.header);
+                stream.next(m.fields.height);
+                stream.next(m.fields.width);
+                stream.next(m.fields.encoding);
+                stream.next(m.fields.is_bigendian);
+                stream.next(m.fields.step);
+                stream.next(m.size);
+                if (m.size > 0)
+                    memcpy(stream.advance(m.size), m.data, m.size);
+            }
+
+            inline static uint32_t serializedLength(const librealsense::image_message_view& m)
+            {
+                // The fields' own (empty) data still accounts for the length prefix
+                return serializationLength(m.fields) + m.size;
+            }
+        };
+    }
+}
+
 namespace librealsense
 {
     using namespace device_serializer;
@@ -30,6 +94,12 @@ namespace librealsense
         write_file_version();
     }
 
+    void ros_writer::set_frame_codec(rs2_stream stream, frame_codec codec)
+    {
+        // Applies to the frames written from now on; formats the codec does not support are written raw
+        m_frame_codecs[stream] = codec;
+    }
+
     void ros_writer::write_device_description(const librealsense::device_snapshot& device_description)
     {
         for (auto&& device_extension_snapshot : device_description.get_device_extensions_snapshots().get_snapshots())
@@ -173,23 +243,38 @@ namespace librealsense
 
     void ros_writer::write_video_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame)
     {
-        sensor_msgs::Image image;
+        image_message_view image;
         auto vid_frame = dynamic_cast<librealsense::video_frame*>(frame.frame);
         assert(vid_frame != nullptr);
 
-        image.width = static_cast<uint32_t>(vid_frame->get_width());
-        image.height = static_cast<uint32_t>(vid_frame->get_height());
-        image.step = static_cast<uint32_t>(vid_frame->get_stride());
-        convert(vid_frame->get_stream()->get_format(), image.encoding);
-        image.is_bigendian = is_big_endian();
-        auto size = vid_frame->get_stride() * vid_frame->get_height();
-        auto p_data = vid_frame->get_frame_data();
-        image.data.assign(p_data, p_data + size);
-        image.header.seq = static_cast<uint32_t>(vid_frame->get_frame_number());
+        image.fields.width = static_cast<uint32_t>(vid_frame->get_width());
+        image.fields.height = static_cast<uint32_t>(vid_frame->get_height());
+        image.fields.step = static_cast<uint32_t>(vid_frame->get_stride());
+        convert(vid_frame->get_stream()->get_format(), image.fields.encoding);
+        image.fields.is_bigendian = is_big_endian();
+        image.size = static_cast<uint32_t>(vid_frame->get_stride() * vid_frame->get_height());
+        image.data = vid_frame->get_frame_data();
+
+        auto codec = m_frame_codecs.find(stream_id.stream_type);
+        if (codec != m_frame_codecs.end() && codec->second == frame_codec::rvl
+            && ros_image_codec::supports(codec->second, vid_frame->get_stream()->get_format()))
+        {
+            // A frame that does not get smaller, like one of noise, is recorded as is
+            m_encoded_frame.resize(image.size);
+            auto encoded_end = rvl::encode(reinterpret_cast<const uint16_t*>(image.data), image.size / sizeof(uint16_t),
+                m_encoded_frame.data(), m_encoded_frame.data() + m_encoded_frame.size());
+            if (encoded_end)
+            {
+                image.fields.encoding = ros_image_codec::to_encoding(image.fields.encoding, codec->second);
+                image.data = m_encoded_frame.data();
+                image.size = static_cast<uint32_t>(encoded_end - m_encoded_frame.data());
+            }
+        }
+        image.fields.header.seq = static_cast<uint32_t>(vid_frame->get_frame_number());
         std::chrono::duration<double, std::milli> timestamp_ms(vid_frame->get_frame_timestamp());
-        image.header.stamp = rs2rosinternal::Time(std::chrono::duration<double>(timestamp_ms).count());
+        image.fields.header.stamp = rs2rosinternal::Time(std::chrono::duration<double>(timestamp_ms).count());
         std::string TODO_CORRECT_ME = "0";
-        image.header.frame_id = TODO_CORRECT_ME;
+        image.fields.header.frame_id = TODO_CORRECT_ME;
         auto image_topic = ros_topic::frame_data_topic(stream_id);
         write_message(image_topic, timestamp, image);
         write_additional_frame_messages(stream_id, timestamp, frame);
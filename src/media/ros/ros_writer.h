@@ -18,6 +18,7 @@ namespace librealsense
         void write_snapshot(uint32_t device_index, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override;
         void write_snapshot(const sensor_identifier& sensor_id, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override;
         const std::string& get_file_name() const override;
+        void set_frame_codec(rs2_stream stream, frame_codec codec) override;
 
     private:
         void write_file_version();
@@ -77,5 +78,7 @@ namespace librealsense
         std::string m_file_path;
         rosbag::Bag m_bag;
         std::map<uint32_t, std::set<rs2_option>> m_written_options_descriptions;
+        std::map<rs2_stream, frame_codec> m_frame_codecs;
+        std::vector<uint8_t> m_encoded_frame;
     };
 }
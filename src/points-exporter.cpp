@@ -0,0 +1,307 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "points-exporter.h"
+#include "core/video.h"
+#include "concurrency.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#define MIN_DISTANCE 1e-6
+
+namespace librealsense
+{
+    namespace
+    {
+        const float face_threshold = 0.05f;
+
+        inline bool is_valid(const float3& v)
+        {
+            return std::fabs(v.x) >= MIN_DISTANCE || std::fabs(v.y) >= MIN_DISTANCE || std::fabs(v.z) >= MIN_DISTANCE;
+        }
+
+        template<class T>
+        inline void append(std::vector<char>& out, const T& value)
+        {
+            // we assume little endian architecture on your device
+            auto bytes = reinterpret_cast<const char*>(&value);
+            out.insert(out.end(), bytes, bytes + sizeof(T));
+        }
+
+        inline void append(std::vector<char>& out, const char* text, int length)
+        {
+            if (length > 0)
+                out.insert(out.end(), text, text + length);
+        }
+
+        // Calls task(block) for each of the 'block_size' items blocks of [0, count)
+        template<class T>
+        void for_each_block(size_t count, size_t block_size, T task)
+        {
+            thread_pool::shared().parallel_for(count, block_size, [&](size_t first, size_t last)
+            {
+                // Chunks start at a block boundary, unless the pool runs the whole range on this thread
+                for (auto block = first / block_size; block * block_size < last; ++block)
+                    task(block);
+            });
+        }
+    }
+
+    points_exporter::points_exporter(points_file_format format, bool binary)
+        : _format(format), _binary(binary)
+    {
+    }
+
+    points_file_format points_exporter::format_from_name(const std::string& fname)
+    {
+        const std::string ext = ".pcd";
+        if (fname.size() < ext.size())
+            return points_file_format::ply;
+
+        auto matches = std::equal(ext.begin(), ext.end(), fname.end() - ext.size(), [](char a, char b)
+        {
+            return a == std::tolower(static_cast<unsigned char>(b));
+        });
+        return matches ? points_file_format::pcd : points_file_format::ply;
+    }
+
+    void points_exporter::texture_view::get_color(float u, float v, uint8_t rgb[3]) const
+    {
+        int x = std::min(std::max(int(u*width + .5f), 0), width - 1);
+        int y = std::min(std::max(int(v*height + .5f), 0), height - 1);
+        auto pixel = data + y * stride + x * bytes_per_pixel;
+        rgb[0] = pixel[0];
+        rgb[1] = pixel[1];
+        rgb[2] = pixel[2];
+    }
+
+    void points_exporter::write_vertex(std::vector<char>& out, const float3& v, const uint8_t* rgb) const
+    {
+        char text[96];
+        if (_format == points_file_format::ply)
+        {
+            // Flipped to the y-up, z-towards-the-viewer convention of mesh viewers
+            float3 p{ v.x, -1 * v.y, -1 * v.z };
+            if (_binary)
+            {
+                append(out, p);
+                if (rgb)
+                    append(out, reinterpret_cast<const char*>(rgb), 3);
+            }
+            else if (rgb)
+                append(out, text, snprintf(text, sizeof(text), "%g %g %g %u %u %u\n", p.x, p.y, p.z, rgb[0], rgb[1], rgb[2]));
+            else
+                append(out, text, snprintf(text, sizeof(text), "%g %g %g\n", p.x, p.y, p.z));
+        }
+        else
+        {
+            // PCD keeps the camera coordinates, with the color packed into a single 0x00RRGGBB field
+            uint32_t packed = rgb ? (uint32_t(rgb[0]) << 16) | (uint32_t(rgb[1]) << 8) | rgb[2] : 0;
+            if (_binary)
+            {
+                append(out, v);
+                if (rgb)
+                    append(out, packed);
+            }
+            else if (rgb)
+                append(out, text, snprintf(text, sizeof(text), "%g %g %g %u\n", v.x, v.y, v.z, packed));
+            else
+                append(out, text, snprintf(text, sizeof(text), "%g %g %g\n", v.x, v.y, v.z));
+        }
+    }
+
+    void points_exporter::write_face(std::vector<char>& out, int a, int b, int c) const
+    {
+        if (_binary)
+        {
+            append(out, uint8_t(3));
+            append(out, a);
+            append(out, b);
+            append(out, c);
+        }
+        else
+        {
+            char text[48];
+            append(out, text, snprintf(text, sizeof(text), "3 %d %d %d\n", a, b, c));
+        }
+    }
+
+    std::string points_exporter::make_header(size_t vertex_count, size_t face_count, bool color) const
+    {
+        std::ostringstream out;
+        if (_format == points_file_format::ply)
+        {
+            out << "ply\n";
+            out << "format " << (_binary ? "binary_little_endian" : "ascii") << " 1.0\n";
+            out << "comment pointcloud saved from Realsense Viewer\n";
+            out << "element vertex " << vertex_count << "\n";
+            out << "property float" << sizeof(float) * 8 << " x\n";
+            out << "property float" << sizeof(float) * 8 << " y\n";
+            out << "property float" << sizeof(float) * 8 << " z\n";
+            if (color)
+            {
+                out << "property uchar red\n";
+                out << "property uchar green\n";
+                out << "property uchar blue\n";
+            }
+            out << "element face " << face_count << "\n";
+            out << "property list uchar int vertex_indices\n";
+            out << "end_header\n";
+        }
+        else
+        {
+            out << "# .PCD v0.7 - Point Cloud Data file format\n";
+            out << "VERSION 0.7\n";
+            out << (color ? "FIELDS x y z rgb\n" : "FIELDS x y z\n");
+            out << (color ? "SIZE 4 4 4 4\n" : "SIZE 4 4 4\n");
+            out << (color ? "TYPE F F F U\n" : "TYPE F F F\n");
+            out << (color ? "COUNT 1 1 1 1\n" : "COUNT 1 1 1\n");
+            out << "WIDTH " << vertex_count << "\n";
+            out << "HEIGHT 1\n";
+            out << "VIEWPOINT 0 0 0 1 0 0 0\n";
+            out << "POINTS " << vertex_count << "\n";
+            out << "DATA " << (_binary ? "binary" : "ascii") << "\n";
+        }
+        return out.str();
+    }
+
+    void points_exporter::write(const std::string& fname, points& pts, const frame_holder& texture) const
+    {
+        auto video_stream_profile = dynamic_cast<video_stream_profile_interface*>(pts.get_stream().get());
+        if (!video_stream_profile)
+            throw librealsense::invalid_value_exception("stream must be video stream");
+
+        // The texture is resolved once, rather than per vertex
+        texture_view tex;
+        const bool color = texture;
+        if (color)
+        {
+            auto ptr = dynamic_cast<video_frame*>(texture.frame);
+            if (ptr == nullptr)
+                throw librealsense::invalid_value_exception("frame must be video frame");
+            if (ptr->get_bpp() < 24)
+                throw librealsense::invalid_value_exception("texture frame must have at least 3 bytes per pixel");
+
+            tex.data = reinterpret_cast<const uint8_t*>(ptr->get_frame_data());
+            tex.width = ptr->get_width();
+            tex.height = ptr->get_height();
+            tex.bytes_per_pixel = ptr->get_bpp() / 8;
+            tex.stride = ptr->get_stride();
+        }
+
+        const auto vertices = pts.get_vertices();
+        const auto texcoords = pts.get_texture_coordinates();
+        const auto pixel_indices = pts.get_pixel_indices();
+        const auto count = pts.get_vertex_count();
+        const int width = video_stream_profile->get_width();
+        const int height = video_stream_profile->get_height();
+
+        // Faces connect neighboring depth pixels, so they need to know which pixel each vertex came from.
+        // A sparse frame without pixel indices is saved as vertices only, as is any PCD file.
+        const bool dense = !pixel_indices && count == size_t(width) * height;
+        const bool mesh = _format == points_file_format::ply && (dense || pixel_indices);
+
+        // Each run of vertices first counts its valid vertices, so that it knows where its output starts
+        const auto runs = (count + vertices_per_task - 1) / vertices_per_task;
+        std::vector<size_t> run_begin(runs + 1, 0);
+        for_each_block(count, vertices_per_task, [&](size_t run)
+        {
+            auto last = std::min((run + 1) * vertices_per_task, count);
+            size_t valid = 0;
+            for (auto i = run * vertices_per_task; i < last; ++i)
+                valid += is_valid(vertices[i]);
+            run_begin[run + 1] = valid;
+        });
+        for (size_t run = 0; run < runs; ++run)
+            run_begin[run + 1] += run_begin[run];
+        const auto vertex_count = run_begin[runs];
+
+        std::vector<int> pixel_to_vertex(mesh ? size_t(width) * height : 0, -1);
+        std::vector<float> vertex_z(mesh ? vertex_count : 0);
+        std::vector<std::vector<char>> vertex_blocks(runs);
+        for_each_block(count, vertices_per_task, [&](size_t run)
+        {
+            auto& out = vertex_blocks[run];
+            auto next = run_begin[run];
+            out.reserve((run_begin[run + 1] - next) * (_binary ? sizeof(float3) + sizeof(uint32_t) : 48));
+
+            auto last = std::min((run + 1) * vertices_per_task, count);
+            for (auto i = run * vertices_per_task; i < last; ++i)
+            {
+                if (!is_valid(vertices[i]))
+                    continue;
+
+                uint8_t rgb[3];
+                if (color)
+                    tex.get_color(texcoords[i].x, texcoords[i].y, rgb);
+                write_vertex(out, vertices[i], color ? rgb : nullptr);
+
+                if (mesh)
+                {
+                    pixel_to_vertex[dense ? i : pixel_indices[i]] = int(next);
+                    vertex_z[next] = vertices[i].z;
+                }
+                ++next;
+            }
+        });
+
+        // Faces are generated per band of columns, down each column in turn as export_to_ply always did,
+        // and the bands are written in order
+        const size_t face_columns = (mesh && width > 1 && height > 1) ? width - 1 : 0;
+        std::vector<std::vector<char>> face_blocks((face_columns + columns_per_task - 1) / columns_per_task);
+        std::vector<size_t> face_counts(face_blocks.size(), 0);
+        for_each_block(face_columns, columns_per_task, [&](size_t band)
+        {
+            auto& out = face_blocks[band];
+            size_t faces = 0;
+
+            auto last = std::min((band + 1) * columns_per_task, face_columns);
+            for (auto x = band * columns_per_task; x < last; ++x)
+            {
+                for (int y = 0; y < height - 1; ++y)
+                {
+                    auto row = pixel_to_vertex.data() + y * width;
+                    auto next_row = row + width;
+                    auto a = row[x], b = row[x + 1], c = next_row[x], d = next_row[x + 1];
+                    if (a < 0 || b < 0 || c < 0 || d < 0)
+                        continue;
+
+                    auto za = vertex_z[a], zb = vertex_z[b], zc = vertex_z[c], zd = vertex_z[d];
+                    if (za && zb && zc && zd
+                        && std::fabs(za - zb) < face_threshold && std::fabs(za - zc) < face_threshold
+                        && std::fabs(zb - zd) < face_threshold && std::fabs(zc - zd) < face_threshold)
+                    {
+                        write_face(out, a, d, b);
+                        write_face(out, d, a, c);
+                        faces += 2;
+                    }
+                }
+            }
+            face_counts[band] = faces;
+        });
+
+        size_t face_count = 0;
+        for (auto faces : face_counts)
+            face_count += faces;
+
+        std::ofstream out(fname, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+        if (!out)
+            throw librealsense::io_exception(to_string() << "failed to open " << fname << " for writing");
+
+        auto header = make_header(vertex_count, face_count, color);
+        out.write(header.data(), header.size());
+        for (auto&& block : vertex_blocks)
+            out.write(block.data(), block.size());
+        for (auto&& block : face_blocks)
+            out.write(block.data(), block.size());
+
+        out.close();
+        if (!out)
+            throw librealsense::io_exception(to_string() << "failed to write " << fname);
+    }
+}
@@ -0,0 +1,57 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "archive.h"
+
+#include <string>
+#include <vector>
+
+namespace librealsense
+{
+    enum class points_file_format
+    {
+        ply,
+        pcd
+    };
+
+    // Saves a points frame, optionally colored by a texture frame, as a PLY or PCD file.
+    // The file is serialized in parallel blocks: the valid vertices are split into fixed-size runs and
+    // the mesh faces (PLY only) into bands of depth columns, each encoded into its own buffer on the shared
+    // thread pool, and the buffers are then written to the file in order with a few large writes.
+    // An exporter holds no state between calls, so frames can be saved from any thread, including a
+    // background thread that writes a continuous capture while the pipeline keeps running.
+    class points_exporter
+    {
+    public:
+        points_exporter(points_file_format format, bool binary);
+
+        void write(const std::string& fname, points& pts, const frame_holder& texture) const;
+
+        // PCD for names ending with ".pcd", PLY otherwise
+        static points_file_format format_from_name(const std::string& fname);
+
+        static const size_t vertices_per_task = 0x4000;
+        static const size_t columns_per_task = 16;
+
+    private:
+        struct texture_view
+        {
+            const uint8_t* data = nullptr;
+            int width = 0;
+            int height = 0;
+            int bytes_per_pixel = 0;
+            int stride = 0;
+
+            void get_color(float u, float v, uint8_t rgb[3]) const;
+        };
+
+        void write_vertex(std::vector<char>& out, const float3& v, const uint8_t* rgb) const;
+        void write_face(std::vector<char>& out, int a, int b, int c) const;
+        std::string make_header(size_t vertex_count, size_t face_count, bool color) const;
+
+        points_file_format _format;
+        bool _binary;
+    };
+}
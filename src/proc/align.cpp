@@ -10,60 +10,92 @@
 #include "environment.h"
 #include "align.h"
 #include "stream.h"
+#include "../concurrency.h"
 
 namespace librealsense
 {
     template<int N> struct bytes { byte b[N]; };
 
-    template<class GET_DEPTH, class TRANSFER_PIXEL>
-    void align_images(const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other,
-        const rs2_intrinsics& other_intrin, GET_DEPTH get_depth, TRANSFER_PIXEL transfer_pixel)
+    // Maps the top-left and bottom-right corners of each depth pixel onto the other image, writing the
+    // rectangle of other pixels it covers. Pixels without depth, or whose rectangle leaves the other
+    // image, get an empty rectangle. Rows are split across the shared thread pool.
+    template<class GET_DEPTH>
+    void map_depth_pixels(const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other,
+        const rs2_intrinsics& other_intrin, const float2* rays, GET_DEPTH get_depth, align::pixel_rect* rects)
     {
-        // Iterate over the pixels of the depth image
-#pragma omp parallel for schedule(dynamic)
-        for (int depth_y = 0; depth_y < depth_intrin.height; ++depth_y)
+        thread_pool::shared().parallel_for(depth_intrin.height, align::rows_per_task, [&](size_t first_row, size_t last_row)
         {
-            int depth_pixel_index = depth_y * depth_intrin.width;
-            for (int depth_x = 0; depth_x < depth_intrin.width; ++depth_x, ++depth_pixel_index)
+            for (int depth_y = int(first_row); depth_y < int(last_row); ++depth_y)
             {
-                // Skip over depth pixels with the value of zero, we have no depth data so we will not write anything into our aligned images
-                if (float depth = get_depth(depth_pixel_index))
+                int depth_pixel_index = depth_y * depth_intrin.width;
+                for (int depth_x = 0; depth_x < depth_intrin.width; ++depth_x, ++depth_pixel_index)
                 {
-                    // Map the top-left corner of the depth pixel onto the other image
-                    float depth_pixel[2] = { depth_x - 0.5f, depth_y - 0.5f }, depth_point[3], other_point[3], other_pixel[2];
-                    rs2_deproject_pixel_to_point(depth_point, &depth_intrin, depth_pixel, depth);
-                    rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
-                    rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
-                    const int other_x0 = static_cast<int>(other_pixel[0] + 0.5f);
-                    const int other_y0 = static_cast<int>(other_pixel[1] + 0.5f);
-
-                    // Map the bottom-right corner of the depth pixel onto the other image
-                    depth_pixel[0] = depth_x + 0.5f; depth_pixel[1] = depth_y + 0.5f;
-                    rs2_deproject_pixel_to_point(depth_point, &depth_intrin, depth_pixel, depth);
-                    rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
-                    rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
-                    const int other_x1 = static_cast<int>(other_pixel[0] + 0.5f);
-                    const int other_y1 = static_cast<int>(other_pixel[1] + 0.5f);
-
-                    if (other_x0 < 0 || other_y0 < 0 || other_x1 >= other_intrin.width || other_y1 >= other_intrin.height)
-                        continue;
-
-                    // Transfer between the depth pixels and the pixels inside the rectangle on the other image
-                    for (int y = other_y0; y <= other_y1; ++y)
+                    auto& rect = rects[depth_pixel_index];
+                    rect = { 0, 0, -1, -1 };
+
+                    // Skip over depth pixels with the value of zero, we have no depth data so we will not write anything into our aligned images
+                    if (float depth = get_depth(depth_pixel_index))
                     {
-                        for (int x = other_x0; x <= other_x1; ++x)
-                        {
-                            transfer_pixel(depth_pixel_index, y * other_intrin.width + x);
-                        }
+                        // Map the top-left corner of the depth pixel onto the other image
+                        auto ray = rays[depth_pixel_index * 2];
+                        float depth_point[3] = { depth * ray.x, depth * ray.y, depth }, other_point[3], other_pixel[2];
+                        rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
+                        rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
+                        const int other_x0 = static_cast<int>(other_pixel[0] + 0.5f);
+                        const int other_y0 = static_cast<int>(other_pixel[1] + 0.5f);
+
+                        // Map the bottom-right corner of the depth pixel onto the other image
+                        ray = rays[depth_pixel_index * 2 + 1];
+                        depth_point[0] = depth * ray.x; depth_point[1] = depth * ray.y;
+                        rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
+                        rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
+                        const int other_x1 = static_cast<int>(other_pixel[0] + 0.5f);
+                        const int other_y1 = static_cast<int>(other_pixel[1] + 0.5f);
+
+                        if (other_x0 < 0 || other_y0 < 0 || other_x1 >= other_intrin.width || other_y1 >= other_intrin.height)
+                            continue;
+
+                        rect = { other_x0, other_y0, other_x1, other_y1 };
                     }
                 }
             }
-        }
+        });
     }
 
     align::align(rs2_stream to_stream) : align(to_stream, "Align")
     {}
 
+    const float2* align::get_depth_rays(const rs2_intrinsics& depth_intrin)
+    {
+        // The rays depend only on the depth intrinsics, so they are reused across frames and align directions
+        if (!_depth_rays.empty() && !memcmp(&_depth_rays_intrin, &depth_intrin, sizeof(depth_intrin)))
+            return _depth_rays.data();
+
+        _depth_rays_intrin = depth_intrin;
+        _depth_rays.resize(size_t(depth_intrin.width) * depth_intrin.height * 2);
+        auto rays = _depth_rays.data();
+
+        // Deprojecting at unit depth gives the same ray coordinates that rs2_deproject_pixel_to_point scales by the depth
+        thread_pool::shared().parallel_for(depth_intrin.height, rows_per_task, [&](size_t first_row, size_t last_row)
+        {
+            for (int y = int(first_row); y < int(last_row); ++y)
+            {
+                for (int x = 0; x < depth_intrin.width; ++x)
+                {
+                    auto ray = rays + (y * depth_intrin.width + x) * 2;
+                    const float corners[2][2] = { { x - 0.5f, y - 0.5f }, { x + 0.5f, y + 0.5f } };
+                    for (int c = 0; c < 2; ++c)
+                    {
+                        float point[3];
+                        rs2_deproject_pixel_to_point(point, &depth_intrin, corners[c], 1.f);
+                        ray[c] = { point[0], point[1] };
+                    }
+                }
+            }
+        });
+        return rays;
+    }
+
     void align::align_z_to_other(rs2::video_frame& aligned, 
         const rs2::video_frame& depth, const rs2::video_stream_profile& other_profile, float z_scale)
     {
@@ -80,44 +112,63 @@ namespace librealsense
         auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
         auto out_z = (uint16_t *)(aligned_data);
 
-        align_images(z_intrin, z_to_other, other_intrin,
-            [z_pixels, z_scale](int z_pixel_index) { return z_scale * z_pixels[z_pixel_index]; },
-            [out_z, z_pixels](int z_pixel_index, int other_pixel_index)
+        _pixel_rects.resize(size_t(z_intrin.width) * z_intrin.height);
+        map_depth_pixels(z_intrin, z_to_other, other_intrin, get_depth_rays(z_intrin),
+            [z_pixels, z_scale](int z_pixel_index) { return z_scale * z_pixels[z_pixel_index]; }, _pixel_rects.data());
+
+        // Several depth pixels may cover the same pixel of the other image, so the nearest one is kept sequentially
+        for (size_t z_pixel_index = 0; z_pixel_index < _pixel_rects.size(); ++z_pixel_index)
         {
-            out_z[other_pixel_index] = out_z[other_pixel_index] ?
-                std::min((int)out_z[other_pixel_index], (int)z_pixels[z_pixel_index]) :
-                z_pixels[z_pixel_index];
-        });
+            auto& rect = _pixel_rects[z_pixel_index];
+            for (int y = rect.y0; y <= rect.y1; ++y)
+            {
+                for (int x = rect.x0; x <= rect.x1; ++x)
+                {
+                    auto other_pixel_index = y * other_intrin.width + x;
+                    out_z[other_pixel_index] = out_z[other_pixel_index] ?
+                        std::min((int)out_z[other_pixel_index], (int)z_pixels[z_pixel_index]) :
+                        z_pixels[z_pixel_index];
+                }
+            }
+        }
     }
 
-    template<int N, class GET_DEPTH>
-    void align_other_to_depth_bytes(byte* other_aligned_to_depth, GET_DEPTH get_depth, const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other, const rs2_intrinsics& other_intrin, const byte* other_pixels)
+    template<int N>
+    void align_other_to_depth_bytes(byte* other_aligned_to_depth, const align::pixel_rect* rects, const rs2_intrinsics& depth_intrin, const rs2_intrinsics& other_intrin, const byte* other_pixels)
     {
         auto in_other = (const bytes<N> *)(other_pixels);
         auto out_other = (bytes<N> *)(other_aligned_to_depth);
-        align_images(depth_intrin, depth_to_other, other_intrin, get_depth,
-            [out_other, in_other](int depth_pixel_index, int other_pixel_index) { out_other[depth_pixel_index] = in_other[other_pixel_index]; });
+
+        // Each depth pixel takes the last (bottom-right) pixel of the rectangle it covers, so rows are independent
+        thread_pool::shared().parallel_for(depth_intrin.height, align::rows_per_task, [&](size_t first_row, size_t last_row)
+        {
+            for (auto depth_pixel_index = first_row * depth_intrin.width; depth_pixel_index < last_row * depth_intrin.width; ++depth_pixel_index)
+            {
+                auto& rect = rects[depth_pixel_index];
+                if (rect.x0 <= rect.x1 && rect.y0 <= rect.y1)
+                    out_other[depth_pixel_index] = in_other[rect.y1 * other_intrin.width + rect.x1];
+            }
+        });
     }
 
-    template<class GET_DEPTH>
-    void align_other_to_depth(byte* other_aligned_to_depth, GET_DEPTH get_depth, const rs2_intrinsics& depth_intrin, const rs2_extrinsics & depth_to_other, const rs2_intrinsics& other_intrin, const byte* other_pixels, rs2_format other_format)
+    void align_other_to_depth(byte* other_aligned_to_depth, const align::pixel_rect* rects, const rs2_intrinsics& depth_intrin, const rs2_intrinsics& other_intrin, const byte* other_pixels, rs2_format other_format)
     {
         switch (other_format)
         {
         case RS2_FORMAT_Y8:
-            align_other_to_depth_bytes<1>(other_aligned_to_depth, get_depth, depth_intrin, depth_to_other, other_intrin, other_pixels);
+            align_other_to_depth_bytes<1>(other_aligned_to_depth, rects, depth_intrin, other_intrin, other_pixels);
             break;
         case RS2_FORMAT_Y16:
         case RS2_FORMAT_Z16:
-            align_other_to_depth_bytes<2>(other_aligned_to_depth, get_depth, depth_intrin, depth_to_other, other_intrin, other_pixels);
+            align_other_to_depth_bytes<2>(other_aligned_to_depth, rects, depth_intrin, other_intrin, other_pixels);
             break;
         case RS2_FORMAT_RGB8:
         case RS2_FORMAT_BGR8:
-            align_other_to_depth_bytes<3>(other_aligned_to_depth, get_depth, depth_intrin, depth_to_other, other_intrin, other_pixels);
+            align_other_to_depth_bytes<3>(other_aligned_to_depth, rects, depth_intrin, other_intrin, other_pixels);
             break;
         case RS2_FORMAT_RGBA8:
         case RS2_FORMAT_BGRA8:
-            align_other_to_depth_bytes<4>(other_aligned_to_depth, get_depth, depth_intrin, depth_to_other, other_intrin, other_pixels);
+            align_other_to_depth_bytes<4>(other_aligned_to_depth, rects, depth_intrin, other_intrin, other_pixels);
             break;
         default:
             assert(false); // NOTE: rs2_align_other_to_depth_bytes<2>(...) is not appropriate for RS2_FORMAT_YUYV/RS2_FORMAT_RAW10 images, no logic prevents U/V channels from being written to one another
@@ -140,8 +191,11 @@ namespace librealsense
         auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
         auto other_pixels = reinterpret_cast<const byte*>(other.get_data());
 
-        align_other_to_depth(aligned_data, [z_pixels, z_scale](int z_pixel_index) { return z_scale * z_pixels[z_pixel_index]; },
-            z_intrin, z_to_other, other_intrin, other_pixels, other_profile.format());
+        _pixel_rects.resize(size_t(z_intrin.width) * z_intrin.height);
+        map_depth_pixels(z_intrin, z_to_other, other_intrin, get_depth_rays(z_intrin),
+            [z_pixels, z_scale](int z_pixel_index) { return z_scale * z_pixels[z_pixel_index]; }, _pixel_rects.data());
+
+        align_other_to_depth(aligned_data, _pixel_rects.data(), z_intrin, other_intrin, other_pixels, other_profile.format());
     }
 
     std::shared_ptr<rs2::video_stream_profile> align::create_aligned_profile(
@@ -17,6 +17,11 @@ namespace librealsense
     public:
         align(rs2_stream to_stream);
 
+        // The rectangle of pixels of the other image covered by a depth pixel; empty when x0 > x1
+        struct pixel_rect { int x0, y0, x1, y1; };
+
+        static const size_t rows_per_task = 8;
+
     protected:
         align(rs2_stream to_stream, const char* name)
             : generic_processing_block(name), 
@@ -44,12 +49,19 @@ namespace librealsense
             rs2::video_stream_profile& original_profile,
             rs2::video_stream_profile& to_profile);
 
+        // Unit-depth rays through the top-left and bottom-right corners of each depth pixel, interleaved
+        const float2* get_depth_rays(const rs2_intrinsics& depth_intrin);
+
         rs2_stream _to_stream_type;
         std::map<std::pair<stream_profile_interface*, stream_profile_interface*>, std::shared_ptr<rs2::video_stream_profile>> _align_stream_unique_ids;
         rs2::stream_profile _source_stream_profile;
         float _depth_scale;
 
     private:
+        std::vector<float2> _depth_rays;
+        rs2_intrinsics _depth_rays_intrin;
+        std::vector<pixel_rect> _pixel_rects;
+
         rs2::video_frame allocate_aligned_frame(const rs2::frame_source& source, const rs2::video_frame& from, const rs2::video_frame& to);
         void align_frames(rs2::video_frame& aligned, const rs2::video_frame& from, const rs2::video_frame& to);
     };
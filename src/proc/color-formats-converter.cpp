@@ -27,19 +27,32 @@ bool has_avx() { return false; }
 #ifdef _WIN32
 #include <intrin.h>
 #define cpuid(info, x)    __cpuidex(info, x, 0)
+#define xgetbv0()         _xgetbv(0)
 #else
 #include <cpuid.h>
 void cpuid(int info[4], int info_type) {
     __cpuid_count(info_type, 0, info[0], info[1], info[2], info[3]);
 }
+unsigned long long xgetbv0() {
+    unsigned int eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (unsigned long long)edx << 32 | eax;
+}
 #endif
 
 bool has_avx()
 {
+    // AVX2 is usable when the CPU supports it (leaf 7) and the OS saves the YMM registers (OSXSAVE, XCR0)
     int info[4];
     cpuid(info, 0);
-    cpuid(info, 0x80000000);
-    return (info[2] & ((int)1 << 28)) != 0;
+    if (info[0] < 7)
+        return false;
+    cpuid(info, 1);
+    const int osxsave_avx = ((int)1 << 27) | ((int)1 << 28);
+    if ((info[2] & osxsave_avx) != osxsave_avx || (xgetbv0() & 0x6) != 0x6)
+        return false;
+    cpuid(info, 7);
+    return (info[1] & ((int)1 << 5)) != 0;
 }
 
 #endif
@@ -10,6 +10,8 @@
 #include "option.h"
 #include "colorizer.h"
 #include "disparity-transform.h"
+#include "proc/sse/sse-colorizer.h"
+#include "image-avx.h"
 
 namespace librealsense
 {
@@ -185,6 +187,7 @@ namespace librealsense
 
         preset_opt->on_set([this](float val)
         {
+            _frames_since_histogram_update = 0;
             if (fabs(val - 0.f) < 1e-6)
             {
                 // Dynamic
@@ -219,7 +222,19 @@ namespace librealsense
         register_option(RS2_OPTION_VISUAL_PRESET, preset_opt);
 
         auto hist_opt = std::make_shared<ptr_option<bool>>(false, true, true, true, &_equalize, "Perform histogram equalization");
+        hist_opt->on_set([this](float val)
+        {
+            _frames_since_histogram_update = 0;
+        });
         register_option(RS2_OPTION_HISTOGRAM_EQUALIZATION_ENABLED, hist_opt);
+
+        auto hist_interval_opt = std::make_shared<ptr_option<int>>(1, 300, 1, default_histogram_update_interval, &_histogram_update_interval,
+            "Number of frames between updates of the equalization histogram");
+        hist_interval_opt->on_set([this](float val)
+        {
+            _frames_since_histogram_update = 0;
+        });
+        register_option(RS2_OPTION_HISTOGRAM_UPDATE_INTERVAL, hist_interval_opt);
     }
 
     bool colorizer::should_process(const rs2::frame& frame)
@@ -233,6 +248,55 @@ namespace librealsense
         return true;
     }
 
+    bool colorizer::histogram_update_due(const rs2::frame& f)
+    {
+        auto profile = f.get_profile().get();
+        if (profile != _histogram_profile || !_frames_since_histogram_update ||
+            _frames_since_histogram_update >= _histogram_update_interval)
+        {
+            _histogram_profile = profile;
+            _frames_since_histogram_update = 1;
+            return true;
+        }
+
+        ++_frames_since_histogram_update;
+        return false;
+    }
+
+    void colorizer::make_rgb_data_z16(const uint16_t* depth_data, uint8_t* rgb_data, int width, int height)
+    {
+        auto lut = _rgb_lut.data();
+        thread_pool::shared().parallel_for(height, rows_per_task, [&](size_t first_row, size_t last_row)
+        {
+            auto first = first_row * width;
+            auto count = (last_row - first_row) * width;
+            auto depth = depth_data + first;
+            auto rgb = rgb_data + first * 3;
+
+            for (auto i = colorize_z16_lut_simd(depth, rgb, count, lut); i < count; ++i)
+            {
+                auto c = lut[depth[i]];
+                rgb[i * 3 + 0] = uint8_t(c);
+                rgb[i * 3 + 1] = uint8_t(c >> 8);
+                rgb[i * 3 + 2] = uint8_t(c >> 16);
+            }
+        });
+    }
+
+    size_t colorizer::colorize_z16_lut_simd(const uint16_t* depth_data, uint8_t* rgb_data, size_t count, const uint32_t* lut)
+    {
+#if defined __SSSE3__ && ! defined ANDROID
+        static bool do_avx = has_avx();
+#ifdef RS2_HAVE_AVX2_KERNELS
+        if (do_avx)
+            return colorize_z16_lut_avx2(depth_data, rgb_data, count, lut);
+#endif
+        return colorize_z16_lut_sse(depth_data, rgb_data, count, lut);
+#else
+        return 0;
+#endif
+    }
+
     rs2::frame colorizer::process_frame(const rs2::frame_source& source, const rs2::frame& f)
     {
         if (f.get_profile().get() != _source_stream_profile.get())
@@ -267,6 +331,7 @@ namespace librealsense
         auto make_equalized_histogram = [this](const rs2::video_frame& depth, rs2::video_frame rgb)
         {
             auto depth_format = depth.get_profile().format();
+            auto update_histogram_now = histogram_update_due(depth);
             const auto w = depth.get_width(), h = depth.get_height();
             auto rgb_data = reinterpret_cast<uint8_t*>(const_cast<void *>(rgb.get_data()));
             auto coloring_function = [&, this](float data) {
@@ -278,14 +343,20 @@ namespace librealsense
             if (depth_format == RS2_FORMAT_DISPARITY32)
             {
                 auto depth_data = reinterpret_cast<const float*>(depth.get_data());
-                update_histogram(_hist_data, depth_data, w, h);
+                if (update_histogram_now)
+                    update_histogram(_hist_data, depth_data, w, h);
                 make_rgb_data<float>(depth_data, rgb_data, w, h, coloring_function);
             }
             else if (depth_format == RS2_FORMAT_Z16)
             {
                 auto depth_data = reinterpret_cast<const uint16_t*>(depth.get_data());
-                update_histogram(_hist_data, depth_data, w, h);
-                make_rgb_data<uint16_t>(depth_data, rgb_data, w, h, coloring_function);
+                if (update_histogram_now)
+                {
+                    update_histogram(_hist_data, depth_data, w, h);
+                    _rgb_lut_valid = false;
+                }
+                update_rgb_lut(coloring_function);
+                make_rgb_data_z16(depth_data, rgb_data, w, h);
             }
         };
 
@@ -318,7 +389,8 @@ namespace librealsense
                     if (min >= max) return 0.f;
                     return (data * _depth_units - min) / (max - min);
                 };
-                make_rgb_data<uint16_t>(depth_data, rgb_data, w, h, coloring_function);
+                update_rgb_lut(coloring_function);
+                make_rgb_data_z16(depth_data, rgb_data, w, h);
             }
         };
 
@@ -5,6 +5,8 @@
 
 #include <map>
 #include <vector>
+#include <cstring>
+#include "../concurrency.h"
 
 namespace rs2
 {
@@ -103,12 +105,37 @@ namespace librealsense {
         template<typename T>
         static void update_histogram(int* hist, const T* depth_data, int w, int h)
         {
+            // Larger frames are split between the workers, each counting into a partial histogram of its own
+            const size_t count = size_t(w) * h;
+            auto& pool = thread_pool::shared();
+            auto parts = std::min(pool.get_num_workers() + 1, count / min_pixels_per_histogram_part);
+
             memset(hist, 0, MAX_DEPTH * sizeof(int));
-            for (auto i = 0; i < w*h; ++i)
+            if (parts <= 1)
             {
-                T depth_val = depth_data[i];
-                int index = static_cast< int >( depth_val );
-                hist[index] += 1;
+                count_histogram(hist, depth_data, 0, count);
+            }
+            else
+            {
+                std::vector<int> partials((parts - 1) * MAX_DEPTH, 0);
+                auto part_size = (count + parts - 1) / parts;
+                pool.parallel_for(parts, 1, [&](size_t first, size_t last)
+                {
+                    for (auto part = first; part < last; ++part)
+                    {
+                        auto part_hist = part ? partials.data() + (part - 1) * MAX_DEPTH : hist;
+                        count_histogram(part_hist, depth_data, part * part_size, std::min(count, (part + 1) * part_size));
+                    }
+                });
+                pool.parallel_for(MAX_DEPTH, histogram_merge_grain, [&](size_t first, size_t last)
+                {
+                    for (size_t part = 1; part < parts; ++part)
+                    {
+                        auto part_hist = partials.data() + (part - 1) * MAX_DEPTH;
+                        for (auto i = first; i < last; ++i)
+                            hist[i] += part_hist[i];
+                    }
+                });
             }
 
             for (auto i = 2; i < MAX_DEPTH; ++i) hist[i] += hist[i - 1]; // Build a cumulative histogram for the indices in [1,0xFFFF]
@@ -117,23 +144,80 @@ namespace librealsense {
         static const int MAX_DEPTH = 0x10000;
         static const int MAX_DISPARITY = 0x2710;
 
+    private:
+        static const size_t rows_per_task = 16;
+        static const size_t lut_entries_per_task = 0x1000;
+        static const size_t histogram_merge_grain = 0x1000;
+        static const size_t min_pixels_per_histogram_part = 0x10000;
+        // Equalized depth rebuilds the histogram, and for Z16 the color table, on every histogram update;
+        // by default on every frame. A longer interval lets the frames in between only look up the table.
+        static const int default_histogram_update_interval = 1;
+
     protected:
         colorizer(const char* name);
 
         bool should_process(const rs2::frame& frame) override;
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
 
+        // Returns true when the equalization histogram should be recomputed for this frame:
+        // on every histogram update interval, and whenever the stream changed or equalization was re-enabled
+        bool histogram_update_due(const rs2::frame& f);
+
+        template<typename T>
+        static void count_histogram(int* hist, const T* depth_data, size_t first, size_t last)
+        {
+            for (auto i = first; i < last; ++i)
+            {
+                T depth_val = depth_data[i];
+                int index = static_cast< int >( depth_val );
+                hist[index] += 1;
+            }
+        }
+
         template<typename T, typename F>
         void make_rgb_data(const T* depth_data, uint8_t* rgb_data, int width, int height, F coloring_func)
         {
             auto cm = _maps[_map_index];
-            for (auto i = 0; i < width*height; ++i)
+            thread_pool::shared().parallel_for(height, rows_per_task, [&](size_t first_row, size_t last_row)
             {
-                auto d = depth_data[i];
-                colorize_pixel(rgb_data, i, cm, d, coloring_func);
-            }
+                for (auto i = int(first_row * width); i < int(last_row * width); ++i)
+                {
+                    auto d = depth_data[i];
+                    colorize_pixel(rgb_data, i, cm, d, coloring_func);
+                }
+            });
+        }
+
+        // Z16 depth takes only 0x10000 values, so it is colorized through a table of the RGB color of each value.
+        // The table is rebuilt only when the coloring changes: a new histogram, color map or range.
+        template<typename F>
+        void update_rgb_lut(F coloring_func)
+        {
+            rgb_lut_key key{ _equalize, _map_index, _min, _max, _depth_units };
+            if (_rgb_lut_valid && key == _rgb_lut_key)
+                return;
+
+            auto cm = _maps[_map_index];
+            _rgb_lut.resize(MAX_DEPTH);
+            auto lut = _rgb_lut.data();
+            lut[0] = 0;
+            thread_pool::shared().parallel_for(MAX_DEPTH - 1, lut_entries_per_task, [&](size_t first, size_t last)
+            {
+                for (auto i = first + 1; i < last + 1; ++i)
+                {
+                    uint8_t rgb[3];
+                    colorize_pixel(rgb, 0, cm, uint16_t(i), coloring_func);
+                    lut[i] = rgb[0] | (rgb[1] << 8) | (rgb[2] << 16);
+                }
+            });
+
+            _rgb_lut_key = key;
+            _rgb_lut_valid = true;
         }
 
+        void make_rgb_data_z16(const uint16_t* depth_data, uint8_t* rgb_data, int width, int height);
+        static size_t colorize_z16_lut_simd(const uint16_t* depth_data, uint8_t* rgb_data, size_t count, const uint32_t* lut);
+
         template<typename T, typename F>
         void colorize_pixel(uint8_t* rgb_data, int idx, color_map* cm, T data, F coloring_func)
         {
@@ -161,6 +245,25 @@ namespace librealsense {
 
         std::vector<int> _histogram;
         int* _hist_data;
+        int _histogram_update_interval = default_histogram_update_interval;
+        int _frames_since_histogram_update = 0;
+        const rs2_stream_profile* _histogram_profile = nullptr;
+
+        struct rgb_lut_key
+        {
+            bool equalize;
+            int map_index;
+            float min, max, depth_units;
+
+            bool operator==(const rgb_lut_key& other) const
+            {
+                return equalize == other.equalize && map_index == other.map_index &&
+                    min == other.min && max == other.max && depth_units == other.depth_units;
+            }
+        };
+        std::vector<uint32_t> _rgb_lut;
+        rgb_lut_key _rgb_lut_key;
+        bool _rgb_lut_valid = false;
 
         int _preset = 0;
         rs2::stream_profile _target_stream_profile;
@@ -16,5 +16,6 @@ namespace librealsense
             const rs2_intrinsics &depth_intrinsics,
             const rs2::depth_frame& depth_frame,
             float depth_scale) override;
+        bool tiled_processing() const override { return false; }
     };
 }
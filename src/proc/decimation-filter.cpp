@@ -12,6 +12,9 @@
 #include "core/video.h"
 #include "proc/synthetic-stream.h"
 #include "proc/decimation-filter.h"
+#include "proc/sse/sse-decimation-filter.h"
+#include "image-avx.h"
+#include "../concurrency.h"
 
 
 #define PIX_SORT(a,b) { if ((a)>(b)) PIX_SWAP((a),(b)); }
@@ -357,136 +360,186 @@ namespace librealsense
     void decimation_filter::decimate_depth(const uint16_t * frame_data_in, uint16_t * frame_data_out,
         size_t width_in, size_t height_in, size_t scale)
     {
-        // Use median filtering
-        std::vector<uint16_t> working_kernel(_kernel_size);
-        auto wk_begin = working_kernel.data();
-        auto wk_itr = wk_begin;
-        std::vector<uint16_t*> pixel_raws(scale);
-        uint16_t* block_start = const_cast<uint16_t*>(frame_data_in);
+        // Each output row depends only on its own band of input rows, so bands of rows are decimated
+        // on the shared worker pool
+        thread_pool::shared().parallel_for(_real_height, rows_per_task, [&](size_t first_row, size_t last_row)
+        {
+            for (size_t j = first_row; j < last_row; j++)
+                decimate_depth_row(frame_data_in + j * scale * width_in, frame_data_out + j * _padded_width, width_in, scale);
+        });
+
+        // Fill-in the padded rows with zeros
+        std::fill(frame_data_out + _real_height * _padded_width, frame_data_out + _padded_height * _padded_width, uint16_t(0));
+    }
+
+    void decimation_filter::decimate_depth_row(const uint16_t * block_start, uint16_t * frame_data_out,
+        size_t width_in, size_t scale)
+    {
+        const uint16_t *p{};
 
         if (scale == 2 || scale == 3)
         {
-            for (int j = 0; j < _real_height; j++)
-            {
-                uint16_t *p{};
-                // Mark the beginning of each of the N lines that the filter will run upon
-                for (size_t i = 0; i < pixel_raws.size(); i++)
-                    pixel_raws[i] = block_start + (width_in*i);
+            // Use median filtering
+            uint16_t working_kernel[9];
+            auto wk_begin = working_kernel;
+            auto wk_itr = wk_begin;
 
-                for (size_t i = 0, chunk_offset = 0; i < _real_width; i++)
+            for (size_t i = decimate_depth_median_simd(block_start, frame_data_out, width_in, scale); i < _real_width; i++)
+            {
+                wk_itr = wk_begin;
+                // extract data the kernel to process
+                for (size_t n = 0; n < scale; ++n)
                 {
-                    wk_itr = wk_begin;
-                    // extract data the kernel to process
-                    for (size_t n = 0; n < scale; ++n)
-                    {
-                        p = pixel_raws[n] + chunk_offset;
-                        for (size_t m = 0; m < scale; ++m)
-                        {
-                            if (*(p + m))
-                                *wk_itr++ = *(p + m);
-                        }
-                    }
-
-                    // For even-size kernels pick the member one below the middle
-                    auto ks = (int)(wk_itr - wk_begin);
-                    if (ks == 0)
-                        *frame_data_out++ = 0;
-                    else
+                    p = block_start + width_in * n + i * scale;
+                    for (size_t m = 0; m < scale; ++m)
                     {
-                        switch (ks)
-                        {
-                        case 1:
-                            *frame_data_out++ = working_kernel[0];
-                            break;
-                        case 2:
-                            *frame_data_out++ = PIX_MIN(working_kernel[0], working_kernel[1]);
-                            break;
-                        case 3:
-                            *frame_data_out++ = opt_med3<uint16_t>(working_kernel.data());
-                            break;
-                        case 4:
-                            *frame_data_out++ = opt_med4<uint16_t>(working_kernel.data());
-                            break;
-                        case 5:
-                            *frame_data_out++ = opt_med5<uint16_t>(working_kernel.data());
-                            break;
-                        case 6:
-                            *frame_data_out++ = opt_med6<uint16_t>(working_kernel.data());
-                            break;
-                        case 7:
-                            *frame_data_out++ = opt_med7<uint16_t>(working_kernel.data());
-                            break;
-                        case 8:
-                            *frame_data_out++ = opt_med8<uint16_t>(working_kernel.data());
-                            break;
-                        case 9:
-                            *frame_data_out++ = opt_med9<uint16_t>(working_kernel.data());
-                            break;
-                        }
+                        if (*(p + m))
+                            *wk_itr++ = *(p + m);
                     }
-
-                    chunk_offset += scale;
                 }
 
-                // Fill-in the padded colums with zeros
-                for (int j = _real_width; j < _padded_width; j++)
-                    *frame_data_out++ = 0;
-
-                // Skip N lines to the beginnig of the next processing segment
-                block_start += width_in * scale;
+                // For even-size kernels pick the member one below the middle
+                auto ks = (int)(wk_itr - wk_begin);
+                uint16_t & out = frame_data_out[i];
+                switch (ks)
+                {
+                case 0:
+                    out = 0;
+                    break;
+                case 1:
+                    out = working_kernel[0];
+                    break;
+                case 2:
+                    out = PIX_MIN(working_kernel[0], working_kernel[1]);
+                    break;
+                case 3:
+                    out = opt_med3<uint16_t>(working_kernel);
+                    break;
+                case 4:
+                    out = opt_med4<uint16_t>(working_kernel);
+                    break;
+                case 5:
+                    out = opt_med5<uint16_t>(working_kernel);
+                    break;
+                case 6:
+                    out = opt_med6<uint16_t>(working_kernel);
+                    break;
+                case 7:
+                    out = opt_med7<uint16_t>(working_kernel);
+                    break;
+                case 8:
+                    out = opt_med8<uint16_t>(working_kernel);
+                    break;
+                case 9:
+                    out = opt_med9<uint16_t>(working_kernel);
+                    break;
+                }
             }
         }
         else
         {
-            for (int j = 0; j < _real_height; j++)
+            // Use the mean of the valid pixels
+            for (size_t i = 0; i < _real_width; i++)
             {
-                uint16_t *p{};
-                // Mark the beginning of each of the N lines that the filter will run upon
-                for (size_t i = 0; i < pixel_raws.size(); i++)
-                    pixel_raws[i] = block_start + (width_in*i);
+                int sum = 0;
+                int counter = 0;
 
-                for (size_t i = 0, chunk_offset = 0; i < _real_width; i++)
+                // extract data the kernel to process
+                for (size_t n = 0; n < scale; ++n)
                 {
-                    int sum = 0;
-                    int counter = 0;
-
-                    // extract data the kernel to process
-                    for (size_t n = 0; n < scale; ++n)
+                    p = block_start + width_in * n + i * scale;
+                    for (size_t m = 0; m < scale; ++m)
                     {
-                        p = pixel_raws[n] + chunk_offset;
-                        for (size_t m = 0; m < scale; ++m)
+                        if (*(p + m))
                         {
-                            if (*(p + m))
-                            {
-                                sum += p[m];
-                                ++counter;
-                            }
+                            sum += p[m];
+                            ++counter;
                         }
                     }
-
-                    *frame_data_out++ = (counter == 0 ? 0 : sum / counter);
-                    chunk_offset += scale;
                 }
 
-                // Fill-in the padded colums with zeros
-                for (int j = _real_width; j < _padded_width; j++)
-                    *frame_data_out++ = 0;
-
-                // Skip N lines to the beginnig of the next processing segment
-                block_start += width_in * scale;
+                frame_data_out[i] = (counter == 0 ? 0 : sum / counter);
             }
         }
 
-        // Fill-in the padded rows with zeros
-        for (auto v = _real_height; v < _padded_height; ++v)
+        // Fill-in the padded colums with zeros
+        std::fill(frame_data_out + _real_width, frame_data_out + _padded_width, uint16_t(0));
+    }
+
+    size_t decimation_filter::decimate_depth_median_simd(const uint16_t * block_start, uint16_t * frame_data_out,
+        size_t width_in, size_t scale)
+    {
+#if defined __SSSE3__ && ! defined ANDROID
+        static bool do_avx = has_avx();
+
+        if (scale == 2)
         {
-            for (auto u = 0; u < _padded_width; ++u)
-                *frame_data_out++ = 0;
+#ifdef RS2_HAVE_AVX2_KERNELS
+            if (do_avx)
+            {
+                auto done = decimate_median_2x2_z16_avx2(block_start, width_in, frame_data_out, _real_width);
+                return done + decimate_median_2x2_z16_sse(block_start + done * 2, width_in, frame_data_out + done, _real_width - done);
+            }
+#endif
+            return decimate_median_2x2_z16_sse(block_start, width_in, frame_data_out, _real_width);
+        }
+        else
+        {
+#ifdef RS2_HAVE_AVX2_KERNELS
+            if (do_avx)
+            {
+                auto done = decimate_median_3x3_z16_avx2(block_start, width_in, frame_data_out, _real_width);
+                return done + decimate_median_3x3_z16_sse(block_start + done * 3, width_in, frame_data_out + done, _real_width - done);
+            }
+#endif
+            return decimate_median_3x3_z16_sse(block_start, width_in, frame_data_out, _real_width);
         }
+#else
+        return 0;
+#endif
     }
 
     void decimation_filter::decimate_others(rs2_format format, const void * frame_data_in, void * frame_data_out,
         size_t width_in, size_t height_in, size_t scale)
+    {
+        size_t bpp = 0;
+        switch (format)
+        {
+        case RS2_FORMAT_Y8:
+            bpp = 1;
+            break;
+        case RS2_FORMAT_YUYV:
+        case RS2_FORMAT_UYVY:
+        case RS2_FORMAT_Y16:
+            bpp = 2;
+            break;
+        case RS2_FORMAT_RGB8:
+        case RS2_FORMAT_BGR8:
+            bpp = 3;
+            break;
+        case RS2_FORMAT_RGBA8:
+        case RS2_FORMAT_BGRA8:
+            bpp = 4;
+            break;
+        default:
+            return;
+        }
+        const size_t row_size = _padded_width * bpp;
+
+        // Each output row depends only on its own band of input rows, so bands of rows are decimated
+        // on the shared worker pool
+        thread_pool::shared().parallel_for(_real_height, rows_per_task, [&](size_t first_row, size_t last_row)
+        {
+            decimate_others_rows(format, frame_data_in, static_cast<uint8_t*>(frame_data_out), width_in, scale,
+                first_row, last_row, row_size);
+        });
+
+        // Fill-in the padded rows with zeros
+        memset(static_cast<uint8_t*>(frame_data_out) + _real_height * row_size, 0, (_padded_height - _real_height) * row_size);
+    }
+
+    void decimation_filter::decimate_others_rows(rs2_format format, const void * frame_data_in, uint8_t * frame_data_out,
+        size_t width_in, size_t scale, size_t first_row, size_t last_row, size_t row_size)
     {
         int sum = 0;
         auto patch_size = scale * scale;
@@ -497,15 +550,16 @@ namespace librealsense
         {
             uint8_t* from = (uint8_t*)frame_data_in;
             uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;
+            uint8_t* q = nullptr;
 
             auto w_2 = width_in >> 1;
             auto rw_2 = _real_width >> 1;
             auto pw_2 = _padded_width >> 1;
             auto s2 = scale >> 1;
             bool odd = (scale & 1);
-            for (int j = 0; j < _real_height; ++j)
+            for (size_t j = first_row; j < last_row; ++j)
             {
+                q = frame_data_out + j * row_size;
                 for (int i = 0; i < rw_2; ++i)
                 {
                     p = from + scale * (j * w_2 + i) * 4;
@@ -567,15 +621,6 @@ namespace librealsense
                     *q++ = 0;
                 }
             }
-
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
         }
         break;
 
@@ -583,15 +628,16 @@ namespace librealsense
         {
             uint8_t* from = (uint8_t*)frame_data_in;
             uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;
+            uint8_t* q = nullptr;
 
             auto w_2 = width_in >> 1;
             auto rw_2 = _real_width >> 1;
             auto pw_2 = _padded_width >> 1;
             auto s2 = scale >> 1;
             bool odd = (scale & 1);
-            for (int j = 0; j < _real_height; ++j)
+            for (size_t j = first_row; j < last_row; ++j)
             {
+                q = frame_data_out + j * row_size;
                 for (int i = 0; i < rw_2; ++i)
                 {
                     p = from + scale * (j * w_2 + i) * 4;
@@ -653,15 +699,6 @@ namespace librealsense
                     *q++ = 0;
                 }
             }
-
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
         }
         break;
 
@@ -670,10 +707,11 @@ namespace librealsense
         {
             uint8_t* from = (uint8_t*)frame_data_in;
             uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;;
+            uint8_t* q = nullptr;
 
-            for (int j = 0; j < _real_height; ++j)
+            for (size_t j = first_row; j < last_row; ++j)
             {
+                q = frame_data_out + j * row_size;
                 for (int i = 0; i < _real_width; ++i)
                 {
                     for (int k = 0; k < 3; ++k)
@@ -699,16 +737,6 @@ namespace librealsense
                     *q++ = 0;
                 }
             }
-
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
         }
         break;
 
@@ -717,10 +745,11 @@ namespace librealsense
         {
             uint8_t* from = (uint8_t*)frame_data_in;
             uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;
+            uint8_t* q = nullptr;
 
-            for (int j = 0; j < _real_height; ++j)
+            for (size_t j = first_row; j < last_row; ++j)
             {
+                q = frame_data_out + j * row_size;
                 for (int i = 0; i < _real_width; ++i)
                 {
                     for (int k = 0; k < 4; ++k)
@@ -747,17 +776,6 @@ namespace librealsense
                     *q++ = 0;
                 }
             }
-
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
         }
         break;
 
@@ -765,10 +783,11 @@ namespace librealsense
         {
             uint8_t* from = (uint8_t*)frame_data_in;
             uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;
+            uint8_t* q = nullptr;
 
-            for (int j = 0; j < _real_height; ++j)
+            for (size_t j = first_row; j < last_row; ++j)
             {
+                q = frame_data_out + j * row_size;
                 for (int i = 0; i < _real_width; ++i)
                 {
                     p = from + scale * (j * width_in + i);
@@ -787,12 +806,6 @@ namespace librealsense
                 for (int i = _real_width; i < _padded_width; ++i)
                     *q++ = 0;
             }
-
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                    *q++ = 0;
-            }
         }
         break;
 
@@ -800,10 +813,11 @@ namespace librealsense
         {
             uint16_t* from = (uint16_t*)frame_data_in;
             uint16_t* p = nullptr;
-            uint16_t* q = (uint16_t*)frame_data_out;
+            uint16_t* q = nullptr;
 
-            for (int j = 0; j < _real_height; ++j)
+            for (size_t j = first_row; j < last_row; ++j)
             {
+                q = reinterpret_cast<uint16_t*>(frame_data_out + j * row_size);
                 for (int i = 0; i < _real_width; ++i)
                 {
                     p = from + scale * (j * width_in + i);
@@ -822,12 +836,6 @@ namespace librealsense
                 for (int i = _real_width; i < _padded_width; ++i)
                     *q++ = 0;
             }
-
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                    *q++ = 0;
-            }
         }
         break;
 
@@ -28,6 +28,16 @@ namespace librealsense
     private:
         void    update_output_profile(const rs2::frame& f);
 
+        // Decimate a single output row / the output rows in [first_row, last_row)
+        void decimate_depth_row(const uint16_t * block_start, uint16_t * frame_data_out, size_t width_in, size_t scale);
+        void decimate_others_rows(rs2_format format, const void * frame_data_in, uint8_t * frame_data_out,
+            size_t width_in, size_t scale, size_t first_row, size_t last_row, size_t row_size);
+
+        // Median of 2x2/3x3 blocks of the row, vectorized; returns the number of output pixels done
+        size_t decimate_depth_median_simd(const uint16_t * block_start, uint16_t * frame_data_out, size_t width_in, size_t scale);
+
+        static const size_t     rows_per_task = 8;
+
         uint8_t                 _decimation_factor;
         uint8_t                 _control_val;
         uint8_t                 _patch_size;
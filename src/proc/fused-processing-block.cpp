@@ -0,0 +1,107 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "fused-processing-block.h"
+
+namespace librealsense
+{
+    fused_processing_block::fused_processing_block()
+        : composite_processing_block("Fused Processing Block")
+    {
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (auto composite = f.as<rs2::frameset>())
+            {
+                // Each frame of the set goes through the chain; the stages skip the frames they don't handle
+                std::vector<rs2::frame> results;
+                bool processed = false;
+                for (auto sub : composite)
+                {
+                    auto res = process_chain(source, sub);
+                    processed |= (res.get() != sub.get());
+                    results.push_back(res);
+                }
+                if (processed)
+                    f = source.allocate_composite_frame(results);
+            }
+            else
+            {
+                f = process_chain(source, f);
+            }
+
+            source.frame_ready(f);
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+    }
+
+    void fused_processing_block::add(std::shared_ptr<generic_processing_block> block)
+    {
+        composite_processing_block::add(block);
+        _stages.push_back(block);
+        update_info(RS2_CAMERA_INFO_NAME, "Fused Processing Block");
+    }
+
+    void fused_processing_block::set_output_callback(frame_callback_ptr callback)
+    {
+        // The stages are run directly by this block, so only its own source publishes frames
+        processing_block::set_output_callback(callback);
+    }
+
+    void fused_processing_block::invoke(frame_holder frames)
+    {
+        processing_block::invoke(std::move(frames));
+    }
+
+    rs2::frame fused_processing_block::process_chain(const rs2::frame_source& source, rs2::frame f)
+    {
+        // Set once f was allocated within the chain, so no one outside it references the frame
+        bool owned = false;
+
+        for (auto&& stage : _stages)
+        {
+            if (!stage->can_process(f))
+                continue;
+
+            auto in_place = stage->supports_in_place();
+            if (in_place && !owned)
+            {
+                f = clone_frame(source, f);
+                owned = true;
+            }
+
+            auto res = stage->process_stage(source, f, in_place);
+            if (!res || res.get() == f.get())
+                continue;
+
+            f = res;
+            owned = true;
+        }
+        return f;
+    }
+
+    rs2::frame fused_processing_block::clone_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        auto p = f.get_profile();
+        if (p.get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = p;
+            _target_stream_profile = p.clone(p.stream_type(), p.stream_index(), p.format());
+        }
+
+        auto vf = f.as<rs2::video_frame>();
+        if (!vf)
+            throw invalid_value_exception("Fused processing block: in-place stages require video frames");
+
+        auto extension = f.is<rs2::disparity_frame>() ? RS2_EXTENSION_DISPARITY_FRAME :
+            f.is<rs2::depth_frame>() ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME;
+        auto tgt = source.allocate_video_frame(_target_stream_profile, f, vf.get_bytes_per_pixel(),
+            vf.get_width(), vf.get_height(), vf.get_stride_in_bytes(), extension);
+
+        memcpy(const_cast<void*>(tgt.get_data()), f.get_data(), vf.get_stride_in_bytes() * vf.get_height());
+        return tgt;
+    }
+}
@@ -0,0 +1,33 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Runs a sequence of filters as a single processing block, publishing one output frame.
+    // Unlike composite_processing_block, the stages do not invoke each other through their own sources:
+    // blocks that change the frame layout (decimation, disparity transform) allocate their output from
+    // this block's source, and the rest (spatial, temporal, hole filling) process that frame in place.
+    // The input frame is copied only when the first stage that applies to it works in place.
+    // Stages must not keep references to the frames they output, as later stages may modify them.
+    class LRS_EXTENSION_API fused_processing_block : public composite_processing_block
+    {
+    public:
+        fused_processing_block();
+
+        void add(std::shared_ptr<generic_processing_block> block);
+        void set_output_callback(frame_callback_ptr callback) override;
+        void invoke(frame_holder frames) override;
+
+    private:
+        rs2::frame process_chain(const rs2::frame_source& source, rs2::frame f);
+        rs2::frame clone_frame(const rs2::frame_source& source, const rs2::frame& f);
+
+        std::vector<std::shared_ptr<generic_processing_block>> _stages;
+        rs2::stream_profile _source_stream_profile;
+        rs2::stream_profile _target_stream_profile;
+    };
+}
@@ -10,6 +10,7 @@
 #include "software-device.h"
 #include "proc/synthetic-stream.h"
 #include "proc/hole-filling-filter.h"
+#include "proc/sse/sse-hole-filling.h"
 
 namespace librealsense
 {
@@ -58,14 +59,42 @@ namespace librealsense
     {
         update_configuration(f);
         auto tgt = prepare_target_frame(f, source);
+        apply_filter(f.get_data(), const_cast<void*>(tgt.get_data()));
 
+        return tgt;
+    }
+
+    void hole_filling_filter::process_frame_in_place(const rs2::frame& f)
+    {
+        update_configuration(f);
+        apply_filter(f.get_data(), const_cast<void*>(f.get_data()));
+    }
+
+    void hole_filling_filter::apply_filter(const void * input_data, void * output_data)
+    {
         // Hole filling pass
         if (_extension_type == RS2_EXTENSION_DISPARITY_FRAME)
-            apply_hole_filling<float>(const_cast<void*>(tgt.get_data()));
+            apply_hole_filling<float>(input_data, output_data);
         else
-            apply_hole_filling<uint16_t>(const_cast<void*>(tgt.get_data()));
+            apply_hole_filling<uint16_t>(input_data, output_data);
+    }
 
-        return tgt;
+    size_t hole_filling_filter::holes_fill_around_simd(const uint16_t* in, uint16_t* out, size_t width, bool farest)
+    {
+#if defined __SSSE3__ && ! defined ANDROID
+        return farest ? holes_fill_farest_z16_sse(in, out, width) : holes_fill_nearest_z16_sse(in, out, width);
+#else
+        return 1;
+#endif
+    }
+
+    size_t hole_filling_filter::holes_fill_around_simd(const float* in, float* out, size_t width, bool farest)
+    {
+#if defined __SSSE3__ && ! defined ANDROID
+        return farest ? holes_fill_farest_fp_sse(in, out, width) : holes_fill_nearest_fp_sse(in, out, width);
+#else
+        return 1;
+#endif
     }
 
     void  hole_filling_filter::update_configuration(const rs2::frame& f)
@@ -88,11 +117,8 @@ namespace librealsense
 
     rs2::frame hole_filling_filter::prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source)
     {
-        // Allocate and copy the content of the input data to the target
-        rs2::frame tgt = source.allocate_video_frame(_target_stream_profile, f, int(_bpp), int(_width), int(_height), int(_stride), _extension_type);
-
-        memmove(const_cast<void*>(tgt.get_data()), f.get_data(), _current_frm_size_pixels * _bpp);
-        return tgt;
+        // Allocate the target; the hole filling pass writes all of it from the input data
+        return source.allocate_video_frame(_target_stream_profile, f, int(_bpp), int(_width), int(_height), int(_stride), _extension_type);
     }
 
 }
@@ -3,6 +3,9 @@
 // Enhancing the input video frame by filling missing data.
 #pragma once
 
+#include <cstring>
+#include "../concurrency.h"
+
 namespace librealsense
 {
     enum holes_filling_types : uint8_t
@@ -18,29 +21,38 @@ namespace librealsense
     public:
         hole_filling_filter();
 
+        bool supports_in_place() const override { return true; }
+
     protected:
         void update_configuration(const rs2::frame& f);
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+        void process_frame_in_place(const rs2::frame& f) override;
+        void apply_filter(const void * input_data, void * output_data);
 
         rs2::frame prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source);
 
         template<typename T>
-        void apply_hole_filling(void * image_data)
+        void apply_hole_filling(const void * input_data, void * output_data)
         {
-            bool fp = (std::is_floating_point<T>::value);
-            T* data = reinterpret_cast<T*>(image_data);
+            const T* in = reinterpret_cast<const T*>(input_data);
+            T* out = reinterpret_cast<T*>(output_data);
 
-            // Select and apply the appropriate hole filling method
+            // Select and apply the appropriate hole filling method.
+            // The input is filled into the output in a single pass, and may be the same buffer.
             switch (_hole_filling_mode)
             {
             case hf_fill_from_left:
-                holes_fill_left(data, _width, _height, _stride);
+                // Each row is filled independently, so bands of rows run on the shared worker pool
+                thread_pool::shared().parallel_for(_height, rows_per_task, [&](size_t first_row, size_t last_row)
+                {
+                    holes_fill_left(in, out, _width, first_row, last_row);
+                });
                 break;
             case hf_farest_from_around:
-                holes_fill_farest(data, _width, _height, _stride);
+                holes_fill_around(in, out, _width, _height, true);
                 break;
             case hf_nearest_from_around:
-                holes_fill_nearest(data, _width, _height, _stride);
+                holes_fill_around(in, out, _width, _height, false);
                 break;
             default:
                 throw invalid_value_exception(to_string()
@@ -48,114 +60,73 @@ namespace librealsense
             }
         }
 
+        // Disparity holes are identified by their bit pattern, as in the rest of the disparity filters
+        static inline bool empty(uint16_t v) { return !v; }
+        static inline bool empty(float v)
+        {
+            int32_t bits;
+            memcpy(&bits, &v, sizeof(bits));
+            return !bits;
+        }
+
         // Implementations of the hole-filling methods
         template<typename T>
-        inline void holes_fill_left(T* image_data, size_t width, size_t height, size_t stride)
+        inline void holes_fill_left(const T* in, T* out, size_t width, size_t first_row, size_t last_row)
         {
-            std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
-            std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
-            auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
-
-            T* p = image_data;
-
-            for (size_t j = 0; j < height; ++j)
+            for (size_t j = first_row; j < last_row; ++j)
             {
-                ++p;
+                const T* p = in + j * width;
+                T* q = out + j * width;
+
+                q[0] = p[0];
                 for (size_t i = 1; i < width; ++i)
-                {
-                    if (empty(p))
-                        *p = *(p - 1);
-                    ++p;
-                }
+                    q[i] = empty(p[i]) ? q[i - 1] : p[i];
             }
         }
 
+        // Fills each hole with the farest (largest) or the nearest (smallest valid) of its top-left, top, left,
+        // bottom-left and bottom neighbors. The rows above and to the left hold already filled values, so the
+        // rows are processed in order. The first and the last rows and the first column are left as is.
         template<typename T>
-        inline void holes_fill_farest(T* image_data, size_t width, size_t height, size_t stride)
+        inline void holes_fill_around(const T* in, T* out, size_t width, size_t height, bool farest)
         {
-            std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
-            std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
-            auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
-
-            T tmp = 0;
-            T * p = image_data + width;
-            T * q = nullptr;
-            for (int j = 1; j < height - 1; ++j)
+            if (in != out)
             {
-                ++p;
-                for (size_t i = 1; i < width; ++i)
-                {
-                    if (empty(p))
-                    {
-                        tmp = *(p - width);
-
-                        q = p - width - 1;
-                        if (*q > tmp)
-                            tmp = *q;
-
-                        q = p - 1;
-                        if (*q > tmp)
-                            tmp = *q;
-
-                        q = p + width - 1;
-                        if (*q > tmp)
-                            tmp = *q;
-
-                        q = p + width;
-                        if (*q > tmp)
-                            tmp = *q;
-
-                        *p = tmp;
-                    }
-
-                    p++;
-                }
+                memcpy(out, in, width * sizeof(T));
+                if (height > 1)
+                    memcpy(out + (height - 1) * width, in + (height - 1) * width, width * sizeof(T));
             }
-        }
 
-        template<typename T>
-        inline void holes_fill_nearest(T* image_data, size_t width, size_t height, size_t stride)
-        {
-            std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
-            std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
-            auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
-
-            T tmp = 0;
-            T * p = image_data + width;
-            T * q = nullptr;
-            for (int j = 1; j < height - 1; ++j)
+            for (size_t j = 1; j + 1 < height; ++j)
             {
-                ++p;
-                for (size_t i = 1; i < width; ++i)
+                const T* p = in + j * width;
+                T* q = out + j * width;
+
+                q[0] = p[0];
+                for (size_t i = holes_fill_around_simd(p, q, width, farest); i < width; ++i)
                 {
-                    if (empty(p))
+                    if (!empty(p[i]))
                     {
-                        tmp = *(p - width);
-
-                        q = p - width - 1;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
-
-                        q = p - 1;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
-
-                        q = p + width - 1;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
-
-                        q = p + width;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
-
-                        *p = tmp;
+                        q[i] = p[i];
+                        continue;
                     }
 
-                    p++;
+                    T neighbors[4] = { q[i - width - 1], q[i - 1], p[i + width - 1], p[i + width] };
+                    T tmp = q[i - width];
+                    for (auto n : neighbors)
+                    {
+                        if (farest ? (n > tmp) : (!empty(n) && (n < tmp)))
+                            tmp = n;
+                    }
+                    q[i] = tmp;
                 }
             }
         }
 
+        // Vectorized part of holes_fill_around for one row; returns the first column left for the scalar code
+        size_t holes_fill_around_simd(const uint16_t* in, uint16_t* out, size_t width, bool farest);
+        size_t holes_fill_around_simd(const float* in, float* out, size_t width, bool farest);
+
     private:
 
         size_t                  _width, _height, _stride;
@@ -165,6 +136,8 @@ namespace librealsense
         rs2::stream_profile     _source_stream_profile;
         rs2::stream_profile     _target_stream_profile;
         uint8_t                 _hole_filling_mode;
+
+        static const size_t     rows_per_task = 16;
     };
     MAP_EXTENSION(RS2_EXTENSION_HOLE_FILLING_FILTER, librealsense::hole_filling_filter);
 }
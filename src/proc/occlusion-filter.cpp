@@ -116,51 +116,15 @@ namespace librealsense
     //    with a invalidation color such as black/magenta according to the purpose (production/debugging)
    void occlusion_filter::monotonic_heuristic_invalidation(float3* points, float2* uv_map, const std::vector<float2>& pix_coord, const rs2::depth_frame& depth) const
    {
-       float occZTh = 0.1f; //meters
-       int occDilationSz = 1;
        auto points_width = _depth_intrinsics->width;
        auto points_height = _depth_intrinsics->height;
-       auto pixels_ptr = pix_coord.data();
        auto points_ptr = points;
        auto uv_map_ptr = uv_map;
        float maxInLine = -1;
-       float maxZ = 0;
 
        if (_occlusion_scanning == horizontal)
        {
-           for( int y = 0; y < points_height; ++y )
-           {
-               maxInLine = -1;
-               maxZ = 0;
-               int occDilationLeft = 0;
-
-               for(int x = 0; x < points_width; ++x )
-               {
-                   if( points_ptr->z )
-                   {
-                       // Occlusion detection
-                       if( pixels_ptr->x < maxInLine
-                           || ( pixels_ptr->x == maxInLine && ( points_ptr->z - maxZ ) > occZTh ) )
-                       {
-                           *points_ptr = { 0, 0, 0 };
-                           occDilationLeft = occDilationSz;
-                       }
-                       else
-                       {
-                           maxInLine = pixels_ptr->x;
-                           maxZ = points_ptr->z;
-                           if( occDilationLeft > 0 )
-                           {
-                               *points_ptr = { 0, 0, 0 };
-                               occDilationLeft--;
-                           }
-                       }
-                   }
-                   ++points_ptr;
-                   ++uv_map_ptr;
-                   ++pixels_ptr;
-               }
-           }
+           horizontal_invalidation(points, pix_coord.data(), 0, points_height);
        }
        else if (_occlusion_scanning == vertical)
        {
@@ -216,6 +180,49 @@ namespace librealsense
            }
        }
    }
+   // Each row is scanned on its own, so rows may be processed concurrently
+   void occlusion_filter::horizontal_invalidation(float3* points, const float2* pix_coord, int first_row, int last_row) const
+   {
+       float occZTh = 0.1f; //meters
+       int occDilationSz = 1;
+       auto points_width = _depth_intrinsics->width;
+       auto pixels_ptr = pix_coord + first_row * points_width;
+       auto points_ptr = points + first_row * points_width;
+
+       for( int y = first_row; y < last_row; ++y )
+       {
+           float maxInLine = -1;
+           float maxZ = 0;
+           int occDilationLeft = 0;
+
+           for(int x = 0; x < points_width; ++x )
+           {
+               if( points_ptr->z )
+               {
+                   // Occlusion detection
+                   if( pixels_ptr->x < maxInLine
+                       || ( pixels_ptr->x == maxInLine && ( points_ptr->z - maxZ ) > occZTh ) )
+                   {
+                       *points_ptr = { 0, 0, 0 };
+                       occDilationLeft = occDilationSz;
+                   }
+                   else
+                   {
+                       maxInLine = pixels_ptr->x;
+                       maxZ = points_ptr->z;
+                       if( occDilationLeft > 0 )
+                       {
+                           *points_ptr = { 0, 0, 0 };
+                           occDilationLeft--;
+                       }
+                   }
+               }
+               ++points_ptr;
+               ++pixels_ptr;
+           }
+       }
+   }
+
     // Prepare texture map without occlusion that for every texture coordinate there no more than one depth point that is mapped to it
     // i.e. for every (u,v) map coordinate we select the depth point with minimum Z. all other points that are mapped to this texel will be invalidated
     // Algo input data:
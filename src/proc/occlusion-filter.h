@@ -58,6 +58,7 @@ namespace librealsense
         friend class pointcloud;
 
         void monotonic_heuristic_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord, const rs2::depth_frame& depth) const;
+        void horizontal_invalidation(float3* points, const float2* pix_coord, int first_row, int last_row) const;
         void comprehensive_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord) const;
 
         optional_value<rs2_intrinsics>              _depth_intrinsics;
@@ -12,7 +12,9 @@
 #include "../device.h"
 #include "../stream.h"
 #include <iostream>
+#include <chrono>
 #include "device-calibration.h"
+#include "../concurrency.h"
 
 #ifdef RS2_USE_CUDA
 #include "proc/cuda/cuda-pointcloud.h"
@@ -23,25 +25,73 @@
 
 namespace librealsense
 {
-    template<class MAP_DEPTH> void deproject_depth(float * points, const rs2_intrinsics & intrin, const uint16_t * depth, MAP_DEPTH map_depth)
+    namespace
     {
-        for (int y = 0; y < intrin.height; ++y)
+        // A read-only option reporting the processing time measured by the pointcloud
+        class processing_time_option : public readonly_option
         {
-            for (int x = 0; x < intrin.width; ++x)
+        public:
+            explicit processing_time_option(const std::atomic<float>& time_ms) : _time_ms(time_ms) {}
+
+            float query() const override { return _time_ms; }
+            option_range get_range() const override { return { 0.f, 1000.f, 0.001f, 0.f }; }
+            bool is_enabled() const override { return true; }
+            const char* get_description() const override { return "Average time in milliseconds to compute a pointcloud"; }
+
+        private:
+            const std::atomic<float>& _time_ms;
+        };
+    }
+
+    void pointcloud::preprocess()
+    {
+        // The rays are only used by deproject_rows; GPU implementations deproject on their own
+        if (!tiled_processing())
+        {
+            _depth_rays.clear();
+            return;
+        }
+
+        auto& intrin = *_depth_intrinsics;
+        _depth_rays.resize(size_t(intrin.width) * intrin.height);
+
+        // rs2_deproject_pixel_to_point scales the ray through the pixel by the depth, so a unit-depth
+        // deprojection gives the same points once multiplied by it
+        thread_pool::shared().parallel_for(intrin.height, rows_per_task, [&](size_t first_row, size_t last_row)
+        {
+            for (int y = int(first_row); y < int(last_row); ++y)
             {
-                const float pixel[] = { (float)x, (float)y };
-                rs2_deproject_pixel_to_point(points, &intrin, pixel, map_depth(*depth++));
-                points += 3;
+                for (int x = 0; x < intrin.width; ++x)
+                {
+                    const float pixel[] = { (float)x, (float)y };
+                    float point[3];
+                    rs2_deproject_pixel_to_point(point, &intrin, pixel, 1.f);
+                    _depth_rays[y * intrin.width + x] = { point[0], point[1] };
+                }
             }
+        });
+    }
+
+    void pointcloud::deproject_rows(float3* points, const uint16_t* depth, float depth_scale, int first_row, int last_row)
+    {
+        auto width = _depth_intrinsics->width;
+        for (auto i = first_row * width; i < last_row * width; ++i)
+        {
+            float z = depth_scale * depth[i];
+            points[i] = { z * _depth_rays[i].x, z * _depth_rays[i].y, z };
         }
     }
 
     const float3 * pointcloud::depth_to_points(rs2::points output, 
         const rs2_intrinsics &depth_intrinsics, const rs2::depth_frame& depth_frame, float depth_scale)
     {
-        auto image = output.get_vertices();
-        deproject_depth((float*)image, depth_intrinsics, (const uint16_t*)depth_frame.get_data(), [depth_scale](uint16_t z) { return depth_scale * z; });
-        return (float3*)image;
+        auto image = (float3*)output.get_vertices();
+        auto depth = (const uint16_t*)depth_frame.get_data();
+        thread_pool::shared().parallel_for(depth_intrinsics.height, rows_per_task, [&](size_t first_row, size_t last_row)
+        {
+            deproject_rows(image, depth, depth_scale, int(first_row), int(last_row));
+        });
+        return image;
     }
 
     float3 transform(const rs2_extrinsics *extrin, const float3 &point) { float3 p = {}; rs2_transform_point_to_point(&p.x, extrin, &point.x); return p; }
@@ -217,10 +267,24 @@ namespace librealsense
         float2* pixels_ptr)
     {
         auto tex_ptr = (float2*)output.get_texture_coordinates();
+        thread_pool::shared().parallel_for(height, rows_per_task, [&](size_t first_row, size_t last_row)
+        {
+            map_texture_rows(tex_ptr, pixels_ptr, points, other_intrinsics, extr, int(first_row), int(last_row));
+        });
+    }
+
+    void pointcloud::map_texture_rows(float2* tex_ptr, float2* pixels_ptr, const float3* points,
+        const rs2_intrinsics& other_intrinsics, const rs2_extrinsics& extr, int first_row, int last_row)
+    {
+        auto width = _depth_intrinsics->width;
+        auto offset = first_row * width;
+        points += offset;
+        tex_ptr += offset;
+        pixels_ptr += offset;
 
-        for (unsigned int y = 0; y < height; ++y)
+        for (int y = first_row; y < last_row; ++y)
         {
-            for (unsigned int x = 0; x < width; ++x)
+            for (int x = 0; x < width; ++x)
             {
                 if (points->z)
                 {
@@ -249,13 +313,91 @@ namespace librealsense
         return source.allocate_points(_output_stream, depth);
     }
 
+    void pointcloud::process_tiles(const rs2::points& output, const rs2::depth_frame& depth, bool map_texture,
+        const rs2_intrinsics& other_intrinsics, const rs2_extrinsics& extr, bool invalidate_rows)
+    {
+        auto points = (float3*)output.get_vertices();
+        auto tex_ptr = (float2*)output.get_texture_coordinates();
+        auto pixels_ptr = _pixels_map.data();
+        auto depth_data = (const uint16_t*)depth.get_data();
+        auto depth_scale = *_depth_units;
+
+        // Each tile of rows goes through all the stages while its points are still in the cache
+        thread_pool::shared().parallel_for(_depth_intrinsics->height, rows_per_task, [&](size_t first_row, size_t last_row)
+        {
+            for (auto y = int(first_row); y < int(last_row); y += rows_per_task)
+            {
+                auto tile_end = std::min(y + rows_per_task, int(last_row));
+                deproject_rows(points, depth_data, depth_scale, y, tile_end);
+                if (map_texture)
+                    map_texture_rows(tex_ptr, pixels_ptr, points, other_intrinsics, extr, y, tile_end);
+                if (invalidate_rows)
+                    _occlusion_filter->horizontal_invalidation(points, pixels_ptr, y, tile_end);
+            }
+        });
+    }
+
+    void pointcloud::pack_valid_points(librealsense::points* pframe)
+    {
+        auto vertices = pframe->get_vertices();
+        auto tex = pframe->get_texture_coordinates();
+        auto width = _depth_intrinsics->width;
+        auto height = _depth_intrinsics->height;
+        auto with_indices = _sparse_output == sparse_with_pixel_indices;
+        auto tile_size = rows_per_task * width;
+
+        if (with_indices)
+            _pixel_indices.resize(size_t(width) * height);
+        _tile_counts.resize((height + rows_per_task - 1) / rows_per_task);
+
+        // Each tile packs its valid points at its own start...
+        thread_pool::shared().parallel_for(_tile_counts.size(), 1, [&](size_t first_tile, size_t last_tile)
+        {
+            for (auto tile = first_tile; tile < last_tile; ++tile)
+            {
+                auto begin = int(tile) * tile_size;
+                auto end = std::min(begin + tile_size, width * height);
+                auto count = begin;
+                for (auto i = begin; i < end; ++i)
+                {
+                    if (!vertices[i].z)
+                        continue;
+                    vertices[count] = vertices[i];
+                    tex[count] = tex[i];
+                    if (with_indices)
+                        _pixel_indices[count] = i;
+                    ++count;
+                }
+                _tile_counts[tile] = count - begin;
+            }
+        });
+
+        // ...and the tiles are then moved down next to each other
+        size_t count = 0;
+        for (size_t tile = 0; tile < _tile_counts.size(); ++tile)
+        {
+            auto begin = tile * tile_size;
+            auto n = _tile_counts[tile];
+            if (count != begin)
+            {
+                memmove(vertices + count, vertices + begin, n * sizeof(float3));
+                memmove(tex + count, tex + begin, n * sizeof(float2));
+                if (with_indices)
+                    memmove(_pixel_indices.data() + count, _pixel_indices.data() + begin, n * sizeof(int));
+            }
+            count += n;
+        }
+
+        pframe->make_sparse(count, with_indices ? _pixel_indices.data() : nullptr);
+    }
+
     rs2::frame pointcloud::process_depth_frame(const rs2::frame_source& source, const rs2::depth_frame& depth)
     {
+        auto start = std::chrono::steady_clock::now();
+
         auto res = allocate_points(source, depth);
         auto pframe = (librealsense::points*)(res.get());
 
-        const float3* points = depth_to_points(res, *_depth_intrinsics, depth, *_depth_units);
-
         auto vid_frame = depth.as<rs2::video_frame>();
 
         // Pixels calculated in the mapped texture. Used in post-processing filters
@@ -272,23 +414,49 @@ namespace librealsense
             }
         }
 
-        if (map_texture)
+        bool invalidate_occlusions = map_texture && run__occlusion_filter(extr);
+        if (invalidate_occlusions && _occlusion_filter->find_scanning_direction(extr) == vertical)
         {
-            auto height = vid_frame.get_height();
-            auto width = vid_frame.get_width();
+            _occlusion_filter->set_scanning(static_cast<uint8_t>(vertical));
+            _occlusion_filter->_depth_units = _depth_units.value();
+        }
 
-            get_texture_map(res, points, width, height, mapped_intr, extr, pixels_ptr);
+        if (tiled_processing())
+        {
+            // The horizontal scan looks at one row at a time, so it runs within the tiles; the vertical one
+            // needs whole columns and runs once the tiles are done
+            bool invalidate_rows = invalidate_occlusions &&
+                _occlusion_filter->_occlusion_filter == occlusion_monotonic_scan &&
+                _occlusion_filter->_occlusion_scanning == horizontal;
 
-            if (run__occlusion_filter(extr))
-            {
-                if (_occlusion_filter->find_scanning_direction(extr) == vertical)
-                {
-                    _occlusion_filter->set_scanning(static_cast<uint8_t>(vertical));
-                    _occlusion_filter->_depth_units = _depth_units.value();
-                }
+            process_tiles(res, depth, map_texture, mapped_intr, extr, invalidate_rows);
+
+            if (invalidate_occlusions && !invalidate_rows)
                 _occlusion_filter->process(pframe->get_vertices(), pframe->get_texture_coordinates(), _pixels_map, depth);
+
+            // Packing reads the points on the CPU, so the GPU pointclouds always output dense frames
+            if (_sparse_output != sparse_off)
+                pack_valid_points(pframe);
+        }
+        else
+        {
+            const float3* points = depth_to_points(res, *_depth_intrinsics, depth, *_depth_units);
+
+            if (map_texture)
+            {
+                auto height = vid_frame.get_height();
+                auto width = vid_frame.get_width();
+
+                get_texture_map(res, points, width, height, mapped_intr, extr, pixels_ptr);
+
+                if (invalidate_occlusions)
+                    _occlusion_filter->process(pframe->get_vertices(), pframe->get_texture_coordinates(), _pixels_map, depth);
             }
         }
+
+        std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        float average = _processing_time_ms;
+        _processing_time_ms = average ? average + (elapsed.count() - average) / 16 : elapsed.count();
         return res;
     }
 
@@ -297,7 +465,7 @@ namespace librealsense
     {}
 
     pointcloud::pointcloud(const char* name)
-        : stream_filter_processing_block(name)
+        : stream_filter_processing_block(name), _processing_time_ms(0.f), _sparse_output(sparse_off)
     {
         _occlusion_filter = std::make_shared<occlusion_filter>();
 
@@ -319,6 +487,15 @@ namespace librealsense
         occlusion_invalidation->set_description(1.f, "Off");
         occlusion_invalidation->set_description(2.f, "On");
         register_option(RS2_OPTION_FILTER_MAGNITUDE, occlusion_invalidation);
+
+        register_option(RS2_OPTION_PROCESSING_TIME, std::make_shared<processing_time_option>(_processing_time_ms));
+
+        auto sparse_output = std::make_shared<ptr_option<uint8_t>>(
+            sparse_off, sparse_with_pixel_indices, 1, sparse_off, &_sparse_output, "Output only the valid points (CPU pointclouds)");
+        sparse_output->set_description(sparse_off, "Off");
+        sparse_output->set_description(sparse_on, "On");
+        sparse_output->set_description(sparse_with_pixel_indices, "On, with pixel indices");
+        register_option(RS2_OPTION_SPARSE_POINTCLOUD, sparse_output);
     }
 
     bool pointcloud::should_process(const rs2::frame& frame)
@@ -4,9 +4,18 @@
 #pragma once
 #include "synthetic-stream.h"
 
+#include <atomic>
+
 namespace librealsense
 {
     class occlusion_filter;
+    class points;
+
+    enum sparse_output_mode : uint8_t {
+        sparse_off,
+        sparse_on,
+        sparse_with_pixel_indices
+    };
 
     class LRS_EXTENSION_API pointcloud : public stream_filter_processing_block
     {
@@ -29,12 +38,25 @@ namespace librealsense
             const rs2_extrinsics& extr,
             float2* pixels_ptr);
         virtual rs2::points allocate_points(const rs2::frame_source& source, const rs2::frame& f);
-        virtual void preprocess() {}
+        virtual void preprocess();
         virtual bool run__occlusion_filter(const rs2_extrinsics& extr);
 
     protected:
         pointcloud(const char* name);
 
+        // Rows of the depth image handled by each task of the tiled pass
+        static const int rows_per_task = 8;
+
+        // Deprojects / maps rows [first_row, last_row) of the frame. Called concurrently on disjoint rows.
+        virtual void deproject_rows(float3* points, const uint16_t* depth, float depth_scale, int first_row, int last_row);
+        virtual void map_texture_rows(float2* tex_ptr, float2* pixels_ptr, const float3* points,
+            const rs2_intrinsics& other_intrinsics, const rs2_extrinsics& extr, int first_row, int last_row);
+
+        // Whether the frame is computed on the CPU through the row steps above, so that deprojection, texture
+        // mapping and horizontal occlusion invalidation can be fused into one pass over tiles of rows.
+        // Implementations that override depth_to_points / get_texture_map wholesale (GPU) return false.
+        virtual bool tiled_processing() const { return true; }
+
         bool should_process(const rs2::frame& frame) override;
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
 
@@ -46,6 +68,14 @@ namespace librealsense
 
         // Intermediate translation table of (depth_x*depth_y) with actual texel coordinates per depth pixel
         std::vector<float2>                    _pixels_map;
+        // Deprojection of each depth pixel at unit depth, computed once per depth intrinsics for deproject_rows
+        std::vector<float2>                    _depth_rays;
+        // Moving average of the time taken to compute a pointcloud, in milliseconds
+        std::atomic<float>                     _processing_time_ms;
+        uint8_t                                _sparse_output;
+        // Scratch space used to pack the valid points
+        std::vector<int>                       _pixel_indices;
+        std::vector<size_t>                    _tile_counts;
 
         rs2::stream_profile _output_stream;
         rs2::frame _other_stream;
@@ -54,7 +84,10 @@ namespace librealsense
         void inspect_depth_frame(const rs2::frame& depth);
         void inspect_other_frame(const rs2::frame& other);
         rs2::frame process_depth_frame(const rs2::frame_source& source, const rs2::depth_frame& depth);
+        void process_tiles(const rs2::points& output, const rs2::depth_frame& depth, bool map_texture,
+            const rs2_intrinsics& other_intrinsics, const rs2_extrinsics& extr, bool invalidate_rows);
         void set_extrinsics();
+        void pack_valid_points(librealsense::points* pframe);
 
         stream_filter _prev_stream_filter;
         std::shared_ptr< pointcloud > _registered_auto_calib_cb;
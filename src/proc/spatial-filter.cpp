@@ -10,6 +10,8 @@
 #include "proc/synthetic-stream.h"
 #include "proc/hole-filling-filter.h"
 #include "proc/spatial-filter.h"
+#include "proc/sse/sse-spatial-filter.h"
+#include "image-avx.h"
 
 namespace librealsense
 {
@@ -153,14 +155,24 @@ namespace librealsense
 
         update_configuration(f);
         tgt = prepare_target_frame(f, source);
+        apply_filter(const_cast<void*>(tgt.get_data()));
 
+        return tgt;
+    }
+
+    void spatial_filter::process_frame_in_place(const rs2::frame& f)
+    {
+        update_configuration(f);
+        apply_filter(const_cast<void*>(f.get_data()));
+    }
+
+    void spatial_filter::apply_filter(void * frame_data)
+    {
         // Spatial domain transform edge-preserving filter
         if (_extension_type == RS2_EXTENSION_DISPARITY_FRAME)
-            dxf_smooth<float>(const_cast<void*>(tgt.get_data()), _spatial_alpha_param, _spatial_edge_threshold, _spatial_iterations);
+            dxf_smooth<float>(frame_data, _spatial_alpha_param, _spatial_edge_threshold, _spatial_iterations);
         else
-            dxf_smooth<uint16_t>(const_cast<void*>(tgt.get_data()), _spatial_alpha_param, _spatial_edge_threshold, _spatial_iterations);
-
-        return tgt;
+            dxf_smooth<uint16_t>(frame_data, _spatial_alpha_param, _spatial_edge_threshold, _spatial_iterations);
     }
 
     void  spatial_filter::update_configuration(const rs2::frame& f)
@@ -226,13 +238,13 @@ namespace librealsense
         return tgt;
     }
 
-    void spatial_filter::recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ)
+    void spatial_filter::recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ, size_t first_row, size_t last_row)
     {
         float *image = reinterpret_cast<float*>(image_data);
 
         int v, u;
 
-        for (v = 0; v < _height;) {
+        for (v = int(first_row); v < last_row;) {
             // left to right
             float *im = image + v * _width;
             float state = *im;
@@ -354,15 +366,24 @@ namespace librealsense
         }
     }
 
-    void spatial_filter::recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ)
+    void spatial_filter::recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ, size_t first_col, size_t last_col)
     {
         float *image = reinterpret_cast<float*>(image_data);
 
         int v, u;
 
+#if defined __SSSE3__ && ! defined ANDROID
+        static bool do_avx = has_avx();
+#ifdef RS2_HAVE_AVX2_KERNELS
+        if (do_avx)
+            first_col = recursive_filter_vertical_fp_avx2(image, _width, _height, first_col, last_col, alpha, deltaZ);
+#endif
+        first_col = recursive_filter_vertical_fp_sse(image, _width, _height, first_col, last_col, alpha, deltaZ);
+#endif
+
         // we'll do one column at a time, top to bottom, bottom to top, left to right,
 
-        for (u = 0; u < _width;) {
+        for (u = int(first_col); u < last_col;) {
 
             float *im = image + u;
             float state = im[0];
@@ -484,4 +505,18 @@ namespace librealsense
             u++;
         }
     }
+
+    size_t spatial_filter::recursive_filter_vertical_simd(uint16_t * image, float alpha, float deltaZ, size_t first_col, size_t last_col)
+    {
+#if defined __SSSE3__ && ! defined ANDROID
+        static bool do_avx = has_avx();
+        const auto delta_z = static_cast<uint16_t>(deltaZ);
+#ifdef RS2_HAVE_AVX2_KERNELS
+        if (do_avx)
+            first_col = recursive_filter_vertical_z16_avx2(image, _width, _height, first_col, last_col, alpha, delta_z);
+#endif
+        first_col = recursive_filter_vertical_z16_sse(image, _width, _height, first_col, last_col, alpha, delta_z);
+#endif
+        return first_col;
+    }
 }
@@ -12,6 +12,7 @@
 
 #include "../include/librealsense2/hpp/rs_frame.hpp"
 #include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "../concurrency.h"
 
 namespace librealsense
 {
@@ -20,11 +21,15 @@ namespace librealsense
     public:
         spatial_filter();
 
+        bool supports_in_place() const override { return true; }
+
     protected:
         void    update_configuration(const rs2::frame& f);
 
         rs2::frame prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source);
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+        void process_frame_in_place(const rs2::frame& f) override;
+        void apply_filter(void * frame_data);
 
         template <typename T>
         void dxf_smooth(void *frame_data, float alpha, float delta, int iterations)
@@ -32,31 +37,53 @@ namespace librealsense
             static_assert((std::is_arithmetic<T>::value), "Spatial filter assumes numeric types");
             bool fp = (std::is_floating_point<T>::value);
 
-            for (int i = 0; i < iterations; i++)
+            // Image rows are filtered independently by the horizontal pass, and columns by the vertical pass,
+            // so each pass is split into bands of rows/columns that run on the shared worker pool
+            auto& pool = thread_pool::shared();
+            const size_t rows_per_task = 16;
+            const size_t cols_per_task = 64;    // A multiple of the widest vectorized column group
+
+            auto horizontal_pass = [&](size_t first_row, size_t last_row)
             {
                 if (fp)
-                {
-                    recursive_filter_horizontal_fp(frame_data, alpha, delta);
-                    recursive_filter_vertical_fp(frame_data, alpha, delta);
-                }
+                    recursive_filter_horizontal_fp(frame_data, alpha, delta, first_row, last_row);
                 else
-                {
-                    recursive_filter_horizontal<T>(frame_data, alpha, delta);
-                    recursive_filter_vertical<T>(frame_data, alpha, delta);
-                }
+                    recursive_filter_horizontal<T>(frame_data, alpha, delta, first_row, last_row);
+            };
+            auto vertical_pass = [&](size_t first_col, size_t last_col)
+            {
+                if (fp)
+                    recursive_filter_vertical_fp(frame_data, alpha, delta, first_col, last_col);
+                else
+                    recursive_filter_vertical<T>(frame_data, alpha, delta, first_col, last_col);
+            };
+
+            for (int i = 0; i < iterations; i++)
+            {
+                pool.parallel_for(_height, rows_per_task, horizontal_pass);
+                pool.parallel_for(_width, cols_per_task, vertical_pass);
             }
 
             // Disparity domain hole filling requires a second pass over the frame data
             // For depth domain a more efficient in-place hole filling is performed
             if (_holes_filling_mode && fp)
-                intertial_holes_fill<T>(static_cast<T*>(frame_data));
+            {
+                pool.parallel_for(_height, rows_per_task, [&](size_t first_row, size_t last_row)
+                {
+                    intertial_holes_fill<T>(static_cast<T*>(frame_data), first_row, last_row);
+                });
+            }
         }
 
-        void recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ);
-        void recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ);
+        // The passes below filter the rows/columns in [first, last) only
+        void recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ, size_t first_row, size_t last_row);
+        void recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ, size_t first_col, size_t last_col);
+
+        // Vectorized vertical pass over Z16 data; returns the first column left for the scalar code
+        size_t recursive_filter_vertical_simd(uint16_t * image, float alpha, float deltaZ, size_t first_col, size_t last_col);
 
         template <typename T>
-        void  recursive_filter_horizontal(void * image_data, float alpha, float deltaZ)
+        void  recursive_filter_horizontal(void * image_data, float alpha, float deltaZ, size_t first_row, size_t last_row)
         {
             size_t v{}, u{};
 
@@ -72,7 +99,7 @@ namespace librealsense
             auto image = reinterpret_cast<T*>(image_data);
             size_t cur_fill = 0;
 
-            for (v = 0; v < _height; v++)
+            for (v = first_row; v < last_row; v++)
             {
                 // left to right
                 T *im = image + v * _width;
@@ -151,7 +178,7 @@ namespace librealsense
         }
 
         template <typename T>
-        void recursive_filter_vertical(void * image_data, float alpha, float deltaZ)
+        void recursive_filter_vertical(void * image_data, float alpha, float deltaZ, size_t first_col, size_t last_col)
         {
             size_t v{}, u{};
 
@@ -166,16 +193,20 @@ namespace librealsense
 
             auto image = reinterpret_cast<T*>(image_data);
 
+            if (std::is_same<T, uint16_t>::value)
+                first_col = recursive_filter_vertical_simd(reinterpret_cast<uint16_t*>(image_data), alpha, deltaZ, first_col, last_col);
+
             // we'll do one row at a time, top to bottom, then bottom to top
 
             // top to bottom
 
-            T *im = image;
+            T *im = nullptr;
             T im0{};
             T imw{};
             for (v = 1; v < _height; v++)
             {
-                for (u = 0; u < _width; u++)
+                im = image + (v - 1) * _width + first_col;
+                for (u = first_col; u < last_col; u++)
                 {
                     im0 = im[0];
                     imw = im[_width];
@@ -194,10 +225,10 @@ namespace librealsense
             }
 
             // bottom to top
-            im = image + (_height - 2) * _width;
-            for (v = 1; v < _height; v++, im -= (_width * 2))
+            for (v = 1; v < _height; v++)
             {
-                for (u = 0; u < _width; u++)
+                im = image + (_height - 1 - v) * _width + first_col;
+                for (u = first_col; u < last_col; u++)
                 {
                     im0 = im[0];
                     imw = im[_width];
@@ -217,7 +248,7 @@ namespace librealsense
         }
 
         template<typename T>
-        inline void intertial_holes_fill(T* image_data)
+        inline void intertial_holes_fill(T* image_data, size_t first_row, size_t last_row)
         {
             std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
             std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
@@ -225,8 +256,8 @@ namespace librealsense
 
             size_t cur_fill = 0;
 
-            T* p = image_data;
-            for (int j = 0; j < _height; ++j)
+            T* p = image_data + first_row * _width;
+            for (size_t j = first_row; j < last_row; ++j)
             {
                 ++p;
                 cur_fill = 0;
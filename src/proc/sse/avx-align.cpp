@@ -0,0 +1,118 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "sse-align.h"
+
+#if defined(__SSSE3__) && defined(__AVX2__)
+
+#include <immintrin.h>
+
+namespace librealsense
+{
+    namespace
+    {
+        template<rs2_distortion dist>
+        inline void distort_x_y(__m256& x, __m256& y, const rs2_intrinsics& to)
+        {
+        }
+
+        // Same operations, in the same order, as the SSE version, so both produce identical maps
+        template<>
+        inline void distort_x_y<RS2_DISTORTION_MODIFIED_BROWN_CONRADY>(__m256& x, __m256& y, const rs2_intrinsics& to)
+        {
+            __m256 c[5];
+            auto one = _mm256_set1_ps(1);
+            auto two = _mm256_set1_ps(2);
+
+            for (int i = 0; i < 5; ++i)
+            {
+                c[i] = _mm256_set1_ps(to.coeffs[i]);
+            }
+            auto r2 = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+            auto r3 = _mm256_add_ps(_mm256_mul_ps(c[1], _mm256_mul_ps(r2, r2)), _mm256_mul_ps(c[4], _mm256_mul_ps(r2, _mm256_mul_ps(r2, r2))));
+            auto f = _mm256_add_ps(one, _mm256_add_ps(_mm256_mul_ps(c[0], r2), r3));
+
+            auto x_f = _mm256_mul_ps(x, f);
+            auto y_f = _mm256_mul_ps(y, f);
+
+            auto r4 = _mm256_mul_ps(c[3], _mm256_add_ps(r2, _mm256_mul_ps(two, _mm256_mul_ps(x_f, x_f))));
+            auto d_x = _mm256_add_ps(x_f, _mm256_add_ps(_mm256_mul_ps(two, _mm256_mul_ps(c[2], _mm256_mul_ps(x_f, y_f))), r4));
+            auto d_y = _mm256_add_ps(y_f, _mm256_add_ps(_mm256_mul_ps(two, _mm256_mul_ps(c[3], _mm256_mul_ps(x_f, y_f))), r4));
+
+            x = d_x;
+            y = d_y;
+        }
+    }
+
+    template<rs2_distortion dist>
+    void get_texture_map_avx2(const uint16_t * depth,
+        float depth_scale,
+        const unsigned int size,
+        const float * pre_compute_x, const float * pre_compute_y,
+        byte * pixels_ptr_int,
+        const rs2_intrinsics& to,
+        const rs2_extrinsics& from_to_other)
+    {
+        auto res = reinterpret_cast<__m256i*>(pixels_ptr_int);
+
+        __m256 r[9];
+        __m256 t[3];
+
+        for (int i = 0; i < 9; ++i)
+        {
+            r[i] = _mm256_set1_ps(from_to_other.rotation[i]);
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            t[i] = _mm256_set1_ps(from_to_other.translation[i]);
+        }
+        auto scale = _mm256_set1_ps(depth_scale);
+        auto zero = _mm256_setzero_ps();
+        auto half = _mm256_set1_ps(0.5f);
+        auto fx = _mm256_set1_ps(to.fx);
+        auto fy = _mm256_set1_ps(to.fy);
+        auto ppx = _mm256_set1_ps(to.ppx);
+        auto ppy = _mm256_set1_ps(to.ppy);
+
+        for (unsigned int i = 0; i < size; i += 8)
+        {
+            auto x = _mm256_loadu_ps(pre_compute_x + i);
+            auto y = _mm256_loadu_ps(pre_compute_y + i);
+
+            auto d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(depth + i));
+            auto z = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(d)), scale);
+
+            auto px = _mm256_mul_ps(z, x);
+            auto py = _mm256_mul_ps(z, y);
+
+            auto p_x = _mm256_add_ps(_mm256_mul_ps(r[0], px), _mm256_add_ps(_mm256_mul_ps(r[3], py), _mm256_add_ps(_mm256_mul_ps(r[6], z), t[0])));
+            auto p_y = _mm256_add_ps(_mm256_mul_ps(r[1], px), _mm256_add_ps(_mm256_mul_ps(r[4], py), _mm256_add_ps(_mm256_mul_ps(r[7], z), t[1])));
+            auto p_z = _mm256_add_ps(_mm256_mul_ps(r[2], px), _mm256_add_ps(_mm256_mul_ps(r[5], py), _mm256_add_ps(_mm256_mul_ps(r[8], z), t[2])));
+
+            p_x = _mm256_div_ps(p_x, p_z);
+            p_y = _mm256_div_ps(p_y, p_z);
+
+            distort_x_y<dist>(p_x, p_y, to);
+
+            // Zero the coordinates of pixels without depth
+            auto cmp = _mm256_cmp_ps(z, zero, _CMP_NEQ_UQ);
+            auto u = _mm256_and_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p_x, fx), ppx), half), cmp);
+            auto v = _mm256_and_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p_y, fy), ppy), half), cmp);
+
+            // Interleave to u0 v0 u1 v1 ... u7 v7; unpacking works within 128-bit lanes
+            auto uv_lo = _mm256_unpacklo_ps(u, v);  // u0 v0 u1 v1 | u4 v4 u5 v5
+            auto uv_hi = _mm256_unpackhi_ps(u, v);  // u2 v2 u3 v3 | u6 v6 u7 v7
+
+            _mm256_storeu_si256(&res[0], _mm256_cvtps_epi32(_mm256_permute2f128_ps(uv_lo, uv_hi, 0x20)));
+            _mm256_storeu_si256(&res[1], _mm256_cvtps_epi32(_mm256_permute2f128_ps(uv_lo, uv_hi, 0x31)));
+            res += 2;
+        }
+    }
+
+    template void get_texture_map_avx2<RS2_DISTORTION_NONE>(const uint16_t*, float, const unsigned int, const float*, const float*,
+        byte*, const rs2_intrinsics&, const rs2_extrinsics&);
+    template void get_texture_map_avx2<RS2_DISTORTION_MODIFIED_BROWN_CONRADY>(const uint16_t*, float, const unsigned int, const float*, const float*,
+        byte*, const rs2_intrinsics&, const rs2_extrinsics&);
+}
+
+#endif
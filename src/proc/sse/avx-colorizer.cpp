@@ -0,0 +1,50 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "sse-colorizer.h"
+
+#if defined(__SSSE3__) && defined(__AVX2__)
+
+#include <immintrin.h>
+
+namespace librealsense
+{
+    namespace
+    {
+        // Packs 16 RGBX pixels, 8 per register, into 48 bytes of RGB
+        inline void store_rgb(uint8_t * rgb, __m256i lo, __m256i hi)
+        {
+            const auto drop_x = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                                 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+            lo = _mm256_shuffle_epi8(lo, drop_x);
+            hi = _mm256_shuffle_epi8(hi, drop_x);
+
+            auto p0 = _mm256_castsi256_si128(lo);
+            auto p1 = _mm256_extracti128_si256(lo, 1);
+            auto p2 = _mm256_castsi256_si128(hi);
+            auto p3 = _mm256_extracti128_si256(hi, 1);
+
+            auto out = reinterpret_cast<__m128i*>(rgb);
+            _mm_storeu_si128(out + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+            _mm_storeu_si128(out + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+            _mm_storeu_si128(out + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+        }
+    }
+
+    size_t colorize_z16_lut_avx2(const uint16_t * depth, uint8_t * rgb, size_t count, const uint32_t * lut)
+    {
+        auto table = reinterpret_cast<const int*>(lut);
+
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            auto d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(depth + i));
+            auto lo = _mm256_i32gather_epi32(table, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(d)), 4);
+            auto hi = _mm256_i32gather_epi32(table, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(d, 1)), 4);
+            store_rgb(rgb + i * 3, lo, hi);
+        }
+        return i;
+    }
+}
+
+#endif
@@ -0,0 +1,151 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "sse-decimation-filter.h"
+
+#if defined(__SSSE3__) && defined(__AVX2__)
+
+#include <immintrin.h>
+
+namespace librealsense
+{
+    namespace
+    {
+        inline __m256i select_si256(__m256i mask, __m256i if_true, __m256i if_false)
+        {
+            return _mm256_or_si256(_mm256_and_si256(mask, if_true), _mm256_andnot_si256(mask, if_false));
+        }
+
+        inline __m128i load(const uint16_t * p)
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        inline __m256i combine(__m128i lo, __m128i hi)
+        {
+            return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        }
+
+        // Zero (invalid) pixels become the largest value, so they sort after all the valid ones;
+        // 'zeros' accumulates -1 for each of them
+        inline __m256i to_sortable(__m256i v, __m256i& zeros)
+        {
+            auto invalid = _mm256_cmpeq_epi16(v, _mm256_setzero_si256());
+            zeros = _mm256_add_epi16(zeros, invalid);
+            return _mm256_or_si256(v, invalid);
+        }
+
+        inline void sort2(__m256i& a, __m256i& b)
+        {
+            auto lo = _mm256_min_epu16(a, b);
+            b = _mm256_max_epu16(a, b);
+            a = lo;
+        }
+
+        // Splits 16 consecutive pixels into the even and the odd ones.
+        // The pixels are gathered in 128-bit halves, as the byte shuffles cannot cross 128-bit lanes.
+        inline void load_2x(const uint16_t * p, __m128i& c0, __m128i& c1)
+        {
+            const auto split = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+            auto a = _mm_shuffle_epi8(load(p), split);
+            auto b = _mm_shuffle_epi8(load(p + 8), split);
+            c0 = _mm_unpacklo_epi64(a, b);
+            c1 = _mm_unpackhi_epi64(a, b);
+        }
+
+        // Splits 24 consecutive pixels into pixels 3i, 3i+1 and 3i+2
+        inline void load_3x(const uint16_t * p, __m128i& c0, __m128i& c1, __m128i& c2)
+        {
+            auto a = load(p);
+            auto b = load(p + 8);
+            auto c = load(p + 16);
+
+            c0 = _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(a, _mm_setr_epi8(0, 1, 6, 7, 12, 13, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128)),
+                _mm_shuffle_epi8(b, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, 2, 3, 8, 9, 14, 15, -128, -128, -128, -128))),
+                _mm_shuffle_epi8(c, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 4, 5, 10, 11)));
+            c1 = _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(a, _mm_setr_epi8(2, 3, 8, 9, 14, 15, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128)),
+                _mm_shuffle_epi8(b, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, 4, 5, 10, 11, -128, -128, -128, -128, -128, -128))),
+                _mm_shuffle_epi8(c, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 0, 1, 6, 7, 12, 13)));
+            c2 = _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(a, _mm_setr_epi8(4, 5, 10, 11, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128)),
+                _mm_shuffle_epi8(b, _mm_setr_epi8(-128, -128, -128, -128, 0, 1, 6, 7, 12, 13, -128, -128, -128, -128, -128, -128))),
+                _mm_shuffle_epi8(c, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 2, 3, 8, 9, 14, 15)));
+        }
+
+        // Zero when all the pixels were invalid
+        inline __m256i valid_median(__m256i median, __m256i valid)
+        {
+            return _mm256_andnot_si256(_mm256_cmpeq_epi16(valid, _mm256_setzero_si256()), median);
+        }
+    }
+
+    size_t decimate_median_2x2_z16_avx2(const uint16_t * in, size_t width_in, uint16_t * out, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i lo[4], hi[4];
+            load_2x(in + 2 * i, lo[0], lo[1]);
+            load_2x(in + width_in + 2 * i, lo[2], lo[3]);
+            load_2x(in + 2 * i + 16, hi[0], hi[1]);
+            load_2x(in + width_in + 2 * i + 16, hi[2], hi[3]);
+
+            __m256i p[4];
+            auto zeros = _mm256_setzero_si256();
+            for (int k = 0; k < 4; k++)
+                p[k] = to_sortable(combine(lo[k], hi[k]), zeros);
+
+            sort2(p[0], p[1]); sort2(p[2], p[3]);
+            sort2(p[0], p[2]); sort2(p[1], p[3]);
+            sort2(p[1], p[2]);
+
+            // With k valid pixels the median is the sorted value at (k - 1) / 2
+            auto valid = _mm256_add_epi16(_mm256_set1_epi16(4), zeros);
+            auto median = select_si256(_mm256_cmpgt_epi16(valid, _mm256_set1_epi16(2)), p[1], p[0]);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), valid_median(median, valid));
+        }
+        return i;
+    }
+
+    size_t decimate_median_3x3_z16_avx2(const uint16_t * in, size_t width_in, uint16_t * out, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i lo[9], hi[9];
+            for (size_t r = 0; r < 3; r++)
+            {
+                load_3x(in + r * width_in + 3 * i, lo[3 * r], lo[3 * r + 1], lo[3 * r + 2]);
+                load_3x(in + r * width_in + 3 * i + 24, hi[3 * r], hi[3 * r + 1], hi[3 * r + 2]);
+            }
+
+            __m256i p[9];
+            auto zeros = _mm256_setzero_si256();
+            for (int k = 0; k < 9; k++)
+                p[k] = to_sortable(combine(lo[k], hi[k]), zeros);
+
+            // 25-comparator sorting network for 9 values
+            sort2(p[0], p[3]); sort2(p[1], p[7]); sort2(p[2], p[5]); sort2(p[4], p[8]);
+            sort2(p[0], p[7]); sort2(p[2], p[4]); sort2(p[3], p[8]); sort2(p[5], p[6]);
+            sort2(p[0], p[2]); sort2(p[1], p[3]); sort2(p[4], p[5]); sort2(p[7], p[8]);
+            sort2(p[1], p[4]); sort2(p[3], p[6]); sort2(p[5], p[7]);
+            sort2(p[0], p[1]); sort2(p[2], p[4]); sort2(p[3], p[5]); sort2(p[6], p[8]);
+            sort2(p[2], p[3]); sort2(p[4], p[5]); sort2(p[6], p[7]);
+            sort2(p[1], p[2]); sort2(p[3], p[4]); sort2(p[5], p[6]);
+
+            // With k valid pixels the median is the sorted value at (k - 1) / 2
+            auto valid = _mm256_add_epi16(_mm256_set1_epi16(9), zeros);
+            auto median = p[0];
+            for (int k = 1; k <= 4; k++)
+                median = select_si256(_mm256_cmpgt_epi16(valid, _mm256_set1_epi16(short(2 * k))), p[k], median);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), valid_median(median, valid));
+        }
+        return i;
+    }
+}
+
+#endif
@@ -0,0 +1,147 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "sse-spatial-filter.h"
+
+#if defined(__SSSE3__) && defined(__AVX2__)
+
+#include <immintrin.h>
+
+namespace librealsense
+{
+    namespace
+    {
+        inline __m256i select_si256(__m256i mask, __m256i if_true, __m256i if_false)
+        {
+            return _mm256_or_si256(_mm256_and_si256(mask, if_true), _mm256_andnot_si256(mask, if_false));
+        }
+
+        // Disparity values are valid when their bit pattern is a positive integer, as in the scalar code
+        inline __m256 is_valid_fp(__m256 v)
+        {
+            return _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_castps_si256(v), _mm256_setzero_si256()));
+        }
+
+        // One step of the recursion for 8 columns: filters 'innovation' against the running state
+        // and returns the value to store back into the image
+        inline __m256 filter_step_fp(__m256 innovation, __m256& state, __m256& previous,
+            __m256 alpha, __m256 one_minus_alpha, __m256 delta_z, __m256 neg_delta_z)
+        {
+            auto valid = is_valid_fp(innovation);
+            auto delta = _mm256_sub_ps(previous, innovation);
+            auto small = _mm256_and_ps(_mm256_cmp_ps(delta, delta_z, _CMP_LT_OQ), _mm256_cmp_ps(delta, neg_delta_z, _CMP_GT_OQ));
+            auto apply = _mm256_and_ps(_mm256_and_ps(valid, is_valid_fp(previous)), small);
+            auto filtered = _mm256_add_ps(_mm256_mul_ps(innovation, alpha), _mm256_mul_ps(state, one_minus_alpha));
+
+            state = _mm256_blendv_ps(_mm256_blendv_ps(state, innovation, valid), filtered, apply);
+            previous = innovation;
+            return _mm256_blendv_ps(innovation, filtered, apply);
+        }
+
+        // |a - b| < delta for 16 unsigned 16-bit lanes
+        inline __m256i diff_below_z16(__m256i a, __m256i b, __m256i delta)
+        {
+            auto diff = _mm256_or_si256(_mm256_subs_epu16(a, b), _mm256_subs_epu16(b, a));
+            auto not_below = _mm256_cmpeq_epi16(_mm256_subs_epu16(delta, diff), _mm256_setzero_si256());
+            return _mm256_xor_si256(not_below, _mm256_set1_epi16(-1));
+        }
+
+        // a * alpha + b * (1 - alpha), rounded as the scalar code does (+0.5 and truncate).
+        // Unpacking and packing both work within 128-bit lanes, so the lane order is preserved.
+        inline __m256i mix_z16(__m256i a, __m256i b, __m256 alpha, __m256 one_minus_alpha)
+        {
+            const auto zero = _mm256_setzero_si256();
+            const auto half = _mm256_set1_ps(0.5f);
+
+            auto a_lo = _mm256_cvtepi32_ps(_mm256_unpacklo_epi16(a, zero));
+            auto a_hi = _mm256_cvtepi32_ps(_mm256_unpackhi_epi16(a, zero));
+            auto b_lo = _mm256_cvtepi32_ps(_mm256_unpacklo_epi16(b, zero));
+            auto b_hi = _mm256_cvtepi32_ps(_mm256_unpackhi_epi16(b, zero));
+
+            auto lo = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a_lo, alpha), _mm256_mul_ps(b_lo, one_minus_alpha)), half);
+            auto hi = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a_hi, alpha), _mm256_mul_ps(b_hi, one_minus_alpha)), half);
+
+            return _mm256_packus_epi32(_mm256_cvttps_epi32(lo), _mm256_cvttps_epi32(hi));
+        }
+    }
+
+    size_t recursive_filter_vertical_fp_avx2(float * image, size_t width, size_t height,
+        size_t first_col, size_t last_col, float alpha_val, float delta_val)
+    {
+        const auto alpha = _mm256_set1_ps(alpha_val);
+        const auto one_minus_alpha = _mm256_set1_ps(1.f - alpha_val);
+        const auto delta_z = _mm256_set1_ps(delta_val);
+        const auto neg_delta_z = _mm256_set1_ps(-delta_val);
+
+        if (height < 2)
+            return first_col;
+
+        size_t u = first_col;
+        for (; u + 8 <= last_col; u += 8)
+        {
+            // top to bottom
+            float * im = image + u;
+            auto state = _mm256_loadu_ps(im);
+            auto previous = state;
+            for (size_t v = 1; v < height; v++)
+            {
+                im += width;
+                _mm256_storeu_ps(im, filter_step_fp(_mm256_loadu_ps(im), state, previous,
+                    alpha, one_minus_alpha, delta_z, neg_delta_z));
+            }
+
+            // bottom to top
+            state = _mm256_loadu_ps(im);
+            previous = state;
+            for (size_t v = 1; v < height; v++)
+            {
+                im -= width;
+                _mm256_storeu_ps(im, filter_step_fp(_mm256_loadu_ps(im), state, previous,
+                    alpha, one_minus_alpha, delta_z, neg_delta_z));
+            }
+        }
+        return u;
+    }
+
+    size_t recursive_filter_vertical_z16_avx2(uint16_t * image, size_t width, size_t height,
+        size_t first_col, size_t last_col, float alpha_val, uint16_t delta_val)
+    {
+        const auto alpha = _mm256_set1_ps(alpha_val);
+        const auto one_minus_alpha = _mm256_set1_ps(1.f - alpha_val);
+        const auto delta_z = _mm256_set1_epi16(static_cast<short>(delta_val));
+        const auto zero = _mm256_setzero_si256();
+
+        if (height < 2)
+            return first_col;
+
+        size_t u = first_col;
+        for (; u + 16 <= last_col; u += 16)
+        {
+            // top to bottom, over all the values
+            uint16_t * im = image + u;
+            for (size_t v = 1; v < height; v++, im += width)
+            {
+                auto im0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(im));
+                auto imw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(im + width));
+                auto apply = diff_below_z16(im0, imw, delta_z);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(im + width),
+                    select_si256(apply, mix_z16(imw, im0, alpha, one_minus_alpha), imw));
+            }
+
+            // bottom to top, over valid values only
+            for (size_t v = height - 1; v-- > 0;)
+            {
+                im = image + u + v * width;
+                auto im0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(im));
+                auto imw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(im + width));
+                auto invalid = _mm256_or_si256(_mm256_cmpeq_epi16(im0, zero), _mm256_cmpeq_epi16(imw, zero));
+                auto apply = _mm256_andnot_si256(invalid, diff_below_z16(im0, imw, delta_z));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(im),
+                    select_si256(apply, mix_z16(im0, imw, alpha, one_minus_alpha), im0));
+            }
+        }
+        return u;
+    }
+}
+
+#endif
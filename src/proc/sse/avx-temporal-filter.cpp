@@ -0,0 +1,147 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "sse-temporal-filter.h"
+
+#if defined(__SSSE3__) && defined(__AVX2__)
+
+#include <immintrin.h>
+
+namespace librealsense
+{
+    namespace
+    {
+        inline __m128i select_si128(__m128i mask, __m128i if_true, __m128i if_false)
+        {
+            return _mm_or_si128(_mm_and_si128(mask, if_true), _mm_andnot_si128(mask, if_false));
+        }
+
+        inline __m256i select_si256(__m256i mask, __m256i if_true, __m256i if_false)
+        {
+            return _mm256_or_si256(_mm256_and_si256(mask, if_true), _mm256_andnot_si256(mask, if_false));
+        }
+
+        // Looks up the bit of each history byte in the 256-bit persistence table; 0xFF where it is set
+        inline __m128i is_persistent(__m128i hist, __m128i table_lo, __m128i table_hi)
+        {
+            auto byte_index = _mm_and_si128(_mm_srli_epi16(hist, 3), _mm_set1_epi8(0x1F));
+            auto from_hi = _mm_cmpgt_epi8(byte_index, _mm_set1_epi8(15));
+            auto bytes = select_si128(from_hi, _mm_shuffle_epi8(table_hi, byte_index), _mm_shuffle_epi8(table_lo, byte_index));
+            auto bit = _mm_shuffle_epi8(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128),
+                                        _mm_and_si128(hist, _mm_set1_epi8(7)));
+            return _mm_cmpeq_epi8(_mm_and_si128(bytes, bit), bit);
+        }
+
+        // |a - b| < delta for 16 unsigned 16-bit lanes
+        inline __m256i diff_below_z16(__m256i a, __m256i b, __m256i delta)
+        {
+            auto diff = _mm256_or_si256(_mm256_subs_epu16(a, b), _mm256_subs_epu16(b, a));
+            auto not_below = _mm256_cmpeq_epi16(_mm256_subs_epu16(delta, diff), _mm256_setzero_si256());
+            return _mm256_xor_si256(not_below, _mm256_set1_epi16(-1));
+        }
+
+        // a * alpha + b * (1 - alpha), truncated as the scalar code does.
+        // Unpacking and packing both work within 128-bit lanes, so the lane order is preserved.
+        inline __m256i mix_z16(__m256i a, __m256i b, __m256 alpha, __m256 one_minus_alpha)
+        {
+            const auto zero = _mm256_setzero_si256();
+
+            auto lo = _mm256_add_ps(_mm256_mul_ps(alpha, _mm256_cvtepi32_ps(_mm256_unpacklo_epi16(a, zero))),
+                                    _mm256_mul_ps(one_minus_alpha, _mm256_cvtepi32_ps(_mm256_unpacklo_epi16(b, zero))));
+            auto hi = _mm256_add_ps(_mm256_mul_ps(alpha, _mm256_cvtepi32_ps(_mm256_unpackhi_epi16(a, zero))),
+                                    _mm256_mul_ps(one_minus_alpha, _mm256_cvtepi32_ps(_mm256_unpackhi_epi16(b, zero))));
+
+            return _mm256_packus_epi32(_mm256_cvttps_epi32(lo), _mm256_cvttps_epi32(hi));
+        }
+
+        // Narrows 16 16-bit lane masks to 16 byte masks, in order
+        inline __m128i pack_mask_epi16(__m256i m)
+        {
+            return _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packs_epi16(m, m), 0xD8));
+        }
+
+        // Narrows 8 32-bit lane masks to 8 byte masks, in order
+        inline __m128i pack_mask_epi32(__m256 m)
+        {
+            auto words = _mm_packs_epi32(_mm256_castsi256_si128(_mm256_castps_si256(m)),
+                                         _mm256_extracti128_si256(_mm256_castps_si256(m), 1));
+            return _mm_packs_epi16(words, words);
+        }
+
+        inline __m128i update_history(__m128i hist, __m128i cur_valid, __m128i agree, __m128i mask)
+        {
+            return select_si128(cur_valid, _mm_or_si128(_mm_and_si128(agree, hist), mask), _mm_andnot_si128(mask, hist));
+        }
+    }
+
+    size_t temporal_filter_z16_avx2(uint16_t * frame, uint16_t * last_frame, uint8_t * history, size_t count,
+        float alpha_val, float one_minus_alpha_val, uint16_t delta_val, uint8_t mask_val, const uint8_t * persistent)
+    {
+        const auto zero = _mm256_setzero_si256();
+        const auto ones = _mm256_set1_epi16(-1);
+        const auto alpha = _mm256_set1_ps(alpha_val);
+        const auto one_minus_alpha = _mm256_set1_ps(one_minus_alpha_val);
+        const auto delta_z = _mm256_set1_epi16(static_cast<short>(delta_val));
+        const auto mask = _mm_set1_epi8(static_cast<char>(mask_val));
+        const auto table_lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(persistent));
+        const auto table_hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(persistent + 16));
+
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            auto cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(frame + i));
+            auto prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(last_frame + i));
+            auto hist = _mm_loadu_si128(reinterpret_cast<const __m128i*>(history + i));
+
+            auto cur_valid = _mm256_xor_si256(_mm256_cmpeq_epi16(cur, zero), ones);
+            auto prev_valid = _mm256_xor_si256(_mm256_cmpeq_epi16(prev, zero), ones);
+            auto agree = _mm256_and_si256(_mm256_and_si256(cur_valid, prev_valid), diff_below_z16(cur, prev, delta_z));
+            auto fill = _mm256_andnot_si256(cur_valid, _mm256_and_si256(prev_valid,
+                _mm256_cvtepi8_epi16(is_persistent(hist, table_lo, table_hi))));
+            auto filtered = mix_z16(cur, prev, alpha, one_minus_alpha);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(frame + i), select_si256(agree, filtered, select_si256(fill, prev, cur)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(last_frame + i), select_si256(agree, filtered, select_si256(cur_valid, cur, prev)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(history + i),
+                update_history(hist, pack_mask_epi16(cur_valid), pack_mask_epi16(agree), mask));
+        }
+        return i;
+    }
+
+    size_t temporal_filter_fp_avx2(float * frame, float * last_frame, uint8_t * history, size_t count,
+        float alpha_val, float one_minus_alpha_val, float delta_val, uint8_t mask_val, const uint8_t * persistent)
+    {
+        const auto zero = _mm256_setzero_ps();
+        const auto abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+        const auto alpha = _mm256_set1_ps(alpha_val);
+        const auto one_minus_alpha = _mm256_set1_ps(one_minus_alpha_val);
+        const auto delta_z = _mm256_set1_ps(delta_val);
+        const auto mask = _mm_set1_epi8(static_cast<char>(mask_val));
+        const auto table_lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(persistent));
+        const auto table_hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(persistent + 16));
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            auto cur = _mm256_loadu_ps(frame + i);
+            auto prev = _mm256_loadu_ps(last_frame + i);
+            auto hist = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(history + i));
+
+            auto cur_valid = _mm256_cmp_ps(cur, zero, _CMP_NEQ_UQ);
+            auto prev_valid = _mm256_cmp_ps(prev, zero, _CMP_NEQ_UQ);
+            auto diff = _mm256_and_ps(_mm256_sub_ps(cur, prev), abs_mask);
+            auto agree = _mm256_and_ps(_mm256_and_ps(cur_valid, prev_valid), _mm256_cmp_ps(diff, delta_z, _CMP_LT_OQ));
+            auto fill = _mm256_andnot_ps(cur_valid, _mm256_and_ps(prev_valid,
+                _mm256_castsi256_ps(_mm256_cvtepi8_epi32(is_persistent(hist, table_lo, table_hi)))));
+            auto filtered = _mm256_add_ps(_mm256_mul_ps(alpha, cur), _mm256_mul_ps(one_minus_alpha, prev));
+
+            _mm256_storeu_ps(frame + i, _mm256_blendv_ps(_mm256_blendv_ps(cur, prev, fill), filtered, agree));
+            _mm256_storeu_ps(last_frame + i, _mm256_blendv_ps(_mm256_blendv_ps(prev, cur, cur_valid), filtered, agree));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(history + i),
+                update_history(hist, pack_mask_epi32(cur_valid), pack_mask_epi32(agree), mask));
+        }
+        return i;
+    }
+}
+
+#endif
@@ -12,6 +12,10 @@
 #include "proc/synthetic-stream.h"
 #include "environment.h"
 #include "stream.h"
+#include "image-avx.h"
+#include "concurrency.h"
+
+#include <algorithm>
 
 using namespace librealsense;
 
@@ -192,6 +196,9 @@ inline void get_texture_map_sse(const uint16_t * depth,
         _mm_stream_si128(&res[1], res2_int1);
         res += 2;
     }
+
+    // The map is read by other threads, so make the streaming stores visible before returning
+    _mm_sfence();
 }
 
 image_transform::image_transform(const rs2_intrinsics& from, float depth_scale)
@@ -240,6 +247,44 @@ void image_transform::pre_compute_x_y_map(std::vector<float>& pre_compute_map_x,
     }
 }
 
+template<rs2_distortion dist>
+void image_transform::compute_texture_map(const uint16_t* z_pixels, const std::vector<float>& pre_compute_map_x,
+    const std::vector<float>& pre_compute_map_y, std::vector<int2>& pixels_int, const rs2_intrinsics& to,
+    const rs2_extrinsics& from_to_other)
+{
+    static bool do_avx = has_avx();
+
+    // The kernels work on groups of 8 pixels, which keeps the map pointers of each task aligned
+    const size_t groups = (_depth.height * _depth.width + 7) / 8;
+    thread_pool::shared().parallel_for(groups, groups_per_task, [&](size_t first, size_t last)
+    {
+        auto offset = first * 8;
+        auto count = static_cast<unsigned int>((last - first) * 8);
+        auto out = reinterpret_cast<byte*>(pixels_int.data() + offset);
+#ifdef RS2_HAVE_AVX2_KERNELS
+        if (do_avx)
+        {
+            get_texture_map_avx2<dist>(z_pixels + offset, _depth_scale, count, pre_compute_map_x.data() + offset,
+                pre_compute_map_y.data() + offset, out, to, from_to_other);
+            return;
+        }
+#endif
+        get_texture_map_sse<dist>(z_pixels + offset, _depth_scale, count, pre_compute_map_x.data() + offset,
+            pre_compute_map_y.data() + offset, out, to, from_to_other);
+    });
+}
+
+bool image_transform::supports(const rs2_intrinsics& depth, const rs2_intrinsics& to)
+{
+    // The deprojection maps model inverse brown-conrady only (brown-conrady without coefficients is
+    // the identity), and the kernels project without distortion or with modified brown-conrady
+    auto depth_supported = depth.model == RS2_DISTORTION_NONE || depth.model == RS2_DISTORTION_INVERSE_BROWN_CONRADY ||
+        (depth.model == RS2_DISTORTION_BROWN_CONRADY && std::all_of(std::begin(depth.coeffs), std::end(depth.coeffs), [](float c) { return c == 0.f; }));
+    auto to_supported = to.model == RS2_DISTORTION_NONE || to.model == RS2_DISTORTION_MODIFIED_BROWN_CONRADY ||
+        to.model == RS2_DISTORTION_INVERSE_BROWN_CONRADY;
+    return depth_supported && to_supported;
+}
+
 void image_transform::align_depth_to_other(const uint16_t* z_pixels, uint16_t* dest, int bpp, const rs2_intrinsics& depth, const rs2_intrinsics& to,
     const rs2_extrinsics& from_to_other)
 {
@@ -302,8 +347,7 @@ template<rs2_distortion dist>
 inline void image_transform::align_depth_to_other_sse(const uint16_t * z_pixels, uint16_t * dest, const rs2_intrinsics& depth, const rs2_intrinsics& to,
     const rs2_extrinsics& from_to_other)
 {
-    get_texture_map_sse<dist>(z_pixels, _depth_scale, _depth.height*_depth.width, _pre_compute_map_x_top_left.data(),
-        _pre_compute_map_y_top_left.data(), (byte*)_pixel_top_left_int.data(), to, from_to_other);
+    compute_texture_map<dist>(z_pixels, _pre_compute_map_x_top_left, _pre_compute_map_y_top_left, _pixel_top_left_int, to, from_to_other);
 
     float fov[2];
     rs2_fov(&depth, fov);
@@ -314,8 +358,7 @@ inline void image_transform::align_depth_to_other_sse(const uint16_t * z_pixels,
 
     if (pixels_per_angle_depth.x < pixels_per_angle_target.x || pixels_per_angle_depth.y < pixels_per_angle_target.y || is_special_resolution(depth, to))
     {
-        get_texture_map_sse<dist>(z_pixels, _depth_scale, _depth.height*_depth.width, _pre_compute_map_x_bottom_right.data(),
-            _pre_compute_map_y_bottom_right.data(), (byte*)_pixel_bottom_right_int.data(), to, from_to_other);
+        compute_texture_map<dist>(z_pixels, _pre_compute_map_x_bottom_right, _pre_compute_map_y_bottom_right, _pixel_bottom_right_int, to, from_to_other);
 
         move_depth_to_other(z_pixels, dest, to, _pixel_top_left_int, _pixel_bottom_right_int);
     }
@@ -330,35 +373,38 @@ template<rs2_distortion dist>
 inline void image_transform::align_other_to_depth_sse(const uint16_t * z_pixels, const byte * source, byte * dest, int bpp, const rs2_intrinsics& to,
     const rs2_extrinsics& from_to_other)
 {
-    get_texture_map_sse<dist>(z_pixels, _depth_scale, _depth.height*_depth.width, _pre_compute_map_x_top_left.data(),
-        _pre_compute_map_y_top_left.data(), (byte*)_pixel_top_left_int.data(), to, from_to_other);
-
-    std::vector<int2>& bottom_right = _pixel_top_left_int;
+    // When the other image is smaller, each depth pixel takes the pixel under its bottom-right corner,
+    // otherwise the one under its top-left corner
+    const std::vector<int2>* corner = &_pixel_top_left_int;
     if (to.height < _depth.height && to.width < _depth.width)
     {
-        get_texture_map_sse<dist>(z_pixels, _depth_scale, _depth.height*_depth.width, _pre_compute_map_x_bottom_right.data(),
-            _pre_compute_map_y_bottom_right.data(), (byte*)_pixel_bottom_right_int.data(), to, from_to_other);
-
-        bottom_right = _pixel_bottom_right_int;
+        compute_texture_map<dist>(z_pixels, _pre_compute_map_x_bottom_right, _pre_compute_map_y_bottom_right, _pixel_bottom_right_int, to, from_to_other);
+        corner = &_pixel_bottom_right_int;
     }
+    else
+    {
+        compute_texture_map<dist>(z_pixels, _pre_compute_map_x_top_left, _pre_compute_map_y_top_left, _pixel_top_left_int, to, from_to_other);
+    }
+    const std::vector<int2>& top_left = *corner;
+    const std::vector<int2>& bottom_right = *corner;
 
     switch (bpp)
     {
     case 1:
         move_other_to_depth(z_pixels, reinterpret_cast<const bytes<1>*>(source), reinterpret_cast<bytes<1>*>(dest), to,
-            _pixel_top_left_int, bottom_right);
+            top_left, bottom_right);
         break;
     case 2:
         move_other_to_depth(z_pixels, reinterpret_cast<const bytes<2>*>(source), reinterpret_cast<bytes<2>*>(dest), to,
-            _pixel_top_left_int, bottom_right);
+            top_left, bottom_right);
         break;
     case 3:
         move_other_to_depth(z_pixels, reinterpret_cast<const bytes<3>*>(source), reinterpret_cast<bytes<3>*>(dest), to,
-            _pixel_top_left_int, bottom_right);
+            top_left, bottom_right);
         break;
     case 4:
         move_other_to_depth(z_pixels, reinterpret_cast<const bytes<4>*>(source), reinterpret_cast<bytes<4>*>(dest), to,
-            _pixel_top_left_int, bottom_right);
+            top_left, bottom_right);
         break;
     default:
         break;
@@ -372,29 +418,32 @@ void image_transform::move_other_to_depth(const uint16_t* z_pixels,
     const std::vector<librealsense::int2>& pixel_top_left_int,
     const std::vector<librealsense::int2>& pixel_bottom_right_int)
 {
-    // Iterate over the pixels of the depth image
-    for (int y = 0; y < _depth.height; ++y)
+    // Iterate over the pixels of the depth image. Each writes only its own aligned pixel, so rows are independent.
+    thread_pool::shared().parallel_for(_depth.height, align::rows_per_task, [&](size_t first_row, size_t last_row)
     {
-        for (int x = 0; x < _depth.width; ++x)
+        for (int y = int(first_row); y < int(last_row); ++y)
         {
-            auto depth_pixel_index = y * _depth.width + x;
-            // Skip over depth pixels with the value of zero, we have no depth data so we will not write anything into our aligned images
-            if (z_pixels[depth_pixel_index])
+            for (int x = 0; x < _depth.width; ++x)
             {
-                for (int other_y = pixel_top_left_int[depth_pixel_index].y; other_y <= pixel_bottom_right_int[depth_pixel_index].y; ++other_y)
+                auto depth_pixel_index = y * _depth.width + x;
+                // Skip over depth pixels with the value of zero, we have no depth data so we will not write anything into our aligned images
+                if (z_pixels[depth_pixel_index])
                 {
-                    for (int other_x = pixel_top_left_int[depth_pixel_index].x; other_x <= pixel_bottom_right_int[depth_pixel_index].x; ++other_x)
+                    for (int other_y = pixel_top_left_int[depth_pixel_index].y; other_y <= pixel_bottom_right_int[depth_pixel_index].y; ++other_y)
                     {
-                        if (other_x < 0 || other_y < 0 || other_x >= to.width || other_y >= to.height)
-                            continue;
-                        auto other_ind = other_y * to.width + other_x;
-
-                        dest[depth_pixel_index] = source[other_ind];
+                        for (int other_x = pixel_top_left_int[depth_pixel_index].x; other_x <= pixel_bottom_right_int[depth_pixel_index].x; ++other_x)
+                        {
+                            if (other_x < 0 || other_y < 0 || other_x >= to.width || other_y >= to.height)
+                                continue;
+                            auto other_ind = other_y * to.width + other_x;
+
+                            dest[depth_pixel_index] = source[other_ind];
+                        }
                     }
                 }
             }
         }
-    }
+    });
 }
 
 void align_sse::reset_cache(rs2_stream from, rs2_stream to)
@@ -416,6 +465,10 @@ void align_sse::align_z_to_other(rs2::video_frame& aligned, const rs2::video_fra
 
     auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
 
+    // Other distortion models go through the generic path, which handles all of them
+    if (!image_transform::supports(z_intrin, other_intrin))
+        return align::align_z_to_other(aligned, depth, other_profile, z_scale);
+
     if (_stream_transform == nullptr)
     {
         _stream_transform = std::make_shared<image_transform>(z_intrin, z_scale);
@@ -440,6 +493,9 @@ void align_sse::align_other_to_z(rs2::video_frame& aligned, const rs2::video_fra
     auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
     auto other_pixels = reinterpret_cast<const byte*>(other.get_data());
 
+    if (!image_transform::supports(z_intrin, other_intrin))
+        return align::align_other_to_z(aligned, depth, other, z_scale);
+
     if (_stream_transform == nullptr)
     {
         _stream_transform = std::make_shared<image_transform>(z_intrin, z_scale);
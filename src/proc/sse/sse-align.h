@@ -7,9 +7,23 @@
 
 namespace librealsense
 {
+    // Projects 'size' depth pixels (a multiple of 8) into the other image, as get_texture_map_sse does, 8 at a time.
+    // Instantiated for RS2_DISTORTION_NONE and RS2_DISTORTION_MODIFIED_BROWN_CONRADY.
+    // Built with AVX2 in avx-align.cpp, when RS2_HAVE_AVX2_KERNELS is defined; only call it when has_avx()
+    template<rs2_distortion dist>
+    void get_texture_map_avx2(const uint16_t * depth,
+        float depth_scale,
+        const unsigned int size,
+        const float * pre_compute_x, const float * pre_compute_y,
+        byte * pixels_ptr_int,
+        const rs2_intrinsics& to,
+        const rs2_extrinsics& from_to_other);
+
     class image_transform
     {
     public:
+        // Whether the precomputed maps and kernels model the distortions of both streams
+        static bool supports(const rs2_intrinsics& depth, const rs2_intrinsics& to);
 
         image_transform(const rs2_intrinsics& from,
             float depth_scale);
@@ -28,6 +42,7 @@ namespace librealsense
         void pre_compute_x_y_map_corners();
 
     private:
+        static const size_t groups_per_task = 0x400;
 
         const rs2_intrinsics _depth;
         float _depth_scale;
@@ -44,6 +59,14 @@ namespace librealsense
             std::vector<float>& pre_compute_map_y,
             float offset = 0);
 
+        template<rs2_distortion dist>
+        void compute_texture_map(const uint16_t* z_pixels,
+            const std::vector<float>& pre_compute_map_x,
+            const std::vector<float>& pre_compute_map_y,
+            std::vector<int2>& pixels_int,
+            const rs2_intrinsics& to,
+            const rs2_extrinsics& from_to_other);
+
         template<rs2_distortion dist = RS2_DISTORTION_NONE>
         inline void align_depth_to_other_sse(const uint16_t* z_pixels,
             uint16_t* dest, const rs2_intrinsics& depth,
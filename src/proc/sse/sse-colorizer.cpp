@@ -0,0 +1,48 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "sse-colorizer.h"
+
+#ifdef __SSSE3__
+
+#include <tmmintrin.h> // For SSSE3 intrinsics
+
+namespace librealsense
+{
+    namespace
+    {
+        // Packs 16 RGBX pixels, 4 per register, into 48 bytes of RGB
+        inline void store_rgb(uint8_t * rgb, __m128i p0, __m128i p1, __m128i p2, __m128i p3)
+        {
+            const auto drop_x = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+            p0 = _mm_shuffle_epi8(p0, drop_x);
+            p1 = _mm_shuffle_epi8(p1, drop_x);
+            p2 = _mm_shuffle_epi8(p2, drop_x);
+            p3 = _mm_shuffle_epi8(p3, drop_x);
+
+            auto out = reinterpret_cast<__m128i*>(rgb);
+            _mm_storeu_si128(out + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+            _mm_storeu_si128(out + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+            _mm_storeu_si128(out + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+        }
+
+        inline __m128i lookup(const uint16_t * depth, const uint32_t * lut)
+        {
+            return _mm_setr_epi32(lut[depth[0]], lut[depth[1]], lut[depth[2]], lut[depth[3]]);
+        }
+    }
+
+    size_t colorize_z16_lut_sse(const uint16_t * depth, uint8_t * rgb, size_t count, const uint32_t * lut)
+    {
+        // SSSE3 has no gather, so the table is read per pixel and only the packing is vectorized
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            store_rgb(rgb + i * 3, lookup(depth + i, lut), lookup(depth + i + 4, lut),
+                      lookup(depth + i + 8, lut), lookup(depth + i + 12, lut));
+        }
+        return i;
+    }
+}
+
+#endif // __SSSE3__
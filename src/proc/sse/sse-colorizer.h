@@ -0,0 +1,20 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace librealsense
+{
+    // Colorizes Z16 depth through a lookup table of 0x10000 entries holding the RGB color of each depth
+    // value in the low three bytes. Each function converts up to 'count' pixels in groups of 16 and
+    // returns the number of pixels it wrote; the rest is left for the scalar code.
+#ifdef __SSSE3__
+    size_t colorize_z16_lut_sse(const uint16_t * depth, uint8_t * rgb, size_t count, const uint32_t * lut);
+#endif
+
+    // Built with AVX2 in avx-colorizer.cpp, when RS2_HAVE_AVX2_KERNELS is defined; only call it when has_avx()
+    size_t colorize_z16_lut_avx2(const uint16_t * depth, uint8_t * rgb, size_t count, const uint32_t * lut);
+}
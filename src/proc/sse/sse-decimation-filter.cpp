@@ -0,0 +1,141 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "sse-decimation-filter.h"
+
+#ifdef __SSSE3__
+
+#include <tmmintrin.h> // For SSSE3 intrinsics
+
+namespace librealsense
+{
+    namespace
+    {
+        inline __m128i select_si128(__m128i mask, __m128i if_true, __m128i if_false)
+        {
+            return _mm_or_si128(_mm_and_si128(mask, if_true), _mm_andnot_si128(mask, if_false));
+        }
+
+        inline __m128i load(const uint16_t * p)
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        // SSSE3 only compares signed 16-bit values, so the pixels are biased into the signed range.
+        // Zero (invalid) pixels become the largest value, so they sort after all the valid ones;
+        // 'zeros' accumulates -1 for each of them.
+        inline __m128i to_sortable(__m128i v, __m128i& zeros)
+        {
+            auto invalid = _mm_cmpeq_epi16(v, _mm_setzero_si128());
+            zeros = _mm_add_epi16(zeros, invalid);
+            return _mm_xor_si128(_mm_or_si128(v, invalid), _mm_set1_epi16(-0x8000));
+        }
+
+        inline void sort2(__m128i& a, __m128i& b)
+        {
+            auto lo = _mm_min_epi16(a, b);
+            b = _mm_max_epi16(a, b);
+            a = lo;
+        }
+
+        // Splits 16 consecutive pixels into the even and the odd ones
+        inline void load_2x(const uint16_t * p, __m128i& c0, __m128i& c1)
+        {
+            const auto split = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+            auto a = _mm_shuffle_epi8(load(p), split);
+            auto b = _mm_shuffle_epi8(load(p + 8), split);
+            c0 = _mm_unpacklo_epi64(a, b);
+            c1 = _mm_unpackhi_epi64(a, b);
+        }
+
+        // Splits 24 consecutive pixels into pixels 3i, 3i+1 and 3i+2
+        inline void load_3x(const uint16_t * p, __m128i& c0, __m128i& c1, __m128i& c2)
+        {
+            auto a = load(p);
+            auto b = load(p + 8);
+            auto c = load(p + 16);
+
+            c0 = _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(a, _mm_setr_epi8(0, 1, 6, 7, 12, 13, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128)),
+                _mm_shuffle_epi8(b, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, 2, 3, 8, 9, 14, 15, -128, -128, -128, -128))),
+                _mm_shuffle_epi8(c, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 4, 5, 10, 11)));
+            c1 = _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(a, _mm_setr_epi8(2, 3, 8, 9, 14, 15, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128)),
+                _mm_shuffle_epi8(b, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, 4, 5, 10, 11, -128, -128, -128, -128, -128, -128))),
+                _mm_shuffle_epi8(c, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 0, 1, 6, 7, 12, 13)));
+            c2 = _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(a, _mm_setr_epi8(4, 5, 10, 11, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128)),
+                _mm_shuffle_epi8(b, _mm_setr_epi8(-128, -128, -128, -128, 0, 1, 6, 7, 12, 13, -128, -128, -128, -128, -128, -128))),
+                _mm_shuffle_epi8(c, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 2, 3, 8, 9, 14, 15)));
+        }
+
+        // Returns the biased median back as a pixel value, or zero when all the pixels were invalid
+        inline __m128i from_sortable(__m128i median, __m128i valid)
+        {
+            auto none = _mm_cmpeq_epi16(valid, _mm_setzero_si128());
+            return _mm_andnot_si128(none, _mm_xor_si128(median, _mm_set1_epi16(-0x8000)));
+        }
+    }
+
+    size_t decimate_median_2x2_z16_sse(const uint16_t * in, size_t width_in, uint16_t * out, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i p[4];
+            load_2x(in + 2 * i, p[0], p[1]);
+            load_2x(in + width_in + 2 * i, p[2], p[3]);
+
+            auto zeros = _mm_setzero_si128();
+            for (auto& v : p)
+                v = to_sortable(v, zeros);
+
+            sort2(p[0], p[1]); sort2(p[2], p[3]);
+            sort2(p[0], p[2]); sort2(p[1], p[3]);
+            sort2(p[1], p[2]);
+
+            // With k valid pixels the median is the sorted value at (k - 1) / 2
+            auto valid = _mm_add_epi16(_mm_set1_epi16(4), zeros);
+            auto median = select_si128(_mm_cmpgt_epi16(valid, _mm_set1_epi16(2)), p[1], p[0]);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), from_sortable(median, valid));
+        }
+        return i;
+    }
+
+    size_t decimate_median_3x3_z16_sse(const uint16_t * in, size_t width_in, uint16_t * out, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i p[9];
+            load_3x(in + 3 * i, p[0], p[1], p[2]);
+            load_3x(in + width_in + 3 * i, p[3], p[4], p[5]);
+            load_3x(in + 2 * width_in + 3 * i, p[6], p[7], p[8]);
+
+            auto zeros = _mm_setzero_si128();
+            for (auto& v : p)
+                v = to_sortable(v, zeros);
+
+            // 25-comparator sorting network for 9 values
+            sort2(p[0], p[3]); sort2(p[1], p[7]); sort2(p[2], p[5]); sort2(p[4], p[8]);
+            sort2(p[0], p[7]); sort2(p[2], p[4]); sort2(p[3], p[8]); sort2(p[5], p[6]);
+            sort2(p[0], p[2]); sort2(p[1], p[3]); sort2(p[4], p[5]); sort2(p[7], p[8]);
+            sort2(p[1], p[4]); sort2(p[3], p[6]); sort2(p[5], p[7]);
+            sort2(p[0], p[1]); sort2(p[2], p[4]); sort2(p[3], p[5]); sort2(p[6], p[8]);
+            sort2(p[2], p[3]); sort2(p[4], p[5]); sort2(p[6], p[7]);
+            sort2(p[1], p[2]); sort2(p[3], p[4]); sort2(p[5], p[6]);
+
+            // With k valid pixels the median is the sorted value at (k - 1) / 2
+            auto valid = _mm_add_epi16(_mm_set1_epi16(9), zeros);
+            auto median = p[0];
+            for (int k = 1; k <= 4; k++)
+                median = select_si128(_mm_cmpgt_epi16(valid, _mm_set1_epi16(short(2 * k))), p[k], median);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), from_sortable(median, valid));
+        }
+        return i;
+    }
+}
+
+#endif // __SSSE3__
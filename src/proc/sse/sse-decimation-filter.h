@@ -0,0 +1,24 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace librealsense
+{
+    // Median decimation of Z16 depth, vectorized across adjacent output pixels with sorting networks.
+    // Each function produces up to 'count' pixels of one output row from the 2 (or 3) input rows starting
+    // at 'in', in whole vector-width groups, and returns the number of pixels it wrote; the rest is left
+    // for the scalar code. Zero (invalid) pixels are excluded from the median, and even-sized sets pick
+    // the member one below the middle, so the results are bit-exact with decimation_filter::decimate_depth.
+#ifdef __SSSE3__
+    size_t decimate_median_2x2_z16_sse(const uint16_t * in, size_t width_in, uint16_t * out, size_t count);
+    size_t decimate_median_3x3_z16_sse(const uint16_t * in, size_t width_in, uint16_t * out, size_t count);
+#endif
+
+    // Built with AVX2 in avx-decimation-filter.cpp, when RS2_HAVE_AVX2_KERNELS is defined; only call them when has_avx()
+    size_t decimate_median_2x2_z16_avx2(const uint16_t * in, size_t width_in, uint16_t * out, size_t count);
+    size_t decimate_median_3x3_z16_avx2(const uint16_t * in, size_t width_in, uint16_t * out, size_t count);
+}
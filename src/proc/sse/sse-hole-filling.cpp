@@ -0,0 +1,187 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "sse-hole-filling.h"
+
+#ifdef __SSSE3__
+
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#include <cstring>
+
+namespace librealsense
+{
+    namespace
+    {
+        inline __m128i select_si128(__m128i mask, __m128i if_true, __m128i if_false)
+        {
+            return _mm_or_si128(_mm_and_si128(mask, if_true), _mm_andnot_si128(mask, if_false));
+        }
+
+        inline __m128 select_ps(__m128 mask, __m128 if_true, __m128 if_false)
+        {
+            return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+        }
+
+        inline __m128i load(const uint16_t * p)
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        inline void store(uint16_t * p, __m128i v)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+        }
+
+        // SSSE3 only compares signed 16-bit values, so unsigned comparisons go through a bias
+        inline __m128i max_epu16(__m128i a, __m128i b)
+        {
+            const auto bias = _mm_set1_epi16(-0x8000);
+            return _mm_xor_si128(_mm_max_epi16(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias)), bias);
+        }
+
+        inline __m128i cmplt_epu16(__m128i a, __m128i b)
+        {
+            const auto bias = _mm_set1_epi16(-0x8000);
+            return _mm_cmplt_epi16(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+        }
+
+        // Disparity holes are identified by their bit pattern, as in the scalar code
+        inline __m128 is_hole_fp(__m128 v)
+        {
+            return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_castps_si128(v), _mm_setzero_si128()));
+        }
+
+        inline bool is_hole_fp(float v)
+        {
+            int32_t bits;
+            memcpy(&bits, &v, sizeof(bits));
+            return !bits;
+        }
+    }
+
+    size_t holes_fill_farest_z16_sse(const uint16_t * in, uint16_t * out, size_t width)
+    {
+        const auto zero = _mm_setzero_si128();
+
+        size_t i = 1;
+        for (; i + 8 <= width; i += 8)
+        {
+            auto cur = load(in + i);
+            auto holes = _mm_cmpeq_epi16(cur, zero);
+            auto hole_bits = _mm_movemask_epi8(holes);
+            if (!hole_bits)
+            {
+                if (out != in)
+                    store(out + i, cur);
+                continue;
+            }
+
+            auto around = max_epu16(max_epu16(load(out + i - width - 1), load(out + i - width)),
+                                    max_epu16(load(in + i + width - 1), load(in + i + width)));
+            store(out + i, select_si128(holes, around, cur));
+
+            for (size_t k = 0; k < 8; k++)
+            {
+                if ((hole_bits & (1 << (2 * k))) && out[i + k - 1] > out[i + k])
+                    out[i + k] = out[i + k - 1];
+            }
+        }
+        return i;
+    }
+
+    size_t holes_fill_nearest_z16_sse(const uint16_t * in, uint16_t * out, size_t width)
+    {
+        const auto zero = _mm_setzero_si128();
+
+        size_t i = 1;
+        for (; i + 8 <= width; i += 8)
+        {
+            auto cur = load(in + i);
+            auto holes = _mm_cmpeq_epi16(cur, zero);
+            auto hole_bits = _mm_movemask_epi8(holes);
+            if (!hole_bits)
+            {
+                if (out != in)
+                    store(out + i, cur);
+                continue;
+            }
+
+            // Starting from the top neighbor, take any smaller valid one
+            auto around = load(out + i - width);
+            const __m128i others[3] = { load(out + i - width - 1), load(in + i + width - 1), load(in + i + width) };
+            for (auto&& n : others)
+                around = select_si128(_mm_andnot_si128(_mm_cmpeq_epi16(n, zero), cmplt_epu16(n, around)), n, around);
+            store(out + i, select_si128(holes, around, cur));
+
+            for (size_t k = 0; k < 8; k++)
+            {
+                auto left = out[i + k - 1];
+                if ((hole_bits & (1 << (2 * k))) && left && left < out[i + k])
+                    out[i + k] = left;
+            }
+        }
+        return i;
+    }
+
+    size_t holes_fill_farest_fp_sse(const float * in, float * out, size_t width)
+    {
+        size_t i = 1;
+        for (; i + 4 <= width; i += 4)
+        {
+            auto cur = _mm_loadu_ps(in + i);
+            auto holes = is_hole_fp(cur);
+            auto hole_bits = _mm_movemask_ps(holes);
+            if (!hole_bits)
+            {
+                if (out != in)
+                    _mm_storeu_ps(out + i, cur);
+                continue;
+            }
+
+            auto around = _mm_max_ps(_mm_max_ps(_mm_loadu_ps(out + i - width - 1), _mm_loadu_ps(out + i - width)),
+                                     _mm_max_ps(_mm_loadu_ps(in + i + width - 1), _mm_loadu_ps(in + i + width)));
+            _mm_storeu_ps(out + i, select_ps(holes, around, cur));
+
+            for (size_t k = 0; k < 4; k++)
+            {
+                if ((hole_bits & (1 << k)) && out[i + k - 1] > out[i + k])
+                    out[i + k] = out[i + k - 1];
+            }
+        }
+        return i;
+    }
+
+    size_t holes_fill_nearest_fp_sse(const float * in, float * out, size_t width)
+    {
+        size_t i = 1;
+        for (; i + 4 <= width; i += 4)
+        {
+            auto cur = _mm_loadu_ps(in + i);
+            auto holes = is_hole_fp(cur);
+            auto hole_bits = _mm_movemask_ps(holes);
+            if (!hole_bits)
+            {
+                if (out != in)
+                    _mm_storeu_ps(out + i, cur);
+                continue;
+            }
+
+            // Starting from the top neighbor, take any smaller valid one
+            auto around = _mm_loadu_ps(out + i - width);
+            const __m128 others[3] = { _mm_loadu_ps(out + i - width - 1), _mm_loadu_ps(in + i + width - 1), _mm_loadu_ps(in + i + width) };
+            for (auto&& n : others)
+                around = select_ps(_mm_andnot_ps(is_hole_fp(n), _mm_cmplt_ps(n, around)), n, around);
+            _mm_storeu_ps(out + i, select_ps(holes, around, cur));
+
+            for (size_t k = 0; k < 4; k++)
+            {
+                auto left = out[i + k - 1];
+                if ((hole_bits & (1 << k)) && !is_hole_fp(left) && left < out[i + k])
+                    out[i + k] = left;
+            }
+        }
+        return i;
+    }
+}
+
+#endif // __SSSE3__
@@ -0,0 +1,24 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace librealsense
+{
+    // Vectorized "farest/nearest from around" hole filling of one image row.
+    // 'in' and 'out' point to the row in the input and the output images, which may be the same buffer;
+    // the row above is read from the output (already filled) and the row below from the input.
+    // The neighbors of all the holes in a vector are reduced at once; only the dependency on the left
+    // neighbor, which may be a hole filled just before, is resolved per pixel. Each function starts
+    // at column 1 and returns the first column left for the scalar code. The results are bit-exact
+    // with hole_filling_filter::holes_fill_around.
+#ifdef __SSSE3__
+    size_t holes_fill_farest_z16_sse(const uint16_t * in, uint16_t * out, size_t width);
+    size_t holes_fill_nearest_z16_sse(const uint16_t * in, uint16_t * out, size_t width);
+    size_t holes_fill_farest_fp_sse(const float * in, float * out, size_t width);
+    size_t holes_fill_nearest_fp_sse(const float * in, float * out, size_t width);
+#endif
+}
@@ -54,21 +54,18 @@ namespace librealsense
         }
     }
 
-    const float3* pointcloud_sse::depth_to_points(rs2::points output,
-            const rs2_intrinsics &depth_intrinsics, 
-            const rs2::depth_frame& depth_frame,
-            float depth_scale)
+    void pointcloud_sse::deproject_rows(float3* points, const uint16_t* depth, float depth_scale, int first_row, int last_row)
     {
-#ifdef __SSSE3__
-
-        auto depth_image = (const uint16_t*)depth_frame.get_data();
-
-        float* pre_compute_x = _pre_compute_map_x.data();
-        float* pre_compute_y = _pre_compute_map_y.data();
+        auto offset = first_row * _depth_intrinsics->width;
+        uint32_t size = (last_row - first_row) * _depth_intrinsics->width;
 
-        uint32_t size = depth_intrinsics.height * depth_intrinsics.width;
+        auto depth_image = depth + offset;
+        const float* pre_compute_x = _pre_compute_map_x.data() + offset;
+        const float* pre_compute_y = _pre_compute_map_y.data() + offset;
+        auto point = (float*)(points + offset);
+        uint32_t i = 0;
 
-        auto point = (float*)output.get_vertices();
+#ifdef __SSSE3__
 
         //mask for shuffle
         const __m128i mask0 = _mm_set_epi8((char)0xff, (char)0xff, (char)7, (char)6, (char)0xff, (char)0xff, (char)5, (char)4,
@@ -81,15 +78,16 @@ namespace librealsense
         auto mapx = pre_compute_x;
         auto mapy = pre_compute_y;
 
-        for (unsigned int i = 0; i < size; i += 8)
+        // Rows start anywhere within the frame buffers, so the loads and stores are unaligned
+        for (; i + 8 <= size; i += 8)
         {
-            auto x0 = _mm_load_ps(mapx + i);
-            auto x1 = _mm_load_ps(mapx + i + 4);
+            auto x0 = _mm_loadu_ps(mapx + i);
+            auto x1 = _mm_loadu_ps(mapx + i + 4);
 
-            auto y0 = _mm_load_ps(mapy + i);
-            auto y1 = _mm_load_ps(mapy + i + 4);
+            auto y0 = _mm_loadu_ps(mapy + i);
+            auto y1 = _mm_loadu_ps(mapy + i + 4);
 
-            __m128i d = _mm_load_si128((__m128i const*)(depth_image + i));        //d7 d7 d6 d6 d5 d5 d4 d4 d3 d3 d2 d2 d1 d1 d0 d0
+            __m128i d = _mm_loadu_si128((__m128i const*)(depth_image + i));        //d7 d7 d6 d6 d5 d5 d4 d4 d3 d3 d2 d2 d1 d1 d0 d0
 
                                                                             //split the depth pixel to 2 registers of 4 floats each
             __m128i d0 = _mm_shuffle_epi8(d, mask0);        // 00 00 d3 d3 00 00 d2 d2 00 00 d1 d1 00 00 d0 d0
@@ -126,16 +124,80 @@ namespace librealsense
 
 
             //store 8 points of x y z
-            _mm_stream_ps(&point[0], xyz01);
-            _mm_stream_ps(&point[4], xyz02);
-            _mm_stream_ps(&point[8], xyz03);
-            _mm_stream_ps(&point[12], xyz11);
-            _mm_stream_ps(&point[16], xyz12);
-            _mm_stream_ps(&point[20], xyz13);
+            _mm_storeu_ps(&point[0], xyz01);
+            _mm_storeu_ps(&point[4], xyz02);
+            _mm_storeu_ps(&point[8], xyz03);
+            _mm_storeu_ps(&point[12], xyz11);
+            _mm_storeu_ps(&point[16], xyz12);
+            _mm_storeu_ps(&point[20], xyz13);
             point += 24;
         }
 #endif
-        return (float3*)output.get_vertices();
+        // Remaining pixels, computed as the vector code does
+        for (; i < size; ++i)
+        {
+            float z = float(depth_image[i]) * depth_scale;
+            point[0] = z * pre_compute_x[i];
+            point[1] = z * pre_compute_y[i];
+            point[2] = z;
+            point += 3;
+        }
+    }
+
+    namespace
+    {
+        // Scalar version of the projection in get_texture_map_sse, with the same operations in the same order
+        inline void project_point_sse_order(const float3& point, const rs2_intrinsics& other_intrinsics,
+            const rs2_extrinsics& extr, float2& pixel, float2& tex)
+        {
+            auto r = extr.rotation;
+            auto t = extr.translation;
+            auto c = other_intrinsics.coeffs;
+
+            float p_x = r[0] * point.x + (r[3] * point.y + (r[6] * point.z + t[0]));
+            float p_y = r[1] * point.x + (r[4] * point.y + (r[7] * point.z + t[1]));
+            float p_z = r[2] * point.x + (r[5] * point.y + (r[8] * point.z + t[2]));
+
+            p_x = p_x / p_z;
+            p_y = p_y / p_z;
+
+            float r2 = p_x * p_x + p_y * p_y;
+            float r3 = c[1] * (r2 * r2) + c[4] * (r2 * (r2 * r2));
+            float f = 1 + (c[0] * r2 + r3);
+
+            float x_f = p_x * f;
+            float y_f = p_y * f;
+
+            bool brown = other_intrinsics.model == RS2_DISTORTION_BROWN_CONRADY;
+            float x_f_dist = brown ? p_x : x_f;
+            float y_f_dist = brown ? p_y : y_f;
+
+            float r4 = c[3] * (r2 + 2 * (x_f_dist * x_f_dist));
+            float d_x = x_f + (2 * (c[2] * (x_f_dist * y_f_dist)) + r4);
+
+            float r5 = c[2] * (r2 + 2 * (y_f_dist * y_f_dist));
+            float d_y = y_f + (2 * (c[3] * (x_f_dist * y_f_dist)) + r5);
+
+            if (other_intrinsics.model != RS2_DISTORTION_NONE)
+            {
+                p_x = d_x;
+                p_y = d_y;
+            }
+
+            //zero the x and y if z is zero
+            if (point.z != 0)
+            {
+                p_x = p_x * other_intrinsics.fx + other_intrinsics.ppx;
+                p_y = p_y * other_intrinsics.fy + other_intrinsics.ppy;
+            }
+            else
+            {
+                p_x = p_y = 0;
+            }
+
+            pixel = { p_x, p_y };
+            tex = { p_x / float(other_intrinsics.width), p_y / float(other_intrinsics.height) };
+        }
     }
 
     void pointcloud_sse::get_texture_map_sse( float2 * texture_map,
@@ -147,6 +209,8 @@ namespace librealsense
                                           float2 * pixels_ptr )
     {
         auto tex_ptr = texture_map;
+        auto size = height * width;
+        auto i = 0UL;
 
 #ifdef __SSSE3__
         auto point = reinterpret_cast<const float*>(points);
@@ -182,12 +246,12 @@ namespace librealsense
         auto one = _mm_set_ps1(1);
         auto two = _mm_set_ps1(2);
 
-        for (auto i = 0UL; i < height*width * 3; i += 12)
+        for (; i + 4 <= size; i += 4)
         {
             //load 4 points (x,y,z)
-            auto xyz1 = _mm_load_ps(point + i);
-            auto xyz2 = _mm_load_ps(point + i + 4);
-            auto xyz3 = _mm_load_ps(point + i + 8);
+            auto xyz1 = _mm_loadu_ps(point + i * 3);
+            auto xyz2 = _mm_loadu_ps(point + i * 3 + 4);
+            auto xyz3 = _mm_loadu_ps(point + i * 3 + 8);
 
 
             //gather x,y,z
@@ -245,8 +309,8 @@ namespace librealsense
             auto xyxy1 = _mm_shuffle_ps(xx_yy01, xx_yy23, _MM_SHUFFLE(2, 0, 2, 0));
             auto xyxy2 = _mm_shuffle_ps(xx_yy01, xx_yy23, _MM_SHUFFLE(3, 1, 3, 1));
 
-            _mm_stream_ps(res1, xyxy1);
-            _mm_stream_ps(res1 + 4, xyxy2);
+            _mm_storeu_ps(res1, xyxy1);
+            _mm_storeu_ps(res1 + 4, xyxy2);
             res1 += 8;
 
             //normalize x and y
@@ -260,29 +324,21 @@ namespace librealsense
             xyxy1 = _mm_shuffle_ps(xx_yy01, xx_yy23, _MM_SHUFFLE(2, 0, 2, 0));
             xyxy2 = _mm_shuffle_ps(xx_yy01, xx_yy23, _MM_SHUFFLE(3, 1, 3, 1));
 
-            _mm_stream_ps(res, xyxy1);
-            _mm_stream_ps(res + 4, xyxy2);
+            _mm_storeu_ps(res, xyxy1);
+            _mm_storeu_ps(res + 4, xyxy2);
             res += 8;
         }
 #endif
-
+        for (; i < size; ++i)
+            project_point_sse_order(points[i], other_intrinsics, extr, pixels_ptr[i], tex_ptr[i]);
     }
 
-    void pointcloud_sse::get_texture_map( rs2::points output,
-                                          const float3 * points,
-                                          const unsigned int width,
-                                          const unsigned int height,
-                                          const rs2_intrinsics & other_intrinsics,
-                                          const rs2_extrinsics & extr,
-                                          float2 * pixels_ptr )
+    void pointcloud_sse::map_texture_rows(float2* tex_ptr, float2* pixels_ptr, const float3* points,
+        const rs2_intrinsics& other_intrinsics, const rs2_extrinsics& extr, int first_row, int last_row)
     {
-
-        get_texture_map_sse( (float2 *)output.get_texture_coordinates(),
-                         points,
-                         width,
-                         height,
-                         other_intrinsics,
-                         extr,
-                         pixels_ptr );
+        auto width = _depth_intrinsics->width;
+        auto offset = first_row * width;
+        get_texture_map_sse(tex_ptr + offset, points + offset, width, last_row - first_row,
+            other_intrinsics, extr, pixels_ptr + offset);
     }
     }
@@ -21,19 +21,9 @@ namespace librealsense
 
     private:
         void preprocess() override;
-        const float3 * depth_to_points(
-            rs2::points output,
-            const rs2_intrinsics &depth_intrinsics, 
-            const rs2::depth_frame& depth_frame, 
-            float depth_scale) override;
-        void get_texture_map(
-            rs2::points output,
-            const float3* points,
-            const unsigned int width,
-            const unsigned int height,
-            const rs2_intrinsics &other_intrinsics,
-            const rs2_extrinsics& extr,
-            float2* pixels_ptr) override;
+        void deproject_rows(float3* points, const uint16_t* depth, float depth_scale, int first_row, int last_row) override;
+        void map_texture_rows(float2* tex_ptr, float2* pixels_ptr, const float3* points,
+            const rs2_intrinsics& other_intrinsics, const rs2_extrinsics& extr, int first_row, int last_row) override;
 
         std::vector<float> _pre_compute_map_x;
         std::vector<float> _pre_compute_map_y;
@@ -0,0 +1,155 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "sse-spatial-filter.h"
+
+#ifdef __SSSE3__
+
+#include <tmmintrin.h> // For SSSE3 intrinsics
+
+namespace librealsense
+{
+    namespace
+    {
+        inline __m128 select_ps(__m128 mask, __m128 if_true, __m128 if_false)
+        {
+            return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+        }
+
+        inline __m128i select_si128(__m128i mask, __m128i if_true, __m128i if_false)
+        {
+            return _mm_or_si128(_mm_and_si128(mask, if_true), _mm_andnot_si128(mask, if_false));
+        }
+
+        // Disparity values are valid when their bit pattern is a positive integer, as in the scalar code
+        inline __m128 is_valid_fp(__m128 v)
+        {
+            return _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_castps_si128(v), _mm_setzero_si128()));
+        }
+
+        // One step of the recursion for 4 columns: filters 'innovation' against the running state
+        // and returns the value to store back into the image
+        inline __m128 filter_step_fp(__m128 innovation, __m128& state, __m128& previous,
+            __m128 alpha, __m128 one_minus_alpha, __m128 delta_z, __m128 neg_delta_z)
+        {
+            auto valid = is_valid_fp(innovation);
+            auto delta = _mm_sub_ps(previous, innovation);
+            auto small = _mm_and_ps(_mm_cmplt_ps(delta, delta_z), _mm_cmpgt_ps(delta, neg_delta_z));
+            auto apply = _mm_and_ps(_mm_and_ps(valid, is_valid_fp(previous)), small);
+            auto filtered = _mm_add_ps(_mm_mul_ps(innovation, alpha), _mm_mul_ps(state, one_minus_alpha));
+
+            state = select_ps(apply, filtered, select_ps(valid, innovation, state));
+            previous = innovation;
+            return select_ps(apply, filtered, innovation);
+        }
+
+        // |a - b| < delta for 8 unsigned 16-bit lanes
+        inline __m128i diff_below_z16(__m128i a, __m128i b, __m128i delta)
+        {
+            auto diff = _mm_or_si128(_mm_subs_epu16(a, b), _mm_subs_epu16(b, a));
+            auto not_below = _mm_cmpeq_epi16(_mm_subs_epu16(delta, diff), _mm_setzero_si128());
+            return _mm_xor_si128(not_below, _mm_set1_epi16(-1));
+        }
+
+        // a * alpha + b * (1 - alpha), rounded as the scalar code does (+0.5 and truncate)
+        inline __m128i mix_z16(__m128i a, __m128i b, __m128 alpha, __m128 one_minus_alpha)
+        {
+            const auto zero = _mm_setzero_si128();
+            const auto half = _mm_set1_ps(0.5f);
+            const auto bias = _mm_set1_epi32(0x8000);
+
+            auto a_lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(a, zero));
+            auto a_hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(a, zero));
+            auto b_lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(b, zero));
+            auto b_hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(b, zero));
+
+            auto lo = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a_lo, alpha), _mm_mul_ps(b_lo, one_minus_alpha)), half);
+            auto hi = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a_hi, alpha), _mm_mul_ps(b_hi, one_minus_alpha)), half);
+
+            // SSSE3 has no unsigned saturating pack, so bias the values into the signed range and back
+            auto packed = _mm_packs_epi32(_mm_sub_epi32(_mm_cvttps_epi32(lo), bias),
+                                          _mm_sub_epi32(_mm_cvttps_epi32(hi), bias));
+            return _mm_xor_si128(packed, _mm_set1_epi16(-0x8000));
+        }
+    }
+
+    size_t recursive_filter_vertical_fp_sse(float * image, size_t width, size_t height,
+        size_t first_col, size_t last_col, float alpha_val, float delta_val)
+    {
+        const auto alpha = _mm_set1_ps(alpha_val);
+        const auto one_minus_alpha = _mm_set1_ps(1.f - alpha_val);
+        const auto delta_z = _mm_set1_ps(delta_val);
+        const auto neg_delta_z = _mm_set1_ps(-delta_val);
+
+        if (height < 2)
+            return first_col;
+
+        size_t u = first_col;
+        for (; u + 4 <= last_col; u += 4)
+        {
+            // top to bottom
+            float * im = image + u;
+            auto state = _mm_loadu_ps(im);
+            auto previous = state;
+            for (size_t v = 1; v < height; v++)
+            {
+                im += width;
+                _mm_storeu_ps(im, filter_step_fp(_mm_loadu_ps(im), state, previous,
+                    alpha, one_minus_alpha, delta_z, neg_delta_z));
+            }
+
+            // bottom to top
+            state = _mm_loadu_ps(im);
+            previous = state;
+            for (size_t v = 1; v < height; v++)
+            {
+                im -= width;
+                _mm_storeu_ps(im, filter_step_fp(_mm_loadu_ps(im), state, previous,
+                    alpha, one_minus_alpha, delta_z, neg_delta_z));
+            }
+        }
+        return u;
+    }
+
+    size_t recursive_filter_vertical_z16_sse(uint16_t * image, size_t width, size_t height,
+        size_t first_col, size_t last_col, float alpha_val, uint16_t delta_val)
+    {
+        const auto alpha = _mm_set1_ps(alpha_val);
+        const auto one_minus_alpha = _mm_set1_ps(1.f - alpha_val);
+        const auto delta_z = _mm_set1_epi16(static_cast<short>(delta_val));
+        const auto zero = _mm_setzero_si128();
+
+        if (height < 2)
+            return first_col;
+
+        size_t u = first_col;
+        for (; u + 8 <= last_col; u += 8)
+        {
+            // top to bottom, over all the values
+            uint16_t * im = image + u;
+            for (size_t v = 1; v < height; v++, im += width)
+            {
+                auto im0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(im));
+                auto imw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(im + width));
+                auto apply = diff_below_z16(im0, imw, delta_z);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(im + width),
+                    select_si128(apply, mix_z16(imw, im0, alpha, one_minus_alpha), imw));
+            }
+
+            // bottom to top, over valid values only
+            for (size_t v = height - 1; v-- > 0;)
+            {
+                im = image + u + v * width;
+                auto im0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(im));
+                auto imw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(im + width));
+                auto invalid = _mm_or_si128(_mm_cmpeq_epi16(im0, zero), _mm_cmpeq_epi16(imw, zero));
+                auto apply = _mm_andnot_si128(invalid, diff_below_z16(im0, imw, delta_z));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(im),
+                    select_si128(apply, mix_z16(im0, imw, alpha, one_minus_alpha), im0));
+            }
+        }
+        return u;
+    }
+}
+
+#endif // __SSSE3__
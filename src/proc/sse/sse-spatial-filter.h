@@ -0,0 +1,27 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace librealsense
+{
+    // Vertical pass of the spatial filter's domain transform, vectorized across adjacent columns.
+    // Each function filters columns [first_col, last_col) in whole vector-width groups, top to
+    // bottom and then bottom to top, and returns the first column it left for the scalar code.
+    // The results are bit-exact with the scalar implementation in spatial-filter.h/.cpp.
+#ifdef __SSSE3__
+    size_t recursive_filter_vertical_fp_sse(float * image, size_t width, size_t height,
+        size_t first_col, size_t last_col, float alpha, float delta_z);
+    size_t recursive_filter_vertical_z16_sse(uint16_t * image, size_t width, size_t height,
+        size_t first_col, size_t last_col, float alpha, uint16_t delta_z);
+#endif
+
+    // Built with AVX2 in avx-spatial-filter.cpp, when RS2_HAVE_AVX2_KERNELS is defined; only call them when has_avx()
+    size_t recursive_filter_vertical_fp_avx2(float * image, size_t width, size_t height,
+        size_t first_col, size_t last_col, float alpha, float delta_z);
+    size_t recursive_filter_vertical_z16_avx2(uint16_t * image, size_t width, size_t height,
+        size_t first_col, size_t last_col, float alpha, uint16_t delta_z);
+}
@@ -0,0 +1,147 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "sse-temporal-filter.h"
+
+#ifdef __SSSE3__
+
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#include <cstring>
+
+namespace librealsense
+{
+    namespace
+    {
+        inline __m128i select_si128(__m128i mask, __m128i if_true, __m128i if_false)
+        {
+            return _mm_or_si128(_mm_and_si128(mask, if_true), _mm_andnot_si128(mask, if_false));
+        }
+
+        inline __m128 select_ps(__m128 mask, __m128 if_true, __m128 if_false)
+        {
+            return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+        }
+
+        // Looks up the bit of each history byte in the 256-bit persistence table; 0xFF where it is set
+        inline __m128i is_persistent(__m128i hist, __m128i table_lo, __m128i table_hi)
+        {
+            auto byte_index = _mm_and_si128(_mm_srli_epi16(hist, 3), _mm_set1_epi8(0x1F));
+            auto from_hi = _mm_cmpgt_epi8(byte_index, _mm_set1_epi8(15));
+            auto bytes = select_si128(from_hi, _mm_shuffle_epi8(table_hi, byte_index), _mm_shuffle_epi8(table_lo, byte_index));
+            auto bit = _mm_shuffle_epi8(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128),
+                                        _mm_and_si128(hist, _mm_set1_epi8(7)));
+            return _mm_cmpeq_epi8(_mm_and_si128(bytes, bit), bit);
+        }
+
+        // |a - b| < delta for 8 unsigned 16-bit lanes
+        inline __m128i diff_below_z16(__m128i a, __m128i b, __m128i delta)
+        {
+            auto diff = _mm_or_si128(_mm_subs_epu16(a, b), _mm_subs_epu16(b, a));
+            auto not_below = _mm_cmpeq_epi16(_mm_subs_epu16(delta, diff), _mm_setzero_si128());
+            return _mm_xor_si128(not_below, _mm_set1_epi16(-1));
+        }
+
+        // a * alpha + b * (1 - alpha), truncated as the scalar code does
+        inline __m128i mix_z16(__m128i a, __m128i b, __m128 alpha, __m128 one_minus_alpha)
+        {
+            const auto zero = _mm_setzero_si128();
+            const auto bias = _mm_set1_epi32(0x8000);
+
+            auto lo = _mm_add_ps(_mm_mul_ps(alpha, _mm_cvtepi32_ps(_mm_unpacklo_epi16(a, zero))),
+                                 _mm_mul_ps(one_minus_alpha, _mm_cvtepi32_ps(_mm_unpacklo_epi16(b, zero))));
+            auto hi = _mm_add_ps(_mm_mul_ps(alpha, _mm_cvtepi32_ps(_mm_unpackhi_epi16(a, zero))),
+                                 _mm_mul_ps(one_minus_alpha, _mm_cvtepi32_ps(_mm_unpackhi_epi16(b, zero))));
+
+            // SSSE3 has no unsigned saturating pack, so bias the values into the signed range and back
+            auto packed = _mm_packs_epi32(_mm_sub_epi32(_mm_cvttps_epi32(lo), bias),
+                                          _mm_sub_epi32(_mm_cvttps_epi32(hi), bias));
+            return _mm_xor_si128(packed, _mm_set1_epi16(-0x8000));
+        }
+
+        // New history bytes: valid pixels restart their history unless they agree with the previous
+        // value, and holes clear the bit of the current phase
+        inline __m128i update_history(__m128i hist, __m128i cur_valid, __m128i agree, __m128i mask)
+        {
+            return select_si128(cur_valid, _mm_or_si128(_mm_and_si128(agree, hist), mask), _mm_andnot_si128(mask, hist));
+        }
+    }
+
+    size_t temporal_filter_z16_sse(uint16_t * frame, uint16_t * last_frame, uint8_t * history, size_t count,
+        float alpha_val, float one_minus_alpha_val, uint16_t delta_val, uint8_t mask_val, const uint8_t * persistent)
+    {
+        const auto zero = _mm_setzero_si128();
+        const auto ones = _mm_set1_epi16(-1);
+        const auto alpha = _mm_set1_ps(alpha_val);
+        const auto one_minus_alpha = _mm_set1_ps(one_minus_alpha_val);
+        const auto delta_z = _mm_set1_epi16(static_cast<short>(delta_val));
+        const auto mask = _mm_set1_epi8(static_cast<char>(mask_val));
+        const auto table_lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(persistent));
+        const auto table_hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(persistent + 16));
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            auto cur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frame + i));
+            auto prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(last_frame + i));
+            auto hist = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(history + i));
+
+            auto cur_valid = _mm_xor_si128(_mm_cmpeq_epi16(cur, zero), ones);
+            auto prev_valid = _mm_xor_si128(_mm_cmpeq_epi16(prev, zero), ones);
+            auto agree = _mm_and_si128(_mm_and_si128(cur_valid, prev_valid), diff_below_z16(cur, prev, delta_z));
+            auto persistent_bytes = is_persistent(hist, table_lo, table_hi);
+            auto fill = _mm_andnot_si128(cur_valid, _mm_and_si128(prev_valid, _mm_unpacklo_epi8(persistent_bytes, persistent_bytes)));
+            auto filtered = mix_z16(cur, prev, alpha, one_minus_alpha);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(frame + i), select_si128(agree, filtered, select_si128(fill, prev, cur)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(last_frame + i), select_si128(agree, filtered, select_si128(cur_valid, cur, prev)));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(history + i),
+                update_history(hist, _mm_packs_epi16(cur_valid, cur_valid), _mm_packs_epi16(agree, agree), mask));
+        }
+        return i;
+    }
+
+    size_t temporal_filter_fp_sse(float * frame, float * last_frame, uint8_t * history, size_t count,
+        float alpha_val, float one_minus_alpha_val, float delta_val, uint8_t mask_val, const uint8_t * persistent)
+    {
+        const auto zero = _mm_setzero_ps();
+        const auto abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const auto alpha = _mm_set1_ps(alpha_val);
+        const auto one_minus_alpha = _mm_set1_ps(one_minus_alpha_val);
+        const auto delta_z = _mm_set1_ps(delta_val);
+        const auto mask = _mm_set1_epi8(static_cast<char>(mask_val));
+        const auto table_lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(persistent));
+        const auto table_hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(persistent + 16));
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            auto cur = _mm_loadu_ps(frame + i);
+            auto prev = _mm_loadu_ps(last_frame + i);
+            int32_t hist_bytes;
+            memcpy(&hist_bytes, history + i, sizeof(hist_bytes));
+            auto hist = _mm_cvtsi32_si128(hist_bytes);
+
+            auto cur_valid = _mm_cmpneq_ps(cur, zero);
+            auto prev_valid = _mm_cmpneq_ps(prev, zero);
+            auto diff = _mm_and_ps(_mm_sub_ps(cur, prev), abs_mask);
+            auto agree = _mm_and_ps(_mm_and_ps(cur_valid, prev_valid), _mm_cmplt_ps(diff, delta_z));
+            auto persistent_bytes = is_persistent(hist, table_lo, table_hi);
+            auto persistent_words = _mm_unpacklo_epi8(persistent_bytes, persistent_bytes);
+            auto fill = _mm_andnot_ps(cur_valid, _mm_and_ps(prev_valid,
+                _mm_castsi128_ps(_mm_unpacklo_epi16(persistent_words, persistent_words))));
+            auto filtered = _mm_add_ps(_mm_mul_ps(alpha, cur), _mm_mul_ps(one_minus_alpha, prev));
+
+            _mm_storeu_ps(frame + i, select_ps(agree, filtered, select_ps(fill, prev, cur)));
+            _mm_storeu_ps(last_frame + i, select_ps(agree, filtered, select_ps(cur_valid, cur, prev)));
+
+            auto cur_valid_words = _mm_packs_epi32(_mm_castps_si128(cur_valid), _mm_castps_si128(cur_valid));
+            auto agree_words = _mm_packs_epi32(_mm_castps_si128(agree), _mm_castps_si128(agree));
+            hist_bytes = _mm_cvtsi128_si32(update_history(hist, _mm_packs_epi16(cur_valid_words, cur_valid_words),
+                _mm_packs_epi16(agree_words, agree_words), mask));
+            memcpy(history + i, &hist_bytes, sizeof(hist_bytes));
+        }
+        return i;
+    }
+}
+
+#endif // __SSSE3__
@@ -0,0 +1,29 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace librealsense
+{
+    // Per-pixel pass of the temporal filter, vectorized.
+    // 'persistent' holds one bit per 8-bit history value (256 bits), set when the persistence map
+    // allows filling a hole with that history in the current frame phase.
+    // Each function processes whole vector-width groups out of 'count' pixels and returns the number of
+    // pixels it handled; the rest is left for the scalar code. The results are bit-exact with
+    // temporal_filter::temp_jw_smooth.
+#ifdef __SSSE3__
+    size_t temporal_filter_z16_sse(uint16_t * frame, uint16_t * last_frame, uint8_t * history, size_t count,
+        float alpha, float one_minus_alpha, uint16_t delta_z, uint8_t mask, const uint8_t * persistent);
+    size_t temporal_filter_fp_sse(float * frame, float * last_frame, uint8_t * history, size_t count,
+        float alpha, float one_minus_alpha, float delta_z, uint8_t mask, const uint8_t * persistent);
+#endif
+
+    // Built with AVX2 in avx-temporal-filter.cpp, when RS2_HAVE_AVX2_KERNELS is defined; only call them when has_avx()
+    size_t temporal_filter_z16_avx2(uint16_t * frame, uint16_t * last_frame, uint8_t * history, size_t count,
+        float alpha, float one_minus_alpha, uint16_t delta_z, uint8_t mask, const uint8_t * persistent);
+    size_t temporal_filter_fp_avx2(float * frame, float * last_frame, uint8_t * history, size_t count,
+        float alpha, float one_minus_alpha, float delta_z, uint8_t mask, const uint8_t * persistent);
+}
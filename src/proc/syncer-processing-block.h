@@ -11,6 +11,7 @@
 #include "types.h"
 #include "archive.h"
 #include "option.h"
+#include "sync.h"
 
 namespace librealsense
 {
@@ -36,6 +37,15 @@ namespace librealsense
             _matcher->stop();
         }
 
+        // How long the frames of each synchronized stream waited for their partners, and how many were dropped
+        std::vector< matcher_stats > get_stats()
+        {
+            std::vector< matcher_stats > stats;
+            std::lock_guard< std::mutex > lock( _mutex );
+            _matcher->get_stats( stats );
+            return stats;
+        }
+
         ~syncer_process_unit()
         {
             _matcher.reset();
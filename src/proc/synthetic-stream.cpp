@@ -99,6 +99,22 @@ namespace librealsense
         processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
     }
 
+    bool generic_processing_block::can_process(const rs2::frame& f)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return should_process(f);
+    }
+
+    rs2::frame generic_processing_block::process_stage(const rs2::frame_source& source, const rs2::frame& f, bool in_place)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!in_place)
+            return process_frame(source, f);
+
+        process_frame_in_place(f);
+        return f;
+    }
+
     rs2::frame generic_processing_block::prepare_output(const rs2::frame_source& source, rs2::frame input, std::vector<rs2::frame> results)
     {
         // this function prepares the processing block output frame(s) by the following heuristic:
@@ -69,11 +69,20 @@ namespace librealsense
         generic_processing_block(const char* name);
         virtual ~generic_processing_block() { _source.flush(); }
 
+        // Used by fused_processing_block to run the block as one stage of a chain.
+        // process_stage allocates the output from the given source, or, when in_place is set
+        // (only for blocks that support it), processes f into itself and returns it.
+        bool can_process(const rs2::frame& f);
+        rs2::frame process_stage(const rs2::frame_source& source, const rs2::frame& f, bool in_place);
+        virtual bool supports_in_place() const { return false; }
+
     protected:
         virtual rs2::frame prepare_output(const rs2::frame_source& source, rs2::frame input, std::vector<rs2::frame> results);
 
         virtual bool should_process(const rs2::frame& frame) = 0;
         virtual rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) = 0;
+        // Called only with frames that are not referenced outside the chain, so their data may be modified
+        virtual void process_frame_in_place(const rs2::frame& f) {}
     };
 
     struct stream_filter
@@ -9,6 +9,8 @@
 #include "context.h"
 #include "proc/synthetic-stream.h"
 #include "proc/temporal-filter.h"
+#include "proc/sse/sse-temporal-filter.h"
+#include "image-avx.h"
 
 namespace librealsense
 {
@@ -112,14 +114,24 @@ namespace librealsense
     {
         update_configuration(f);
         auto tgt = prepare_target_frame(f, source);
+        apply_filter(const_cast<void*>(tgt.get_data()));
 
+        return tgt;
+    }
+
+    void temporal_filter::process_frame_in_place(const rs2::frame& f)
+    {
+        update_configuration(f);
+        apply_filter(const_cast<void*>(f.get_data()));
+    }
+
+    void temporal_filter::apply_filter(void * frame_data)
+    {
         // Temporal filter execution
         if (_extension_type == RS2_EXTENSION_DISPARITY_FRAME)
-            temp_jw_smooth<float>(const_cast<void*>(tgt.get_data()), _last_frame.data(), _history.data());
+            temp_jw_smooth<float>(frame_data, _last_frame.data(), _history.data());
         else
-            temp_jw_smooth<uint16_t>(const_cast<void*>(tgt.get_data()), _last_frame.data(), _history.data());
-
-        return tgt;
+            temp_jw_smooth<uint16_t>(frame_data, _last_frame.data(), _history.data());
     }
 
 
@@ -185,6 +197,48 @@ namespace librealsense
         return tgt;
     }
 
+    size_t temporal_filter::temp_jw_smooth_simd(void* frame_data, void* last_frame_data, uint8_t* history, uint8_t mask, bool fp)
+    {
+#if defined __SSSE3__ && ! defined ANDROID
+        static bool do_avx = has_avx();
+
+        // The persistence classification of every history value in the current phase, one bit each
+        uint8_t persistent[PRESISTENCY_LUT_SIZE / 8] = {};
+        for (size_t i = 0; i < PRESISTENCY_LUT_SIZE; i++)
+            if (_persistence_map[i] & mask)
+                persistent[i / 8] |= (1 << (i % 8));
+
+        if (fp)
+        {
+            auto frame = reinterpret_cast<float*>(frame_data);
+            auto last_frame = reinterpret_cast<float*>(last_frame_data);
+            const float delta_z = _delta_param;
+#ifdef RS2_HAVE_AVX2_KERNELS
+            if (do_avx)
+                return temporal_filter_fp_avx2(frame, last_frame, history, _current_frm_size_pixels,
+                    _alpha_param, _one_minus_alpha, delta_z, mask, persistent);
+#endif
+            return temporal_filter_fp_sse(frame, last_frame, history, _current_frm_size_pixels,
+                _alpha_param, _one_minus_alpha, delta_z, mask, persistent);
+        }
+        else
+        {
+            auto frame = reinterpret_cast<uint16_t*>(frame_data);
+            auto last_frame = reinterpret_cast<uint16_t*>(last_frame_data);
+            const uint16_t delta_z = _delta_param;
+#ifdef RS2_HAVE_AVX2_KERNELS
+            if (do_avx)
+                return temporal_filter_z16_avx2(frame, last_frame, history, _current_frm_size_pixels,
+                    _alpha_param, _one_minus_alpha, delta_z, mask, persistent);
+#endif
+            return temporal_filter_z16_sse(frame, last_frame, history, _current_frm_size_pixels,
+                _alpha_param, _one_minus_alpha, delta_z, mask, persistent);
+        }
+#else
+        return 0;
+#endif
+    }
+
     void temporal_filter::recalc_persistence_map()
     {
         _persistence_map.fill(0);
@@ -13,9 +13,13 @@ namespace librealsense
     public:
         temporal_filter();
 
+        bool supports_in_place() const override { return true; }
+
     protected:
         void    update_configuration(const rs2::frame& f);
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+        void process_frame_in_place(const rs2::frame& f) override;
+        void apply_filter(void * frame_data);
 
         rs2::frame prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source);
 
@@ -34,7 +38,9 @@ namespace librealsense
             unsigned char mask = 1 << _cur_frame_index;
 
             // pass one -- go through image and update all
-            for (size_t i = 0; i < _current_frm_size_pixels; i++)
+            // The vectorized pass handles the bulk of the image, the loop below completes the remaining pixels
+            size_t i = temp_jw_smooth_simd(frame_data, _last_frame_data, history, mask, fp);
+            for (; i < _current_frm_size_pixels; i++)
             {
                 T cur_val = frame[i];
                 T prev_val = _last_frame[i];
@@ -83,6 +89,9 @@ namespace librealsense
             _cur_frame_index = (_cur_frame_index + 1) % 8;  // at end of cycle
         }
 
+        // Returns the number of pixels processed by the vectorized implementation
+        size_t temp_jw_smooth_simd(void* frame_data, void* last_frame_data, uint8_t* history, uint8_t mask, bool fp);
+
     private:
         void on_set_persistence_control(uint8_t val);
         void on_set_alpha(float val);
@@ -16,6 +16,7 @@
 #include <media/ros/ros_reader.h>
 #include "core/advanced_mode.h"
 #include "source.h"
+#include "points-exporter.h"
 #include "core/processing.h"
 #include "proc/synthetic-stream.h"
 #include "proc/processing-blocks-factory.h"
@@ -33,6 +34,7 @@
 #include "proc/rates-printer.h"
 #include "proc/hdr-merge.h"
 #include "proc/sequence-id-filter.h"
+#include "proc/fused-processing-block.h"
 #include "media/playback/playback_device.h"
 #include "stream.h"
 #include "../include/librealsense2/h/rs_types.h"
@@ -811,6 +813,41 @@ void rs2_set_notifications_callback_cpp(const rs2_sensor* sensor, rs2_notificati
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, sensor, callback)
 
+void rs2_set_frame_buffer_allocator(const rs2_sensor* sensor, rs2_frame_buffer_allocate_ptr on_allocate, rs2_frame_buffer_deallocate_ptr on_deallocate, void* user, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    auto sb = dynamic_cast<librealsense::sensor_base*>(sensor->sensor);
+    if (!sb)
+        throw librealsense::not_implemented_exception("This sensor does not support custom frame buffer allocators");
+
+    librealsense::frame_buffer_allocator_ptr allocator;
+    if (on_allocate)
+    {
+        VALIDATE_NOT_NULL(on_deallocate);
+        allocator.reset(new librealsense::frame_buffer_allocator(on_allocate, on_deallocate, user),
+            [](rs2_frame_buffer_allocator* p) { delete p; });
+    }
+    sb->set_frame_buffer_allocator(allocator);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, on_allocate, on_deallocate, user)
+
+void rs2_set_frame_buffer_allocator_cpp(const rs2_sensor* sensor, rs2_frame_buffer_allocator* allocator, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    auto sb = dynamic_cast<librealsense::sensor_base*>(sensor->sensor);
+    if (!sb)
+    {
+        if (allocator) allocator->release();
+        throw librealsense::not_implemented_exception("This sensor does not support custom frame buffer allocators");
+    }
+
+    librealsense::frame_buffer_allocator_ptr ptr;
+    if (allocator)
+        ptr.reset(allocator, [](rs2_frame_buffer_allocator* p) { p->release(); });
+    sb->set_frame_buffer_allocator(ptr);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, allocator)
+
 void rs2_software_device_set_destruction_callback_cpp(const rs2_device* dev, rs2_software_device_destruction_callback* callback, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(dev);
@@ -1578,6 +1615,40 @@ void rs2_playback_seek(const rs2_device* device, long long int time, rs2_error**
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, device)
 
+void rs2_playback_seek_to_frame(const rs2_device* device, rs2_stream stream, int index, unsigned long long int frame_number, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_ENUM(stream);
+    VALIDATE_LE(0, index);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    playback->seek_to_frame(stream, index, frame_number);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, stream, index, frame_number)
+
+void rs2_playback_device_set_index_cache(const rs2_device* device, int enable, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    playback->set_index_cache(enable != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, enable)
+
+void rs2_playback_device_set_prefetch_budget(const rs2_device* device, unsigned long long int bytes, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    playback->set_prefetch_budget(static_cast<size_t>(bytes));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, bytes)
+
+unsigned long long int rs2_playback_device_get_prefetch_budget(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    return playback->get_prefetch_budget();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, device)
+
 unsigned long long int rs2_playback_get_position(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -1618,6 +1689,32 @@ int rs2_playback_device_is_real_time(const rs2_device* device, rs2_error** error
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, device)
 
+void rs2_playback_device_set_batch_mode(const rs2_device* device, int batch, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    playback->set_batch_mode(batch != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, batch)
+
+int rs2_playback_device_is_batch_mode(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    return playback->is_batch_mode() ? 1 : 0;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, device)
+
+void rs2_playback_device_get_throughput(const rs2_device* device, double* frames_per_second, double* megabytes_per_second, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(frames_per_second);
+    VALIDATE_NOT_NULL(megabytes_per_second);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    playback->get_throughput(*frames_per_second, *megabytes_per_second);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, frames_per_second, megabytes_per_second)
+
 void rs2_playback_device_set_status_changed_callback(const rs2_device* device, rs2_playback_status_changed_callback* callback, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -1700,6 +1797,39 @@ const char* rs2_record_device_filename(const rs2_device* device, rs2_error** err
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device)
 
+void rs2_record_device_enable_depth_codec(const rs2_device* device, int enable, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    auto codec = enable ? device_serializer::frame_codec::rvl : device_serializer::frame_codec::raw;
+    record_device->set_frame_codec(RS2_STREAM_DEPTH, codec);
+    record_device->set_frame_codec(RS2_STREAM_INFRARED, codec);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, enable)
+
+void rs2_record_device_set_max_cached_size(const rs2_device* device, unsigned long long bytes, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_max_cached_data_size(bytes);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, bytes)
+
+void rs2_record_device_get_statistics(const rs2_device* device, unsigned long long* queued_bytes, unsigned long long* dropped_frames,
+    double* megabytes_per_second, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(queued_bytes);
+    VALIDATE_NOT_NULL(dropped_frames);
+    VALIDATE_NOT_NULL(megabytes_per_second);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    auto stats = record_device->get_statistics();
+    *queued_bytes = stats.queued_bytes;
+    *dropped_frames = stats.dropped_frames;
+    *megabytes_per_second = stats.megabytes_per_second;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, queued_bytes, dropped_frames, megabytes_per_second)
+
 
 rs2_frame* rs2_allocate_synthetic_video_frame(rs2_source* source, const rs2_stream_profile* new_stream, rs2_frame* original,
     int new_bpp, int new_width, int new_height, int new_stride, rs2_extension frame_type, rs2_error** error) BEGIN_API_CALL
@@ -2067,6 +2197,35 @@ rs2_processing_block* rs2_create_sync_processing_block(rs2_error** error) BEGIN_
 }
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
+int rs2_get_sync_stats(const rs2_processing_block* block, rs2_sync_stats* stats, int capacity, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(block);
+    VALIDATE_RANGE(capacity, 0, std::numeric_limits<int>::max());
+    if (capacity)
+    {
+        VALIDATE_NOT_NULL(stats);
+    }
+    auto sync = std::dynamic_pointer_cast<librealsense::syncer_process_unit>(block->block);
+    if (!sync)
+        throw librealsense::invalid_value_exception("not a sync processing block");
+
+    // A single snapshot of all the matchers, taken under the syncer's lock
+    auto all = sync->get_stats();
+    for (int i = 0; i < capacity && i < (int)all.size(); i++)
+    {
+        auto& s = all[i];
+        stats[i] = {};
+        strncpy(stats[i].name, s.name.c_str(), sizeof(stats[i].name) - 1);
+        stats[i].frames = s.frames;
+        stats[i].published = s.published;
+        stats[i].dropped = s.dropped;
+        stats[i].average_wait_ms = s.average_wait_ms;
+        stats[i].max_wait_ms = s.max_wait_ms;
+    }
+    return static_cast<int>(all.size());
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, block, stats, capacity)
+
 void rs2_start_processing(rs2_processing_block* block, rs2_frame_callback* on_frame, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(block);
@@ -2168,6 +2327,15 @@ void rs2_export_to_ply(const rs2_frame* frame, const char* fname, rs2_frame* tex
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, frame, fname)
 
+void rs2_export_to_file(const rs2_frame* frame, const char* fname, rs2_frame* texture, int binary, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_NOT_NULL(fname);
+    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    points_exporter(points_exporter::format_from_name(fname), binary != 0).write(fname, *points, (frame_interface*)texture);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, frame, fname, binary)
+
 rs2_pixel* rs2_get_frame_texture_coordinates(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame);
@@ -2184,6 +2352,14 @@ int rs2_get_frame_points_count(const rs2_frame* frame, rs2_error** error) BEGIN_
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame)
 
+const int* rs2_get_frame_pixel_indices(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    return points->get_pixel_indices();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame)
+
 rs2_processing_block* rs2_create_pointcloud(rs2_error** error) BEGIN_API_CALL
 {
     return new rs2_processing_block { pointcloud::create() };
@@ -2309,6 +2485,26 @@ rs2_processing_block* rs2_create_sequence_id_filter(rs2_error** error) BEGIN_API
 }
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
+rs2_processing_block* rs2_create_fused_processing_block(rs2_processing_block** blocks, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(blocks);
+    VALIDATE_RANGE(count, 1, std::numeric_limits<int>::max());
+
+    auto block = std::make_shared<librealsense::fused_processing_block>();
+    for (int i = 0; i < count; i++)
+    {
+        VALIDATE_NOT_NULL(blocks[i]);
+        auto stage = std::dynamic_pointer_cast<librealsense::generic_processing_block>(blocks[i]->block);
+        if (!stage)
+            throw librealsense::invalid_value_exception(librealsense::to_string()
+                << "Processing block " << i << " cannot be used as a stage of a fused processing block");
+        block->add(stage);
+    }
+
+    return new rs2_processing_block{ block };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, blocks, count)
+
 float rs2_get_depth_scale(rs2_sensor* sensor, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(sensor);
@@ -2327,6 +2523,18 @@ float rs2_get_max_usable_depth_range(rs2_sensor const * sensor, rs2_error** erro
 
 HANDLE_EXCEPTIONS_AND_RETURN(0.f, sensor)
 
+void rs2_get_frame_pool_stats(rs2_sensor const * sensor, rs2_frame_pool_stats * stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(stats);
+
+    *stats = {};
+    // Sensors that do not own frame archives (e.g. playback sensors) do not recycle buffers
+    if (auto sb = dynamic_cast<librealsense::sensor_base*>(sensor->sensor))
+        *stats = sb->get_frame_pool_stats();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, stats)
+
 float rs2_get_stereo_baseline(rs2_sensor* sensor, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(sensor);
@@ -0,0 +1,485 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "rvl-codec.h"
+
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+
+namespace librealsense
+{
+    namespace rvl
+    {
+        namespace
+        {
+            const int nibbles_per_word = 8;
+            const uint32_t small_values_mask = 0x88888888; // a word of single nibble values has none of these bits set
+
+            int count_leading_zeros(uint32_t value)
+            {
+#ifdef _MSC_VER
+                unsigned long index;
+                _BitScanReverse(&index, value);
+                return 31 - int(index);
+#else
+                return __builtin_clz(value);
+#endif
+            }
+
+            uint32_t byte_swap(uint32_t value)
+            {
+#ifdef _MSC_VER
+                return _byteswap_ulong(value);
+#else
+                return __builtin_bswap32(value);
+#endif
+            }
+
+            // Reverses the order of the nibbles of a word
+            uint32_t reverse_nibbles(uint32_t value)
+            {
+                value = byte_swap(value);
+                return ((value & 0x0f0f0f0f) << 4) | ((value >> 4) & 0x0f0f0f0f);
+            }
+
+            // Spreads the lower 24 bits of a value into 8 nibbles of 3 bits, lower bits in the lower nibbles
+            uint32_t spread_groups(uint32_t value)
+            {
+                value = (value & 0x00000fff) | ((value & 0x00fff000) << 4);
+                value = (value & 0x003f003f) | ((value & 0x0fc00fc0) << 2);
+                return (value & 0x07070707) | ((value & 0x38383838) << 1);
+            }
+
+            // Gathers the lower 3 bits of 8 nibbles into a value, the reverse of spread_groups
+            uint32_t gather_groups(uint32_t nibbles)
+            {
+                nibbles &= 0x77777777;
+                nibbles = (nibbles & 0x07070707) | ((nibbles >> 1) & 0x38383838);
+                nibbles = (nibbles & 0x003f003f) | ((nibbles >> 2) & 0x0fc00fc0);
+                return (nibbles & 0x00000fff) | ((nibbles >> 4) & 0x00fff000);
+            }
+
+            // Pixels are differenced as signed 16 bit values, and differences wrap around like the pixels do
+            int to_signed(uint16_t pixel)
+            {
+                return int16_t(pixel);
+            }
+
+            uint32_t zigzag(int delta)
+            {
+                uint16_t d = uint16_t(delta);
+                return uint16_t((d << 1) ^ -(d >> 15));
+            }
+
+            int unzigzag(uint32_t value)
+            {
+                return int(value >> 1) ^ -int(value & 1);
+            }
+
+            // Values of 1 or 2 nibbles, like most depth differences are: their nibbles, and the value that starts
+            // a byte of nibbles
+            struct short_values
+            {
+                short_values()
+                {
+                    for (int v = 0; v < 64; v++)
+                    {
+                        code_length[v] = v < 8 ? 1 : 2;
+                        code[v] = uint8_t(v < 8 ? v : ((v & 0x7) | 0x8) << 4 | (v >> 3));
+                    }
+                    for (int byte = 0; byte < 256; byte++)
+                    {
+                        length[byte] = (byte & 0x80) ? ((byte & 0x08) ? 0 : 2) : 1;
+                        value[byte] = uint8_t((byte & 0x80) ? ((byte >> 4) & 0x7) | ((byte & 0x7) << 3) : byte >> 4);
+                    }
+                }
+
+                uint8_t code_length[64];
+                uint8_t code[64];
+                uint8_t length[256]; // 0 for longer values
+                uint8_t value[256];
+            };
+
+            const short_values shorts;
+
+#ifdef __SSSE3__
+            int count_trailing_zeros(uint32_t value)
+            {
+#ifdef _MSC_VER
+                unsigned long index;
+                _BitScanForward(&index, value);
+                return int(index);
+#else
+                return __builtin_ctz(value);
+#endif
+            }
+
+            const uint16_t* skip_zeros(const uint16_t* begin, const uint16_t* end)
+            {
+                // 8 pixels at a time
+                const __m128i zero = _mm_setzero_si128();
+                for (; end - begin >= 8; begin += 8)
+                {
+                    int zeros = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)begin), zero));
+                    if (zeros != 0xffff)
+                        return begin + count_trailing_zeros(~zeros) / 2;
+                }
+                for (; begin != end && !*begin; begin++)
+                    ;
+                return begin;
+            }
+
+            const uint16_t* skip_nonzeros(const uint16_t* begin, const uint16_t* end)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                for (; end - begin >= 8; begin += 8)
+                {
+                    int zeros = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)begin), zero));
+                    if (zeros)
+                        return begin + count_trailing_zeros(zeros) / 2;
+                }
+                for (; begin != end && *begin; begin++)
+                    ;
+                return begin;
+            }
+
+            // The zigzag differences of 8 pixels; returns whether all are single nibble values, packed in word then
+            bool encode_block(const uint16_t* pixels, int previous, uint16_t* values, uint32_t& word)
+            {
+                __m128i p = _mm_loadu_si128((const __m128i*)pixels);
+                __m128i prev = _mm_or_si128(_mm_slli_si128(p, 2), _mm_cvtsi32_si128(previous & 0xffff));
+                __m128i delta = _mm_sub_epi16(p, prev);
+                __m128i v = _mm_xor_si128(_mm_slli_epi16(delta, 1), _mm_srai_epi16(delta, 15));
+                _mm_storeu_si128((__m128i*)values, v);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16(-8)), _mm_setzero_si128())) != 0xffff)
+                    return false;
+
+                // Pairs of values into bytes, first value in the high nibble, then the bytes into a word, first byte highest
+                __m128i bytes = _mm_maddubs_epi16(_mm_packus_epi16(v, v), _mm_set1_epi16(0x0110));
+                bytes = _mm_packus_epi16(bytes, bytes);
+                word = byte_swap(uint32_t(_mm_cvtsi128_si32(bytes)));
+                return true;
+            }
+
+            // Decodes 8 single nibble values, first one highest; returns the last pixel
+            int decode_block(uint32_t nibbles, int previous, uint16_t* pixels)
+            {
+                // Nibbles into 16 bit lanes, first nibble in the first lane
+                __m128i bytes = _mm_cvtsi32_si128(int(reverse_nibbles(nibbles)));
+                __m128i low = _mm_and_si128(bytes, _mm_set1_epi8(0x0f));
+                __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0x0f));
+                __m128i values = _mm_unpacklo_epi8(_mm_unpacklo_epi8(low, high), _mm_setzero_si128());
+
+                __m128i delta = _mm_xor_si128(_mm_srli_epi16(values, 1), _mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(values, _mm_set1_epi16(1))));
+                delta = _mm_add_epi16(delta, _mm_slli_si128(delta, 2));
+                delta = _mm_add_epi16(delta, _mm_slli_si128(delta, 4));
+                delta = _mm_add_epi16(delta, _mm_slli_si128(delta, 8));
+                __m128i p = _mm_add_epi16(delta, _mm_set1_epi16(short(previous)));
+                _mm_storeu_si128((__m128i*)pixels, p);
+                return int16_t(_mm_extract_epi16(p, 7));
+            }
+#else
+            const uint16_t* skip_zeros(const uint16_t* begin, const uint16_t* end)
+            {
+                // 4 pixels at a time
+                uint64_t pixels;
+                for (; end - begin >= 4; begin += 4)
+                {
+                    memcpy(&pixels, begin, sizeof(pixels));
+                    if (pixels)
+                        break;
+                }
+                for (; begin != end && !*begin; begin++)
+                    ;
+                return begin;
+            }
+
+            const uint16_t* skip_nonzeros(const uint16_t* begin, const uint16_t* end)
+            {
+                // 4 pixels at a time, the expression is non zero when one of the 16 bit lanes is zero
+                uint64_t pixels;
+                for (; end - begin >= 4; begin += 4)
+                {
+                    memcpy(&pixels, begin, sizeof(pixels));
+                    if ((pixels - 0x0001000100010001ull) & ~pixels & 0x8000800080008000ull)
+                        break;
+                }
+                for (; begin != end && *begin; begin++)
+                    ;
+                return begin;
+            }
+
+            bool encode_block(const uint16_t* pixels, int previous, uint16_t* values, uint32_t& word)
+            {
+                uint32_t any = 0, w = 0;
+                for (int i = 0; i < nibbles_per_word; i++)
+                {
+                    int current = to_signed(pixels[i]);
+                    values[i] = uint16_t(zigzag(current - previous));
+                    any |= values[i];
+                    w = (w << 4) | (values[i] & 0xf);
+                    previous = current;
+                }
+                word = w;
+                return any < 8;
+            }
+
+            int decode_block(uint32_t nibbles, int previous, uint16_t* pixels)
+            {
+                for (int i = 0; i < nibbles_per_word; i++)
+                {
+                    previous = to_signed(uint16_t(previous + unzigzag((nibbles >> (28 - 4 * i)) & 0x7)));
+                    pixels[i] = uint16_t(previous);
+                }
+                return previous;
+            }
+#endif
+
+            // Encoding state, kept in locals of the encoding so that it stays in registers.
+            // Values are packed and written without data dependent branches, as depth differences are noisy.
+            class nibble_writer
+            {
+            public:
+                nibble_writer(uint8_t* begin, uint8_t* end)
+                    : _words(begin), _words_end(end), _nibbles(0), _nibbles_count(0), _previous(0), _overflow(false) {}
+
+                // Up to 8 nibbles: with the up to 7 buffered nibbles, that is at most 60 bits. The current word is
+                // always stored, and the write position only moves once it is complete.
+                void write_nibbles(uint32_t nibbles, int count)
+                {
+                    _nibbles = (_nibbles << (4 * count)) | nibbles;
+                    _nibbles_count += count;
+                    int complete = _nibbles_count >= nibbles_per_word;
+                    _nibbles_count -= nibbles_per_word * complete;
+                    if (_words == _words_end)
+                    {
+                        _overflow |= complete != 0;
+                        return;
+                    }
+                    uint32_t word = uint32_t(_nibbles >> (4 * _nibbles_count));
+                    memcpy(_words, &word, sizeof(word));
+                    _words += sizeof(word) * complete;
+                }
+
+                void encode_vle(uint32_t value)
+                {
+                    if (value >> 24)
+                    {
+                        // Longer than a word, only counts of more than 2^24 pixels are: a word of the lower 24 bits, then the rest
+                        write_nibbles(reverse_nibbles(spread_groups(value) | 0x88888888), nibbles_per_word);
+                        value >>= 24;
+                    }
+                    int count = (34 - count_leading_zeros(value | 1)) / 3;
+                    write_nibbles(encode(value, count), count);
+                }
+
+                void encode_deltas(const uint16_t* begin, const uint16_t* end)
+                {
+                    for (; end - begin >= nibbles_per_word; begin += nibbles_per_word)
+                    {
+                        uint16_t values[nibbles_per_word];
+                        uint32_t word;
+                        if (encode_block(begin, _previous, values, word))
+                        {
+                            write_nibbles(word, nibbles_per_word);
+                        }
+                        else
+                        {
+                            for (int i = 0; i < nibbles_per_word; i++)
+                            {
+                                if (values[i] < 64)
+                                    write_nibbles(shorts.code[values[i]], shorts.code_length[values[i]]);
+                                else
+                                    encode_vle(values[i]);
+                            }
+                        }
+                        _previous = to_signed(begin[nibbles_per_word - 1]);
+                    }
+                    for (; begin != end; begin++)
+                    {
+                        int current = to_signed(*begin);
+                        encode_vle(zigzag(current - _previous));
+                        _previous = current;
+                    }
+                }
+
+                // Writes the last few values, returns the end of the data, or nullptr on overflow
+                uint8_t* finish()
+                {
+                    if (_nibbles_count)
+                        write_nibbles(0, nibbles_per_word - _nibbles_count);
+                    return _overflow ? nullptr : _words;
+                }
+
+                bool overflow() const { return _overflow; }
+
+            private:
+                // The count nibbles of a value below 2^(3 * count), lower bits first, with the high bit set on all
+                // nibbles but the last
+                static uint32_t encode(uint32_t value, int count)
+                {
+                    uint32_t nibbles = spread_groups(value) | (0x88888888 & ((1u << (4 * (count - 1))) - 1));
+                    return reverse_nibbles(nibbles) >> (4 * (nibbles_per_word - count));
+                }
+
+                uint8_t* _words;
+                uint8_t* _words_end;
+                uint64_t _nibbles; // the last _nibbles_count nibbles, not written yet, are the lowest
+                int _nibbles_count;
+                int _previous;
+                bool _overflow;
+            };
+
+            // Decoding state, kept in locals of the decoding so that it stays in registers.
+            // Values that go past the end of the data are rejected.
+            class nibble_reader
+            {
+            public:
+                nibble_reader(const uint8_t* begin, const uint8_t* end)
+                    : _words(begin), _words_end(end), _nibbles(0), _nibbles_count(0), _previous(0) {}
+
+                bool decode_vle(uint32_t& value)
+                {
+                    // The value ends at the first nibble without the high bit set. Nibbles past the end of the data
+                    // are zero, so a value cut by the end of the data looks longer than the nibbles left, and is rejected.
+                    fill();
+                    uint32_t nibbles = uint32_t(_nibbles >> 32);
+                    uint32_t last_nibbles = ~nibbles & small_values_mask;
+                    if (!last_nibbles)
+                        return decode_long_vle(value);
+                    int length = count_leading_zeros(last_nibbles) / 4 + 1;
+                    if (length > _nibbles_count)
+                        return false;
+                    _nibbles <<= 4 * length;
+                    _nibbles_count -= length;
+                    value = gather_groups(reverse_nibbles(nibbles) & uint32_t((1ull << (4 * length)) - 1));
+                    return true;
+                }
+
+                bool decode_deltas(uint16_t* begin, uint16_t* end)
+                {
+                    while (begin != end)
+                    {
+                        fill();
+                        uint32_t nibbles = uint32_t(_nibbles >> 32);
+                        if (end - begin >= nibbles_per_word && _nibbles_count >= nibbles_per_word && !(nibbles & small_values_mask))
+                        {
+                            // 8 single nibble values
+                            _previous = decode_block(nibbles, _previous, begin);
+                            _nibbles <<= 4 * nibbles_per_word;
+                            _nibbles_count -= nibbles_per_word;
+                            begin += nibbles_per_word;
+                            continue;
+                        }
+
+                        uint32_t value;
+                        int length = shorts.length[nibbles >> 24];
+                        if (length && length <= _nibbles_count)
+                        {
+                            value = shorts.value[nibbles >> 24];
+                            _nibbles <<= 4 * length;
+                            _nibbles_count -= length;
+                        }
+                        else if (!decode_vle(value))
+                            return false;
+                        _previous = to_signed(uint16_t(_previous + unzigzag(value)));
+                        *begin++ = uint16_t(_previous);
+                    }
+                    return true;
+                }
+
+            private:
+                // Keeps at least 9 nibbles buffered while there is data left, without data dependent branches
+                void fill()
+                {
+                    if (_words == _words_end)
+                        return;
+                    int refill = _nibbles_count <= nibbles_per_word;
+                    uint32_t word;
+                    memcpy(&word, _words, sizeof(word));
+                    _nibbles |= (uint64_t(word) << ((4 * (nibbles_per_word - _nibbles_count)) & 63)) & (0 - uint64_t(refill));
+                    _nibbles_count += nibbles_per_word * refill;
+                    _words += sizeof(word) * refill;
+                }
+
+                // Values longer than a word; only counts of more than 2^24 pixels are
+                bool decode_long_vle(uint32_t& value)
+                {
+                    value = 0;
+                    int shift = 0;
+                    uint32_t nibble;
+                    do
+                    {
+                        fill();
+                        if (!_nibbles_count)
+                            return false;
+                        if (shift > 30) // no valid value is longer than 11 nibbles
+                            return false;
+                        nibble = uint32_t(_nibbles >> 60);
+                        _nibbles <<= 4;
+                        _nibbles_count--;
+                        value |= (nibble & 0x7) << shift;
+                        shift += 3;
+                    } while (nibble & 0x8);
+                    return true;
+                }
+
+                const uint8_t* _words;
+                const uint8_t* _words_end;
+                uint64_t _nibbles; // the next _nibbles_count nibbles are the highest, the rest is zero
+                int _nibbles_count;
+                int _previous;
+            };
+        }
+
+        uint8_t* encode(const uint16_t* pixels, size_t count, uint8_t* begin, uint8_t* end)
+        {
+            const uint16_t* pixels_end = pixels + count;
+            nibble_writer writer(begin, begin + (end - begin) / sizeof(uint32_t) * sizeof(uint32_t));
+            while (pixels != pixels_end && !writer.overflow())
+            {
+                const uint16_t* zeros = pixels;
+                pixels = skip_zeros(pixels, pixels_end);
+                writer.encode_vle(uint32_t(pixels - zeros));
+
+                const uint16_t* nonzeros = pixels;
+                pixels = skip_nonzeros(pixels, pixels_end);
+                writer.encode_vle(uint32_t(pixels - nonzeros));
+                writer.encode_deltas(nonzeros, pixels);
+            }
+            return writer.finish();
+        }
+
+        bool decode(const uint8_t* data, size_t size, uint16_t* pixels, size_t count)
+        {
+            uint16_t* end = pixels + count;
+            nibble_reader reader(data, data + size / sizeof(uint32_t) * sizeof(uint32_t));
+            while (pixels != end)
+            {
+                uint32_t zeros, nonzeros;
+                if (!reader.decode_vle(zeros) || zeros > uint32_t(end - pixels))
+                    return false;
+                memset(pixels, 0, zeros * sizeof(uint16_t));
+                pixels += zeros;
+
+                if (!reader.decode_vle(nonzeros) || nonzeros > uint32_t(end - pixels))
+                    return false;
+                if (!reader.decode_deltas(pixels, pixels + nonzeros))
+                    return false;
+                pixels += nonzeros;
+
+                // The encoding never writes a pair of empty runs, it can only come from corrupt data
+                if (!zeros && !nonzeros)
+                    return false;
+            }
+            return true;
+        }
+    }
+}
@@ -0,0 +1,24 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// RVL (Run length, Variable Length) lossless depth codec, shared by the recorder and the network device compression.
+// Runs of zero and non-zero pixels are stored as counts, and non-zero pixels as the difference from the previous
+// one. Values are variable length nibbles (3 bits of value, and a bit set when more nibbles follow), packed 8 to a
+// 32 bit word, first nibble highest; words are in host byte order. Differences wrap around as 16 bit values.
+// This code has no dependencies on the rest of the library, so that the compression library can build it too.
+namespace librealsense
+{
+    namespace rvl
+    {
+        // Encodes count pixels into [begin, end); returns the end of the encoded data, or nullptr when it does not fit
+        uint8_t* encode(const uint16_t* pixels, size_t count, uint8_t* begin, uint8_t* end);
+
+        // Decodes count pixels; returns false when the data is truncated or corrupt
+        bool decode(const uint8_t* data, size_t size, uint16_t* pixels, size_t count);
+    }
+}
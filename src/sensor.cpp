@@ -184,6 +184,13 @@ namespace librealsense
         _source_owner = owner;
     }
 
+    void sensor_base::set_frame_buffer_allocator(frame_buffer_allocator_ptr allocator)
+    {
+        if (is_streaming())
+            throw wrong_api_call_sequence_exception("Frame buffer allocator cannot be replaced while streaming!");
+        _source.set_allocator(std::move(allocator));
+    }
+
     stream_profiles sensor_base::get_stream_profiles( int tag ) const
     {
         stream_profiles results;
@@ -245,9 +252,8 @@ namespace librealsense
     {
         auto system_time = environment::get_instance().get_time_service()->get_time();
         auto fr = std::make_shared<frame>();
-        byte* pix = (byte*)fo.pixels;
-        std::vector<byte> pixels(pix, pix + fo.frame_size);
-        fr->data = pixels;
+        // The backend buffer outlives this temporary frame, so it is wrapped rather than copied
+        fr->attach_continuation(frame_continuation([]() {}, fo.pixels, fo.frame_size));
         fr->set_stream(profile);
 
         // generate additional data
@@ -276,6 +282,33 @@ namespace librealsense
     /////////////////// UVC Sensor ///////////////////////
     //////////////////////////////////////////////////////
 
+    // Zero-copy frames wrap the backend buffer directly and hand it back to the backend
+    // only when the last reference to the frame is released (ENABLE_ZERO_COPY build option)
+    static bool zero_copy_enabled()
+    {
+#ifdef ZERO_COPY
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Formats whose raw payload is already the final frame layout
+    static bool is_zero_copy_format(rs2_format format)
+    {
+        switch (format)
+        {
+        case RS2_FORMAT_Z16:
+        case RS2_FORMAT_Y8:
+        case RS2_FORMAT_Y16:
+        case RS2_FORMAT_RAW8:
+        case RS2_FORMAT_RAW16:
+            return true;
+        default:
+            return false;
+        }
+    }
+
     uvc_sensor::~uvc_sensor()
     {
         try
@@ -318,10 +351,20 @@ namespace librealsense
                     [this, req_profile_base, req_profile, last_frame_number, last_timestamp](platform::stream_profile p, platform::frame_object f, std::function<void()> continuation) mutable
                 {
                     const auto&& system_time = environment::get_instance().get_time_service()->get_time();
+                    const auto&& vsp = As<video_stream_profile, stream_profile_interface>(req_profile);
+                    int width = vsp ? vsp->get_width() : 0;
+                    int height = vsp ? vsp->get_height() : 0;
+                    const auto&& bpp = get_image_bpp(req_profile_base->get_format());
+                    const size_t frame_size = width * height * bpp / 8;
+
+                    // Constructed first so that the backend buffer is returned on every exit path
+                    frame_continuation release_and_enqueue(continuation, f.pixels, frame_size);
+
                     const auto&& fr = generate_frame_from_data(f, _timestamp_reader.get(), last_timestamp, last_frame_number, req_profile_base);
-                    const auto&& requires_processing = true; // TODO - Ariel add option
+                    // Frames may wrap the backend buffer only when the backend lends it, and its content needs no unpacking
+                    const auto&& requires_processing = !(zero_copy_enabled() && f.retainable
+                        && is_zero_copy_format(req_profile_base->get_format()) && f.frame_size >= frame_size);
                     const auto&& timestamp_domain = _timestamp_reader->get_frame_timestamp_domain(fr);
-                    const auto&& bpp = get_image_bpp(req_profile_base->get_format());
                     auto&& frame_counter = fr->additional_data.frame_number;
                     auto&& timestamp = fr->additional_data.timestamp;
 
@@ -334,8 +377,6 @@ namespace librealsense
                         return;
                     }
 
-                    frame_continuation release_and_enqueue(continuation, f.pixels);
-
                     LOG_DEBUG("FrameAccepted," << librealsense::get_string(req_profile_base->get_stream_type())
                         << ",Counter," << std::dec << fr->additional_data.frame_number
                         << ",Index," << req_profile_base->get_stream_index()
@@ -348,18 +389,15 @@ namespace librealsense
                     last_frame_number = frame_counter;
                     last_timestamp = timestamp;
 
-                    const auto&& vsp = As<video_stream_profile, stream_profile_interface>(req_profile);
-                    int width = vsp ? vsp->get_width() : 0;
-                    int height = vsp ? vsp->get_height() : 0;
-
-                    frame_holder fh = _source.alloc_frame(stream_to_frame_types(req_profile_base->get_stream_type()), width * height * bpp / 8, fr->additional_data, requires_processing);
+                    frame_holder fh = _source.alloc_frame(stream_to_frame_types(req_profile_base->get_stream_type()), frame_size, fr->additional_data, requires_processing);
                     auto diff = environment::get_instance().get_time_service()->get_time() - system_time;
                     if (diff >10 )
                         LOG_DEBUG("!! Frame allocation took " << diff << " msec");
 
                     if (fh.frame)
                     {
-                        memcpy((void*)fh->get_frame_data(), fr->data.data(), sizeof(byte)*fr->data.size());
+                        if (requires_processing)
+                            memcpy((void*)fh->get_frame_data(), fr->get_frame_data(), sizeof(byte)*fr->get_frame_data_size());
                         auto&& video = (video_frame*)fh.frame;
                         video->assign(width, height, width * bpp / 8, bpp);
                         video->set_timestamp_domain(timestamp_domain);
@@ -843,7 +881,7 @@ namespace librealsense
             last_frame_number = frame_counter;
             last_timestamp = timestamp;
             frame_holder frame = _source.alloc_frame(RS2_EXTENSION_MOTION_FRAME, data_size, fr->additional_data, true);
-            memcpy((void*)frame->get_frame_data(), fr->data.data(), sizeof(byte)*fr->data.size());
+            memcpy((void*)frame->get_frame_data(), fr->get_frame_data(), sizeof(byte)*fr->get_frame_data_size());
             if (!frame)
             {
                 LOG_INFO("Dropped frame. alloc_frame(...) returned nullptr");
@@ -1623,6 +1661,24 @@ namespace librealsense
         return _raw_sensor->is_opened();
     }
 
+    void synthetic_sensor::set_frame_buffer_allocator(frame_buffer_allocator_ptr allocator)
+    {
+        _raw_sensor->set_frame_buffer_allocator(allocator);
+        sensor_base::set_frame_buffer_allocator(allocator);
+    }
+
+    rs2_frame_pool_stats synthetic_sensor::get_frame_pool_stats() const
+    {
+        // Raw frames are allocated by the raw sensor, processed frames by our own source
+        auto stats = _raw_sensor->get_frame_pool_stats();
+        auto own = sensor_base::get_frame_pool_stats();
+        stats.hits += own.hits;
+        stats.misses += own.misses;
+        stats.trimmed += own.trimmed;
+        stats.bytes_held += own.bytes_held;
+        return stats;
+    }
+
     void motion_sensor::create_snapshot(std::shared_ptr<motion_sensor>& snapshot) const
     {
         snapshot = std::make_shared<motion_sensor_snapshot>();
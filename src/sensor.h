@@ -85,6 +85,9 @@ namespace librealsense
         rs2_format fourcc_to_rs2_format(uint32_t format) const;
         rs2_stream fourcc_to_rs2_stream(uint32_t fourcc_format) const;
 
+        virtual rs2_frame_pool_stats get_frame_pool_stats() const { return _source.get_pool_stats(); }
+        virtual void set_frame_buffer_allocator(frame_buffer_allocator_ptr allocator);
+
     protected:
         void raise_on_before_streaming_changes(bool streaming);
         void set_active_streams(const stream_profiles& requests);
@@ -228,6 +231,8 @@ namespace librealsense
         void register_metadata(rs2_frame_metadata_value metadata, std::shared_ptr<md_attribute_parser_base> metadata_parser) const override;
         bool is_streaming() const override;
         bool is_opened() const override;
+        rs2_frame_pool_stats get_frame_pool_stats() const override;
+        void set_frame_buffer_allocator(frame_buffer_allocator_ptr allocator) override;
 
     protected:
         void add_source_profiles_missing_data();
@@ -61,7 +61,7 @@ namespace librealsense
 
         for (auto type : supported)
         {
-            _archive[type] = make_archive(type, &_max_publish_list_size, _ts, metadata_parsers);
+            _archive[type] = make_archive(type, &_max_publish_list_size, _ts, metadata_parsers, _allocator);
         }
 
         _metadata_parsers = metadata_parsers;
@@ -91,6 +91,12 @@ namespace librealsense
         return it->second->alloc_and_track(size, additional_data, requires_memory);
     }
 
+    void frame_source::set_allocator(frame_buffer_allocator_ptr allocator)
+    {
+        std::lock_guard<std::mutex> lock(_callback_mutex);
+        _allocator = std::move(allocator);
+    }
+
     void frame_source::set_sensor(const std::shared_ptr<sensor_interface>& s)
     {
         for (auto&& a : _archive)
@@ -136,6 +142,22 @@ namespace librealsense
         }
     }
 
+    rs2_frame_pool_stats frame_source::get_pool_stats() const
+    {
+        rs2_frame_pool_stats total = {};
+        for (auto&& kvp : _archive)
+        {
+            if (!kvp.second)
+                continue;
+            auto stats = kvp.second->get_pool_stats();
+            total.hits += stats.hits;
+            total.misses += stats.misses;
+            total.trimmed += stats.trimmed;
+            total.bytes_held += stats.bytes_held;
+        }
+        return total;
+    }
+
     void frame_source::flush() const
     {
         for (auto&& kvp : _archive)
@@ -35,6 +35,8 @@ namespace librealsense
 
         void flush() const;
 
+        rs2_frame_pool_stats get_pool_stats() const;
+
         virtual ~frame_source() { flush(); }
 
         double get_time() const { return _ts ? _ts->get_time() : 0; }
@@ -44,11 +46,14 @@ namespace librealsense
         template<class T>
         void add_extension(rs2_extension ex)
         {
-            _archive[ex] = std::make_shared<frame_archive<T>>(&_max_publish_list_size, _ts, _metadata_parsers);
+            _archive[ex] = std::make_shared<frame_archive<T>>(&_max_publish_list_size, _ts, _metadata_parsers, _allocator);
         }
 
         void set_max_publish_list_size(int qsize) {_max_publish_list_size = qsize; }
 
+        // Takes effect for the archives created by the next init()
+        void set_allocator(frame_buffer_allocator_ptr allocator);
+
     private:
         friend class syncer_process_unit;
 
@@ -60,5 +65,6 @@ namespace librealsense
         frame_callback_ptr _callback;
         std::shared_ptr<platform::time_service> _ts;
         std::shared_ptr<metadata_parser_map> _metadata_parsers;
+        frame_buffer_allocator_ptr _allocator;
     };
 }
@@ -111,19 +111,80 @@ namespace librealsense
         return s.str();
     }
 
+    void composite_matcher::matcher_slot::join()
+    {
+        if (queued)
+            return;
+        queued = true;
+        queue.start();
+    }
+
+    void composite_matcher::matcher_slot::leave()
+    {
+        clear();
+        queued = false;
+    }
+
+    void composite_matcher::matcher_slot::enqueue(frame_holder&& f, double now)
+    {
+        join();
+        ++frames;
+
+        // A full queue makes room by dropping its oldest frame; a stopped one drops the new frame
+        if (queue.stopped() || (queue.size() >= QUEUE_MAX_SIZE && !f.is_blocking()))
+            ++dropped;
+
+        // Older entries belong to frames that were published or dropped already
+        arrivals[arrivals_next] = { f.frame, now };
+        arrivals_next = (arrivals_next + 1) % arrivals.size();
+        arrivals_count = std::min(arrivals_count + 1, arrivals.size());
+
+        queue.enqueue(std::move(f));
+    }
+
+    bool composite_matcher::matcher_slot::dequeue(frame_holder* f, double now)
+    {
+        int timeout_ms = 5000;
+        if (!queue.dequeue(f, timeout_ms))
+            return false;
+        ++published;
+
+        // A frame object may be reused once released, so only the latest entry for it is its own
+        for (size_t i = 1; i <= arrivals_count; ++i)
+        {
+            auto& entry = arrivals[(arrivals_next + arrivals.size() - i) % arrivals.size()];
+            if (entry.first != f->frame)
+                continue;
+
+            auto wait = now - entry.second;
+            total_wait_ms = total_wait_ms + wait;
+            if (wait > max_wait_ms)
+                max_wait_ms = wait;
+            arrivals_count = i - 1;
+            break;
+        }
+        return true;
+    }
+
+    void composite_matcher::matcher_slot::clear()
+    {
+        dropped += queue.size();
+        queue.clear();
+        arrivals_count = 0;
+    }
+
     composite_matcher::composite_matcher(
         std::vector< std::shared_ptr< matcher > > const & matchers, std::string const & name )
     {
         for (auto&& matcher : matchers)
         {
+            auto index = add_slot(matcher);
             for (auto&& stream : matcher->get_streams())
             {
-                matcher->set_callback(
-                    [&]( frame_holder f, const syncronization_environment & env ) {
-                        LOG_IF_ENABLE( "<-- " << *f.frame << "  " << _name, env );
-                        sync( std::move( f ), env );
-                    } );
-                _matchers[stream] = matcher;
+                if (auto known = slot_of_stream(stream))
+                    known->second = index;
+                else
+                    _slot_of_stream.emplace_back(stream, index);
                 _streams_id.push_back(stream);
             }
             for (auto&& stream : matcher->get_streams_types())
@@ -135,17 +196,44 @@ namespace librealsense
         _name = create_composite_name(matchers, name);
     }
 
+    size_t composite_matcher::add_slot(std::shared_ptr<matcher> m)
+    {
+        m->set_callback(
+            [&]( frame_holder f, const syncronization_environment & env ) {
+                LOG_IF_ENABLE( "<-- " << *f.frame << "  " << _name, env );
+                sync( std::move( f ), env );
+            } );
+        _slots.emplace_back(std::move(m));
+
+        // Reserved up front, so that sync() does not allocate once a frame of each stream arrived
+        _arrived.reserve(_slots.size());
+        _synced.reserve(_slots.size());
+        _missing.reserve(_slots.size());
+        return _slots.size() - 1;
+    }
+
+    std::pair<stream_id, size_t>* composite_matcher::slot_of_stream(stream_id stream)
+    {
+        for (auto& s : _slot_of_stream)
+            if (s.first == stream)
+                return &s;
+        return nullptr;
+    }
+
     void composite_matcher::dispatch(frame_holder f, const syncronization_environment& env)
     {
         clean_inactive_streams(f);
-        auto matcher = find_matcher(f);
+        auto slot = find_slot(f);
 
         //LOG_IF_ENABLE( "--> composite_matcher: " << _name, env );
 
-        if (matcher)
+        if (slot)
         {
-            update_last_arrived(f, matcher.get());
-            matcher->dispatch(std::move(f), env);
+            update_last_arrived(f, *slot);
+            _dispatched_frame = f.frame;
+            _dispatched_slot = slot;
+            slot->matcher->dispatch(std::move(f), env);
+            _dispatched_frame = nullptr;
         }
         else
         {
@@ -155,32 +243,27 @@ namespace librealsense
         
     }
 
-    std::shared_ptr<matcher> composite_matcher::find_matcher(const frame_holder& frame)
+    composite_matcher::matcher_slot* composite_matcher::find_slot(const frame_holder& frame)
     {
         auto stream_profile = frame.frame->get_stream();
         auto stream_id = stream_profile->get_unique_id();
         auto stream_type = stream_profile->get_stream_type();
 
-        std::shared_ptr<matcher> matcher;
-        auto it = _matchers.find( stream_id );
-        if( it != _matchers.end() )
+        if( auto known = slot_of_stream( stream_id ) )
         {
-            matcher = it->second;
-            if( matcher )
+            auto & slot = _slots[known->second];
+            if( ! slot.matcher->get_active() )
             {
-                if( ! matcher->get_active() )
-                {
-                    matcher->set_active( true );
-                    _frames_queue[matcher.get()].start();
-                }
-                return matcher;
+                slot.matcher->set_active( true );
+                slot.join();
+                slot.queue.start();
             }
+            return &slot;
         }
         LOG_DEBUG( "no matcher found for " << rs2_stream_to_string( stream_type ) << '/'
                                            << stream_id << "; creating matcher from device..." );
 
         auto sensor = frame.frame->get_sensor().get(); //TODO: Potential deadlock if get_sensor() gets a hold of the last reference of that sensor
-        auto dev_exist = false;
         if (sensor)
         {
             const device_interface* dev = nullptr;
@@ -194,22 +277,22 @@ namespace librealsense
             }
             if (dev)
             {
-                dev_exist = true;
-                matcher = dev->create_matcher(frame);
-
-                matcher->set_callback(
-                    [&]( frame_holder f, syncronization_environment const & env ) {
-                        LOG_IF_ENABLE( "<-- " << *f.frame << "  " << _name, env );
-                        sync( std::move( f ), env );
-                    } );
+                auto matcher = dev->create_matcher(frame);
+                auto index = add_slot(matcher);
 
                 for (auto stream : matcher->get_streams())
                 {
-                    if (_matchers[stream])
+                    if (auto prev = slot_of_stream(stream))
                     {
-                        _frames_queue.erase(_matchers[stream].get());
+                        // The matcher that held the stream loses its queued frames
+                        auto & old = _slots[prev->second];
+                        old.leave();
+                        prev->second = index;
+                        old.retired = std::none_of(_slot_of_stream.begin(), _slot_of_stream.end(),
+                            [&]( decltype( *_slot_of_stream.begin() ) s ) { return &_slots[s.second] == &old; } );
                     }
-                    _matchers[stream] = matcher;
+                    else
+                        _slot_of_stream.emplace_back(stream, index);
                     _streams_id.push_back(stream);
                 }
                 for (auto stream : matcher->get_streams_types())
@@ -226,6 +309,8 @@ namespace librealsense
                     _name = create_composite_name( { matcher },
                                                     _name.substr( 1, _name.length() - 2 ) );  // Remove the "()" around "(CI: )"
                 }
+
+                return &_slots[index];
             }
         }
         else
@@ -233,34 +318,53 @@ namespace librealsense
             LOG_DEBUG("sensor does not exist");
         }
 
-        if (!dev_exist)
+        // We don't know what device this frame came from, so just store it under device NULL with ID matcher
+        auto index = add_slot( std::make_shared< identity_matcher >( stream_id, stream_type ) );
+        _slot_of_stream.emplace_back(stream_id, index);
+        _streams_id.push_back(stream_id);
+        _streams_type.push_back(stream_type);
+        return &_slots[index];
+    }
+
+    void composite_matcher::stop()
+    {
+        set_active( false );
+        for( auto & slot : _slots )
         {
-            matcher = _matchers[stream_id];
-            // We don't know what device this frame came from, so just store it under device NULL with ID matcher
-            if (!matcher)
+            if( slot.queued )
+            {
+                slot.dropped += slot.queue.size();
+                slot.queue.stop();
+            }
+            slot.matcher->stop();
+
+            if( ! slot.retired && slot.published )
             {
-                _matchers[stream_id] = std::make_shared<identity_matcher>(stream_id, stream_type);
-                _streams_id.push_back(stream_id);
-                _streams_type.push_back(stream_type);
-                matcher = _matchers[stream_id];
-
-                matcher->set_callback(
-                    [&]( frame_holder f, syncronization_environment const & env ) {
-                        LOG_IF_ENABLE( "<-- " << *f.frame << "  " << _name, env );
-                        sync( std::move( f ), env );
-                    } );
+                LOG_DEBUG( _name << ": " << slot.matcher->get_name() << " published " << slot.published << " of "
+                                 << slot.frames << " frames, waited " << slot.total_wait_ms / slot.published
+                                 << " ms on average, up to " << slot.max_wait_ms << " ms" );
             }
         }
-        return matcher;
     }
 
-    void composite_matcher::stop()
+    void composite_matcher::get_stats( std::vector< matcher_stats > & stats ) const
     {
-        set_active( false );
-        for( auto & fq : _frames_queue )
-            fq.second.stop();
-        for( auto m : _matchers )
-            m.second->stop();
+        for( auto & slot : _slots )
+        {
+            if( slot.retired )
+                continue;
+
+            matcher_stats s;
+            s.name = slot.matcher->get_name();
+            s.frames = slot.frames;
+            s.published = slot.published;
+            s.dropped = slot.dropped;
+            s.average_wait_ms = s.published ? slot.total_wait_ms / s.published : 0;
+            s.max_wait_ms = slot.max_wait_ms;
+            stats.push_back( s );
+
+            slot.matcher->get_stats( stats );
+        }
     }
 
     std::string
@@ -273,13 +377,13 @@ namespace librealsense
     }
 
     std::string
-        composite_matcher::matchers_to_string( std::vector< librealsense::matcher* > const& matchers )
+        composite_matcher::matchers_to_string( std::vector< size_t > const& slots )
     {
         std::string str;
-        for( auto m : matchers )
+        for( auto index : slots )
         {
             frame_holder* f;
-            if( _frames_queue[m].peek( &f ) )
+            if( _slots[index].queue.peek( &f ) )
                 str += frame_to_string( *f->frame );
         }
         return str;
@@ -289,50 +393,48 @@ namespace librealsense
     {
         //LOG_IF_ENABLE( "SYNC " << _name, env );
 
-        auto matcher = find_matcher(f);
-        if (!matcher)
+        // Frames that come back from the matcher dispatch() handed them to already know their slot
+        auto slot = f.frame == _dispatched_frame ? _dispatched_slot : find_slot(f);
+        if (!slot)
         {
             LOG_ERROR("didn't find any matcher for " << frame_holder_to_string(f) << " will not be synchronized");
             _callback(std::move(f), env);
             return;
         }
-        update_next_expected( matcher, f );
+        update_next_expected( *slot, f );
 
-        _frames_queue[matcher.get()].enqueue(std::move(f));
+        auto const now = environment::get_instance().get_time_service()->get_time();
+        slot->enqueue(std::move(f), now);
 
         // We have a queue for each known stream we want to sync.
         // E.g., for (Depth Color), we need to sync two frames, one from each.
         // If we have a Color frame but not Depth, then Depth is "missing" and needs to be
         // waited-for...
 
-        std::vector<frame_holder*> frames_arrived;
-        std::vector<librealsense::matcher*> frames_arrived_matchers;
-        std::vector<librealsense::matcher*> synced_frames;
-        std::vector<librealsense::matcher*> missing_streams;
-
         while( true )
         {
-            missing_streams.clear();
-            frames_arrived_matchers.clear();
-            frames_arrived.clear();
+            _missing.clear();
+            _arrived.clear();
 
-            for (auto s = _frames_queue.begin(); s != _frames_queue.end(); s++)
+            for (size_t i = 0; i < _slots.size(); i++)
             {
-                librealsense::matcher * const m = s->first;
+                auto & s = _slots[i];
+                if (!s.queued)
+                    continue;
+
                 frame_holder* f;
-                if (s->second.peek(&f))
+                if (s.queue.peek(&f))
                 {
                     LOG_IF_ENABLE( "... have " << *f->frame, env );
-                    frames_arrived.push_back( f );
-                    frames_arrived_matchers.push_back( m );
+                    _arrived.emplace_back( i, f );
                 }
                 else
                 {
-                    missing_streams.push_back( m );
+                    _missing.push_back( i );
                 }
             }
 
-            if( frames_arrived.empty() )
+            if( _arrived.empty() )
             {
                 //LOG_IF_ENABLE( "... nothing more to do", env );
                 break;
@@ -340,38 +442,39 @@ namespace librealsense
 
             // Check that everything we have matches together
 
-            frame_holder * curr_sync = frames_arrived[0];
-            synced_frames.clear();
-            synced_frames.push_back( frames_arrived_matchers[0] );
+            frame_holder * curr_sync = _arrived[0].second;
+            _synced.clear();
+            _synced.push_back( _arrived[0].first );
 
             auto old_frames = false;
-            for (auto i = 1; i < frames_arrived.size(); i++)
+            for (size_t i = 1; i < _arrived.size(); i++)
             {
-                if (are_equivalent(*curr_sync, *frames_arrived[i]))
+                if (are_equivalent(*curr_sync, *_arrived[i].second))
                 {
-                    synced_frames.push_back(frames_arrived_matchers[i]);
+                    _synced.push_back(_arrived[i].first);
                 }
-                else if (is_smaller_than(*frames_arrived[i], *curr_sync))
+                else if (is_smaller_than(*_arrived[i].second, *curr_sync))
                 {
                     old_frames = true;
-                    synced_frames.clear();
-                    synced_frames.push_back(frames_arrived_matchers[i]);
-                    curr_sync = frames_arrived[i];
+                    _synced.clear();
+                    _synced.push_back(_arrived[i].first);
+                    curr_sync = _arrived[i].second;
                 }
                 else
                 {
                     old_frames = true;
                 }
             }
-            bool release_synced_frames = ( synced_frames.size() != 0 );
+            bool release_synced_frames = ( _synced.size() != 0 );
             if (!old_frames)
             {
                 // Everything (could be only one!) matches together... but if we also have something missing, we can't
                 // release anything yet...
-                for (auto i : missing_streams)
+                for (auto i : _missing)
                 {
-                    LOG_IF_ENABLE( "... missing " << i->get_name() << ", next expected " << _next_expected[i], env );
-                    if( skip_missing_stream( synced_frames, i, env ) )
+                    auto & missing = _slots[i];
+                    LOG_IF_ENABLE( "... missing " << missing.matcher->get_name() << ", next expected " << missing.next_expected, env );
+                    if( skip_missing_stream( _slots[_synced[0]], missing, env ) )
                     {
                         LOG_IF_ENABLE( "...     ignoring it", env );
                         continue;
@@ -384,20 +487,19 @@ namespace librealsense
             else
             {
                 LOG_IF_ENABLE( "old frames; ignoring missing "
-                                   << matchers_to_string( missing_streams ),
+                                   << matchers_to_string( _missing ),
                                env );
             }
             if( ! release_synced_frames )
                 break;
 
             std::vector<frame_holder> match;
-            match.reserve(synced_frames.size());
+            match.reserve(_synced.size());
 
-            for (auto index : synced_frames)
+            for (auto index : _synced)
             {
                 frame_holder frame;
-                int timeout_ms = 5000;
-                _frames_queue[index].dequeue(&frame, timeout_ms);
+                _slots[index].dequeue(&frame, now);
                 if (old_frames)
                 {
                     LOG_IF_ENABLE("--> " << frame_holder_to_string(frame), env);
@@ -430,9 +532,9 @@ namespace librealsense
     {
     }
 
-    void frame_number_composite_matcher::update_last_arrived(frame_holder& f, matcher* m)
+    void frame_number_composite_matcher::update_last_arrived(frame_holder& f, matcher_slot& slot)
     {
-        _last_arrived[m] =f->get_frame_number();
+        slot.last_frame_number = f->get_frame_number();
     }
 
     bool frame_number_composite_matcher::are_equivalent(frame_holder& a, frame_holder& b)
@@ -445,46 +547,44 @@ namespace librealsense
     }
     void frame_number_composite_matcher::clean_inactive_streams(frame_holder& f)
     {
-        std::vector<stream_id> inactive_matchers;
-        for(auto m: _matchers)
+        for(auto & slot : _slots)
         {
-            if( _last_arrived[m.second.get()]
+            if( slot.retired )
+                continue;
+
+            if( slot.last_frame_number
                 && ( fabs( (long long)f->get_frame_number()
-                           - (long long)_last_arrived[m.second.get()] ) )
+                           - (long long)slot.last_frame_number ) )
                        > 5 )
             {
                 std::stringstream s;
                 s << "clean inactive stream in "<<_name;
-                for (auto stream : m.second->get_streams_types())
+                for (auto stream : slot.matcher->get_streams_types())
                 {
                     s << stream << " ";
                 }
                 LOG_DEBUG(s.str());
 
-                inactive_matchers.push_back(m.first);
-                m.second->set_active(false);
+                slot.matcher->set_active(false);
+                slot.join();
+                slot.clear();
             }
         }
-
-        for(auto id: inactive_matchers)
-        {
-            _frames_queue[_matchers[id].get()].clear();
-        }
     }
 
     bool
-    frame_number_composite_matcher::skip_missing_stream( std::vector< matcher * > const & synced,
-                                                         matcher * missing,
+    frame_number_composite_matcher::skip_missing_stream( matcher_slot & synced,
+                                                         matcher_slot & missing,
                                                          const syncronization_environment & env )
     {
         frame_holder* synced_frame;
 
-         if(!missing->get_active())
+         if(!missing.matcher->get_active())
              return true;
 
-        _frames_queue[synced[0]].peek(&synced_frame);
+        synced.queue.peek(&synced_frame);
 
-        auto next_expected = _next_expected[missing];
+        auto next_expected = missing.next_expected;
 
         if((*synced_frame)->get_frame_number() - next_expected > 4 || (*synced_frame)->get_frame_number() < next_expected)
         {
@@ -494,9 +594,9 @@ namespace librealsense
     }
 
     void frame_number_composite_matcher::update_next_expected(
-        std::shared_ptr< matcher > const & matcher, const frame_holder & f )
+        matcher_slot & slot, const frame_holder & f )
     {
-        _next_expected[matcher.get()] = f.frame->get_frame_number()+1.;
+        slot.next_expected = f.frame->get_frame_number()+1.;
     }
 
     std::pair<double, double> extract_timestamps(frame_holder & a, frame_holder & b)
@@ -539,16 +639,16 @@ namespace librealsense
         return ts.first < ts.second;
     }
 
-    void timestamp_composite_matcher::update_last_arrived(frame_holder& f, matcher* m)
+    void timestamp_composite_matcher::update_last_arrived(frame_holder& f, matcher_slot& slot)
     {
         if(f->supports_frame_metadata(RS2_FRAME_METADATA_ACTUAL_FPS))
-            _fps[m] = (uint32_t)f->get_frame_metadata(RS2_FRAME_METADATA_ACTUAL_FPS);
+            slot.fps = (uint32_t)f->get_frame_metadata(RS2_FRAME_METADATA_ACTUAL_FPS);
         else
-            _fps[m] = f->get_stream()->get_framerate();
+            slot.fps = f->get_stream()->get_framerate();
 
         auto const now = environment::get_instance().get_time_service()->get_time();
-        //LOG_DEBUG( _name << ": _last_arrived[" << m->get_name() << "] = " << now );
-        _last_arrived[m] = now;
+        //LOG_DEBUG( _name << ": _last_arrived[" << slot.matcher->get_name() << "] = " << now );
+        slot.last_arrived = now;
     }
 
     unsigned int timestamp_composite_matcher::get_fps(const frame_holder & f)
@@ -571,7 +671,7 @@ namespace librealsense
     }
 
     void
-    timestamp_composite_matcher::update_next_expected( std::shared_ptr< matcher > const & matcher,
+    timestamp_composite_matcher::update_next_expected( matcher_slot & slot,
                                                        const frame_holder & f )
     {
         auto fps = get_fps( f );
@@ -580,8 +680,8 @@ namespace librealsense
         auto ts = f.frame->get_frame_timestamp();
         auto ne = ts + gap;
         //LOG_DEBUG( "... next_expected = {timestamp}" << ts << " + {gap}(1000/{fps}" << fps << ") = " << ne );
-        _next_expected[matcher.get()] = ne;
-        _next_expected_domain[matcher.get()] = f.frame->get_frame_timestamp_domain();
+        slot.next_expected = ne;
+        slot.next_expected_domain = f.frame->get_frame_timestamp_domain();
     }
 
     void timestamp_composite_matcher::clean_inactive_streams(frame_holder& f)
@@ -589,29 +689,28 @@ namespace librealsense
         // We let skip_missing_stream clean any inactive missing streams
     }
 
-    bool timestamp_composite_matcher::skip_missing_stream( std::vector< matcher * > const & synced,
-                                                           matcher * missing,
+    bool timestamp_composite_matcher::skip_missing_stream( matcher_slot & synced,
+                                                           matcher_slot & missing,
                                                            const syncronization_environment & env )
     {
         // true : frameset is ready despite the missing stream (no use waiting) -- "skip" it
         // false: the missing stream is relevant and our frameset isn't ready yet!
 
-        if(!missing->get_active())
+        if(!missing.matcher->get_active())
             return true;
 
         frame_holder* synced_frame;
 
-        //LOG_IF_ENABLE( "...     matcher " << synced[0]->get_name(), env );
-        _frames_queue[synced[0]].peek(&synced_frame);
+        //LOG_IF_ENABLE( "...     matcher " << synced.matcher->get_name(), env );
+        synced.queue.peek(&synced_frame);
         //LOG_IF_ENABLE( "...     frame   " << *synced_frame->frame, env );
 
-        auto next_expected = _next_expected[missing];
+        auto next_expected = missing.next_expected;
         //LOG_IF_ENABLE( "...     next    " << std::fixed << next_expected, env );
 
-        auto it = _next_expected_domain.find(missing);
-        if (it != _next_expected_domain.end())
+        if (missing.next_expected_domain != RS2_TIMESTAMP_DOMAIN_COUNT)
         {
-            if (it->second != (*synced_frame)->get_frame_timestamp_domain())
+            if (missing.next_expected_domain != (*synced_frame)->get_frame_timestamp_domain())
             {
                 //LOG_IF_ENABLE( "...     not the same domain: frameset not ready!", env );
                 return false;
@@ -632,13 +731,9 @@ namespace librealsense
             }
             LOG_IF_ENABLE( "...     exceeded threshold of {10*gap}" << threshold << "; deactivating matcher!", env );
 
-            auto const q_it = _frames_queue.find( missing );
-            if( q_it != _frames_queue.end() )
-            {
-                if( q_it->second.empty() )
-                    _frames_queue.erase( q_it );
-            }
-            missing->set_active( false );
+            if( missing.queued && missing.queue.empty() )
+                missing.leave();
+            missing.matcher->set_active( false );
         }
 
         return ! are_equivalent( timestamp, next_expected, get_fps( *synced_frame ) );
@@ -7,6 +7,9 @@
 #include "archive.h"
 
 #include <stdint.h>
+#include <array>
+#include <atomic>
+#include <deque>
 #include <vector>
 #include <mutex>
 #include <memory>
@@ -73,6 +76,17 @@ namespace librealsense
     typedef int stream_id;
     typedef std::function<void(frame_holder, const syncronization_environment&)> sync_callback;
 
+    // Counters of the frames a composite matcher received from one of its matchers
+    struct matcher_stats
+    {
+        std::string name;
+        unsigned long long frames = 0;      // Queued for matching
+        unsigned long long published = 0;   // Released as part of a frameset
+        unsigned long long dropped = 0;     // Discarded while waiting: queue overflow, inactive stream or stop
+        double average_wait_ms = 0;         // How long the published frames waited for their partners
+        double max_wait_ms = 0;
+    };
+
     class matcher_interface
     {
     public:
@@ -102,6 +116,9 @@ namespace librealsense
         void set_active(const bool active);
         virtual void stop() override {}
 
+        // Appends the counters of the streams synchronized by this matcher and by the matchers it holds
+        virtual void get_stats(std::vector<matcher_stats>& stats) const {}
+
     protected:
        std::vector<stream_id> _streams_id;
        std::vector<rs2_stream> _streams_type;
@@ -125,33 +142,79 @@ namespace librealsense
     public:
         composite_matcher(std::vector<std::shared_ptr<matcher>> const & matchers, std::string const & name);
 
+        // Everything the composite keeps per matcher it holds. Slots are only ever added, so their
+        // index and address stay valid, and the per-frame path does not allocate.
+        struct matcher_slot
+        {
+            explicit matcher_slot(std::shared_ptr<librealsense::matcher> m) : matcher(std::move(m)) {}
+
+            std::shared_ptr<librealsense::matcher> matcher;
+            single_consumer_frame_queue<frame_holder> queue;
+            bool queued = false;    // Frames are expected from this matcher, so it takes part in matching
+            bool retired = false;   // All its streams were taken over by a matcher created from the device
+
+            double next_expected = 0;
+            rs2_timestamp_domain next_expected_domain = RS2_TIMESTAMP_DOMAIN_COUNT;  // COUNT until known
+            unsigned long long last_frame_number = 0;
+            double last_arrived = 0;
+            unsigned int fps = 0;
+
+            std::atomic<unsigned long long> frames{ 0 };
+            std::atomic<unsigned long long> published{ 0 };
+            std::atomic<unsigned long long> dropped{ 0 };
+            std::atomic<double> total_wait_ms{ 0 };
+            std::atomic<double> max_wait_ms{ 0 };
+
+            // Arrival time of the latest queued frames, to measure how long each waits until published
+            std::array<std::pair<const frame_interface*, double>, QUEUE_MAX_SIZE> arrivals;
+            size_t arrivals_count = 0;
+            size_t arrivals_next = 0;
+
+            void join();
+            void leave();
+            void enqueue(frame_holder&& f, double now);
+            bool dequeue(frame_holder* f, double now);
+            void clear();
+        };
 
         virtual bool are_equivalent(frame_holder& a, frame_holder& b) = 0;
         virtual bool is_smaller_than(frame_holder& a, frame_holder& b) = 0;
-        virtual bool skip_missing_stream( std::vector< matcher * > const & synced,
-                                          matcher * missing,
+        virtual bool skip_missing_stream( matcher_slot & synced,
+                                          matcher_slot & missing,
                                           const syncronization_environment & env )
             = 0;
         virtual void clean_inactive_streams(frame_holder& f) = 0;
-        virtual void update_last_arrived(frame_holder& f, matcher* m) = 0;
+        virtual void update_last_arrived(frame_holder& f, matcher_slot& slot) = 0;
 
         void dispatch(frame_holder f, const syncronization_environment& env) override;
         void sync(frame_holder f, const syncronization_environment& env) override;
-        std::shared_ptr<matcher> find_matcher(const frame_holder& f);
+        matcher_slot* find_slot(const frame_holder& f);
         virtual void stop() override;
+        void get_stats(std::vector<matcher_stats>& stats) const override;
 
         static std::string frames_to_string( std::vector< frame_holder* > const& );
-        std::string matchers_to_string( std::vector< matcher* > const& );
+        std::string matchers_to_string( std::vector< size_t > const& );
 
     protected:
-        virtual void update_next_expected( std::shared_ptr< matcher > const & matcher,
+        virtual void update_next_expected( matcher_slot & slot,
                                            const frame_holder & f )
             = 0;
 
-        std::map<matcher*, single_consumer_frame_queue<frame_holder>> _frames_queue;
-        std::map<stream_id, std::shared_ptr<matcher>> _matchers;
-        std::map<matcher*, double> _next_expected;
-        std::map<matcher*, rs2_timestamp_domain> _next_expected_domain;
+        size_t add_slot(std::shared_ptr<matcher> m);
+        std::pair<stream_id, size_t>* slot_of_stream(stream_id stream);
+
+        std::deque<matcher_slot> _slots;
+        // Composites sync a handful of streams, so a flat list is scanned faster than a hash is computed
+        std::vector<std::pair<stream_id, size_t>> _slot_of_stream;
+
+        // The slot dispatch() handed the frame to, so that sync() finds it again without a lookup
+        const frame_interface* _dispatched_frame = nullptr;
+        matcher_slot* _dispatched_slot = nullptr;
+
+        // Scratch lists reused by every sync() call
+        std::vector<std::pair<size_t, frame_holder*>> _arrived;
+        std::vector<size_t> _synced;
+        std::vector<size_t> _missing;
     };
 
     // composite matcher that does not synchronize between any frames, and instead just passes them on to callback
@@ -163,17 +226,17 @@ namespace librealsense
         void sync(frame_holder f, const syncronization_environment& env) override;
         virtual bool are_equivalent(frame_holder& a, frame_holder& b) override { return false; }
         virtual bool is_smaller_than(frame_holder& a, frame_holder& b) override { return false; }
-        virtual bool skip_missing_stream( std::vector< matcher * > const & synced,
-                                          matcher * missing,
+        virtual bool skip_missing_stream( matcher_slot & synced,
+                                          matcher_slot & missing,
                                           const syncronization_environment & env ) override
         {
             return false;
         }
         virtual void clean_inactive_streams(frame_holder& f) override {}
-        virtual void update_last_arrived(frame_holder& f, matcher* m) override {}
+        virtual void update_last_arrived(frame_holder& f, matcher_slot& slot) override {}
 
     protected:
-        void update_next_expected( std::shared_ptr< matcher > const & matcher,
+        void update_next_expected( matcher_slot & slot,
                                    const frame_holder & f ) override
         {
         }
@@ -184,18 +247,15 @@ namespace librealsense
     public:
         frame_number_composite_matcher(
             std::vector< std::shared_ptr< matcher > > const & matchers );
-        virtual void update_last_arrived(frame_holder& f, matcher* m) override;
+        virtual void update_last_arrived(frame_holder& f, matcher_slot& slot) override;
         bool are_equivalent(frame_holder& a, frame_holder& b) override;
         bool is_smaller_than(frame_holder& a, frame_holder& b) override;
-        bool skip_missing_stream( std::vector< matcher * > const & synced,
-                                  matcher * missing,
+        bool skip_missing_stream( matcher_slot & synced,
+                                  matcher_slot & missing,
                                   const syncronization_environment & env ) override;
         void clean_inactive_streams(frame_holder& f) override;
-        void update_next_expected( std::shared_ptr< matcher > const & matcher,
+        void update_next_expected( matcher_slot & slot,
                                    const frame_holder & f ) override;
-
-    private:
-         std::map<matcher*,unsigned long long> _last_arrived;
     };
 
     class timestamp_composite_matcher : public composite_matcher
@@ -204,19 +264,16 @@ namespace librealsense
         timestamp_composite_matcher( std::vector< std::shared_ptr< matcher > > const & matchers );
         bool are_equivalent(frame_holder& a, frame_holder& b) override;
         bool is_smaller_than(frame_holder& a, frame_holder& b) override;
-        virtual void update_last_arrived(frame_holder& f, matcher* m) override;
+        virtual void update_last_arrived(frame_holder& f, matcher_slot& slot) override;
         void clean_inactive_streams(frame_holder& f) override;
-        bool skip_missing_stream( std::vector< matcher * > const & synced,
-                                  matcher * missing,
+        bool skip_missing_stream( matcher_slot & synced,
+                                  matcher_slot & missing,
                                   const syncronization_environment & env ) override;
-        void update_next_expected( std::shared_ptr< matcher > const & matcher,
+        void update_next_expected( matcher_slot & slot,
                                    const frame_holder & f ) override;
 
     private:
         unsigned int get_fps(const frame_holder & f);
         bool are_equivalent(double a, double b, int fps);
-        std::map<matcher*, double> _last_arrived;
-        std::map<matcher*, unsigned int> _fps;
-
     };
 }
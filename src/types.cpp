@@ -444,6 +444,9 @@ namespace librealsense
             CASE(AUTO_GAIN_LIMIT)
             CASE(AUTO_RX_SENSITIVITY)
             CASE(TRANSMITTER_FREQUENCY)
+            CASE(HISTOGRAM_UPDATE_INTERVAL)
+            CASE(PROCESSING_TIME)
+            CASE(SPARSE_POINTCLOUD)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 #undef CASE
@@ -38,10 +38,14 @@
 #include <limits>
 #include <algorithm>
 #include <condition_variable>
+#include <atomic>
 #include <functional>
 #include <utility>                          // For std::forward
 #include <limits>
 #include <iomanip>
+#ifdef _MSC_VER
+#include <intrin.h>                         // For _BitScanForward
+#endif
 #include "backend.h"
 #include "concurrency.h"
 
@@ -1116,6 +1120,81 @@ namespace librealsense
     typedef std::shared_ptr<rs2_devices_changed_callback> devices_changed_callback_ptr;
     typedef std::shared_ptr<rs2_update_progress_callback> update_progress_callback_ptr;
 
+    class frame_buffer_allocator : public rs2_frame_buffer_allocator
+    {
+        rs2_frame_buffer_allocate_ptr _allocate;
+        rs2_frame_buffer_deallocate_ptr _deallocate;
+        void* _user;
+    public:
+        frame_buffer_allocator(rs2_frame_buffer_allocate_ptr on_allocate, rs2_frame_buffer_deallocate_ptr on_deallocate, void* user)
+            : _allocate(on_allocate), _deallocate(on_deallocate), _user(user) {}
+
+        void* allocate(unsigned int size) override { return _allocate(size, _user); }
+        void deallocate(void* buffer, unsigned int size) override { _deallocate(buffer, size, _user); }
+        void release() override { delete this; }
+    };
+
+    typedef std::shared_ptr<rs2_frame_buffer_allocator> frame_buffer_allocator_ptr;
+
+    // Standard allocator for frame data buffers.
+    // Forwards to the user-supplied allocator when one is set, and to the heap otherwise.
+    // Elements are default-initialized, so growing a buffer does not zero-fill it:
+    // frame data is always written in full by whoever produces the frame.
+    template<class T>
+    class frame_data_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_copy_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+        template<class U> struct rebind { typedef frame_data_allocator<U> other; };
+
+        frame_data_allocator() = default;
+        explicit frame_data_allocator(frame_buffer_allocator_ptr impl) : _impl(std::move(impl)) {}
+        template<class U>
+        frame_data_allocator(const frame_data_allocator<U>& other) : _impl(other.get_impl()) {}
+
+        T* allocate(size_t n)
+        {
+            if (!_impl)
+                return std::allocator<T>().allocate(n);
+
+            if (n * sizeof(T) > std::numeric_limits<unsigned int>::max())
+                throw std::bad_alloc();
+            auto p = static_cast<T*>(_impl->allocate(static_cast<unsigned int>(n * sizeof(T))));
+            if (!p)
+                throw std::bad_alloc();
+            return p;
+        }
+
+        void deallocate(T* p, size_t n)
+        {
+            if (!_impl)
+                std::allocator<T>().deallocate(p, n);
+            else
+                _impl->deallocate(p, static_cast<unsigned int>(n * sizeof(T)));
+        }
+
+        template<class U>
+        void construct(U* p) { ::new(static_cast<void*>(p)) U; }
+        template<class U, class... Args>
+        void construct(U* p, Args&&... args) { ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+
+        const frame_buffer_allocator_ptr& get_impl() const { return _impl; }
+
+    private:
+        frame_buffer_allocator_ptr _impl;
+    };
+
+    template<class T, class U>
+    bool operator==(const frame_data_allocator<T>& a, const frame_data_allocator<U>& b) { return a.get_impl() == b.get_impl(); }
+    template<class T, class U>
+    bool operator!=(const frame_data_allocator<T>& a, const frame_data_allocator<U>& b) { return !(a == b); }
+
+    typedef std::vector<byte, frame_data_allocator<byte>> frame_buffer;
+
     using internal_callback = std::function<void(rs2_device_list* removed, rs2_device_list* added)>;
     class devices_changed_callback_internal : public rs2_devices_changed_callback
     {
@@ -1199,72 +1278,112 @@ namespace librealsense
         return (c0 << 24) | (c1 << 16) | (c2 << 8) | c3;
     }
 
+    // Index of the lowest set bit of a non-zero word
+    inline int find_first_set(uint64_t word)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        if (_BitScanForward(&index, static_cast<unsigned long>(word)))
+            return int(index);
+        _BitScanForward(&index, static_cast<unsigned long>(word >> 32));
+        return int(index) + 32;
+#else
+        return __builtin_ctzll(word);
+#endif
+    }
+
+    // Fixed pool of C objects. Allocation claims a free slot in a bitmap of atomic words, so allocate and
+    // deallocate never block each other; only wait_until_empty blocks, until all the items are returned.
     template<class T, int C>
     class small_heap
     {
+        static const int WORDS = (C + 63) / 64;
+
         T buffer[C];
-        bool is_free[C];
+        std::atomic<uint64_t> in_use[WORDS];
+        std::atomic<bool> keep_allocating;
+        std::atomic<int> size;
+        std::atomic<uint64_t> contention;   // Slots lost to another thread claiming them first
+        std::atomic<uint64_t> exhausted;    // Allocations that found no free slot
         std::mutex mutex;
-        bool keep_allocating = true;
         std::condition_variable cv;
-        int size = 0;
+
+        static uint64_t word_mask(int word)
+        {
+            auto bits = std::min(C - word * 64, 64);
+            return bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+        }
+
+        void release_count()
+        {
+            if (--size == 0)
+            {
+                // Taking the lock makes sure a waiter either sees the size or is already waiting
+                std::lock_guard<std::mutex> lock(mutex);
+                cv.notify_all();
+            }
+        }
 
     public:
         static const int CAPACITY = C;
 
-        small_heap()
+        small_heap() : keep_allocating(true), size(0), contention(0), exhausted(0)
         {
             for (auto i = 0; i < C; i++)
             {
-                is_free[i] = true;
                 buffer[i] = std::move(T());
             }
+            for (auto& word : in_use)
+                word = 0;
         }
 
         T * allocate()
         {
-            std::unique_lock<std::mutex> lock(mutex);
-            if (!keep_allocating) return nullptr;
+            // Counted before checking for stop_allocation, so that once it returns, wait_until_empty
+            // sees every allocation that got past the check
+            ++size;
+            if (!keep_allocating)
+            {
+                release_count();
+                return nullptr;
+            }
 
-            for (auto i = 0; i < C; i++)
+            for (auto w = 0; w < WORDS; w++)
             {
-                if (is_free[i])
+                auto word = in_use[w].load(std::memory_order_relaxed);
+                while (auto free_slots = ~word & word_mask(w))
                 {
-                    is_free[i] = false;
-                    size++;
-                    return &buffer[i];
+                    auto bit = find_first_set(free_slots);
+                    if (in_use[w].compare_exchange_weak(word, word | (uint64_t(1) << bit), std::memory_order_acquire, std::memory_order_relaxed))
+                        return &buffer[w * 64 + bit];
+                    contention.fetch_add(1, std::memory_order_relaxed);
                 }
             }
+
+            exhausted.fetch_add(1, std::memory_order_relaxed);
+            release_count();
             return nullptr;
         }
 
         void deallocate(T * item)
         {
-             if (item < buffer || item >= buffer + C)
+            if (item < buffer || item >= buffer + C)
             {
                 throw invalid_value_exception("Trying to return item to a heap that didn't allocate it!");
             }
             auto i = item - buffer;
+
+            // The slot is reset before it is marked free, and the old item is destroyed after, so neither
+            // delays the other threads allocating
             auto old_value = std::move(buffer[i]);
             buffer[i] = std::move(T());
 
-            {
-                std::unique_lock<std::mutex> lock(mutex);
-
-                is_free[i] = true;
-                size--;
-
-                if (size == 0)
-                {
-                    lock.unlock();
-                    cv.notify_one();
-                }
-            }
+            in_use[i / 64].fetch_and(~(uint64_t(1) << (i % 64)), std::memory_order_release);
+            release_count();
         }
 
         void stop_allocation()
         {
-            std::unique_lock<std::mutex> lock(mutex);
             keep_allocating = false;
         }
 
@@ -1284,6 +1403,8 @@ namespace librealsense
 
         bool is_empty() const { return size == 0; }
         int get_size() const { return size; }
+        uint64_t get_contention_count() const { return contention; }
+        uint64_t get_exhausted_count() const { return exhausted; }
     };
 
     struct uvc_device_info
@@ -1485,19 +1606,22 @@ namespace librealsense
     {
         std::function<void()> continuation;
         const void* protected_data = nullptr;
+        size_t protected_size = 0;
 
         frame_continuation(const frame_continuation &) = delete;
         frame_continuation & operator=(const frame_continuation &) = delete;
     public:
         frame_continuation() : continuation([]() {}) {}
 
-        explicit frame_continuation(std::function<void()> continuation, const void* protected_data) : continuation(continuation), protected_data(protected_data) {}
+        explicit frame_continuation(std::function<void()> continuation, const void* protected_data, size_t protected_size = 0)
+            : continuation(continuation), protected_data(protected_data), protected_size(protected_size) {}
 
 
-        frame_continuation(frame_continuation && other) : continuation(std::move(other.continuation)), protected_data(other.protected_data)
+        frame_continuation(frame_continuation && other) : continuation(std::move(other.continuation)), protected_data(other.protected_data), protected_size(other.protected_size)
         {
             other.continuation = []() {};
             other.protected_data = nullptr;
+            other.protected_size = 0;
         }
 
         void operator()()
@@ -1505,23 +1629,29 @@ namespace librealsense
             continuation();
             continuation = []() {};
             protected_data = nullptr;
+            protected_size = 0;
         }
 
         void reset()
         {
             protected_data = nullptr;
+            protected_size = 0;
             continuation = [](){};
         }
 
         const void* get_data() const { return protected_data; }
+        // Size of the protected data, when known (0 otherwise)
+        size_t get_data_size() const { return protected_size; }
 
         frame_continuation & operator=(frame_continuation && other)
         {
             continuation();
             protected_data = other.protected_data;
+            protected_size = other.protected_size;
             continuation = other.continuation;
             other.continuation = []() {};
             other.protected_data = nullptr;
+            other.protected_size = 0;
             return *this;
         }
 
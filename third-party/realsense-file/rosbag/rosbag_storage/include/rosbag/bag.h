@@ -226,6 +226,7 @@ private:
 
     template<typename Stream>
     void readMessageDataIntoStream(IndexEntry const& index_entry, Stream& stream) const;
+    uint32_t readMessageDataPrefix(IndexEntry const& index_entry, uint8_t* data, uint32_t size) const;
 
     void     decompressChunk(uint64_t chunk_pos) const;
     void     decompressRawChunk(ChunkHeader const& chunk_header) const;
@@ -93,6 +93,12 @@ public:
     //! Size of serialized message
     uint32_t size() const;
 
+    //! Copy the leading bytes of the serialized message contents, e.g. its header, without copying the rest
+    /*!
+     * returns the number of bytes copied, less than size when the message is shorter
+     */
+    uint32_t readPrefix(uint8_t* data, uint32_t size) const;
+
 private:
     MessageInstance(ConnectionInfo const* connection_info, IndexEntry const& index, Bag const& bag);
 
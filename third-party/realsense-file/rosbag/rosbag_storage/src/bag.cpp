@@ -38,6 +38,7 @@
 #include <signal.h>
 #include <assert.h>
 #include <iomanip>
+#include <algorithm>
 #include <map>
 #include <tuple>
 #include <boost/foreach.hpp>
@@ -921,6 +922,28 @@ uint32_t Bag::readMessageDataSize(IndexEntry const& index_entry) const {
     }
 }
 
+uint32_t Bag::readMessageDataPrefix(IndexEntry const& index_entry, uint8_t* data, uint32_t size) const {
+    rs2rosinternal::Header header;
+    uint32_t data_size;
+    uint32_t bytes_read;
+    switch (version_)
+    {
+    case 200:
+        decompressChunk(index_entry.chunk_pos);
+        readMessageDataHeaderFromBuffer(*current_buffer_, index_entry.offset, header, data_size, bytes_read);
+        size = std::min(size, data_size);
+        memcpy(data, current_buffer_->getData() + index_entry.offset + bytes_read, size);
+        return size;
+    case 102:
+        readMessageDataRecord102(index_entry.chunk_pos, header);
+        size = std::min(size, record_buffer_.getSize());
+        memcpy(data, record_buffer_.getData(), size);
+        return size;
+    default:
+        throw BagFormatException((format("Unhandled version: %1%") % version_).str());
+    }
+}
+
 void Bag::writeChunkInfoRecords() {
     foreach(ChunkInfo const& chunk_info, chunks_) {
         // Write the chunk info header
@@ -62,4 +62,8 @@ uint32_t MessageInstance::size() const {
     return bag_->readMessageDataSize(index_entry_);
 }
 
+uint32_t MessageInstance::readPrefix(uint8_t* data, uint32_t size) const {
+    return bag_->readMessageDataPrefix(index_entry_, data, size);
+}
+
 } // namespace rosbag
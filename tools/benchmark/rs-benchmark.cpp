@@ -153,6 +153,26 @@ private:
     volatile void* _ptr;
 };
 
+// Decimation at a given scale; the median (2, 3) and mean (4 and up) kernels differ in cost
+class decimation_test : public test
+{
+public:
+    decimation_test(int scale)
+        : _block(float(scale)), _name("decimation_filter(" + std::to_string(scale) + ")") {}
+
+    frame process(frame f) override
+    {
+        return _block.process(f);
+    }
+    virtual const std::string& name() const override
+    {
+        return _name;
+    }
+private:
+    decimation_filter _block;
+    std::string _name;
+};
+
 class suite
 {
 public:
@@ -176,7 +196,8 @@ public:
             REGISTER_TEST(temporal_filter);
             REGISTER_TEST(disparity_transform);
             REGISTER_TEST(threshold_filter);
-            REGISTER_TEST(decimation_filter);
+            for (int scale = 2; scale <= 8; scale++)
+                tests.push_back(make_shared<decimation_test>(scale));
         }
         if (stream.format() == RS2_FORMAT_YUYV)
         {
@@ -268,9 +289,11 @@ int main(int argc, char** argv) try
     for (auto stream : prof.get_streams())
     {
         cout << "**Stream Type**: " << stream.stream_name();
+        double megapixels = 0;
         if (auto vs = stream.as<video_stream_profile>())
         {
             cout << ", **Resolution**: " << vs.width() << " x " << vs.height() << endl;
+            megapixels = vs.width() * vs.height() * 1e-6;
         }
         auto fps = stream.fps();
 
@@ -291,8 +314,8 @@ int main(int argc, char** argv) try
         }
 
         cout << endl;
-        cout << "|Filter Name |Step |Median(m)   |Mean(m)  |STD(m)  |Max(m)  | Max FPS |" << endl;
-        cout << "|------------|-----|------------|---------|--------|--------|---------|" << endl;
+        cout << "|Filter Name |Step |Median(m)   |Mean(m)  |STD(m)  |Max(m)  |Median per MP(m) | Max FPS |" << endl;
+        cout << "|------------|-----|------------|---------|--------|--------|-----------------|---------|" << endl;
 
         string last_name = "";
         for (auto&& test : procs)
@@ -354,6 +377,10 @@ int main(int argc, char** argv) try
                         << fixed << median << " |" << mean << " |"
                         << stdev << " |" << max << " |";
 
+                    // Normalized cost, comparable across resolutions
+                    if (megapixels > 0) cout << median / megapixels << " |";
+                    else cout << "- |";
+
                     if (best_fps == 90) cout << "90 ![90](https://placehold.it/15/35ff4d/000000?text=+)";
                     else if (best_fps == 60) cout << "60 ![60](https://placehold.it/15/6fe837/000000?text=+)";
                     else if (best_fps == 30) cout << "30 ![30](https://placehold.it/15/82c13e/000000?text=+)";
@@ -0,0 +1,165 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2020 Intel Corporation. All Rights Reserved.
+
+#include <librealsense2/rs.hpp>
+#include <compression/Lz4Compression.h>
+#include <compression/RvlCompression.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tclap/CmdLine.h"
+
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours for the compression logs.
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+using namespace TCLAP;
+
+struct depth_frame_data
+{
+    int width, height;
+    std::vector<unsigned char> pixels;
+};
+
+// Reads the depth frames of a recording, as fast as the file is read
+std::vector<depth_frame_data> read_depth_frames(const std::string& file, int max_frames)
+{
+    rs2::config cfg;
+    cfg.enable_device_from_file(file, false);
+    cfg.enable_stream(RS2_STREAM_DEPTH, RS2_FORMAT_Z16);
+
+    rs2::pipeline pipe;
+    auto profile = pipe.start(cfg);
+    profile.get_device().as<rs2::playback>().set_real_time(false);
+
+    std::vector<depth_frame_data> frames;
+    rs2::frameset fs;
+    while ((int)frames.size() < max_frames && pipe.try_wait_for_frames(&fs, 1000))
+    {
+        auto depth = fs.get_depth_frame();
+        if (!depth)
+            continue;
+        auto data = (const unsigned char*)depth.get_data();
+        frames.push_back({ depth.get_width(), depth.get_height(), std::vector<unsigned char>(data, data + depth.get_data_size()) });
+    }
+    pipe.stop();
+    return frames;
+}
+
+// Compresses and decompresses every frame with a codec, and checks that frames decode unchanged and that
+// truncated frames are rejected
+void benchmark(const std::string& name, std::vector<depth_frame_data>& frames, int repeats)
+{
+    typedef std::chrono::high_resolution_clock clock;
+    const auto& first = frames.front();
+    std::shared_ptr<ICompression> codec;
+    if (name == "rvl")
+        codec = std::make_shared<RvlCompression>(first.width, first.height, RS2_FORMAT_Z16, 2);
+    else
+        codec = std::make_shared<Lz4Compression>(first.width, first.height, RS2_FORMAT_Z16, 2);
+
+    std::vector<std::vector<unsigned char>> compressed(frames.size());
+    std::vector<unsigned char> decompressed(first.pixels.size());
+    clock::duration compression_time(0), decompression_time(0);
+    size_t raw_bytes = 0, compressed_bytes = 0;
+    int mismatches = 0, accepted_truncations = 0;
+
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        auto& pixels = frames[i].pixels;
+        // Room for frames that do not compress, which the codecs reject only after writing them
+        compressed[i].resize(2 * pixels.size());
+        int size = 0;
+        auto begin = clock::now();
+        for (int r = 0; r < repeats; r++)
+            size = codec->compressBuffer(pixels.data(), (int)pixels.size(), compressed[i].data());
+        compression_time += clock::now() - begin;
+        if (size <= 0)
+        {
+            std::cout << name << ": frame " << i << " does not compress" << std::endl;
+            return;
+        }
+        compressed[i].resize(size);
+        raw_bytes += pixels.size();
+        compressed_bytes += size;
+    }
+
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        // The payload follows the compressed size, the way frames are sent
+        auto payload = compressed[i].data() + sizeof(int);
+        int payload_size = (int)compressed[i].size() - (int)sizeof(int);
+        auto begin = clock::now();
+        for (int r = 0; r < repeats; r++)
+            codec->decompressBuffer(payload, payload_size, decompressed.data());
+        decompression_time += clock::now() - begin;
+        if (decompressed != frames[i].pixels)
+            mismatches++;
+
+        std::vector<unsigned char> truncated(payload, payload + payload_size / 2);
+        if (codec->decompressBuffer(truncated.data(), (int)truncated.size(), decompressed.data()) > 0)
+            accepted_truncations++;
+    }
+
+    auto mb_per_second = [&](clock::duration time) {
+        return raw_bytes * repeats / std::chrono::duration<double>(time).count() / (1024 * 1024);
+    };
+    std::cout << std::left << std::setw(6) << name << std::right << std::fixed << std::setprecision(1)
+        << "ratio " << std::setw(5) << double(raw_bytes) / compressed_bytes
+        << "   compression " << std::setw(8) << mb_per_second(compression_time) << " MB/s"
+        << "   decompression " << std::setw(8) << mb_per_second(decompression_time) << " MB/s"
+        << "   mismatches " << mismatches
+        << "   accepted truncations " << accepted_truncations << std::endl;
+}
+
+int main(int argc, char** argv) try
+{
+    CmdLine cmd("librealsense rs-compression-benchmark tool", ' ', RS2_API_VERSION_STR);
+
+    ValueArg<std::string> arg_file("i", "input", "Recording (.bag) with a depth stream", true, "", "string");
+    ValueArg<int> arg_frames("n", "frames", "Number of depth frames to read from the recording", false, 100, "integer");
+    ValueArg<int> arg_repeats("r", "repeats", "Number of times each frame is compressed and decompressed", false, 10, "integer");
+
+    cmd.add(arg_file);
+    cmd.add(arg_frames);
+    cmd.add(arg_repeats);
+    cmd.parse(argc, argv);
+
+    // The codecs log to the librealsense logger, which is kept off the console
+    el::Loggers::getLogger("librealsense");
+    el::Loggers::reconfigureAllLoggers(el::Level::Global, el::ConfigurationType::ToStandardOutput, "false");
+    el::Loggers::reconfigureAllLoggers(el::Level::Global, el::ConfigurationType::ToFile, "false");
+
+    auto frames = read_depth_frames(arg_file.getValue(), arg_frames.getValue());
+    if (frames.empty())
+    {
+        std::cerr << "No depth frames in " << arg_file.getValue() << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << frames.size() << " depth frames of " << frames.front().width << "x" << frames.front().height << std::endl;
+
+    benchmark("rvl", frames, std::max(1, arg_repeats.getValue()));
+    benchmark("lz4", frames, std::max(1, arg_repeats.getValue()));
+
+    return EXIT_SUCCESS;
+}
+catch (const rs2::error & e)
+{
+    std::cerr << "RealSense error calling " << e.get_failed_function() << "(" << e.get_failed_args() << "):\n    " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
+catch (const std::exception& e)
+{
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,121 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "RsFrameQueue.hh"
+#include <compression/CompressionFactory.h>
+#include <ipDeviceCommon/RsCommon.h>
+
+RsFrameQueue::RsFrameQueue(rs2::video_stream_profile& t_videoStreamProfile, size_t t_capacity)
+    : m_capacity(t_capacity)
+{
+    if(CompressionFactory::isCompressionSupported(t_videoStreamProfile.format(), t_videoStreamProfile.stream_type()))
+    {
+        m_compression = CompressionFactory::getObject(t_videoStreamProfile.width(), t_videoStreamProfile.height(), t_videoStreamProfile.format(), t_videoStreamProfile.stream_type(), getStreamProfileBpp(t_videoStreamProfile.format()));
+    }
+    else
+    {
+        INF << "unsupported compression format or compression is disabled, continue without compression";
+    }
+}
+
+RsFrameQueue::~RsFrameQueue()
+{
+    flush();
+}
+
+void RsFrameQueue::enqueue(const rs2::frame& t_frame)
+{
+    unsigned int frameSize = t_frame.get_data_size();
+    unsigned char* buffer = m_memPool.getNextMem();
+    if(m_compression)
+    {
+        // The codecs write the compressed size in front of the data, where the frame header is written below
+        int compressedSize = m_compression->compressBuffer((unsigned char*)t_frame.get_data(), frameSize, buffer + sizeof(RsFrameHeader) - sizeof(int));
+        if(compressedSize == -1)
+        {
+            m_memPool.returnMem(buffer);
+            return;
+        }
+        frameSize = compressedSize - sizeof(int);
+    }
+    else
+    {
+        if(frameSize > MAX_FRAME_SIZE)
+        {
+            ERR << "frame of " << frameSize << " bytes is larger than the largest frame, dropped";
+            m_memPool.returnMem(buffer);
+            return;
+        }
+        memcpy(buffer + sizeof(RsFrameHeader), t_frame.get_data(), frameSize);
+    }
+
+    RsFrameHeader header;
+    header.networkHeader.data.frameSize = frameSize + sizeof(RsMetadataHeader);
+    if(t_frame.supports_frame_metadata(RS2_FRAME_METADATA_FRAME_TIMESTAMP))
+    {
+        header.metadataHeader.data.timestamp = t_frame.get_frame_metadata(RS2_FRAME_METADATA_FRAME_TIMESTAMP) / 1000;
+    }
+    else
+    {
+        header.metadataHeader.data.timestamp = t_frame.get_timestamp();
+    }
+
+    if(t_frame.supports_frame_metadata(RS2_FRAME_METADATA_FRAME_COUNTER))
+    {
+        header.metadataHeader.data.frameCounter = t_frame.get_frame_metadata(RS2_FRAME_METADATA_FRAME_COUNTER);
+    }
+    else
+    {
+        header.metadataHeader.data.frameCounter = t_frame.get_frame_number();
+    }
+
+    if(t_frame.supports_frame_metadata(RS2_FRAME_METADATA_ACTUAL_FPS))
+    {
+        header.metadataHeader.data.actualFps = t_frame.get_frame_metadata(RS2_FRAME_METADATA_ACTUAL_FPS);
+    }
+
+    header.metadataHeader.data.timestampDomain = t_frame.get_frame_timestamp_domain();
+
+    memcpy(buffer, &header, sizeof(header));
+
+    RsPacket dropped = {nullptr, 0};
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if(m_packets.size() >= m_capacity)
+        {
+            dropped = m_packets.front();
+            m_packets.pop_front();
+        }
+        m_packets.push_back({buffer, unsigned(sizeof(RsFrameHeader)) + frameSize});
+    }
+    if(dropped.buffer)
+    {
+        m_memPool.returnMem(dropped.buffer);
+    }
+}
+
+bool RsFrameQueue::pollForPacket(RsPacket& t_packet)
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if(m_packets.empty())
+    {
+        return false;
+    }
+    t_packet = m_packets.front();
+    m_packets.pop_front();
+    return true;
+}
+
+void RsFrameQueue::returnPacket(const RsPacket& t_packet)
+{
+    m_memPool.returnMem(t_packet.buffer);
+}
+
+void RsFrameQueue::flush()
+{
+    RsPacket packet;
+    while(pollForPacket(packet))
+    {
+        returnPacket(packet);
+    }
+}
@@ -0,0 +1,43 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "compression/ICompression.h"
+#include <deque>
+#include <ipDeviceCommon/MemoryPool.h>
+#include <memory>
+#include <mutex>
+#include <rs.hpp> // Include RealSense Cross Platform API
+
+// A frame ready to be sent: a buffer of the queue's pool holding the frame header and the frame data
+struct RsPacket
+{
+    unsigned char* buffer;
+    unsigned int size;
+};
+
+// Frames of a stream, on their way from the sensor callback to the stream source. Frames are compressed
+// by enqueue, on the sensor's thread, so that the live555 event loop only copies packets out. When the
+// source falls behind, the oldest packets are dropped.
+class RsFrameQueue
+{
+public:
+    RsFrameQueue(rs2::video_stream_profile& t_videoStreamProfile, size_t t_capacity);
+    ~RsFrameQueue();
+
+    RsFrameQueue(const RsFrameQueue&) = delete;
+    RsFrameQueue& operator=(const RsFrameQueue&) = delete;
+
+    void enqueue(const rs2::frame& t_frame);
+    bool pollForPacket(RsPacket& t_packet);
+    void returnPacket(const RsPacket& t_packet);
+    void flush();
+
+private:
+    size_t m_capacity;
+    std::shared_ptr<ICompression> m_compression;
+    MemoryPool m_memPool;
+    std::deque<RsPacket> m_packets;
+    std::mutex m_mutex;
+};
@@ -313,11 +313,9 @@ void RsRTSPServer::RsRTSPClientSession::closeRsCamera()
 
 void RsRTSPServer::RsRTSPClientSession::emptyStreamProfileQueue(long long int profile_key)
 {
-    rs2::frame f;
     if(m_streamProfiles.find(profile_key) != m_streamProfiles.end())
     {
-        while(m_streamProfiles[profile_key].poll_for_frame(&f))
-            ;
+        m_streamProfiles[profile_key]->flush();
     }
 }
 
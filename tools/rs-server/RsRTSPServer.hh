@@ -63,7 +63,7 @@ public:
         void emptyStreamProfileQueue(long long int t_profile_key);
 
     private:
-        std::unordered_map<long long int, rs2::frame_queue> m_streamProfiles;
+        std::unordered_map<long long int, std::shared_ptr<RsFrameQueue>> m_streamProfiles;
     };
 
 protected:
@@ -73,7 +73,7 @@ protected:
     virtual ClientSession* createNewClientSession(u_int32_t t_sessionId);
 
 private:
-    int openRsCamera(RsSensor t_sensor, std::unordered_map<long long int, rs2::frame_queue>& t_streamProfiles);
+    int openRsCamera(RsSensor t_sensor, std::unordered_map<long long int, std::shared_ptr<RsFrameQueue>>& t_streamProfiles);
 
 private:
     friend class RsRTSPClientConnection;
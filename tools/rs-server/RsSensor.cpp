@@ -25,10 +25,9 @@ RsSensor::RsSensor(UsageEnvironment* t_env, rs2::sensor t_sensor, rs2::device t_
             m_prevSample.emplace(getStreamProfileKey(streamProfile), std::chrono::high_resolution_clock::now());
         }
     }
-    m_memPool = new MemoryPool();
 }
 
-int RsSensor::open(std::unordered_map<long long int, rs2::frame_queue>& t_streamProfilesQueues)
+int RsSensor::open(std::unordered_map<long long int, std::shared_ptr<RsFrameQueue>>& t_streamProfilesQueues)
 {
     std::vector<rs2::stream_profile> requestedStreamProfiles;
     for(auto streamProfile : t_streamProfilesQueues)
@@ -36,19 +35,6 @@ int RsSensor::open(std::unordered_map<long long int, rs2::frame_queue>& t_stream
         //make a vector of all requested stream profiles
         long long int streamProfileKey = streamProfile.first;
         requestedStreamProfiles.push_back(m_streamProfiles.at(streamProfileKey));
-        if(CompressionFactory::isCompressionSupported(m_streamProfiles.at(streamProfileKey).format(), m_streamProfiles.at(streamProfileKey).stream_type()))
-        {
-            rs2::video_stream_profile vsp = m_streamProfiles.at(streamProfileKey);
-            std::shared_ptr<ICompression> compressPtr = CompressionFactory::getObject(vsp.width(), vsp.height(), vsp.format(), vsp.stream_type(), getStreamProfileBpp(vsp.format()));
-            if(compressPtr != nullptr)
-            {
-                m_iCompress.insert(std::pair<long long int, std::shared_ptr<ICompression>>(streamProfileKey, compressPtr));
-            }
-        }
-        else
-        {
-            *env << "unsupported compression format or compression is disabled, continue without compression\n";
-        }
     }
     m_sensor.open(requestedStreamProfiles);
     return EXIT_SUCCESS;
@@ -66,7 +52,7 @@ int RsSensor::stop()
     return EXIT_SUCCESS;
 }
 
-int RsSensor::start(std::unordered_map<long long int, rs2::frame_queue>& t_streamProfilesQueues)
+int RsSensor::start(std::unordered_map<long long int, std::shared_ptr<RsFrameQueue>>& t_streamProfilesQueues)
 {
     auto callback = [&](const rs2::frame& frame) {
         long long int profileKey = getStreamProfileKey(frame.get_profile());
@@ -75,20 +61,8 @@ int RsSensor::start(std::unordered_map<long long int, rs2::frame_queue>& t_strea
         {
             std::chrono::high_resolution_clock::time_point curSample = std::chrono::high_resolution_clock::now();
             std::chrono::duration<double> timeSpan = std::chrono::duration_cast<std::chrono::duration<double>>(curSample - m_prevSample[profileKey]);
-            if(CompressionFactory::isCompressionSupported(frame.get_profile().format(), frame.get_profile().stream_type()))
-            {
-                unsigned char* buff = m_memPool->getNextMem();
-                int frameSize = m_iCompress.at(profileKey)->compressBuffer((unsigned char*)frame.get_data(), frame.get_data_size(), buff);
-                if(frameSize == -1)
-                {
-                    m_memPool->returnMem(buff);
-                    return;
-                }
-                memcpy((unsigned char*)frame.get_data(), buff, frameSize);
-                m_memPool->returnMem(buff);
-            }
-            //push frame to its queue
-            t_streamProfilesQueues[profileKey].enqueue(frame);
+            //compress the frame and push it to its queue
+            t_streamProfilesQueues[profileKey]->enqueue(frame);
             m_prevSample[profileKey] = curSample;
         }
     };
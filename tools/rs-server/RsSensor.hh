@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "RsFrameQueue.hh"
 #include "compression/ICompression.h"
 #include <chrono>
 #include <ipDeviceCommon/MemoryPool.h>
@@ -20,8 +21,8 @@ class RsSensor
 {
 public:
     RsSensor(UsageEnvironment* t_env, rs2::sensor t_sensor, rs2::device t_device);
-    int open(std::unordered_map<long long int, rs2::frame_queue>& t_streamProfilesQueues);
-    int start(std::unordered_map<long long int, rs2::frame_queue>& t_streamProfilesQueues);
+    int open(std::unordered_map<long long int, std::shared_ptr<RsFrameQueue>>& t_streamProfilesQueues);
+    int start(std::unordered_map<long long int, std::shared_ptr<RsFrameQueue>>& t_streamProfilesQueues);
     int close();
     int stop();
     rs2::sensor& getRsSensor()
@@ -44,8 +45,6 @@ private:
     UsageEnvironment* env;
     rs2::sensor m_sensor;
     std::unordered_map<long long int, rs2::video_stream_profile> m_streamProfiles;
-    std::unordered_map<long long int, std::shared_ptr<ICompression>> m_iCompress;
     rs2::device m_device;
-    MemoryPool* m_memPool;
     std::unordered_map<long long int, std::chrono::high_resolution_clock::time_point> m_prevSample;
 };
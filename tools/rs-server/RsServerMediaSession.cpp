@@ -18,7 +18,7 @@ RsServerMediaSession::RsServerMediaSession(UsageEnvironment& t_env, RsSensor& t_
 
 RsServerMediaSession::~RsServerMediaSession() {}
 
-void RsServerMediaSession::openRsCamera(std::unordered_map<long long int, rs2::frame_queue>& t_streamProfiles)
+void RsServerMediaSession::openRsCamera(std::unordered_map<long long int, std::shared_ptr<RsFrameQueue>>& t_streamProfiles)
 {
     if(m_isActive)
     {
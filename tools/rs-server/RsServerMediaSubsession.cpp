@@ -6,8 +6,6 @@
 #include "RsServerMediaSession.h"
 #include "RsSimpleRTPSink.h"
 
-#define CAPACITY 100
-
 RsServerMediaSubsession* RsServerMediaSubsession::createNew(UsageEnvironment& t_env, rs2::video_stream_profile& t_videoStreamProfile, std::shared_ptr<RsDevice> rsDevice)
 {
     return new RsServerMediaSubsession(t_env, t_videoStreamProfile, rsDevice);
@@ -17,13 +15,14 @@ RsServerMediaSubsession ::RsServerMediaSubsession(UsageEnvironment& env, rs2::vi
     : OnDemandServerMediaSubsession(env, false)
     , m_videoStreamProfile(t_videoStreamProfile)
 {
-    m_frameQueue = rs2::frame_queue(CAPACITY, true);
+    // Deeper than the pool of frame buffers, the queue would keep allocating them
+    m_frameQueue = std::make_shared<RsFrameQueue>(m_videoStreamProfile, POOL_SIZE);
     m_rsDevice = device;
 }
 
 RsServerMediaSubsession::~RsServerMediaSubsession() {}
 
-rs2::frame_queue& RsServerMediaSubsession::getFrameQueue()
+std::shared_ptr<RsFrameQueue> RsServerMediaSubsession::getFrameQueue()
 {
     return m_frameQueue;
 }
@@ -36,7 +35,7 @@ rs2::video_stream_profile RsServerMediaSubsession::getStreamProfile()
 FramedSource* RsServerMediaSubsession::createNewStreamSource(unsigned /*t_clientSessionId*/, unsigned& t_estBitrate)
 {
     t_estBitrate = 20000;
-    return RsDeviceSource::createNew(envir(), m_videoStreamProfile, m_frameQueue);
+    return RsDeviceSource::createNew(envir(), m_frameQueue);
 }
 
 RTPSink* RsServerMediaSubsession ::createNewRTPSink(Groupsock* t_rtpGroupsock, unsigned char t_rtpPayloadTypeIfDynamic, FramedSource* /*t_inputSource*/)
@@ -16,7 +16,7 @@ class RsServerMediaSubsession : public OnDemandServerMediaSubsession
 {
 public:
     static RsServerMediaSubsession* createNew(UsageEnvironment& t_env, rs2::video_stream_profile& t_videoStreamProfile, std::shared_ptr<RsDevice> rsDevice);
-    rs2::frame_queue& getFrameQueue();
+    std::shared_ptr<RsFrameQueue> getFrameQueue();
     rs2::video_stream_profile getStreamProfile();
 
 protected:
@@ -27,6 +27,6 @@ protected:
 
 private:
     rs2::video_stream_profile m_videoStreamProfile;
-    rs2::frame_queue m_frameQueue;
+    std::shared_ptr<RsFrameQueue> m_frameQueue;
     std::shared_ptr<RsDevice> m_rsDevice;
 };
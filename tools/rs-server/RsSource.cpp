@@ -6,67 +6,37 @@
 #include "RsStatistics.h"
 #include <GroupsockHelper.hh>
 #include <cassert>
-#include <compression/CompressionFactory.h>
 #include <ipDeviceCommon/RsCommon.h>
-#include <ipDeviceCommon/Statistic.h>
-#include <librealsense2/h/rs_sensor.h>
 
-RsDeviceSource* RsDeviceSource::createNew(UsageEnvironment& t_env, rs2::video_stream_profile& t_videoStreamProfile, rs2::frame_queue& t_queue)
+RsDeviceSource* RsDeviceSource::createNew(UsageEnvironment& t_env, std::shared_ptr<RsFrameQueue> t_queue)
 {
-    return new RsDeviceSource(t_env, t_videoStreamProfile, t_queue);
+    return new RsDeviceSource(t_env, t_queue);
 }
 
-RsDeviceSource::RsDeviceSource(UsageEnvironment& t_env, rs2::video_stream_profile& t_videoStreamProfile, rs2::frame_queue& t_queue)
+RsDeviceSource::RsDeviceSource(UsageEnvironment& t_env, std::shared_ptr<RsFrameQueue> t_queue)
     : FramedSource(t_env)
-{
-    m_framesQueue = &t_queue;
-    m_streamProfile = &t_videoStreamProfile;
-}
+    , m_framesQueue(t_queue)
+{}
 
 RsDeviceSource::~RsDeviceSource() {}
 
 void RsDeviceSource::doGetNextFrame()
 {
     // This function is called (by our 'downstream' object) when it asks for new data.
-
-    rs2::frame frame;
-    try
-    {
-        if(!m_framesQueue->poll_for_frame(&frame))
-        {
-            nextTask() = envir().taskScheduler().scheduleDelayedTask(0, (TaskFunc*)waitForFrame, this);
-        }
-        else
-        {
-            frame.keep();
-            deliverRSFrame(&frame);
-        }
-    }
-    catch(const std::exception& e)
-    {
-        envir() << "RsDeviceSource: " << e.what() << '\n';
-    }
+    handleWaitForFrame();
 }
 
 void RsDeviceSource::handleWaitForFrame()
 {
     // If a new frame of data is immediately available to be delivered, then do this now:
-    rs2::frame frame;
-    try
+    RsPacket packet;
+    if(!m_framesQueue->pollForPacket(packet))
     {
-        if(!(getFramesQueue()->poll_for_frame(&frame)))
-        {
-            nextTask() = envir().taskScheduler().scheduleDelayedTask(0, (TaskFunc*)RsDeviceSource::waitForFrame, this);
-        }
-        else
-        {
-            frame.keep();
-            deliverRSFrame(&frame);
-        }
+        nextTask() = envir().taskScheduler().scheduleDelayedTask(0, (TaskFunc*)RsDeviceSource::waitForFrame, this);
     }
-    catch(const std::exception& e)
+    else
     {
-        envir() << "RsDeviceSource: " << e.what() << '\n';
+        deliverRSFrame(packet);
     }
 }
 
@@ -76,59 +46,26 @@ void RsDeviceSource::waitForFrame(RsDeviceSource* t_deviceSource)
     t_deviceSource->handleWaitForFrame();
 }
 
-void RsDeviceSource::deliverRSFrame(rs2::frame* t_frame)
+void RsDeviceSource::deliverRSFrame(const RsPacket& t_packet)
 {
     if(!isCurrentlyAwaitingData())
     {
         envir() << "isCurrentlyAwaitingData returned false\n";
+        m_framesQueue->returnPacket(t_packet);
         return; // we're not ready for the data yet
     }
 
-    unsigned newFrameSize = t_frame->get_data_size();
-
     gettimeofday(&fPresentationTime, NULL); // If you have a more accurate time - e.g., from an encoder - then use that instead.
-    RsFrameHeader header;
-    unsigned char* data;
-    if(CompressionFactory::isCompressionSupported(t_frame->get_profile().format(), t_frame->get_profile().stream_type()))
-    {
-        fFrameSize = ((int*)t_frame->get_data())[0];
-        data = (unsigned char*)t_frame->get_data() + sizeof(int);
-    }
-    else
-    {
-        fFrameSize = t_frame->get_data_size();
-        data = (unsigned char*)t_frame->get_data();
-    }
-    memmove(fTo + sizeof(RsFrameHeader), data, fFrameSize);
-    fFrameSize += sizeof(RsMetadataHeader);
-    header.networkHeader.data.frameSize = fFrameSize;
-    fFrameSize += sizeof(RsNetworkHeader);
-    if(t_frame->supports_frame_metadata(RS2_FRAME_METADATA_FRAME_TIMESTAMP))
-    {
-        header.metadataHeader.data.timestamp = t_frame->get_frame_metadata(RS2_FRAME_METADATA_FRAME_TIMESTAMP) / 1000;
-    }
-    else
-    {
-        header.metadataHeader.data.timestamp = t_frame->get_timestamp();
-    }
 
-    if(t_frame->supports_frame_metadata(RS2_FRAME_METADATA_FRAME_COUNTER))
+    // The frame was compressed and its header written in the sensor callback, all that is left is to copy it out
+    fFrameSize = t_packet.size;
+    if(fFrameSize > fMaxSize)
     {
-        header.metadataHeader.data.frameCounter = t_frame->get_frame_metadata(RS2_FRAME_METADATA_FRAME_COUNTER);
+        fNumTruncatedBytes = fFrameSize - fMaxSize;
+        fFrameSize = fMaxSize;
     }
-    else
-    {
-        header.metadataHeader.data.frameCounter = t_frame->get_frame_number();
-    }
-
-    if(t_frame->supports_frame_metadata(RS2_FRAME_METADATA_ACTUAL_FPS))
-    {
-        header.metadataHeader.data.actualFps = t_frame->get_frame_metadata(RS2_FRAME_METADATA_ACTUAL_FPS);
-    }
-
-    header.metadataHeader.data.timestampDomain = t_frame->get_frame_timestamp_domain();
-
-    memmove(fTo, &header, sizeof(header));
+    memcpy(fTo, t_packet.buffer, fFrameSize);
+    m_framesQueue->returnPacket(t_packet);
 
     // After delivering the data, inform the reader that it is now available:
     FramedSource::afterGetting(this);
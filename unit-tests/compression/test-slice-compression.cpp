@@ -0,0 +1,243 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake:dependencies realsense2-compression
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <src/compression/CompressionFactory.h>
+#include <src/compression/SliceCompression.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+    const int W = 320, H = 240;
+    const uint8_t GUARD = 0xa5;
+
+    struct codec_case
+    {
+        const char * name;
+        ZipMethod method;
+        rs2_format format;
+        int bpp;
+        int max_error; // of any byte, 0 for lossless codecs
+    };
+
+    const codec_case codec_cases[] = {
+        { "JPEG Y8", ZipMethod::jpeg, RS2_FORMAT_Y8, 1, 16 },
+        { "JPEG RGB8", ZipMethod::jpeg, RS2_FORMAT_RGB8, 3, 16 },
+        { "LZ4", ZipMethod::lz, RS2_FORMAT_Z16, 2, 0 },
+        { "RVL", ZipMethod::rvl, RS2_FORMAT_Z16, 2, 0 },
+    };
+
+    // Smooth images with some noise: depth with holes, or gradients of color, which JPEG keeps close
+    std::vector< uint8_t > make_frame( codec_case const & c )
+    {
+        std::mt19937 gen( 5 );
+        std::vector< uint8_t > frame( W * H * c.bpp );
+        for( int y = 0; y < H; y++ )
+        {
+            for( int x = 0; x < W; x++ )
+            {
+                uint8_t * pixel = frame.data() + ( y * W + x ) * c.bpp;
+                if( c.format == RS2_FORMAT_Z16 )
+                {
+                    uint16_t depth = gen() % 7 ? uint16_t( 800 + x + 2 * y + gen() % 4 ) : 0;
+                    memcpy( pixel, &depth, sizeof( depth ) );
+                }
+                else
+                {
+                    for( int i = 0; i < c.bpp; i++ )
+                        pixel[i] = uint8_t( ( x + y ) / 3 + 20 * i + gen() % 3 );
+                }
+            }
+        }
+        return frame;
+    }
+
+    std::shared_ptr< ICompression > make_codec( codec_case const & c, int slices_count )
+    {
+        auto codec = CompressionFactory::getObject( W, H, c.format, c.method, c.bpp, slices_count );
+        REQUIRE( codec );
+        return codec;
+    }
+
+    // The compressed data, without the size the codecs write in front of it
+    std::vector< uint8_t > compress( ICompression & codec, std::vector< uint8_t > frame )
+    {
+        std::vector< uint8_t > compressed( 2 * frame.size() + 64 );
+        int size = codec.compressBuffer( frame.data(), int( frame.size() ), compressed.data() );
+        REQUIRE( size > int( sizeof( int ) ) );
+        int header = 0;
+        memcpy( &header, compressed.data(), sizeof( header ) );
+        REQUIRE( header == size - int( sizeof( int ) ) );
+        return std::vector< uint8_t >( compressed.begin() + sizeof( int ), compressed.begin() + size );
+    }
+
+    // Decompresses into a frame followed by guard bytes, which must be left alone
+    int decompress( ICompression & codec, std::vector< uint8_t > data, codec_case const & c, std::vector< uint8_t > & frame )
+    {
+        frame.assign( W * H * c.bpp + 64, GUARD );
+        int size = codec.decompressBuffer( data.data(), int( data.size() ), frame.data() );
+        for( size_t i = W * H * c.bpp; i < frame.size(); i++ )
+            REQUIRE( frame[i] == GUARD );
+        return size;
+    }
+
+    int read_int( std::vector< uint8_t > const & data, size_t offset )
+    {
+        int value = 0;
+        memcpy( &value, data.data() + offset, sizeof( value ) );
+        return value;
+    }
+
+    void write_int( std::vector< uint8_t > & data, size_t offset, int value )
+    {
+        memcpy( data.data() + offset, &value, sizeof( value ) );
+    }
+}
+
+TEST_CASE( "Slice compression round trip", "[compression]" )
+{
+    for( auto & c : codec_cases )
+    {
+        auto frame = make_frame( c );
+        // One decoder for all, following the slices count of each frame
+        auto decoder = make_codec( c, 0 );
+        for( int slices_count : { 8, 1, 2 } )
+        {
+            CAPTURE( c.name );
+            CAPTURE( slices_count );
+            auto encoder = make_codec( c, slices_count );
+            auto data = compress( *encoder, frame );
+            if( slices_count == 1 )
+            {
+                // The codec's data alone, as before slices
+                REQUIRE( read_int( data, 0 ) != SLICES_MAGIC );
+            }
+            else
+            {
+                REQUIRE( read_int( data, 0 ) == SLICES_MAGIC );
+                REQUIRE( read_int( data, 4 ) == SLICES_VERSION );
+                REQUIRE( read_int( data, 8 ) == slices_count );
+            }
+
+            std::vector< uint8_t > decoded;
+            REQUIRE( decompress( *decoder, data, c, decoded ) == int( frame.size() ) );
+            int max_error = 0;
+            for( size_t i = 0; i < frame.size(); i++ )
+                max_error = std::max( max_error, std::abs( int( decoded[i] ) - int( frame[i] ) ) );
+            REQUIRE( max_error <= c.max_error );
+        }
+    }
+}
+
+TEST_CASE( "Slice compression rejects truncated and corrupt containers", "[compression]" )
+{
+    for( auto & c : codec_cases )
+    {
+        CAPTURE( c.name );
+        auto frame = make_frame( c );
+        auto encoder = make_codec( c, 4 );
+        auto decoder = make_codec( c, 0 );
+        auto data = compress( *encoder, frame );
+        std::vector< uint8_t > decoded;
+        REQUIRE( decompress( *decoder, data, c, decoded ) == int( frame.size() ) );
+
+        // The slice sizes account for every byte of the container
+        for( size_t size = 0; size < data.size(); size += size < 64 ? 1 : 997 )
+        {
+            CAPTURE( size );
+            REQUIRE( decompress( *decoder, std::vector< uint8_t >( data.begin(), data.begin() + size ), c, decoded ) == -1 );
+        }
+        auto longer = data;
+        longer.push_back( 0 );
+        REQUIRE( decompress( *decoder, longer, c, decoded ) == -1 );
+
+        auto corrupt = data;
+        write_int( corrupt, 4, SLICES_VERSION + 1 );
+        REQUIRE( decompress( *decoder, corrupt, c, decoded ) == -1 );
+
+        for( int count : { 0, -1, MAX_SLICES + 1, H + 1 } )
+        {
+            CAPTURE( count );
+            corrupt = data;
+            write_int( corrupt, 8, count );
+            REQUIRE( decompress( *decoder, corrupt, c, decoded ) == -1 );
+        }
+
+        for( int delta : { -1, 1, -read_int( data, 12 ) - 1 } )
+        {
+            CAPTURE( delta );
+            corrupt = data;
+            write_int( corrupt, 12, read_int( data, 12 ) + delta );
+            REQUIRE( decompress( *decoder, corrupt, c, decoded ) == -1 );
+        }
+
+        // Moving bytes from one slice to the next keeps the total, but not the slices
+        corrupt = data;
+        write_int( corrupt, 12, read_int( data, 12 ) - 16 );
+        write_int( corrupt, 16, read_int( data, 16 ) + 16 );
+        REQUIRE( decompress( *decoder, corrupt, c, decoded ) == -1 );
+
+        // Still decodes good data
+        REQUIRE( decompress( *decoder, data, c, decoded ) == int( frame.size() ) );
+    }
+}
+
+TEST_CASE( "Slice compression of corrupt slices stays inside the frame", "[compression]" )
+{
+    // libjpeg ends the process on some corrupt data, so only the lossless codecs are fed random bytes
+    std::mt19937 gen( 11 );
+    for( auto & c : codec_cases )
+    {
+        if( c.method == ZipMethod::jpeg )
+            continue;
+        CAPTURE( c.name );
+        auto frame = make_frame( c );
+        auto decoder = make_codec( c, 0 );
+        for( int slices_count : { 1, 2, 8 } )
+        {
+            auto data = compress( *make_codec( c, slices_count ), frame );
+            size_t header_size = slices_count == 1 ? 0 : ( 3 + slices_count ) * sizeof( int );
+            for( int n = 0; n < 50; n++ )
+            {
+                auto corrupt = data;
+                corrupt[header_size + gen() % ( corrupt.size() - header_size )] ^= uint8_t( 1 + gen() % 255 );
+                std::vector< uint8_t > decoded;
+                int size = decompress( *decoder, corrupt, c, decoded );
+                REQUIRE( ( size == -1 || size == int( frame.size() ) ) );
+            }
+        }
+    }
+}
+
+TEST_CASE( "Slice compression of a single slice of another size is rejected", "[compression]" )
+{
+    // Peers that predate slices send whole frames; one of another resolution must not be decoded into this one
+    for( auto & c : codec_cases )
+    {
+        CAPTURE( c.name );
+        auto small = CompressionFactory::getObject( W, H / 2, c.format, c.method, c.bpp, 1 );
+        REQUIRE( small );
+        auto frame = make_frame( c );
+        std::vector< uint8_t > compressed( 2 * frame.size() + 64 );
+        int size = small->compressBuffer( frame.data(), int( frame.size() / 2 ), compressed.data() );
+        REQUIRE( size > 0 );
+        std::vector< uint8_t > decoded;
+        REQUIRE( decompress( *make_codec( c, 0 ), std::vector< uint8_t >( compressed.begin() + sizeof( int ), compressed.begin() + size ), c, decoded ) == -1 );
+    }
+}
@@ -0,0 +1,83 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake:dependencies realsense2-compression
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <src/compression/WorkerPool.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE( "WorkerPool runs each task once", "[compression][worker-pool]" )
+{
+    // The calling thread runs tasks too
+    WorkerPool pool( 3 );
+    REQUIRE( pool.getConcurrency() == 4 );
+    for( int count : { 0, 1, 3, 4, 5, 100 } )
+    {
+        CAPTURE( count );
+        std::vector< std::atomic< int > > runs( count );
+        for( auto & r : runs )
+            r = 0;
+        pool.parallelFor( count, [&]( int i ) { runs[i]++; } );
+        for( auto & r : runs )
+            REQUIRE( r == 1 );
+    }
+}
+
+TEST_CASE( "WorkerPool under concurrent callers", "[compression][worker-pool]" )
+{
+    // Like the compressors of several streams, each calling from its own thread
+    const int callers_count = 6;
+    const int iterations = 300;
+    const int tasks_count = 8;
+    WorkerPool pool( 3 );
+    std::atomic< int > errors( 0 );
+
+    std::vector< std::thread > callers;
+    for( int t = 0; t < callers_count; t++ )
+    {
+        callers.emplace_back( [&]()
+        {
+            for( int i = 0; i < iterations; i++ )
+            {
+                // Results the caller reads without synchronization once parallelFor returns
+                std::vector< int > runs( tasks_count, 0 );
+                pool.parallelFor( tasks_count, [&]( int task ) {
+                    runs[task]++;
+                    if( task % 3 == 0 )
+                        std::this_thread::yield();
+                } );
+                for( int r : runs )
+                    if( r != 1 )
+                        errors++;
+            }
+        } );
+    }
+    for( auto & caller : callers )
+        caller.join();
+
+    REQUIRE( errors == 0 );
+}
+
+TEST_CASE( "WorkerPool is destroyed while idle", "[compression][worker-pool]" )
+{
+    for( int i = 0; i < 20; i++ )
+    {
+        WorkerPool pool( i % 5 );
+        std::atomic< int > runs( 0 );
+        pool.parallelFor( 7, [&]( int ) { runs++; } );
+        REQUIRE( runs == 7 );
+    }
+}
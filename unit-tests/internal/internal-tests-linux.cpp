@@ -189,3 +189,57 @@ TEST_CASE("named_mutex_processes", "[code]")
     }
 }
 
+
+TEST_CASE("retained_buffers_lending", "[code]")
+{
+    retained_buffers buffers;
+    const size_t queue_size = 4;
+
+    // Only half of the kernel queue may be retained by frames at a time
+    REQUIRE(buffers.lend(queue_size));
+    REQUIRE(buffers.lend(queue_size));
+    REQUIRE_FALSE(buffers.lend(queue_size));
+    REQUIRE(buffers.wait_for_all(std::chrono::milliseconds(0)) == 3);
+
+    // Buffers lent out without being retainable still count until given back
+    buffers.give_back();
+    REQUIRE_FALSE(buffers.lend(queue_size));
+    buffers.give_back();
+    buffers.give_back();
+    REQUIRE(buffers.lend(queue_size));
+    buffers.give_back();
+    REQUIRE(buffers.wait_for_all(std::chrono::milliseconds(0)) == 1);
+    buffers.give_back();
+    REQUIRE(buffers.wait_for_all(std::chrono::milliseconds(0)) == 0);
+}
+
+TEST_CASE("retained_buffers_close_waits_for_release", "[code]")
+{
+    retained_buffers buffers;
+    const size_t queue_size = 16;
+    for (int i = 0; i < 3; ++i)
+        buffers.lend(queue_size);
+
+    // Buffers given back from other threads wake the waiter as soon as the last one is back
+    auto start = std::chrono::steady_clock::now();
+    std::thread releaser([&]()
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            buffers.give_back();
+        }
+    });
+    REQUIRE(buffers.wait_for_all(std::chrono::seconds(10)) == 0);
+    auto waited = std::chrono::steady_clock::now() - start;
+    releaser.join();
+    REQUIRE(waited >= std::chrono::milliseconds(60));
+    REQUIRE(waited < std::chrono::seconds(5));
+
+    // A buffer never given back leaves the wait at its timeout, reporting it
+    buffers.lend(queue_size);
+    start = std::chrono::steady_clock::now();
+    REQUIRE(buffers.wait_for_all(std::chrono::milliseconds(50)) == 1);
+    REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(50));
+    buffers.give_back();
+}
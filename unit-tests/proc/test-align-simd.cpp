@@ -0,0 +1,106 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake:static!
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <src/image-avx.h>
+#include <src/proc/sse/sse-align.h>
+#include <librealsense2/h/rs_types.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace librealsense;
+
+namespace
+{
+    const unsigned int count = 1000;  // a multiple of 8, as the kernels require
+
+    // The projection of get_texture_map_sse, one pixel at a time, with the same operations in the same order
+    template< rs2_distortion dist >
+    void texture_map_reference( const uint16_t * depth, float depth_scale, const float * map_x, const float * map_y,
+                                int * pixels, const rs2_intrinsics & to, const rs2_extrinsics & from_to_other )
+    {
+        auto & r = from_to_other.rotation;
+        auto & t = from_to_other.translation;
+        for( unsigned int i = 0; i < count; i++ )
+        {
+            float z = float( depth[i] ) * depth_scale;
+            float px = z * map_x[i];
+            float py = z * map_y[i];
+            float x = r[0] * px + ( r[3] * py + ( r[6] * z + t[0] ) );
+            float y = r[1] * px + ( r[4] * py + ( r[7] * z + t[1] ) );
+            float p_z = r[2] * px + ( r[5] * py + ( r[8] * z + t[2] ) );
+            x = x / p_z;
+            y = y / p_z;
+
+            if( dist == RS2_DISTORTION_MODIFIED_BROWN_CONRADY )
+            {
+                auto & c = to.coeffs;
+                float r2 = x * x + y * y;
+                float f = 1 + ( c[0] * r2 + ( c[1] * ( r2 * r2 ) + c[4] * ( r2 * ( r2 * r2 ) ) ) );
+                float x_f = x * f;
+                float y_f = y * f;
+                // Both coordinates take the tangential term of x, as the kernels do
+                float r4 = c[3] * ( r2 + 2 * ( x_f * x_f ) );
+                x = x_f + ( 2 * ( c[2] * ( x_f * y_f ) ) + r4 );
+                y = y_f + ( 2 * ( c[3] * ( x_f * y_f ) ) + r4 );
+            }
+
+            // Pixels without depth map to (0, 0); the rest round to nearest-even after adding half a pixel
+            pixels[i * 2 + 0] = z != 0 ? int( std::nearbyint( x * to.fx + to.ppx + 0.5f ) ) : 0;
+            pixels[i * 2 + 1] = z != 0 ? int( std::nearbyint( y * to.fy + to.ppy + 0.5f ) ) : 0;
+        }
+    }
+
+    template< rs2_distortion dist >
+    void compare_kernels()
+    {
+        rs2_intrinsics to = { 640, 480, 321.3f, 238.9f, 612.7f, 611.2f, dist, { 0.12f, -0.25f, 0.0013f, -0.0021f, 0.09f } };
+        rs2_extrinsics from_to_other = { { 0.9999f, 0.0052f, -0.0101f, -0.0051f, 0.9999f, 0.0043f, 0.0102f, -0.0042f, 0.9999f },
+                                         { 0.0148f, 0.0002f, 0.0005f } };
+        const float depth_scale = 0.001f;
+
+        std::vector< float > map_x( count ), map_y( count );
+        std::vector< uint16_t > depth( count );
+        for( unsigned int i = 0; i < count; i++ )
+        {
+            map_x[i] = ( float( i % 40 ) - 20.f ) / 30.f;
+            map_y[i] = ( float( i / 40 ) - 12.f ) / 30.f;
+            depth[i] = i % 9 == 0 ? 0 : uint16_t( 300 + ( i * 2654435761u ) % 5000 );
+        }
+
+        std::vector< int > expected( count * 2 );
+        texture_map_reference< dist >( depth.data(), depth_scale, map_x.data(), map_y.data(), expected.data(), to, from_to_other );
+
+#ifdef RS2_HAVE_AVX2_KERNELS
+        if( has_avx() )
+        {
+            std::vector< int > pixels( count * 2 );
+            get_texture_map_avx2< dist >( depth.data(), depth_scale, count, map_x.data(), map_y.data(), reinterpret_cast< byte * >( pixels.data() ),
+                                          to, from_to_other );
+            CHECK( pixels == expected );
+        }
+#endif
+    }
+}
+
+TEST_CASE( "align texture map kernel matches the scalar projection, no distortion", "[proc][simd]" )
+{
+    compare_kernels< RS2_DISTORTION_NONE >();
+}
+
+TEST_CASE( "align texture map kernel matches the scalar projection, modified brown-conrady", "[proc][simd]" )
+{
+    compare_kernels< RS2_DISTORTION_MODIFIED_BROWN_CONRADY >();
+}
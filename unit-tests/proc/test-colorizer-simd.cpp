@@ -0,0 +1,74 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake:static!
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <src/image-avx.h>
+#include <src/proc/sse/sse-colorizer.h>
+
+#include <vector>
+
+using namespace librealsense;
+
+namespace
+{
+    const size_t count = 1001;  // not a multiple of any vector width, so every kernel leaves pixels to the scalar code
+
+    // The scalar loop of colorizer::make_rgb_data_z16, from pixel 'first' on
+    void colorize_reference( const uint16_t * depth, uint8_t * rgb, size_t first, const uint32_t * lut )
+    {
+        for( size_t i = first; i < count; i++ )
+        {
+            auto c = lut[depth[i]];
+            rgb[i * 3 + 0] = uint8_t( c );
+            rgb[i * 3 + 1] = uint8_t( c >> 8 );
+            rgb[i * 3 + 2] = uint8_t( c >> 16 );
+        }
+    }
+}
+
+TEST_CASE( "colorizer lookup kernels match the scalar code", "[proc][simd]" )
+{
+    // A distinct color for every depth value, with a top byte the kernels must drop
+    std::vector< uint32_t > lut( 0x10000 );
+    for( uint32_t i = 0; i < lut.size(); i++ )
+        lut[i] = ( i * 2654435761u ) | 0xFF000000u;
+    lut[0] = 0;
+
+    std::vector< uint16_t > depth( count );
+    for( size_t i = 0; i < count; i++ )
+        depth[i] = i % 7 == 0 ? 0 : uint16_t( i * 40503u );
+
+    std::vector< uint8_t > expected( count * 3 );
+    colorize_reference( depth.data(), expected.data(), 0, lut.data() );
+    size_t done;
+
+#ifdef __SSSE3__
+    std::vector< uint8_t > sse( count * 3 );
+    done = colorize_z16_lut_sse( depth.data(), sse.data(), count, lut.data() );
+    CHECK( done == count / 16 * 16 );
+    colorize_reference( depth.data(), sse.data(), done, lut.data() );
+    CHECK( sse == expected );
+#endif
+
+#ifdef RS2_HAVE_AVX2_KERNELS
+    if( has_avx() )
+    {
+        std::vector< uint8_t > avx( count * 3 );
+        done = colorize_z16_lut_avx2( depth.data(), avx.data(), count, lut.data() );
+        CHECK( done == count / 16 * 16 );
+        colorize_reference( depth.data(), avx.data(), done, lut.data() );
+        CHECK( avx == expected );
+    }
+#endif
+}
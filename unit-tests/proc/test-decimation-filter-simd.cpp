@@ -0,0 +1,115 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake:static!
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <src/image-avx.h>
+#include <src/proc/sse/sse-decimation-filter.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace librealsense;
+
+namespace
+{
+    const size_t width_out = 101;   // not a multiple of any vector width, so every kernel leaves pixels to the scalar code
+
+    // The median of decimation_filter::decimate_depth_row: zero pixels are left out, even-sized sets pick
+    // the member one below the middle, and blocks without valid pixels are zero
+    void median_reference( const uint16_t * in, size_t width_in, size_t scale, uint16_t * out, size_t first, size_t last )
+    {
+        for( size_t i = first; i < last; i++ )
+        {
+            std::vector< uint16_t > valid;
+            for( size_t n = 0; n < scale; n++ )
+                for( size_t m = 0; m < scale; m++ )
+                    if( auto v = in[n * width_in + i * scale + m] )
+                        valid.push_back( v );
+            std::sort( valid.begin(), valid.end() );
+            out[i] = valid.empty() ? 0 : valid[( valid.size() - 1 ) / 2];
+        }
+    }
+
+    // Rows of blocks with every number of zero pixels, repeated values, and values at both ends of the range,
+    // so that every comparator of the sorting networks matters
+    std::vector< uint16_t > make_rows( size_t scale, int seed )
+    {
+        size_t width_in = width_out * scale;
+        std::vector< uint16_t > rows( width_in * scale );
+        for( size_t i = 0; i < width_out; i++ )
+        {
+            size_t zeros = ( i + seed ) % ( scale * scale + 1 );
+            for( size_t k = 0; k < scale * scale; k++ )
+            {
+                uint32_t hash = uint32_t( ( i * 31 + k ) * 2654435761u + seed * 40503u );
+                uint16_t v;
+                if( hash % 11 == 0 )
+                    v = 65535;
+                else if( hash % 13 == 0 )
+                    v = 1;
+                else
+                    v = uint16_t( 1000 + ( hash >> 8 ) % ( seed % 2 ? 4 : 500 ) );   // odd seeds repeat values
+                // The zero pixels move around the block from one block to the next
+                if( ( k + i * 7 ) % ( scale * scale ) < zeros )
+                    v = 0;
+                rows[( k / scale ) * width_in + i * scale + k % scale] = v;
+            }
+        }
+        return rows;
+    }
+
+    // Runs the kernels in the order decimation_filter::decimate_depth_median_simd does, the scalar code doing the rest
+    void compare_kernels( size_t scale )
+    {
+        size_t width_in = width_out * scale;
+        for( int seed = 0; seed < 40; seed++ )
+        {
+            auto rows = make_rows( scale, seed );
+            std::vector< uint16_t > expected( width_out );
+            median_reference( rows.data(), width_in, scale, expected.data(), 0, width_out );
+
+#ifdef __SSSE3__
+            auto sse = scale == 2 ? decimate_median_2x2_z16_sse : decimate_median_3x3_z16_sse;
+            std::vector< uint16_t > out( width_out );
+            size_t done = sse( rows.data(), width_in, out.data(), width_out );
+            CHECK( done == width_out / 8 * 8 );
+            median_reference( rows.data(), width_in, scale, out.data(), done, width_out );
+            REQUIRE( out == expected );
+
+#ifdef RS2_HAVE_AVX2_KERNELS
+            if( has_avx() )
+            {
+                auto avx2 = scale == 2 ? decimate_median_2x2_z16_avx2 : decimate_median_3x3_z16_avx2;
+                out.assign( width_out, 0 );
+                done = avx2( rows.data(), width_in, out.data(), width_out );
+                CHECK( done == width_out / 16 * 16 );
+                done += sse( rows.data() + done * scale, width_in, out.data() + done, width_out - done );
+                median_reference( rows.data(), width_in, scale, out.data(), done, width_out );
+                REQUIRE( out == expected );
+            }
+#endif
+#endif
+        }
+    }
+}
+
+TEST_CASE( "decimation median kernels match the scalar code, 2x2", "[proc][simd]" )
+{
+    compare_kernels( 2 );
+}
+
+TEST_CASE( "decimation median kernels match the scalar code, 3x3", "[proc][simd]" )
+{
+    compare_kernels( 3 );
+}
@@ -0,0 +1,100 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake:static!
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <src/proc/pointcloud.h>
+#include <librealsense2/rsutil.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace librealsense;
+
+namespace
+{
+    // The CPU pointcloud, deprojecting through the rays that preprocess() caches
+    class cpu_pointcloud : public pointcloud
+    {
+    public:
+        void set_depth_intrinsics( const rs2_intrinsics & intrin )
+        {
+            _depth_intrinsics = intrin;
+            preprocess();
+        }
+
+        std::vector< float3 > deproject( const rs2_intrinsics & intrin, const std::vector< uint16_t > & depth, float depth_scale )
+        {
+            set_depth_intrinsics( intrin );
+            std::vector< float3 > points( depth.size() );
+            deproject_rows( points.data(), depth.data(), depth_scale, 0, intrin.height );
+            return points;
+        }
+
+        size_t rays() const { return _depth_rays.size(); }
+    };
+
+    // A pointcloud that deprojects on its own, as the GPU implementations do
+    class gpu_pointcloud : public cpu_pointcloud
+    {
+    protected:
+        bool tiled_processing() const override { return false; }
+    };
+
+    // The deprojection the pointcloud did before caching the rays: one rs2_deproject_pixel_to_point per pixel
+    std::vector< float3 > deproject_reference( const rs2_intrinsics & intrin, const std::vector< uint16_t > & depth, float depth_scale )
+    {
+        std::vector< float3 > points( depth.size() );
+        for( int y = 0; y < intrin.height; y++ )
+            for( int x = 0; x < intrin.width; x++ )
+            {
+                auto i = y * intrin.width + x;
+                const float pixel[] = { float( x ), float( y ) };
+                rs2_deproject_pixel_to_point( &points[i].x, &intrin, pixel, depth_scale * depth[i] );
+            }
+        return points;
+    }
+}
+
+TEST_CASE( "cached depth rays deproject like rs2_deproject_pixel_to_point", "[proc][pointcloud]" )
+{
+    const int width = 64, height = 48;
+    std::vector< uint16_t > depth( width * height );
+    for( size_t i = 0; i < depth.size(); i++ )
+        depth[i] = i % 7 == 0 ? 0 : uint16_t( 200 + ( i * 2654435761u ) % 8000 );
+
+    for( auto model : { RS2_DISTORTION_NONE, RS2_DISTORTION_INVERSE_BROWN_CONRADY, RS2_DISTORTION_BROWN_CONRADY,
+                        RS2_DISTORTION_KANNALA_BRANDT4, RS2_DISTORTION_FTHETA } )
+    {
+        CAPTURE( model );
+        rs2_intrinsics intrin = { width, height, 31.7f, 24.2f, 52.3f, 52.9f, model, { 0.11f, -0.24f, 0.0012f, -0.0023f, 0.08f } };
+        if( model == RS2_DISTORTION_FTHETA )
+            intrin.coeffs[0] = 0.9f;
+
+        cpu_pointcloud pc;
+        auto points = pc.deproject( intrin, depth, 0.001f );
+        CHECK( pc.rays() == depth.size() );
+
+        // Scaling the ray by the depth is exact, so the points are bit-identical
+        auto expected = deproject_reference( intrin, depth, 0.001f );
+        REQUIRE( memcmp( points.data(), expected.data(), points.size() * sizeof( float3 ) ) == 0 );
+    }
+}
+
+TEST_CASE( "depth rays are not computed for pointclouds that deproject on their own", "[proc][pointcloud]" )
+{
+    rs2_intrinsics intrin = { 64, 48, 31.7f, 24.2f, 52.3f, 52.9f, RS2_DISTORTION_NONE, { 0 } };
+    gpu_pointcloud pc;
+    pc.set_depth_intrinsics( intrin );
+    CHECK( pc.rays() == 0 );
+}
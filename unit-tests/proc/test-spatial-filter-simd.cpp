@@ -0,0 +1,175 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake:static!
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <src/image-avx.h>
+#include <src/proc/sse/sse-spatial-filter.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace librealsense;
+
+namespace
+{
+    const size_t width = 45;   // not a multiple of any vector width, so every kernel leaves columns to the scalar code
+    const size_t height = 31;
+    const float alpha = 0.4f;
+
+    // Disparity values are valid when their bit pattern is a positive integer, as in spatial_filter
+    bool is_valid( float v )
+    {
+        int bits;
+        memcpy( &bits, &v, sizeof( bits ) );
+        return bits > 0;
+    }
+
+    // The vertical pass of spatial_filter::recursive_filter_vertical_fp, one column at a time
+    void vertical_fp_reference( float * image, size_t first_col, size_t last_col, float delta_z )
+    {
+        for( size_t u = first_col; u < last_col; u++ )
+        {
+            for( int pass = 0; pass < 2; pass++ )
+            {
+                auto row = [&]( size_t v ) -> float & {
+                    return image[( pass ? height - 1 - v : v ) * width + u];
+                };
+                float state = row( 0 );
+                float previous = state;
+                for( size_t v = 1; v < height; v++ )
+                {
+                    float innovation = row( v );
+                    float delta = previous - innovation;
+                    if( is_valid( innovation ) && is_valid( previous ) && delta < delta_z && delta > -delta_z )
+                        row( v ) = state = innovation * alpha + state * ( 1.0f - alpha );
+                    else if( is_valid( innovation ) )
+                        state = innovation;
+                    previous = innovation;
+                }
+            }
+        }
+    }
+
+    // The vertical pass of spatial_filter::recursive_filter_vertical<uint16_t>
+    void vertical_z16_reference( uint16_t * image, size_t first_col, size_t last_col, uint16_t delta_z )
+    {
+        for( size_t v = 1; v < height; v++ )
+        {
+            for( size_t u = first_col; u < last_col; u++ )
+            {
+                uint16_t * im = image + ( v - 1 ) * width + u;
+                uint16_t diff = static_cast< uint16_t >( std::fabs( im[0] - im[width] ) );
+                if( diff < delta_z )
+                    im[width] = static_cast< uint16_t >( im[width] * alpha + im[0] * ( 1.f - alpha ) + 0.5f );
+            }
+        }
+        for( size_t v = 1; v < height; v++ )
+        {
+            for( size_t u = first_col; u < last_col; u++ )
+            {
+                uint16_t * im = image + ( height - 1 - v ) * width + u;
+                if( im[0] >= 1 && im[width] >= 1 )
+                {
+                    uint16_t diff = static_cast< uint16_t >( std::fabs( im[0] - im[width] ) );
+                    if( diff < delta_z )
+                        im[0] = static_cast< uint16_t >( im[0] * alpha + im[width] * ( 1.f - alpha ) + 0.5f );
+                }
+            }
+        }
+    }
+
+    // Depth with holes, edges and noise; values near the top of the range exercise the saturation
+    std::vector< uint16_t > make_depth()
+    {
+        std::vector< uint16_t > depth( width * height );
+        for( size_t v = 0; v < height; v++ )
+            for( size_t u = 0; u < width; u++ )
+            {
+                size_t i = v * width + u;
+                if( ( i * 7919 ) % 11 == 0 )
+                    depth[i] = 0;
+                else if( u > 30 )
+                    depth[i] = uint16_t( 65535 - ( i * 31 ) % 9 );
+                else
+                    depth[i] = uint16_t( ( v < 15 ? 1000 : 1400 ) + ( i * 2654435761u ) % 23 );
+            }
+        return depth;
+    }
+
+    std::vector< float > make_disparity()
+    {
+        auto depth = make_depth();
+        std::vector< float > disparity( depth.size() );
+        for( size_t i = 0; i < depth.size(); i++ )
+            disparity[i] = depth[i] ? 50000.f / depth[i] : 0.f;
+        return disparity;
+    }
+}
+
+TEST_CASE( "spatial filter vertical kernels match the scalar code, fp", "[proc][simd]" )
+{
+    const float delta_z = 2.f;
+    auto expected = make_disparity();
+    vertical_fp_reference( expected.data(), 0, width, delta_z );
+    size_t first_col;
+
+#ifdef __SSSE3__
+    auto sse = make_disparity();
+    first_col = recursive_filter_vertical_fp_sse( sse.data(), width, height, 0, width, alpha, delta_z );
+    CHECK( first_col == width / 4 * 4 );
+    vertical_fp_reference( sse.data(), first_col, width, delta_z );
+    CHECK( memcmp( sse.data(), expected.data(), expected.size() * sizeof( float ) ) == 0 );
+#endif
+
+#ifdef RS2_HAVE_AVX2_KERNELS
+    if( has_avx() )
+    {
+        auto avx = make_disparity();
+        first_col = recursive_filter_vertical_fp_avx2( avx.data(), width, height, 0, width, alpha, delta_z );
+        CHECK( first_col == width / 8 * 8 );
+        first_col = recursive_filter_vertical_fp_sse( avx.data(), width, height, first_col, width, alpha, delta_z );
+        vertical_fp_reference( avx.data(), first_col, width, delta_z );
+        CHECK( memcmp( avx.data(), expected.data(), expected.size() * sizeof( float ) ) == 0 );
+    }
+#endif
+}
+
+TEST_CASE( "spatial filter vertical kernels match the scalar code, z16", "[proc][simd]" )
+{
+    const uint16_t delta_z = 20;
+    auto expected = make_depth();
+    vertical_z16_reference( expected.data(), 0, width, delta_z );
+    size_t first_col;
+
+#ifdef __SSSE3__
+    auto sse = make_depth();
+    first_col = recursive_filter_vertical_z16_sse( sse.data(), width, height, 0, width, alpha, delta_z );
+    CHECK( first_col == width / 8 * 8 );
+    vertical_z16_reference( sse.data(), first_col, width, delta_z );
+    CHECK( sse == expected );
+#endif
+
+#ifdef RS2_HAVE_AVX2_KERNELS
+    if( has_avx() )
+    {
+        auto avx = make_depth();
+        first_col = recursive_filter_vertical_z16_avx2( avx.data(), width, height, 0, width, alpha, delta_z );
+        CHECK( first_col == width / 16 * 16 );
+        first_col = recursive_filter_vertical_z16_sse( avx.data(), width, height, first_col, width, alpha, delta_z );
+        vertical_z16_reference( avx.data(), first_col, width, delta_z );
+        CHECK( avx == expected );
+    }
+#endif
+}
@@ -0,0 +1,167 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake:static!
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <src/image-avx.h>
+#include <src/proc/sse/sse-temporal-filter.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace librealsense;
+
+namespace
+{
+    const size_t count = 1001;  // not a multiple of any vector width, so every kernel leaves pixels to the scalar code
+    const float alpha = 0.4f;
+
+    // The state a temporal filter carries from frame to frame
+    template< class T >
+    struct filter_state
+    {
+        std::vector< T > last_frame = std::vector< T >( count );
+        std::vector< uint8_t > history = std::vector< uint8_t >( count );
+    };
+
+    // The per-pixel pass of temporal_filter::temp_jw_smooth, from pixel 'first' on
+    template< class T >
+    void temporal_reference( T * frame, filter_state< T > & state, size_t first, T delta_z, uint8_t mask,
+                             const uint8_t * persistent )
+    {
+        for( size_t i = first; i < count; i++ )
+        {
+            T cur_val = frame[i];
+            T prev_val = state.last_frame[i];
+            uint8_t & history = state.history[i];
+            if( cur_val )
+            {
+                T diff = static_cast< T >( std::fabs( cur_val - prev_val ) );
+                if( prev_val && diff < delta_z )
+                {
+                    history |= mask;
+                    T result = static_cast< T >( alpha * cur_val + ( 1.f - alpha ) * prev_val );
+                    frame[i] = result;
+                    state.last_frame[i] = result;
+                }
+                else
+                {
+                    state.last_frame[i] = cur_val;
+                    history = mask;
+                }
+            }
+            else
+            {
+                if( prev_val && ( persistent[history / 8] & ( 1 << ( history % 8 ) ) ) )
+                    frame[i] = prev_val;
+                history &= ~mask;
+            }
+        }
+    }
+
+    // Frames with holes that come and go, values that agree with the last frame and values that jump
+    template< class T >
+    std::vector< T > make_frame( int index )
+    {
+        std::vector< T > frame( count );
+        for( size_t i = 0; i < count; i++ )
+        {
+            uint32_t hash = uint32_t( i * 2654435761u + index * 40503u );
+            if( hash % 7 == 0 || ( i % 13 == 0 && index % 3 ) )
+                frame[i] = 0;
+            else if( hash % 5 == 0 )
+                frame[i] = T( 3000 + hash % 1000 );
+            else
+                frame[i] = T( 1000 + ( i % 50 ) + hash % 9 );
+        }
+        return frame;
+    }
+
+    size_t filter_sse( uint16_t * frame, filter_state< uint16_t > & state, uint16_t delta_z, uint8_t mask, const uint8_t * persistent )
+    {
+        return temporal_filter_z16_sse( frame, state.last_frame.data(), state.history.data(), count, alpha, 1.f - alpha, delta_z, mask, persistent );
+    }
+
+    size_t filter_sse( float * frame, filter_state< float > & state, float delta_z, uint8_t mask, const uint8_t * persistent )
+    {
+        return temporal_filter_fp_sse( frame, state.last_frame.data(), state.history.data(), count, alpha, 1.f - alpha, delta_z, mask, persistent );
+    }
+
+    size_t filter_avx2( uint16_t * frame, filter_state< uint16_t > & state, uint16_t delta_z, uint8_t mask, const uint8_t * persistent )
+    {
+        return temporal_filter_z16_avx2( frame, state.last_frame.data(), state.history.data(), count, alpha, 1.f - alpha, delta_z, mask, persistent );
+    }
+
+    size_t filter_avx2( float * frame, filter_state< float > & state, float delta_z, uint8_t mask, const uint8_t * persistent )
+    {
+        return temporal_filter_fp_avx2( frame, state.last_frame.data(), state.history.data(), count, alpha, 1.f - alpha, delta_z, mask, persistent );
+    }
+
+    // Runs a sequence of frames through the scalar code and the kernels, comparing all the state after each frame
+    template< class T >
+    void compare_kernels( T delta_z )
+    {
+        // Histories are persistent when at least 3 of the last 8 frames had a value
+        uint8_t persistent[256 / 8] = {};
+        for( int h = 0; h < 256; h++ )
+        {
+            int bits = 0;
+            for( int b = 0; b < 8; b++ )
+                bits += ( h >> b ) & 1;
+            if( bits >= 3 )
+                persistent[h / 8] |= uint8_t( 1 << ( h % 8 ) );
+        }
+
+        filter_state< T > scalar, sse, avx;
+        bool do_avx = has_avx();
+        for( int index = 0; index < 20; index++ )
+        {
+            uint8_t mask = uint8_t( 1 << ( index % 8 ) );
+            auto expected = make_frame< T >( index );
+            temporal_reference( expected.data(), scalar, 0, delta_z, mask, persistent );
+
+#ifdef __SSSE3__
+            auto frame = make_frame< T >( index );
+            auto done = filter_sse( frame.data(), sse, delta_z, mask, persistent );
+            CHECK( done == count / ( 16 / sizeof( T ) ) * ( 16 / sizeof( T ) ) );
+            temporal_reference( frame.data(), sse, done, delta_z, mask, persistent );
+            REQUIRE( frame == expected );
+            REQUIRE( sse.last_frame == scalar.last_frame );
+            REQUIRE( sse.history == scalar.history );
+#endif
+
+#ifdef RS2_HAVE_AVX2_KERNELS
+            if( do_avx )
+            {
+                frame = make_frame< T >( index );
+                done = filter_avx2( frame.data(), avx, delta_z, mask, persistent );
+                CHECK( done == count / ( 32 / sizeof( T ) ) * ( 32 / sizeof( T ) ) );
+                temporal_reference( frame.data(), avx, done, delta_z, mask, persistent );
+                REQUIRE( frame == expected );
+                REQUIRE( avx.last_frame == scalar.last_frame );
+                REQUIRE( avx.history == scalar.history );
+            }
+#endif
+        }
+    }
+}
+
+TEST_CASE( "temporal filter kernels match the scalar code, z16", "[proc][simd]" )
+{
+    compare_kernels< uint16_t >( 20 );
+}
+
+TEST_CASE( "temporal filter kernels match the scalar code, fp", "[proc][simd]" )
+{
+    compare_kernels< float >( 20.f );
+}
@@ -0,0 +1,286 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+#include "../unit-tests-common.h"
+
+#include <librealsense2/hpp/rs_internal.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+using namespace rs2;
+
+namespace
+{
+    const int W = 16, H = 8, BPP = 2;
+
+    // The depth frame numbers of the recording: a run that restarts part way, as when a camera is reset
+    std::vector< int > recorded_frame_numbers( int first_run_start = 100 )
+    {
+        std::vector< int > numbers;
+        for( int n = first_run_start; n < first_run_start + 40; n++ )
+            numbers.push_back( n );
+        for( int n = 1; n <= 20; n++ )
+            numbers.push_back( n );
+        return numbers;
+    }
+
+    void record( std::string const & filename, int first_run_start = 100 )
+    {
+        software_device dev;
+        auto sensor = dev.add_sensor( "Synthetic" );
+        rs2_intrinsics intrinsics = { W, H, W / 2.f, H / 2.f, float( W ), float( H ), RS2_DISTORTION_NONE, { 0, 0, 0, 0, 0 } };
+        auto depth = sensor.add_video_stream( { RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics } );
+
+        std::vector< uint8_t > pixels( W * H * BPP );
+        recorder recorder( filename, dev, false );
+        sensor.open( depth );
+        sensor.start( []( frame ) {} );
+        double timestamp = 0;
+        for( auto n : recorded_frame_numbers( first_run_start ) )
+        {
+            sensor.on_video_frame( { pixels.data(), []( void * ) {}, W * BPP, BPP, timestamp += 16.6,
+                                     RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, n, depth } );
+            // Frames are stamped with the time they are recorded at, which must differ from one to the next
+            std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+        }
+        sensor.stop();
+        sensor.close();
+    }
+
+    // A paused playback of the recording, which publishes the frame a seek lands on
+    struct paused_playback
+    {
+        context ctx;
+        playback pb;
+        sensor depth_sensor;
+        frame_queue frames{ 100 };
+
+        paused_playback( std::string const & filename, bool index_cache )
+            : pb( ctx.load_device( filename ) )
+        {
+            pb.set_real_time( false );
+            if( index_cache )
+                pb.set_index_cache( true );
+            depth_sensor = pb.query_sensors()[0];
+            depth_sensor.open( depth_sensor.get_stream_profiles() );
+            depth_sensor.start( frames );
+            pb.pause();
+            frame f;
+            while( frames.poll_for_frame( &f ) )
+                ;
+        }
+
+        ~paused_playback()
+        {
+            depth_sensor.stop();
+            depth_sensor.close();
+        }
+
+        int frame_number_after( std::function< void() > seek )
+        {
+            seek();
+            auto f = frames.wait_for_frame( 5000 );
+            frame extra;
+            CHECK_FALSE( frames.poll_for_frame( &extra ) );
+            return int( f.get_frame_number() );
+        }
+
+        int seek_to_frame( int n )
+        {
+            return frame_number_after( [&]() { pb.seek_to_frame( RS2_STREAM_DEPTH, 0, n ); } );
+        }
+
+        int seek( std::chrono::nanoseconds time )
+        {
+            return frame_number_after( [&]() { pb.seek( time ); } );
+        }
+    };
+
+    std::vector< char > read_file( std::string const & path )
+    {
+        std::ifstream in( path, std::ios::binary );
+        return std::vector< char >( std::istreambuf_iterator< char >( in ), std::istreambuf_iterator< char >() );
+    }
+
+    void write_file( std::string const & path, std::vector< char > const & data )
+    {
+        std::ofstream out( path, std::ios::binary | std::ios::trunc );
+        out.write( data.data(), data.size() );
+    }
+
+    // Where the index file of a single topic keeps the frame numbers: after the magic, the size, modification
+    // time and index hash of the recording, the number of topics, and the topic name and frame count
+    const size_t topics_offset = 8 + 8 + 8 + 8;
+
+    size_t frame_numbers_offset( std::vector< char > const & index_file )
+    {
+        uint32_t name_length;
+        REQUIRE( index_file.size() > topics_offset + 4 + 4 );
+        memcpy( &name_length, index_file.data() + topics_offset + 4, sizeof( name_length ) );
+        return topics_offset + 4 + 4 + name_length + 4;
+    }
+}
+
+TEST_CASE( "Playback seeks by time and by frame number", "[software-device][record]" )
+{
+    std::string filename = get_folder_path( special_folder::temp_folder ) + "frame_index.bag";
+    std::remove( ( filename + ".idx" ).c_str() );
+    record( filename );
+    auto numbers = recorded_frame_numbers();
+
+    paused_playback playback( filename, false );
+
+    // Frame numbers of the first run are found by a binary search over time; the ones of the second run
+    // are smaller than all the first run's, so that search misses and the topic's frame numbers are all read
+    std::vector< std::chrono::nanoseconds > times;
+    for( auto n : numbers )
+    {
+        CAPTURE( n );
+        REQUIRE( playback.seek_to_frame( n ) == n );
+        times.emplace_back( playback.pb.get_position() );
+    }
+    for( size_t i = 1; i < times.size(); i++ )
+        REQUIRE( times[i] > times[i - 1] );
+    REQUIRE_THROWS( playback.pb.seek_to_frame( RS2_STREAM_DEPTH, 0, 99 ) );
+
+    // A time seek lands on the last frame at or before the time
+    for( size_t i = 0; i < times.size(); i++ )
+    {
+        CAPTURE( i );
+        REQUIRE( playback.seek( times[i] ) == numbers[i] );
+        if( i + 1 < times.size() )
+        {
+            REQUIRE( playback.seek( times[i] + ( times[i + 1] - times[i] ) / 2 ) == numbers[i] );
+            REQUIRE( playback.seek( times[i + 1] - std::chrono::nanoseconds( 1 ) ) == numbers[i] );
+        }
+    }
+
+    // The index is only kept next to the recording when asked to
+    std::ifstream index_file( filename + ".idx" );
+    CHECK_FALSE( index_file.good() );
+}
+
+TEST_CASE( "Playback keeps the frame index next to the recording", "[software-device][record]" )
+{
+    std::string filename = get_folder_path( special_folder::temp_folder ) + "frame_index_cache.bag";
+    std::string index_filename = filename + ".idx";
+    std::remove( index_filename.c_str() );
+    record( filename );
+
+    {
+        paused_playback playback( filename, true );
+        REQUIRE( playback.seek_to_frame( 5 ) == 5 );
+    }
+    auto index_file = read_file( index_filename );
+    REQUIRE( index_file.size() == frame_numbers_offset( index_file ) + recorded_frame_numbers().size() * sizeof( uint32_t ) );
+
+    // Renumber frame 110 in the index file: a playback that uses the file finds the frame by its new number,
+    // which proves the frame numbers were not read from the recording
+    auto renumbered = index_file;
+    uint32_t new_number = 5000;
+    memcpy( renumbered.data() + frame_numbers_offset( renumbered ) + 10 * sizeof( uint32_t ), &new_number, sizeof( new_number ) );
+
+    SECTION( "a valid index file is used" )
+    {
+        write_file( index_filename, renumbered );
+        paused_playback playback( filename, true );
+        REQUIRE( playback.seek_to_frame( 5000 ) == 110 );
+        REQUIRE( playback.seek_to_frame( 7 ) == 7 );
+    }
+
+    SECTION( "an index file of a different recording is ignored" )
+    {
+        renumbered[8] ^= 1;    // the size of the recording it was made for
+        write_file( index_filename, renumbered );
+        paused_playback playback( filename, true );
+        REQUIRE_THROWS( playback.pb.seek_to_frame( RS2_STREAM_DEPTH, 0, 5000 ) );
+        REQUIRE( playback.seek_to_frame( 110 ) == 110 );
+    }
+
+    SECTION( "an index file of a recording with other index records is ignored" )
+    {
+        renumbered[24] ^= 1;    // the hash of the recording's connections and message times
+        write_file( index_filename, renumbered );
+        paused_playback playback( filename, true );
+        REQUIRE_THROWS( playback.pb.seek_to_frame( RS2_STREAM_DEPTH, 0, 5000 ) );
+        REQUIRE( playback.seek_to_frame( 110 ) == 110 );
+    }
+
+    SECTION( "an index file with a bad magic is ignored" )
+    {
+        renumbered[0] = 'X';
+        write_file( index_filename, renumbered );
+        paused_playback playback( filename, true );
+        REQUIRE_THROWS( playback.pb.seek_to_frame( RS2_STREAM_DEPTH, 0, 5000 ) );
+        REQUIRE( playback.seek_to_frame( 110 ) == 110 );
+    }
+
+    SECTION( "a truncated index file is ignored" )
+    {
+        renumbered.resize( renumbered.size() - 2 );
+        write_file( index_filename, renumbered );
+        paused_playback playback( filename, true );
+        REQUIRE_THROWS( playback.pb.seek_to_frame( RS2_STREAM_DEPTH, 0, 5000 ) );
+        REQUIRE( playback.seek_to_frame( 110 ) == 110 );
+    }
+
+    SECTION( "an index file with a different number of frames is ignored" )
+    {
+        uint32_t count;
+        auto count_offset = frame_numbers_offset( renumbered ) - sizeof( count );
+        memcpy( &count, renumbered.data() + count_offset, sizeof( count ) );
+        count--;
+        memcpy( renumbered.data() + count_offset, &count, sizeof( count ) );
+        renumbered.resize( renumbered.size() - sizeof( uint32_t ) );
+        write_file( index_filename, renumbered );
+        paused_playback playback( filename, true );
+        REQUIRE_THROWS( playback.pb.seek_to_frame( RS2_STREAM_DEPTH, 0, 5000 ) );
+        REQUIRE( playback.seek_to_frame( 110 ) == 110 );
+    }
+}
+
+TEST_CASE( "Playback ignores the frame index of a replaced recording of the same size", "[software-device][record]" )
+{
+    std::string filename = get_folder_path( special_folder::temp_folder ) + "frame_index_replaced.bag";
+    std::string other_filename = get_folder_path( special_folder::temp_folder ) + "frame_index_other.bag";
+    std::string index_filename = filename + ".idx";
+    std::remove( index_filename.c_str() );
+    record( filename );
+    record( other_filename, 300 );
+    auto other = read_file( other_filename );
+    std::remove( other_filename.c_str() );
+    REQUIRE( read_file( filename ).size() == other.size() );
+
+    {
+        paused_playback playback( filename, true );
+        REQUIRE( playback.seek_to_frame( 5 ) == 5 );
+    }
+    REQUIRE( read_file( index_filename ).size() > frame_numbers_offset( read_file( index_filename ) ) );
+
+    // The other recording takes the file's place, likely within the same second; its frames are found by
+    // their own numbers and not by the ones the index file kept
+    write_file( filename, other );
+    {
+        paused_playback playback( filename, true );
+        REQUIRE( playback.seek_to_frame( 310 ) == 310 );
+        REQUIRE( playback.seek_to_frame( 5 ) == 5 );
+        REQUIRE_THROWS( playback.pb.seek_to_frame( RS2_STREAM_DEPTH, 0, 110 ) );
+    }
+    std::remove( filename.c_str() );
+    std::remove( index_filename.c_str() );
+}
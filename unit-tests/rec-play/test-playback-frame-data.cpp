@@ -0,0 +1,171 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake:static!
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+#include "../unit-tests-common.h"
+
+#include <librealsense2/hpp/rs_internal.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace
+{
+    // Not a multiple of the frame buffer pool's size classes, so the pool never allocates exactly this size
+    const int W = 100, H = 50, BPP = 3;
+    const size_t FRAME_SIZE = W * H * BPP;
+
+    // The blocks of exactly FRAME_SIZE bytes currently allocated, once tracking starts: the image data
+    // the reader deserializes, and anything else of that size
+    const int MAX_TRACKED = 256;
+    std::atomic< bool > tracking( false );
+    std::atomic< void * > tracked[MAX_TRACKED];
+
+    bool is_tracked( const void * p )
+    {
+        for( auto & t : tracked )
+            if( t == p )
+                return true;
+        return false;
+    }
+
+    void record( std::string const & filename, int frames_count )
+    {
+        rs2::software_device dev;
+        auto sensor = dev.add_sensor( "Synthetic" );
+        rs2_intrinsics intrinsics = { W, H, W / 2.f, H / 2.f, float( W ), float( H ), RS2_DISTORTION_NONE, { 0, 0, 0, 0, 0 } };
+        auto color = sensor.add_video_stream( { RS2_STREAM_COLOR, 0, 0, W, H, 30, BPP, RS2_FORMAT_RGB8, intrinsics } );
+
+        // The recorder writes the frames from its own thread, so each keeps its pixels until the recorder is gone
+        std::vector< std::vector< uint8_t > > pixels( frames_count, std::vector< uint8_t >( FRAME_SIZE ) );
+        rs2::recorder recorder( filename, dev );
+        sensor.open( color );
+        sensor.start( []( rs2::frame ) {} );
+        for( int i = 0; i < frames_count; i++ )
+        {
+            for( size_t j = 0; j < FRAME_SIZE; j++ )
+                pixels[i][j] = uint8_t( i + j );
+            sensor.on_video_frame( { pixels[i].data(), []( void * ) {}, W * BPP, BPP, double( i ), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK,
+                                     i + 1, color } );
+        }
+        sensor.stop();
+        sensor.close();
+    }
+}
+
+void * operator new( size_t size )
+{
+    auto p = std::malloc( size ? size : 1 );
+    if( ! p )
+        throw std::bad_alloc();
+    if( size == FRAME_SIZE && tracking )
+    {
+        for( auto & t : tracked )
+        {
+            void * expected = nullptr;
+            if( t.compare_exchange_strong( expected, p ) )
+                break;
+        }
+    }
+    return p;
+}
+
+void operator delete( void * p ) noexcept
+{
+    if( p && tracking )
+    {
+        for( auto & t : tracked )
+        {
+            void * expected = p;
+            if( t.compare_exchange_strong( expected, nullptr ) )
+                break;
+        }
+    }
+    std::free( p );
+}
+
+TEST_CASE( "Playback hands out the image data it read", "[playback][record]" )
+{
+    std::string filename = get_folder_path( special_folder::temp_folder ) + "playback_frame_data.bag";
+    const int frames_count = 20;
+    record( filename, frames_count );
+
+    // Raw frames are not copied out of the messages: their data is the block the message was read into
+    tracking = true;
+    {
+        rs2::context ctx;
+        rs2::playback playback = ctx.load_device( filename );
+        playback.set_real_time( false );
+        auto sensor = playback.query_sensors()[0];
+        rs2::frame_queue frames( frames_count );
+        sensor.open( sensor.get_stream_profiles() );
+        sensor.start( frames );
+        for( int i = 0; i < frames_count; i++ )
+        {
+            CAPTURE( i );
+            rs2::video_frame f = frames.wait_for_frame( 5000 );
+            REQUIRE( f.get_frame_number() == i + 1 );
+            REQUIRE( f.get_data_size() == FRAME_SIZE );
+            auto data = static_cast< const uint8_t * >( f.get_data() );
+            REQUIRE( data[0] == uint8_t( i ) );
+            REQUIRE( data[FRAME_SIZE - 1] == uint8_t( i + FRAME_SIZE - 1 ) );
+            REQUIRE( is_tracked( data ) );
+        }
+        sensor.stop();
+        sensor.close();
+    }
+    tracking = false;
+    std::remove( filename.c_str() );
+}
+
+TEST_CASE( "Playback leaves the frame pool to the application while reading ahead", "[playback][record]" )
+{
+    // Frames read ahead do not count against the frames of a version 2 file's pool (32) the application holds
+    std::string filename = get_folder_path( special_folder::temp_folder ) + "playback_frame_pool.bag";
+    const int frames_count = 40;
+    const int held_count = 28;
+    record( filename, frames_count );
+
+    rs2::context ctx;
+    rs2::playback playback = ctx.load_device( filename );
+    playback.set_real_time( false );
+    REQUIRE( playback.get_prefetch_budget() > 0 );
+    auto sensor = playback.query_sensors()[0];
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector< rs2::frame > held;
+    sensor.open( sensor.get_stream_profiles() );
+    sensor.start( [&]( rs2::frame f ) {
+        std::lock_guard< std::mutex > lock( mutex );
+        if( held.size() < held_count )
+            held.push_back( f );
+        cv.notify_all();
+    } );
+    {
+        std::unique_lock< std::mutex > lock( mutex );
+        REQUIRE( cv.wait_for( lock, std::chrono::seconds( 5 ), [&]() { return held.size() == held_count; } ) );
+        for( int i = 0; i < held_count; i++ )
+            REQUIRE( held[i].get_frame_number() == i + 1 );
+        held.clear();
+    }
+    sensor.stop();
+    sensor.close();
+    std::remove( filename.c_str() );
+}
@@ -0,0 +1,426 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/hpp/rs_internal.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const size_t queue_size = 10;   // QUEUE_MAX_SIZE, the size of the matcher queues and of the syncer queue
+
+    struct replay_frame
+    {
+        int stream;     // index into the streams of the replay; the stream unique ID is one more
+        unsigned long long number;
+        double timestamp;
+    };
+
+    // A frameset: the stream and the frame number of each of its frames, ordered by stream
+    typedef std::vector< std::pair< int, unsigned long long > > frameset_ids;
+
+    // The matching rules of a composite matcher of identity matchers, the way composite_matcher applied them
+    // when its state was kept in maps keyed by matcher. Streams are visited in the order the device lists
+    // them, which is the order the composite holds its matchers in.
+    class reference_matcher
+    {
+    public:
+        explicit reference_matcher( std::vector< int > fps )
+            : _streams( fps.size() )
+        {
+            for( size_t i = 0; i < fps.size(); i++ )
+                _streams[i].fps = fps[i];
+        }
+        virtual ~reference_matcher() = default;
+
+        std::vector< frameset_ids > replay( std::vector< replay_frame > const & frames )
+        {
+            std::vector< frameset_ids > framesets;
+            for( auto & f : frames )
+            {
+                // The syncer queues what one frame releases before handing it on, dropping the oldest
+                // framesets past the size of its queue
+                auto released = framesets.size();
+                arrive( f, framesets );
+                while( framesets.size() - released > queue_size )
+                {
+                    _dropped_frames += framesets[released].size();
+                    framesets.erase( framesets.begin() + released );
+                }
+            }
+            return framesets;
+        }
+
+        // Frames the matcher released in framesets the syncer then dropped
+        size_t dropped_frames() const { return _dropped_frames; }
+
+    protected:
+        struct stream_state
+        {
+            int fps = 0;
+            std::deque< replay_frame > queue;
+            bool queued = false;    // takes part in matching, as its queue exists
+            bool active = true;
+            double next_expected = 0;
+            unsigned long long last_number = 0;
+        };
+
+        virtual bool are_equivalent( replay_frame const & a, replay_frame const & b ) = 0;
+        virtual bool is_smaller_than( replay_frame const & a, replay_frame const & b ) = 0;
+        virtual bool skip_missing_stream( replay_frame const & synced, stream_state & missing ) = 0;
+        virtual void update_next_expected( stream_state & s, replay_frame const & f ) = 0;
+        virtual void clean_inactive_streams( replay_frame const & f ) {}
+
+        std::vector< stream_state > _streams;
+
+    private:
+        size_t _dropped_frames = 0;
+
+        void arrive( replay_frame const & f, std::vector< frameset_ids > & framesets )
+        {
+            clean_inactive_streams( f );
+            auto & s = _streams[f.stream];
+            if( ! s.active )
+            {
+                s.active = true;
+                s.queued = true;
+            }
+            s.last_number = f.number;
+            update_next_expected( s, f );
+
+            s.queued = true;
+            if( s.queue.size() >= queue_size )
+                s.queue.pop_front();
+            s.queue.push_back( f );
+
+            while( true )
+            {
+                std::vector< int > arrived, missing;
+                for( int i = 0; i < int( _streams.size() ); i++ )
+                {
+                    if( ! _streams[i].queued )
+                        continue;
+                    if( _streams[i].queue.empty() )
+                        missing.push_back( i );
+                    else
+                        arrived.push_back( i );
+                }
+                if( arrived.empty() )
+                    break;
+
+                auto curr = arrived[0];
+                std::vector< int > synced = { curr };
+                bool old_frames = false;
+                for( size_t i = 1; i < arrived.size(); i++ )
+                {
+                    auto & a = _streams[curr].queue.front();
+                    auto & b = _streams[arrived[i]].queue.front();
+                    if( are_equivalent( a, b ) )
+                        synced.push_back( arrived[i] );
+                    else if( is_smaller_than( b, a ) )
+                    {
+                        old_frames = true;
+                        synced = { arrived[i] };
+                        curr = arrived[i];
+                    }
+                    else
+                        old_frames = true;
+                }
+
+                bool release = true;
+                if( ! old_frames )
+                    for( auto m : missing )
+                        if( ! skip_missing_stream( _streams[synced[0]].queue.front(), _streams[m] ) )
+                            release = false;
+                if( ! release )
+                    break;
+
+                frameset_ids set;
+                for( auto i : synced )
+                {
+                    set.emplace_back( i, _streams[i].queue.front().number );
+                    _streams[i].queue.pop_front();
+                }
+                std::sort( set.begin(), set.end() );
+                framesets.push_back( set );
+            }
+        }
+    };
+
+    class reference_timestamp_matcher : public reference_matcher
+    {
+    public:
+        using reference_matcher::reference_matcher;
+
+    protected:
+        int fps_of( replay_frame const & f ) const { return _streams[f.stream].fps; }
+
+        static bool are_equivalent( double a, double b, int fps )
+        {
+            float gap = 1000.f / fps;
+            return std::fabs( a - b ) < ( gap / 2 );
+        }
+
+        bool are_equivalent( replay_frame const & a, replay_frame const & b ) override
+        {
+            return are_equivalent( a.timestamp, b.timestamp, std::min( fps_of( a ), fps_of( b ) ) );
+        }
+
+        bool is_smaller_than( replay_frame const & a, replay_frame const & b ) override
+        {
+            return a.timestamp < b.timestamp;
+        }
+
+        void update_next_expected( stream_state & s, replay_frame const & f ) override
+        {
+            auto gap = 1000.f / (float)s.fps;
+            s.next_expected = f.timestamp + gap;
+        }
+
+        bool skip_missing_stream( replay_frame const & synced, stream_state & missing ) override
+        {
+            if( ! missing.active )
+                return true;
+
+            auto next_expected = missing.next_expected;
+            auto timestamp = synced.timestamp;
+            if( timestamp > next_expected )
+            {
+                auto gap = 1000.f / (float)fps_of( synced );
+                auto threshold = 10 * gap;
+                if( timestamp - next_expected < threshold )
+                    return false;
+
+                if( missing.queue.empty() )
+                    missing.queued = false;
+                missing.active = false;
+            }
+            return ! are_equivalent( timestamp, next_expected, fps_of( synced ) );
+        }
+    };
+
+    class reference_frame_number_matcher : public reference_matcher
+    {
+    public:
+        using reference_matcher::reference_matcher;
+
+    protected:
+        bool are_equivalent( replay_frame const & a, replay_frame const & b ) override
+        {
+            return a.number == b.number;
+        }
+
+        bool is_smaller_than( replay_frame const & a, replay_frame const & b ) override
+        {
+            return a.number < b.number;
+        }
+
+        void update_next_expected( stream_state & s, replay_frame const & f ) override
+        {
+            s.next_expected = f.number + 1.;
+        }
+
+        void clean_inactive_streams( replay_frame const & f ) override
+        {
+            for( auto & s : _streams )
+            {
+                if( s.last_number && std::fabs( (long long)f.number - (long long)s.last_number ) > 5 )
+                {
+                    s.active = false;
+                    s.queued = true;
+                    s.queue.clear();
+                }
+            }
+        }
+
+        bool skip_missing_stream( replay_frame const & synced, stream_state & missing ) override
+        {
+            if( ! missing.active )
+                return true;
+            return synced.number - missing.next_expected > 4 || synced.number < missing.next_expected;
+        }
+    };
+
+    // Frames of streams running at their own rate, with jitter, lost frames and pauses long enough for the
+    // syncer to give up on a stream, arriving in the order of their timestamp plus a random latency
+    std::vector< replay_frame > make_timestamp_replay( std::vector< int > const & fps, unsigned seed )
+    {
+        std::mt19937 rng( seed );
+        std::uniform_real_distribution< double > jitter( -0.8, 0.8 ), latency( 0, 40 );
+        std::uniform_int_distribution< int > percent( 0, 99 );
+
+        std::vector< std::pair< double, replay_frame > > arrivals;
+        for( int s = 0; s < int( fps.size() ); s++ )
+        {
+            double period = 1000. / fps[s];
+            unsigned long long number = 0;
+            for( double t = 10 * s; t < 3000; t += period )
+            {
+                ++number;
+                if( percent( rng ) < 10 )
+                    continue;           // lost
+                if( percent( rng ) < 2 )
+                    t += 15 * period;   // paused
+                double timestamp = std::round( ( t + jitter( rng ) ) * 10 ) / 10;
+                arrivals.push_back( { timestamp + latency( rng ), { s, number, timestamp } } );
+            }
+        }
+        std::stable_sort( arrivals.begin(), arrivals.end(),
+                          []( std::pair< double, replay_frame > const & a, std::pair< double, replay_frame > const & b ) {
+                              return a.first < b.first;
+                          } );
+
+        std::vector< replay_frame > frames;
+        for( auto & a : arrivals )
+            frames.push_back( a.second );
+        return frames;
+    }
+
+    // Frames of streams with shared frame numbers, some lost, some skipping ahead far enough for the syncer
+    // to drop what it holds, with neighbouring frames arriving out of order
+    std::vector< replay_frame > make_frame_number_replay( int streams, unsigned seed )
+    {
+        std::mt19937 rng( seed );
+        std::uniform_int_distribution< int > percent( 0, 99 );
+
+        std::vector< replay_frame > frames;
+        unsigned long long number = 1;
+        for( int i = 0; i < 300; i++, number++ )
+        {
+            if( percent( rng ) < 2 )
+                number += 8;
+            for( int s = 0; s < streams; s++ )
+                if( percent( rng ) >= 10 )
+                    frames.push_back( { s, number, 33.3 * number } );
+        }
+        for( size_t i = 1; i < frames.size(); i++ )
+            if( percent( rng ) < 15 )
+                std::swap( frames[i - 1], frames[i] );
+        return frames;
+    }
+
+    struct replay_result
+    {
+        std::vector< frameset_ids > framesets;
+        std::vector< rs2_sync_stats > stats;
+    };
+
+    // Feeds the frames to a syncer through a software device, one at a time, collecting what comes out
+    replay_result replay_through_syncer( std::vector< rs2_stream > const & types,
+                                         std::vector< int > const & indices,
+                                         std::vector< int > const & fps,
+                                         rs2_matchers matcher,
+                                         std::vector< replay_frame > const & frames )
+    {
+        const int W = 16, H = 8, BPP = 2;
+        rs2::software_device dev;
+        auto sensor = dev.add_sensor( "software_sensor" );
+        rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE, { 0, 0, 0, 0, 0 } };
+        for( size_t s = 0; s < types.size(); s++ )
+            sensor.add_video_stream( { types[s], indices[s], int( s ) + 1, W, H, fps[s], BPP, RS2_FORMAT_Z16, intrinsics } );
+        dev.create_matcher( matcher );
+
+        auto profiles = sensor.get_stream_profiles();
+        rs2::syncer sync( 100 );
+        sensor.open( profiles );
+        sensor.start( sync );
+
+        std::vector< uint8_t > pixels( W * H * BPP );
+        replay_result result;
+        for( auto & f : frames )
+        {
+            sensor.on_video_frame( { pixels.data(), []( void * ) {}, W * BPP, BPP, f.timestamp,
+                                     RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, int( f.number ), profiles[f.stream] } );
+            rs2::frameset fs;
+            while( sync.poll_for_frames( &fs ) )
+            {
+                frameset_ids set;
+                for( auto && frame : fs )
+                    set.emplace_back( frame.get_profile().unique_id() - 1, frame.get_frame_number() );
+                std::sort( set.begin(), set.end() );
+                result.framesets.push_back( set );
+            }
+        }
+        result.stats = sync.get_stats();
+
+        sensor.stop();
+        sensor.close();
+        return result;
+    }
+
+    // The counters of the stream matchers add up to the frames that went in and came out, and the frames of
+    // framesets the syncer dropped
+    void check_stats( replay_result const & result, size_t frames_in, size_t frames_dropped )
+    {
+        unsigned long long frames = 0, published = 0, dropped = 0;
+        for( auto & s : result.stats )
+        {
+            if( s.name[0] == '(' )
+                continue;   // a composite, whose frames are framesets
+            frames += s.frames;
+            published += s.published;
+            dropped += s.dropped;
+            CHECK( s.published + s.dropped <= s.frames );
+        }
+        size_t frames_out = 0;
+        for( auto & set : result.framesets )
+            frames_out += set.size();
+
+        CHECK( frames == frames_in );
+        CHECK( published == frames_out + frames_dropped );
+    }
+}
+
+TEST_CASE( "syncer matches timestamps the way the reference matcher does", "[syncer]" )
+{
+    std::vector< rs2_stream > types = { RS2_STREAM_DEPTH, RS2_STREAM_COLOR, RS2_STREAM_INFRARED };
+    std::vector< int > indices = { 0, 0, 1 };
+    std::vector< int > fps = { 30, 60, 15 };
+
+    for( unsigned seed = 1; seed <= 20; seed++ )
+    {
+        CAPTURE( seed );
+        auto frames = make_timestamp_replay( fps, seed );
+        reference_timestamp_matcher reference( fps );
+        auto expected = reference.replay( frames );
+
+        auto result = replay_through_syncer( types, indices, fps, RS2_MATCHER_DEFAULT, frames );
+        REQUIRE( result.framesets == expected );
+        check_stats( result, frames.size(), reference.dropped_frames() );
+    }
+}
+
+TEST_CASE( "syncer matches frame numbers the way the reference matcher does", "[syncer]" )
+{
+    std::vector< rs2_stream > types = { RS2_STREAM_DEPTH, RS2_STREAM_INFRARED, RS2_STREAM_INFRARED };
+    std::vector< int > indices = { 0, 1, 2 };
+    std::vector< int > fps = { 30, 30, 30 };
+
+    for( unsigned seed = 1; seed <= 20; seed++ )
+    {
+        CAPTURE( seed );
+        auto frames = make_frame_number_replay( int( types.size() ), seed );
+        reference_frame_number_matcher reference( fps );
+        auto expected = reference.replay( frames );
+
+        auto result = replay_through_syncer( types, indices, fps, RS2_MATCHER_DLR, frames );
+        REQUIRE( result.framesets == expected );
+        check_stats( result, frames.size(), reference.dropped_frames() );
+    }
+}
@@ -0,0 +1,252 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+//#cmake:add-file ../../src/frame-buffer-pool.h
+#include <src/frame-buffer-pool.h>
+
+#include <thread>
+
+using namespace librealsense;
+
+TEST_CASE( "frame_buffer_pool recycles buffers of the same size class" )
+{
+    frame_buffer_pool pool;
+    frame_buffer_pool::buffer_type buf;
+
+    REQUIRE_FALSE( pool.acquire( 640 * 480 * 2, buf ) );
+    REQUIRE( buf.size() == 640 * 480 * 2 );
+    auto ptr = buf.data();
+
+    pool.release( std::move( buf ), 0 );
+    auto stats = pool.get_stats();
+    REQUIRE( stats.bytes_held >= 640 * 480 * 2 );
+
+    // A slightly smaller request falls into the same size class and reuses the buffer
+    frame_buffer_pool::buffer_type other;
+    REQUIRE( pool.acquire( 640 * 480 * 2 - 100, other ) );
+    REQUIRE( other.size() == 640 * 480 * 2 - 100 );
+    REQUIRE( other.data() == ptr );
+
+    stats = pool.get_stats();
+    REQUIRE( stats.hits == 1 );
+    REQUIRE( stats.misses == 1 );
+    REQUIRE( stats.bytes_held == 0 );
+
+    // A different size class does not
+    frame_buffer_pool::buffer_type big;
+    pool.release( std::move( other ), 0 );
+    REQUIRE_FALSE( pool.acquire( 1280 * 720 * 2, big ) );
+}
+
+TEST_CASE( "frame_buffer_pool trims idle buffers" )
+{
+    frame_buffer_pool pool;
+    frame_buffer_pool::buffer_type buf;
+
+    pool.acquire( 1000, buf );
+    pool.release( std::move( buf ), 1000. );
+
+    pool.trim_if_due( 500. );  // not due yet
+    REQUIRE( pool.get_stats().trimmed == 0 );
+
+    pool.trim_if_due( 1500. );  // due, but the buffer is still fresh
+    REQUIRE( pool.get_stats().trimmed == 0 );
+
+    pool.trim_if_due( 2600. );
+    auto stats = pool.get_stats();
+    REQUIRE( stats.trimmed == 1 );
+    REQUIRE( stats.bytes_held == 0 );
+
+    pool.acquire( 1000, buf );
+    REQUIRE( pool.get_stats().misses == 2 );
+}
+
+TEST_CASE( "frame_buffer_pool drops buffers when full" )
+{
+    frame_buffer_pool pool;
+    std::vector< frame_buffer_pool::buffer_type > bufs( frame_buffer_pool::SLOTS_PER_BUCKET + 4 );
+    for( auto & b : bufs )
+        pool.acquire( 100, b );
+    for( auto & b : bufs )
+        pool.release( std::move( b ), 0 );
+
+    REQUIRE( pool.get_stats().bytes_held
+             == frame_buffer_pool::SLOTS_PER_BUCKET * frame_buffer_pool::SIZE_CLASS_GRANULARITY );
+
+    pool.clear();
+    REQUIRE( pool.get_stats().bytes_held == 0 );
+}
+
+TEST_CASE( "frame_buffer_pool concurrent acquire and release" )
+{
+    frame_buffer_pool pool;
+    const int iterations = 10000;
+    std::atomic< int > bad_sizes( 0 );
+
+    auto worker = [&]( size_t size ) {
+        for( int i = 0; i < iterations; ++i )
+        {
+            frame_buffer_pool::buffer_type buf;
+            pool.acquire( size, buf );
+            if( buf.size() != size )
+                ++bad_sizes;
+            buf[0] = 1;
+            pool.release( std::move( buf ), 0 );
+        }
+    };
+
+    std::vector< std::thread > threads;
+    for( size_t i = 0; i < 4; ++i )
+        threads.emplace_back( worker, 1000 + 5000 * ( i % 2 ) );
+    for( auto & t : threads )
+        t.join();
+
+    REQUIRE( bad_sizes == 0 );
+    auto stats = pool.get_stats();
+    REQUIRE( stats.hits + stats.misses == 4 * iterations );
+    REQUIRE( stats.hits > stats.misses );
+
+    pool.clear();
+    REQUIRE( pool.get_stats().bytes_held == 0 );
+}
+
+TEST_CASE( "frame_buffer_pool concurrent release and clear" )
+{
+    // More size classes than buckets, so that buckets are emptied and claimed by other classes
+    frame_buffer_pool pool;
+    const int iterations = 20000;
+    std::atomic< int > bad_buffers( 0 );
+    std::atomic< bool > done( false );
+
+    auto worker = [&]( size_t first_size ) {
+        for( int i = 0; i < iterations; ++i )
+        {
+            auto size = first_size + 5000 * ( i % 3 );
+            frame_buffer_pool::buffer_type buf;
+            if( pool.acquire( size, buf )
+                && frame_buffer_pool::get_size_class( buf.capacity() ) != frame_buffer_pool::get_size_class( size ) )
+                ++bad_buffers;
+            if( buf.size() != size )
+                ++bad_buffers;
+            buf[0] = 1;
+            pool.release( std::move( buf ), i );
+        }
+    };
+
+    std::vector< std::thread > threads;
+    for( size_t i = 0; i < 4; ++i )
+        threads.emplace_back( worker, 1000 + 15000 * ( i % 2 ) );
+    std::thread cleaner( [&]() {
+        for( int i = 0; ! done; ++i )
+        {
+            if( i % 2 )
+                pool.clear();
+            else
+                pool.trim( i );
+        }
+    } );
+    for( auto & t : threads )
+        t.join();
+    done = true;
+    cleaner.join();
+
+    REQUIRE( bad_buffers == 0 );
+    pool.clear();
+    REQUIRE( pool.get_stats().bytes_held == 0 );
+
+    // Every bucket went back to the unused state, so as many new size classes fit again
+    for( size_t i = 0; i < frame_buffer_pool::MAX_BUCKETS; ++i )
+    {
+        frame_buffer_pool::buffer_type buf;
+        pool.acquire( 100000 + 10000 * i, buf );
+        pool.release( std::move( buf ), 0 );
+    }
+    for( size_t i = 0; i < frame_buffer_pool::MAX_BUCKETS; ++i )
+    {
+        frame_buffer_pool::buffer_type buf;
+        REQUIRE( pool.acquire( 100000 + 10000 * i, buf ) );
+    }
+}
+
+TEST_CASE( "frame_buffer_pool keeps no buffer returned while closing" )
+{
+    for( int n = 0; n < 50; ++n )
+    {
+        frame_buffer_pool pool;
+        std::atomic< int > released( 0 );
+        std::vector< std::thread > threads;
+        for( size_t i = 0; i < 4; ++i )
+        {
+            threads.emplace_back( [&]() {
+                for( int j = 0; j < 200; ++j )
+                {
+                    frame_buffer_pool::buffer_type buf;
+                    pool.acquire( 1000, buf );
+                    pool.release( std::move( buf ), 0 );
+                    ++released;
+                }
+            } );
+        }
+        while( released < 100 )
+            std::this_thread::yield();
+        pool.close();
+        for( auto & t : threads )
+            t.join();
+
+        REQUIRE( pool.get_stats().bytes_held == 0 );
+    }
+}
+
+namespace {
+    struct counting_allocator : public rs2_frame_buffer_allocator
+    {
+        std::atomic< long long > & outstanding;
+        explicit counting_allocator( std::atomic< long long > & counter ) : outstanding( counter ) {}
+
+        void * allocate( unsigned int size ) override
+        {
+            outstanding += size;
+            return ::operator new( size );
+        }
+        void deallocate( void * buffer, unsigned int size ) override
+        {
+            outstanding -= size;
+            ::operator delete( buffer );
+        }
+        void release() override { delete this; }
+    };
+}
+
+TEST_CASE( "frame_buffer_pool buffers use the user-supplied allocator" )
+{
+    std::atomic< long long > outstanding( 0 );
+    {
+        frame_buffer_allocator_ptr allocator( new counting_allocator( outstanding ),
+                                              []( rs2_frame_buffer_allocator * p ) { p->release(); } );
+        frame_buffer_pool pool;
+
+        frame_buffer buf( ( frame_data_allocator< byte >( allocator ) ) );
+        pool.acquire( 10000, buf );
+        REQUIRE( outstanding == static_cast< long long >( frame_buffer_pool::get_size_class( 10000 ) ) );
+
+        // The allocator travels with the buffer through the pool
+        pool.release( std::move( buf ), 0 );
+        frame_buffer other;
+        REQUIRE( pool.acquire( 10000, other ) );
+        REQUIRE( other.get_allocator().get_impl() == allocator );
+
+        other = frame_buffer();
+        REQUIRE( outstanding == 0 );
+    }
+    REQUIRE( outstanding == 0 );
+}
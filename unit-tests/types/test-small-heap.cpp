@@ -0,0 +1,183 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake:static!
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <src/types.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace librealsense;
+
+namespace
+{
+    struct item
+    {
+        int owner = -1;
+        std::vector< int > payload;
+    };
+}
+
+TEST_CASE( "small_heap hands out each item once", "[small_heap]" )
+{
+    // Not a multiple of the 64 items of a bitmap word
+    small_heap< item, 100 > heap;
+    std::set< item * > allocated;
+    for( int i = 0; i < 100; i++ )
+    {
+        auto p = heap.allocate();
+        REQUIRE( p );
+        REQUIRE( allocated.insert( p ).second );
+    }
+    REQUIRE( heap.get_size() == 100 );
+    REQUIRE_FALSE( heap.allocate() );
+    REQUIRE( heap.get_exhausted_count() == 1 );
+    REQUIRE( heap.get_size() == 100 );
+
+    item outsider;
+    REQUIRE_THROWS( heap.deallocate( &outsider ) );
+
+    // A returned item is reset, and is handed out again
+    auto p = *allocated.begin();
+    p->payload.assign( 10, 1 );
+    heap.deallocate( p );
+    REQUIRE( heap.get_size() == 99 );
+    REQUIRE( heap.allocate() == p );
+    REQUIRE( p->payload.empty() );
+
+    for( auto q : allocated )
+        heap.deallocate( q );
+    REQUIRE( heap.is_empty() );
+    heap.wait_until_empty();
+}
+
+TEST_CASE( "small_heap under contention", "[small_heap]" )
+{
+    // More threads than items, so that allocations race for the last free slots and find none
+    const int threads_count = 8;
+    const int iterations = 20000;
+    small_heap< item, 6 > heap;
+    std::atomic< int > collisions( 0 ), allocations( 0 );
+
+    std::vector< std::thread > threads;
+    for( int t = 0; t < threads_count; t++ )
+    {
+        threads.emplace_back( [&, t]()
+        {
+            for( int i = 0; i < iterations; i++ )
+            {
+                auto p = heap.allocate();
+                if( ! p )
+                    continue;
+                allocations++;
+                // No other thread may hold the item
+                if( p->owner != -1 )
+                    collisions++;
+                p->owner = t;
+                p->payload.assign( 4, t );
+                std::this_thread::yield();
+                if( p->owner != t || p->payload != std::vector< int >( 4, t ) )
+                    collisions++;
+                p->owner = -1;
+                heap.deallocate( p );
+            }
+        } );
+    }
+    for( auto & thread : threads )
+        thread.join();
+
+    REQUIRE( collisions == 0 );
+    REQUIRE( allocations > 0 );
+    REQUIRE( heap.is_empty() );
+    CHECK( allocations + int( heap.get_exhausted_count() ) == threads_count * iterations );
+    heap.wait_until_empty();
+}
+
+TEST_CASE( "small_heap wait_until_empty waits for the items in use", "[small_heap]" )
+{
+    small_heap< item, 4 > heap;
+    auto a = heap.allocate();
+    auto b = heap.allocate();
+    REQUIRE( a );
+    REQUIRE( b );
+
+    heap.stop_allocation();
+    REQUIRE_FALSE( heap.allocate() );
+    REQUIRE( heap.get_size() == 2 );
+
+    std::atomic< bool > returned( false );
+    std::thread waiter( [&]()
+    {
+        heap.wait_until_empty();
+        returned = true;
+    } );
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+    CHECK_FALSE( returned );
+    heap.deallocate( a );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+    CHECK_FALSE( returned );
+    heap.deallocate( b );
+    waiter.join();
+    REQUIRE( returned );
+    REQUIRE( heap.is_empty() );
+    REQUIRE_FALSE( heap.allocate() );
+}
+
+TEST_CASE( "small_heap stop while allocating", "[small_heap]" )
+{
+    // Once wait_until_empty returns, no item is in use, and none is handed out any more
+    const int threads_count = 4;
+    small_heap< item, 8 > heap;
+    std::atomic< bool > emptied( false ), done( false );
+    std::atomic< int > held( 0 ), late_allocations( 0 ), allocations( 0 );
+
+    std::vector< std::thread > threads;
+    for( int t = 0; t < threads_count; t++ )
+    {
+        threads.emplace_back( [&]()
+        {
+            while( ! done )
+            {
+                auto p = heap.allocate();
+                if( ! p )
+                    continue;
+                if( emptied )
+                    late_allocations++;
+                allocations++;
+                held++;
+                std::this_thread::yield();
+                held--;
+                heap.deallocate( p );
+            }
+        } );
+    }
+
+    while( allocations < 1000 )
+        std::this_thread::yield();
+    heap.stop_allocation();
+    heap.wait_until_empty();
+    REQUIRE( held == 0 );
+    emptied = true;
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    done = true;
+    for( auto & thread : threads )
+        thread.join();
+
+    REQUIRE( late_allocations == 0 );
+    REQUIRE( heap.is_empty() );
+}
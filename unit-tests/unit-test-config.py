@@ -75,7 +75,7 @@ if not os.path.isdir( dir ) or not os.path.isdir( builddir ):
 root = repo.root.replace( '\\' , '/' )
 src = root + '/src'
 
-def generate_cmake( builddir, testdir, testname, filelist, custom_main ):
+def generate_cmake( builddir, testdir, testname, filelist, custom_main, dependencies ):
     makefile = builddir + '/' + testdir + '/CMakeLists.txt'
     log.d( '   creating:', makefile )
     handle = open( makefile, 'w' )
@@ -95,7 +95,7 @@ source_group( "Common Files" FILES ${ELPP_FILES} ${CATCH_FILES}''' )
         handle.write( ' ' + dir + '/unit-test-default-main.cpp' )
     handle.write( ''' )
 set_property(TARGET ''' + testname + ''' PROPERTY CXX_STANDARD 11)
-target_link_libraries( ''' + testname + ''' ${DEPENDENCIES})
+target_link_libraries( ''' + testname + ''' ${DEPENDENCIES} ''' + ' '.join( dependencies ) + ''')
 
 set_target_properties( ''' + testname + ''' PROPERTIES FOLDER "Unit-Tests/''' + os.path.dirname( testdir ) + '''" )
 
@@ -209,6 +209,7 @@ def process_cpp( dir, builddir ):
             shared = False
             static = False
             custom_main = False
+            dependencies = []
             for cmake_directive in file.grep( '^//#cmake:\s*', dir + '/' + f ):
                 m = cmake_directive['match']
                 index = cmake_directive['index']
@@ -249,8 +250,14 @@ def process_cpp( dir, builddir ):
                         shared = True
                 elif cmd == 'custom-main':
                     custom_main = True
+                elif cmd == 'dependencies':
+                    # Libraries the test links with; the test is not built when they are not
+                    if not len(rest):
+                        log.e( f + '+' + str(index) + ': expected targets past \'' + cmd + '\'' )
+                    log.d( 'dependencies:', rest )
+                    dependencies.extend( rest )
                 else:
-                    log.e( f + '+' + str(index) + ': unknown cmd \'' + cmd + '\' (should be \'add-file\', \'static!\', or \'shared!\')' )
+                    log.e( f + '+' + str(index) + ': unknown cmd \'' + cmd + '\' (should be \'add-file\', \'static!\', \'shared!\', or \'dependencies\')' )
             for include in includes:
                 filelist.append( include )
 
@@ -264,7 +271,8 @@ def process_cpp( dir, builddir ):
 
             # Each CMakeLists.txt sits in its own directory
             os.makedirs( builddir + '/' + testdir, exist_ok=True )  # "build/log/internal/test-all"
-            generate_cmake( builddir, testdir, testname, filelist, custom_main )
+            generate_cmake( builddir, testdir, testname, filelist, custom_main, dependencies )
+            test_dependencies[testdir] = dependencies
             if static:
                 statics.append( testdir )
             elif shared:
@@ -279,6 +287,7 @@ def process_py( dir, builddir ):
     return [],[],[]
 
 list_only = list_tags or list_tests
+test_dependencies = dict()
 available_tags = set()
 tests_and_tags = dict()
 normal_tests = []
@@ -327,9 +336,21 @@ set( CATCH_FILES
 
 ''' )
 
+def add_subdirectory( handle, testdir, indent ):
+    """
+    Add the test's directory to the build -- when the test has dependencies, only if they are all built
+    """
+    dependencies = test_dependencies.get( testdir )
+    if dependencies:
+        handle.write( indent + 'if(' + ' AND '.join( 'TARGET ' + d for d in dependencies ) + ')\n' )
+        handle.write( indent + '    add_subdirectory( ' + testdir + ' )\n' )
+        handle.write( indent + 'endif()\n' )
+    else:
+        handle.write( indent + 'add_subdirectory( ' + testdir + ' )\n' )
+
 n_tests = 0
 for sdir in normal_tests:
-    handle.write( 'add_subdirectory( ' + sdir + ' )\n' )
+    add_subdirectory( handle, sdir, '' )
     log.d( '... including:', sdir )
     n_tests += 1
 if len(shared_tests):
@@ -337,7 +358,7 @@ if len(shared_tests):
     handle.write( '    message( INFO "' + str(len(shared_tests)) + ' shared lib unit-tests will be skipped. Check BUILD_SHARED_LIBS to run them..." )\n' )
     handle.write( 'else()\n' )
     for test in shared_tests:
-        handle.write( '    add_subdirectory( ' + test + ' )\n' )
+        add_subdirectory( handle, test, '    ' )
         log.d( '... including:', sdir )
         n_tests += 1
     handle.write( 'endif()\n' )
@@ -346,7 +367,7 @@ if len(static_tests):
     handle.write( '    message( INFO "' + str(len(static_tests)) + ' static lib unit-tests will be skipped. Uncheck BUILD_SHARED_LIBS to run them..." )\n' )
     handle.write( 'else()\n' )
     for test in static_tests:
-        handle.write( '    add_subdirectory( ' + test + ' )\n' )
+        add_subdirectory( handle, test, '    ' )
         log.d( '... including:', sdir )
         n_tests += 1
     handle.write( 'endif()\n' )
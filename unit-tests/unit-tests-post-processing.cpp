@@ -13,6 +13,12 @@
 #include <chrono>
 #include <ctime>
 #include <algorithm>
+#include <numeric>
+#include <array>
+#include <cstdio>
+#include <sstream>
+#include <cstring>
+#include <type_traits>
 
 
 # define SECTION_FROM_TEST_NAME space_to_underscore(Catch::getCurrentContext().getResultCapture()->getCurrentTestName()).c_str()
@@ -566,6 +572,553 @@ TEST_CASE("Post-Processing processing pipe", "[post-processing-filters]")
     pipe.stop();
 }
 
+TEST_CASE("Post-Processing fused chain", "[software-device][post-processing-filters]")
+{
+    const int width = 128, height = 96, depth_bpp = 2;
+    rs2_intrinsics depth_intrinsics = { width, height, width / 2.f, height / 2.f, 100.f, 100.f,
+        RS2_DISTORTION_BROWN_CONRADY, { 0,0,0,0,0 } };
+
+    rs2::software_device dev;
+    auto depth_sensor = dev.add_sensor("Depth");
+    auto depth_stream_profile = depth_sensor.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, width, height, 30, depth_bpp, RS2_FORMAT_Z16, depth_intrinsics });
+    depth_sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+    depth_sensor.add_read_only_option(RS2_OPTION_STEREO_BASELINE, 50.f);
+
+    rs2::frame_queue q(10);
+    depth_sensor.open(depth_stream_profile);
+    depth_sensor.start(q);
+
+    // The same chain of filters, once chained through apply_filter and once fused into a single block
+    rs2::disparity_transform to_disp, fused_to_disp;
+    rs2::spatial_filter spatial, fused_spatial;
+    rs2::temporal_filter temporal, fused_temporal;
+    rs2::disparity_transform from_disp(false), fused_from_disp(false);
+    rs2::hole_filling_filter hole_filling, fused_hole_filling;
+    rs2::fused_filter fused({ fused_to_disp, fused_spatial, fused_temporal, fused_from_disp, fused_hole_filling });
+
+    std::vector<uint16_t> pixels(width * height);
+    for (int i = 0; i < 5; i++)
+    {
+        for (size_t p = 0; p < pixels.size(); p++)
+            pixels[p] = (p % 17 == size_t(i)) ? 0 : uint16_t(1000 + (p * 7 + i * 13) % 200);
+
+        depth_sensor.on_video_frame({ pixels.data(), [](void*) {}, width * depth_bpp, depth_bpp,
+            (rs2_time_t)i, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, i, depth_stream_profile });
+
+        rs2::frame depth = q.wait_for_frame();
+        REQUIRE(depth);
+
+        rs2::video_frame chained = depth.apply_filter(to_disp).apply_filter(spatial).apply_filter(temporal)
+            .apply_filter(from_disp).apply_filter(hole_filling);
+        rs2::video_frame processed = depth.apply_filter(fused);
+
+        REQUIRE(processed.get_profile().format() == RS2_FORMAT_Z16);
+        REQUIRE(processed.get_width() == chained.get_width());
+        REQUIRE(processed.get_height() == chained.get_height());
+        REQUIRE(memcmp(processed.get_data(), chained.get_data(), chained.get_stride_in_bytes() * chained.get_height()) == 0);
+
+        // The input frame is never modified
+        REQUIRE(memcmp(depth.get_data(), pixels.data(), pixels.size() * sizeof(uint16_t)) == 0);
+    }
+}
+
+// Holes are identified by their bit pattern, for disparity too
+template<class T>
+static bool is_hole(T v)
+{
+    typename std::conditional<sizeof(T) == 4, int32_t, int16_t>::type bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return !bits;
+}
+
+// The scalar hole filling of the filter, in place and one pixel at a time
+template<class T>
+static void fill_holes_reference(std::vector<T>& image, size_t width, size_t height, int mode)
+{
+    if (mode == 0)
+    {
+        for (size_t j = 0; j < height; ++j)
+            for (size_t i = 1; i < width; ++i)
+                if (is_hole(image[j * width + i]))
+                    image[j * width + i] = image[j * width + i - 1];
+        return;
+    }
+
+    for (size_t j = 1; j + 1 < height; ++j)
+    {
+        for (size_t i = 1; i < width; ++i)
+        {
+            T* p = &image[j * width + i];
+            if (!is_hole(*p))
+                continue;
+
+            T tmp = *(p - width);
+            for (auto q : { p - width - 1, p - 1, p + width - 1, p + width })
+            {
+                if (mode == 1 ? (*q > tmp) : (!is_hole(*q) && *q < tmp))
+                    tmp = *q;
+            }
+            *p = tmp;
+        }
+    }
+}
+
+template<class T>
+static void check_hole_filling(rs2::video_frame input, int mode)
+{
+    CAPTURE(mode);
+    const size_t width = input.get_width(), height = input.get_height();
+    auto data = reinterpret_cast<const T*>(input.get_data());
+    std::vector<T> expected(data, data + width * height);
+    fill_holes_reference(expected, width, height, mode);
+
+    // Out of place, into a frame of its own, and in place, on a clone of the input the fused block owns
+    rs2::hole_filling_filter hole_filling(mode), fused_hole_filling(mode);
+    rs2::fused_filter fused({ fused_hole_filling });
+    for (rs2::video_frame filled : { input.apply_filter(hole_filling), input.apply_filter(fused) })
+    {
+        REQUIRE(filled.get_data() != input.get_data());
+        REQUIRE(filled.get_stride_in_bytes() == int(width * sizeof(T)));
+        REQUIRE(memcmp(filled.get_data(), expected.data(), expected.size() * sizeof(T)) == 0);
+    }
+    REQUIRE(memcmp(input.get_data(), data, width * height * sizeof(T)) == 0);
+}
+
+TEST_CASE("Post-Processing hole filling modes", "[software-device][post-processing-filters]")
+{
+    // Not a multiple of any vector width, and more rows than the filter hands to a single task
+    const int width = 211, height = 47, depth_bpp = 2;
+    rs2_intrinsics depth_intrinsics = { width, height, width / 2.f, height / 2.f, 100.f, 100.f,
+        RS2_DISTORTION_BROWN_CONRADY, { 0,0,0,0,0 } };
+
+    rs2::software_device dev;
+    auto depth_sensor = dev.add_sensor("Depth");
+    auto depth_stream_profile = depth_sensor.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, width, height, 30, depth_bpp, RS2_FORMAT_Z16, depth_intrinsics });
+    depth_sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+    depth_sensor.add_read_only_option(RS2_OPTION_STEREO_BASELINE, 50.f);
+
+    rs2::frame_queue q(10);
+    depth_sensor.open(depth_stream_profile);
+    depth_sensor.start(q);
+
+    // Scattered holes, holes along the image edges, runs of holes across the end of a row and the start
+    // of the next, a row of holes only, and values at the top of the range
+    std::vector<uint16_t> pixels(width * height);
+    for (int v = 0; v < height; v++)
+    {
+        for (int u = 0; u < width; u++)
+        {
+            size_t i = v * width + u;
+            bool hole = (i * 7919) % 13 < 3 || u == 0 || u == width - 1 || v == 0 || v == height - 1
+                || v == 20 || (v % 5 == 2 && (u < 9 || u > width - 9));
+            pixels[i] = hole ? 0 : uint16_t(u > 150 ? 65535 - (i * 31) % 9 : 800 + (i * 2654435761u) % 1500);
+        }
+    }
+    pixels[width + 1] = 1200;    // a valid pixel between holes, just past the corner
+
+    depth_sensor.on_video_frame({ pixels.data(), [](void*) {}, width * depth_bpp, depth_bpp,
+        0., RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, 0, depth_stream_profile });
+    rs2::video_frame depth = q.wait_for_frame();
+    REQUIRE(depth);
+    rs2::disparity_transform to_disp;
+    rs2::video_frame disparity = depth.apply_filter(to_disp);
+    REQUIRE(disparity.get_profile().format() == RS2_FORMAT_DISPARITY32);
+
+    for (int mode = 0; mode < 3; mode++)
+    {
+        check_hole_filling<uint16_t>(depth, mode);
+        check_hole_filling<float>(disparity, mode);
+    }
+}
+
+TEST_CASE("Post-Processing decimation median and mean", "[software-device][post-processing-filters]")
+{
+    // Not a multiple of any vector width or of the scales, so the output has scalar-only pixels and padding
+    const int width = 211, height = 47, depth_bpp = 2;
+    rs2_intrinsics depth_intrinsics = { width, height, width / 2.f, height / 2.f, 100.f, 100.f,
+        RS2_DISTORTION_BROWN_CONRADY, { 0,0,0,0,0 } };
+
+    rs2::software_device dev;
+    auto depth_sensor = dev.add_sensor("Depth");
+    auto depth_stream_profile = depth_sensor.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, width, height, 30, depth_bpp, RS2_FORMAT_Z16, depth_intrinsics });
+    depth_sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2::frame_queue q(10);
+    depth_sensor.open(depth_stream_profile);
+    depth_sensor.start(q);
+
+    // Holes of every size within a block, repeated values and values at both ends of the range
+    std::vector<uint16_t> pixels(width * height);
+    for (size_t p = 0; p < pixels.size(); p++)
+    {
+        uint32_t hash = uint32_t(p * 2654435761u);
+        if (hash % 5 == 0 || (p / width) % 7 == (p % width) % 5)
+            pixels[p] = 0;
+        else if (hash % 11 == 0)
+            pixels[p] = 65535;
+        else
+            pixels[p] = uint16_t(1000 + (hash >> 8) % ((p / width) % 2 ? 4 : 300));
+    }
+
+    depth_sensor.on_video_frame({ pixels.data(), [](void*) {}, width * depth_bpp, depth_bpp,
+        0, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, 0, depth_stream_profile });
+    rs2::frame depth = q.wait_for_frame();
+    REQUIRE(depth);
+
+    for (int scale = 2; scale <= 5; scale++)
+    {
+        CAPTURE(scale);
+        rs2::decimation_filter decimation;
+        decimation.set_option(RS2_OPTION_FILTER_MAGNITUDE, float(scale));
+        rs2::video_frame decimated = depth.apply_filter(decimation);
+
+        // The output is padded to a multiple of 4 with zeros
+        int real_width = width / scale, real_height = height / scale;
+        REQUIRE(decimated.get_width() == (real_width + 3) / 4 * 4);
+        REQUIRE(decimated.get_height() == (real_height + 3) / 4 * 4);
+
+        auto out = static_cast<const uint16_t*>(decimated.get_data());
+        int mismatches = 0;
+        for (int y = 0; y < decimated.get_height(); y++)
+        {
+            for (int x = 0; x < decimated.get_width(); x++)
+            {
+                uint16_t expected = 0;
+                if (x < real_width && y < real_height)
+                {
+                    std::vector<uint16_t> valid;
+                    for (int n = 0; n < scale; n++)
+                        for (int m = 0; m < scale; m++)
+                            if (auto v = pixels[(y * scale + n) * width + x * scale + m])
+                                valid.push_back(v);
+
+                    // 2x2 and 3x3 blocks take the median of the valid pixels, the member one below the middle
+                    // for even counts; larger blocks take their mean
+                    if (valid.empty())
+                        expected = 0;
+                    else if (scale <= 3)
+                    {
+                        std::sort(valid.begin(), valid.end());
+                        expected = valid[(valid.size() - 1) / 2];
+                    }
+                    else
+                        expected = uint16_t(std::accumulate(valid.begin(), valid.end(), 0) / int(valid.size()));
+                }
+                if (out[y * decimated.get_width() + x] != expected)
+                    mismatches++;
+            }
+        }
+        REQUIRE(mismatches == 0);
+    }
+}
+
+TEST_CASE("Post-Processing sparse pointcloud", "[software-device][post-processing-filters]")
+{
+    // Not a multiple of the rows the pointcloud packs at a time, so the last tile is partial
+    const int width = 64, height = 45;
+    rs2_intrinsics depth_intrinsics = { width, height, 31.5f, 22.5f, 50.f, 50.f, RS2_DISTORTION_NONE, { 0,0,0,0,0 } };
+    rs2_intrinsics color_intrinsics = { width, height, 32.f, 22.f, 55.f, 55.f, RS2_DISTORTION_NONE, { 0,0,0,0,0 } };
+
+    rs2::software_device dev;
+    auto depth_sensor = dev.add_sensor("Depth");
+    auto depth_stream_profile = depth_sensor.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, width, height, 30, 2, RS2_FORMAT_Z16, depth_intrinsics });
+    depth_sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+    auto color_sensor = dev.add_sensor("Color");
+    auto color_stream_profile = color_sensor.add_video_stream({ RS2_STREAM_COLOR, 0, 1, width, height, 30, 3, RS2_FORMAT_RGB8, color_intrinsics });
+    depth_stream_profile.register_extrinsics_to(color_stream_profile, { { 1,0,0,0,1,0,0,0,1 },{ 0.015f,0,0 } });
+
+    rs2::frame_queue depth_queue(10), color_queue(10);
+    depth_sensor.open(depth_stream_profile);
+    depth_sensor.start(depth_queue);
+    color_sensor.open(color_stream_profile);
+    color_sensor.start(color_queue);
+
+    // Depth with scattered holes, a hole across a whole row, and an empty last tile of rows
+    std::vector<uint16_t> depth_pixels(width * height);
+    for (int i = 0; i < width * height; i++)
+    {
+        auto y = i / width;
+        bool hole = i % 5 == 0 || y == 10 || y >= 40;
+        depth_pixels[i] = hole ? 0 : uint16_t(500 + (i * 37) % 1500);
+    }
+    std::vector<uint8_t> color_pixels(width * height * 3, 128);
+
+    depth_sensor.on_video_frame({ depth_pixels.data(), [](void*) {}, width * 2, 2,
+        0, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, 0, depth_stream_profile });
+    color_sensor.on_video_frame({ color_pixels.data(), [](void*) {}, width * 3, 3,
+        0, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, 0, color_stream_profile });
+    rs2::frame depth = depth_queue.wait_for_frame();
+    rs2::frame color = color_queue.wait_for_frame();
+    REQUIRE(depth);
+    REQUIRE(color);
+
+    auto valid = size_t(std::count_if(depth_pixels.begin(), depth_pixels.end(), [](uint16_t d) { return d != 0; }));
+
+    // Occlusion removal would invalidate points with depth, so it is off, and the valid points are those with depth
+    rs2::pointcloud dense;
+    dense.set_option(RS2_OPTION_FILTER_MAGNITUDE, 1.f);
+    dense.map_to(color);
+    rs2::points dense_points = dense.calculate(depth);
+    REQUIRE(dense_points.size() == size_t(width * height));
+    REQUIRE_FALSE(dense_points.get_pixel_indices());
+
+    for (int mode = 1; mode <= 2; mode++)
+    {
+        CAPTURE(mode);
+        rs2::pointcloud sparse;
+        sparse.set_option(RS2_OPTION_FILTER_MAGNITUDE, 1.f);
+        sparse.set_option(RS2_OPTION_SPARSE_POINTCLOUD, float(mode));
+        sparse.map_to(color);
+        rs2::points sparse_points = sparse.calculate(depth);
+        REQUIRE(sparse_points.size() == valid);
+
+        // Without indices, the valid points keep their order, so they are found by walking the dense output
+        auto indices = sparse_points.get_pixel_indices();
+        if (mode == 1)
+            REQUIRE_FALSE(indices);
+        else
+            REQUIRE(indices);
+
+        auto vertices = sparse_points.get_vertices();
+        auto texcoords = sparse_points.get_texture_coordinates();
+        int pixel = -1;
+        for (size_t k = 0; k < sparse_points.size(); k++)
+        {
+            pixel++;
+            while (pixel < width * height && !depth_pixels[pixel])
+                pixel++;
+            REQUIRE(pixel < width * height);
+            if (indices)
+                REQUIRE(indices[k] == pixel);
+
+            REQUIRE(memcmp(&vertices[k], &dense_points.get_vertices()[pixel], sizeof(rs2::vertex)) == 0);
+            REQUIRE(memcmp(&texcoords[k], &dense_points.get_texture_coordinates()[pixel], sizeof(rs2::texture_coordinate)) == 0);
+        }
+    }
+}
+
+// The cloud a PLY/PCD export should hold, computed the way export_to_ply did before it was parallelized:
+// the valid vertices in order with the texel color of each, and two faces for each 2x2 block of valid
+// pixels with similar depth, going down each column in turn
+struct exported_cloud
+{
+    std::vector<rs2::vertex> vertices;
+    std::vector<std::array<uint8_t, 3>> colors;
+    std::vector<std::array<int, 3>> faces;
+
+    exported_cloud(const rs2::points& points, const rs2::video_frame& texture, int width, int height)
+    {
+        auto v = points.get_vertices();
+        auto tc = points.get_texture_coordinates();
+        auto tex = static_cast<const uint8_t*>(texture.get_data());
+        std::vector<int> index(width * height, -1);
+        for (int i = 0; i < width * height; i++)
+        {
+            if (!v[i].x && !v[i].y && !v[i].z)
+                continue;
+            index[i] = int(vertices.size());
+            vertices.push_back(v[i]);
+            int x = std::min(std::max(int(tc[i].u * texture.get_width() + .5f), 0), texture.get_width() - 1);
+            int y = std::min(std::max(int(tc[i].v * texture.get_height() + .5f), 0), texture.get_height() - 1);
+            auto texel = tex + y * texture.get_stride_in_bytes() + x * texture.get_bytes_per_pixel();
+            colors.push_back({ texel[0], texel[1], texel[2] });
+        }
+        for (int x = 0; x < width - 1; x++)
+        {
+            for (int y = 0; y < height - 1; y++)
+            {
+                int a = index[y * width + x], b = index[y * width + x + 1], c = index[(y + 1) * width + x], d = index[(y + 1) * width + x + 1];
+                if (a < 0 || b < 0 || c < 0 || d < 0)
+                    continue;
+                auto za = vertices[a].z, zb = vertices[b].z, zc = vertices[c].z, zd = vertices[d].z;
+                if (za && zb && zc && zd && std::fabs(za - zb) < 0.05f && std::fabs(za - zc) < 0.05f
+                    && std::fabs(zb - zd) < 0.05f && std::fabs(zc - zd) < 0.05f)
+                {
+                    faces.push_back({ a, d, b });
+                    faces.push_back({ d, a, c });
+                }
+            }
+        }
+    }
+
+    std::string ply_header(bool binary) const
+    {
+        std::ostringstream out;
+        out << "ply\nformat " << (binary ? "binary_little_endian" : "ascii") << " 1.0\n"
+            << "comment pointcloud saved from Realsense Viewer\n"
+            << "element vertex " << vertices.size() << "\n"
+            << "property float32 x\nproperty float32 y\nproperty float32 z\n"
+            << "property uchar red\nproperty uchar green\nproperty uchar blue\n"
+            << "element face " << faces.size() << "\n"
+            << "property list uchar int vertex_indices\nend_header\n";
+        return out.str();
+    }
+
+    // PLY files are flipped to the y-up, z-towards-the-viewer convention
+    std::string binary_ply() const
+    {
+        auto out = ply_header(true);
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            float p[] = { vertices[i].x, -1 * vertices[i].y, -1 * vertices[i].z };
+            out.append(reinterpret_cast<const char*>(p), sizeof(p));
+            out.append(reinterpret_cast<const char*>(colors[i].data()), 3);
+        }
+        for (auto& f : faces)
+        {
+            out.push_back(3);
+            out.append(reinterpret_cast<const char*>(f.data()), sizeof(int) * 3);
+        }
+        return out;
+    }
+};
+
+static std::string read_file(const std::string& fname)
+{
+    std::ifstream in(fname, std::ios::binary);
+    std::ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+// Text files hold floats with 6 significant digits
+static bool text_float_matches(float text, float expected)
+{
+    return std::fabs(text - expected) <= 1e-5f * std::fabs(expected) + 1e-7f;
+}
+
+TEST_CASE("Post-Processing points export", "[software-device][post-processing-filters]")
+{
+    const int width = 8, height = 6;
+    rs2_intrinsics depth_intrinsics = { width, height, 3.5f, 2.5f, 6.f, 6.f, RS2_DISTORTION_NONE, { 0,0,0,0,0 } };
+
+    rs2::software_device dev;
+    auto depth_sensor = dev.add_sensor("Depth");
+    auto depth_stream_profile = depth_sensor.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, width, height, 30, 2, RS2_FORMAT_Z16, depth_intrinsics });
+    depth_sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+    auto color_sensor = dev.add_sensor("Color");
+    auto color_stream_profile = color_sensor.add_video_stream({ RS2_STREAM_COLOR, 0, 1, width, height, 30, 3, RS2_FORMAT_RGB8, depth_intrinsics });
+    depth_stream_profile.register_extrinsics_to(color_stream_profile, { { 1,0,0,0,1,0,0,0,1 },{ 0,0,0 } });
+
+    rs2::frame_queue depth_queue(10), color_queue(10);
+    depth_sensor.open(depth_stream_profile);
+    depth_sensor.start(depth_queue);
+    color_sensor.open(color_stream_profile);
+    color_sensor.start(color_queue);
+
+    // A few holes, and a step in depth on the right that no face may cross
+    std::vector<uint16_t> depth_pixels(width * height);
+    std::vector<uint8_t> color_pixels(width * height * 3);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            auto i = y * width + x;
+            depth_pixels[i] = (i % 11 == 3) ? 0 : uint16_t((x < 5 ? 1000 : 1200) + 3 * x + 2 * y);
+            color_pixels[i * 3 + 0] = uint8_t(30 * x);
+            color_pixels[i * 3 + 1] = uint8_t(40 * y);
+            color_pixels[i * 3 + 2] = uint8_t(200 + i);
+        }
+    }
+
+    depth_sensor.on_video_frame({ depth_pixels.data(), [](void*) {}, width * 2, 2,
+        0, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, 0, depth_stream_profile });
+    color_sensor.on_video_frame({ color_pixels.data(), [](void*) {}, width * 3, 3,
+        0, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, 0, color_stream_profile });
+    rs2::frame depth = depth_queue.wait_for_frame();
+    rs2::video_frame color = color_queue.wait_for_frame();
+    REQUIRE(depth);
+    REQUIRE(color);
+
+    rs2::pointcloud pc;
+    pc.set_option(RS2_OPTION_FILTER_MAGNITUDE, 1.f);
+    pc.map_to(color);
+    rs2::points points = pc.calculate(depth);
+
+    exported_cloud expected(points, color, width, height);
+    REQUIRE(expected.vertices.size() == size_t(std::count_if(depth_pixels.begin(), depth_pixels.end(), [](uint16_t d) { return d != 0; })));
+    REQUIRE(expected.faces.size() > 0);
+
+    // The exported files go to the temp folder, and are removed however the section ends
+    struct temp_file
+    {
+        std::string path;
+        explicit temp_file(const std::string& name) : path(get_folder_path(special_folder::temp_folder) + name) {}
+        ~temp_file() { std::remove(path.c_str()); }
+    };
+    temp_file ply("points-export-test.ply"), pcd("points-export-test.pcd");
+
+    SECTION("binary PLY is unchanged")
+    {
+        points.export_to_ply(ply.path, color);
+        CHECK(read_file(ply.path) == expected.binary_ply());
+
+        points.export_to_file(ply.path, color, true);
+        CHECK(read_file(ply.path) == expected.binary_ply());
+    }
+
+    SECTION("text PLY")
+    {
+        points.export_to_file(ply.path, color, false);
+        std::istringstream in(read_file(ply.path));
+        auto header = expected.ply_header(false);
+        std::string text_header(header.size(), 0);
+        in.read(&text_header[0], header.size());
+        REQUIRE(text_header == header);
+
+        for (size_t i = 0; i < expected.vertices.size(); i++)
+        {
+            float x, y, z;
+            int r, g, b;
+            REQUIRE(in >> x >> y >> z >> r >> g >> b);
+            CHECK(text_float_matches(x, expected.vertices[i].x));
+            CHECK(text_float_matches(y, -1 * expected.vertices[i].y));
+            CHECK(text_float_matches(z, -1 * expected.vertices[i].z));
+            CHECK(r == expected.colors[i][0]);
+            CHECK(g == expected.colors[i][1]);
+            CHECK(b == expected.colors[i][2]);
+        }
+        for (auto& f : expected.faces)
+        {
+            int n, a, b, c;
+            REQUIRE(in >> n >> a >> b >> c);
+            CHECK(n == 3);
+            CHECK(a == f[0]);
+            CHECK(b == f[1]);
+            CHECK(c == f[2]);
+        }
+        std::string rest;
+        CHECK_FALSE(in >> rest);
+    }
+
+    SECTION("text PCD")
+    {
+        points.export_to_file(pcd.path, color, false);
+        std::istringstream in(read_file(pcd.path));
+        auto n = std::to_string(expected.vertices.size());
+        std::string header = "# .PCD v0.7 - Point Cloud Data file format\nVERSION 0.7\nFIELDS x y z rgb\n"
+            "SIZE 4 4 4 4\nTYPE F F F U\nCOUNT 1 1 1 1\nWIDTH " + n + "\nHEIGHT 1\nVIEWPOINT 0 0 0 1 0 0 0\n"
+            "POINTS " + n + "\nDATA ascii\n";
+        std::string text_header(header.size(), 0);
+        in.read(&text_header[0], header.size());
+        REQUIRE(text_header == header);
+
+        // PCD keeps the camera coordinates, and packs the color as 0x00RRGGBB
+        for (size_t i = 0; i < expected.vertices.size(); i++)
+        {
+            float x, y, z;
+            uint32_t rgb;
+            REQUIRE(in >> x >> y >> z >> rgb);
+            CHECK(text_float_matches(x, expected.vertices[i].x));
+            CHECK(text_float_matches(y, expected.vertices[i].y));
+            CHECK(text_float_matches(z, expected.vertices[i].z));
+            CHECK(rgb == ((uint32_t(expected.colors[i][0]) << 16) | (uint32_t(expected.colors[i][1]) << 8) | expected.colors[i][2]));
+        }
+        std::string rest;
+        CHECK_FALSE(in >> rest);
+    }
+}
+
 TEST_CASE("Align Processing Block", "[live][pipeline][post-processing-filters][!mayfail]") {
     rs2::context ctx;
 
@@ -8,6 +8,7 @@
 #include <src/concurrency.h>
 
 #include <algorithm>
+#include <limits>
 #include <vector>
 
 using namespace utilities::time;
@@ -147,3 +148,177 @@ TEST_CASE("verify mutex protection")
     enqueue_thread1.join();
     enqueue_thread2.join();
 }
+
+TEST_CASE( "enqueue drops the oldest item when full" )
+{
+    std::vector< int > dropped;
+    single_consumer_queue< int > scq( 3, [&]( int const & i ) { dropped.push_back( i ); } );
+
+    for( int i = 0; i < 5; ++i )
+        scq.enqueue( std::move( i ) );
+    REQUIRE( scq.size() == 3 );
+    REQUIRE( dropped == std::vector< int >{ 0, 1 } );
+
+    int * front;
+    REQUIRE( scq.peek( &front ) );
+    REQUIRE( *front == 2 );
+
+    for( int expected = 2; expected < 5; ++expected )
+    {
+        int val;
+        REQUIRE( scq.try_dequeue( &val ) );
+        REQUIRE( val == expected );
+    }
+    REQUIRE( scq.empty() );
+
+    scq.stop();
+    scq.enqueue( 5 );
+    REQUIRE( scq.empty() );
+    REQUIRE( dropped == std::vector< int >{ 0, 1, 5 } );
+}
+
+TEST_CASE( "handoff between many producers" )
+{
+    single_consumer_queue< int > scq( 4 );
+
+    const int THREADS = 4;
+    const int ITEMS_PER_THREAD = 10000;
+    std::atomic< int > failed_enqueues( 0 );
+    std::vector< std::thread > producers;
+    for( int t = 0; t < THREADS; ++t )
+    {
+        producers.emplace_back( [&, t]() {
+            for( int i = 0; i < ITEMS_PER_THREAD; ++i )
+                if( ! scq.blocking_enqueue( t * ITEMS_PER_THREAD + i ) )
+                    ++failed_enqueues;
+        } );
+    }
+
+    // Items of each producer arrive in order, and none is lost
+    std::vector< int > next( THREADS, 0 );
+    for( int i = 0; i < THREADS * ITEMS_PER_THREAD; ++i )
+    {
+        int val;
+        REQUIRE( scq.dequeue( &val, 5000 ) );
+        auto t = val / ITEMS_PER_THREAD;
+        REQUIRE( val % ITEMS_PER_THREAD == next[t]++ );
+    }
+    REQUIRE( scq.empty() );
+
+    for( auto & t : producers )
+        t.join();
+    REQUIRE( failed_enqueues == 0 );
+}
+
+TEST_CASE( "stop doesn't wait for a blocked drop callback" )
+{
+    std::mutex m;
+    std::condition_variable cv;
+    bool in_callback = false, release = false;
+    std::vector< int > dropped;
+    single_consumer_queue< int > scq( 1, [&]( int const & i ) {
+        std::unique_lock< std::mutex > lock( m );
+        dropped.push_back( i );
+        in_callback = true;
+        cv.notify_all();
+        cv.wait( lock, [&]() { return release; } );
+    } );
+
+    // The queue is full, so the producer drops the front, and blocks in the callback
+    scq.enqueue( 0 );
+    std::thread producer( [&]() { scq.enqueue( 1 ); } );
+    {
+        std::unique_lock< std::mutex > lock( m );
+        REQUIRE( cv.wait_for( lock, std::chrono::seconds( 5 ), [&]() { return in_callback; } ) );
+    }
+
+    std::atomic< bool > stopped( false );
+    std::thread stopper( [&]() {
+        scq.stop();
+        stopped = true;
+    } );
+    stopwatch sw;
+    while( ! stopped && sw.get_elapsed_ms() < 5000 )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    bool stopped_while_blocked = stopped;
+
+    {
+        std::lock_guard< std::mutex > lock( m );
+        release = true;
+        cv.notify_all();
+    }
+    producer.join();
+    stopper.join();
+
+    REQUIRE( stopped_while_blocked );
+    // Once released, the producer finds the queue stopped, and drops its own item too
+    REQUIRE( scq.empty() );
+    REQUIRE( dropped == std::vector< int >{ 0, 1 } );
+}
+
+TEST_CASE( "queues too large for a ring grow as needed" )
+{
+    // Like the recorder's dispatcher: far too large to allocate up front, so the queue grows instead, and
+    // neither drops nor blocks
+    single_consumer_queue< int > scq( std::numeric_limits< unsigned int >::max() );
+    const int COUNT = QUEUE_MAX_RING_SIZE + 10;
+    for( int i = 0; i < COUNT; i++ )
+        scq.enqueue( std::move( i ) );
+    REQUIRE( scq.size() == COUNT );
+
+    int * front;
+    REQUIRE( scq.peek( &front ) );
+    REQUIRE( *front == 0 );
+    int item;
+    for( int i = 0; i < COUNT; i++ )
+    {
+        REQUIRE( scq.dequeue( &item, 1000 ) );
+        REQUIRE( item == i );
+    }
+    REQUIRE( scq.empty() );
+    REQUIRE_FALSE( scq.try_dequeue( &item ) );
+
+    // A consumer waiting for an item is woken by the next enqueue
+    std::thread consumer( [&]() {
+        int val = 0;
+        scq.dequeue( &val, 5000 );
+        item = val;
+    } );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+    scq.enqueue( 42 );
+    consumer.join();
+    REQUIRE( item == 42 );
+
+    scq.enqueue( 1 );
+    scq.stop();
+    REQUIRE( scq.empty() );
+}
+
+TEST_CASE( "queues too large for a ring still drop past their capacity" )
+{
+    std::vector< int > dropped;
+    single_consumer_queue< int > scq( QUEUE_MAX_RING_SIZE + 1, [&]( int const & i ) { dropped.push_back( i ); } );
+    for( int i = 0; i < int( QUEUE_MAX_RING_SIZE ) + 3; i++ )
+        scq.enqueue( std::move( i ) );
+    REQUIRE( scq.size() == QUEUE_MAX_RING_SIZE + 1 );
+    REQUIRE( dropped == std::vector< int >{ 0, 1 } );
+
+    // blocking_enqueue waits for room instead
+    std::atomic< bool > enqueued( false );
+    std::thread producer( [&]() {
+        scq.blocking_enqueue( -1 );
+        enqueued = true;
+    } );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+    REQUIRE_FALSE( enqueued );
+    int item;
+    REQUIRE( scq.dequeue( &item, 1000 ) );
+    REQUIRE( item == 2 );
+    producer.join();
+    REQUIRE( enqueued );
+    REQUIRE( scq.size() == QUEUE_MAX_RING_SIZE + 1 );
+    REQUIRE( dropped == std::vector< int >{ 0, 1 } );
+
+    scq.stop();
+    REQUIRE( scq.empty() );
+}
@@ -0,0 +1,144 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include <unit-tests/test.h>
+#include <src/concurrency.h>
+
+#include <condition_variable>
+#include <set>
+#include <vector>
+
+TEST_CASE( "thread_pool covers every item exactly once" )
+{
+    thread_pool pool( 3 );
+    REQUIRE( pool.get_num_workers() == 3 );
+
+    for( size_t count : { 1, 7, 64, 1000, 1001 } )
+    {
+        std::vector< std::atomic< int > > hits( count );
+        for( auto & h : hits )
+            h = 0;
+
+        pool.parallel_for( count, 16, [&]( size_t begin, size_t end ) {
+            for( size_t i = begin; i < end; ++i )
+                ++hits[i];
+        } );
+
+        for( auto & h : hits )
+            REQUIRE( h == 1 );
+    }
+}
+
+TEST_CASE( "thread_pool spreads work between threads" )
+{
+    thread_pool pool( 3 );
+    std::mutex m;
+    std::set< std::thread::id > ids;
+
+    pool.parallel_for( 64, 1, [&]( size_t, size_t ) {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+        std::lock_guard< std::mutex > lock( m );
+        ids.insert( std::this_thread::get_id() );
+    } );
+
+    REQUIRE( ids.size() > 1 );
+}
+
+TEST_CASE( "thread_pool completes nested calls" )
+{
+    thread_pool pool( 2 );
+    std::atomic< int > total( 0 );
+
+    // Every task, run by a worker or by the caller, queues a job of its own and waits for it
+    pool.parallel_for( 8, 1, [&]( size_t, size_t ) {
+        pool.parallel_for( 4, 1, [&]( size_t begin, size_t end ) { total += int( end - begin ); } );
+    } );
+
+    REQUIRE( total == 32 );
+}
+
+TEST_CASE( "thread_pool helps concurrent callers" )
+{
+    thread_pool pool( 3 );
+    std::mutex m;
+    std::condition_variable cv;
+    int blocked = 0;
+    bool release = false;
+
+    // A caller whose two chunks hold itself and a worker until released
+    std::thread busy_caller( [&]() {
+        pool.parallel_for( 2, 1, [&]( size_t, size_t ) {
+            std::unique_lock< std::mutex > lock( m );
+            ++blocked;
+            cv.notify_all();
+            cv.wait( lock, [&]() { return release; } );
+        } );
+    } );
+    {
+        std::unique_lock< std::mutex > lock( m );
+        REQUIRE( cv.wait_for( lock, std::chrono::seconds( 5 ), [&]() { return blocked == 2; } ) );
+    }
+
+    // Meanwhile, the job of another caller still runs on more than the calling thread: its two chunks
+    // only finish once both run at the same time
+    int running = 0;
+    bool both_ran = true;
+    pool.parallel_for( 2, 1, [&]( size_t, size_t ) {
+        std::unique_lock< std::mutex > lock( m );
+        ++running;
+        cv.notify_all();
+        both_ran &= cv.wait_for( lock, std::chrono::seconds( 5 ), [&]() { return running == 2; } );
+    } );
+    REQUIRE( both_ran );
+
+    {
+        std::lock_guard< std::mutex > lock( m );
+        release = true;
+        cv.notify_all();
+    }
+    busy_caller.join();
+}
+
+TEST_CASE( "thread_pool shares work between many concurrent callers" )
+{
+    thread_pool pool( 3 );
+    const int CALLERS = 8;
+    std::vector< std::atomic< int > > totals( CALLERS );
+    std::vector< std::thread > callers;
+    for( int c = 0; c < CALLERS; ++c )
+    {
+        totals[c] = 0;
+        callers.emplace_back( [&, c]() {
+            for( int i = 0; i < 50; ++i )
+                pool.parallel_for( 100, 7, [&]( size_t begin, size_t end ) { totals[c] += int( end - begin ); } );
+        } );
+    }
+    for( auto & t : callers )
+        t.join();
+
+    for( auto & total : totals )
+        REQUIRE( total == 50 * 100 );
+}
+
+TEST_CASE( "thread_pool rethrows task exceptions" )
+{
+    thread_pool pool( 2 );
+    REQUIRE_THROWS( pool.parallel_for( 100, 1, []( size_t begin, size_t ) {
+        if( begin == 50 )
+            throw std::runtime_error( "task failed" );
+    } ) );
+
+    // The pool is still usable afterwards
+    std::atomic< int > total( 0 );
+    pool.parallel_for( 100, 10, [&]( size_t begin, size_t end ) { total += int( end - begin ); } );
+    REQUIRE( total == 100 );
+}
+
+TEST_CASE( "thread_pool without workers runs inline" )
+{
+    thread_pool pool( 0 );
+    auto id = std::this_thread::get_id();
+    bool same_thread = true;
+    pool.parallel_for( 100, 1, [&]( size_t, size_t ) { same_thread &= std::this_thread::get_id() == id; } );
+    REQUIRE( same_thread );
+}
@@ -279,6 +279,15 @@ namespace Intel.RealSense
         auto_rx_sensitivity = 87,
 
         /// <summary>Change transmitter frequency, increasing effective range over sharpness</summary>
-        transmitter_frequency = 88
+        transmitter_frequency = 88,
+
+        /// <summary>Number of frames between updates of the depth colorizer's equalization histogram</summary>
+        histogram_update_interval = 89,
+
+        /// <summary>Average time in milliseconds a processing block takes per frame</summary>
+        processing_time = 90,
+
+        /// <summary>Pointcloud output holds only the valid points, optionally with the depth pixel index of each</summary>
+        sparse_pointcloud = 91
     }
 }
@@ -90,6 +90,9 @@ classdef option < int64
         auto_gain_limit                 (86)
         auto_rx_sensitivity             (87)
         transmitter_frequency           (88)
-        count                           (89)
+        histogram_update_interval       (89)
+        processing_time                 (90)
+        sparse_pointcloud               (91)
+        count                           (92)
     end
 end
@@ -4783,6 +4783,9 @@ void InitModule(v8::Local<v8::Object> exports) {
   _FORCE_SET_ENUM(RS2_OPTION_AUTO_GAIN_LIMIT);
   _FORCE_SET_ENUM(RS2_OPTION_AUTO_RX_SENSITIVITY);
   _FORCE_SET_ENUM(RS2_OPTION_TRANSMITTER_FREQUENCY);
+  _FORCE_SET_ENUM(RS2_OPTION_HISTOGRAM_UPDATE_INTERVAL);
+  _FORCE_SET_ENUM(RS2_OPTION_PROCESSING_TIME);
+  _FORCE_SET_ENUM(RS2_OPTION_SPARSE_POINTCLOUD);
   _FORCE_SET_ENUM(RS2_OPTION_COUNT);
 
   // rs2_camera_info
@@ -187,6 +187,9 @@ PYBIND11_MODULE(NAME, m) {
         .value("auto_gain_limit", RS2_OPTION_AUTO_GAIN_LIMIT)
         .value("auto_rx_sensitivity", RS2_OPTION_AUTO_RX_SENSITIVITY)
         .value("transmitter_frequency", RS2_OPTION_TRANSMITTER_FREQUENCY)
+        .value("histogram_update_interval", RS2_OPTION_HISTOGRAM_UPDATE_INTERVAL)
+        .value("processing_time", RS2_OPTION_PROCESSING_TIME)
+        .value("sparse_pointcloud", RS2_OPTION_SPARSE_POINTCLOUD)
         .value("count", RS2_OPTION_COUNT);
 
     py::enum_<platform::power_state> power_state(m, "power_state");
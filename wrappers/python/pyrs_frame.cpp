@@ -213,6 +213,8 @@ void init_frame(py::module &m) {
             case 2:
                 return BufData(verts, sizeof(float), "@f", 3, self.size());
             case 3:
+                if (self.size() != h * w)
+                    throw std::domain_error("dims=3 requires a vertex per pixel, which sparse pointclouds don't have");
                 return BufData(verts, sizeof(float), "@f", 3, { h, w, 3 }, { w*3*sizeof(float), 3*sizeof(float), sizeof(float) });
             default:
                 throw std::domain_error("dims arg only supports values of 1, 2 or 3");
@@ -228,12 +230,22 @@ void init_frame(py::module &m) {
             case 2:
                 return BufData(tex, sizeof(float), "@f", 2, self.size());
             case 3:
+                if (self.size() != h * w)
+                    throw std::domain_error("dims=3 requires a vertex per pixel, which sparse pointclouds don't have");
                 return BufData(tex, sizeof(float), "@f", 2, { h, w, 2 }, { w*2*sizeof(float), 2*sizeof(float), sizeof(float) });
             default:
                 throw std::domain_error("dims arg only supports values of 1, 2 or 3");
             }
         }, "Retrieve the texture coordinates (uv map) for the point cloud", py::keep_alive<0, 1>(), "dims"_a=1)
+        .def("get_pixel_indices", [](rs2::points& self) -> py::object {
+            auto indices = const_cast<int*>(self.get_pixel_indices());
+            if (!indices)
+                return py::none();
+            return py::cast(BufData(indices, sizeof(int), "@i", self.size()));
+        }, "Retrieve the depth pixel index of each point of a sparse point cloud, or None if it has none", py::keep_alive<0, 1>())
         .def("export_to_ply", &rs2::points::export_to_ply, "Export the point cloud to a PLY file")
+        .def("export_to_file", &rs2::points::export_to_file, "Export the point cloud to a PLY or PCD file, as selected by the file name extension",
+            "fname"_a, "texture"_a, "binary"_a = true)
         .def("size", &rs2::points::size); // No docstring in C++
 
     py::class_<rs2::depth_frame, rs2::video_frame> depth_frame(m, "depth_frame", "Extends the video_frame class with additional depth related attributes and functions.");
@@ -17,11 +17,25 @@ void init_record_playback(py::module &m) {
         .def("get_position", &rs2::playback::get_position, "Retrieves the current position of the playback in the file in terms of time. Units are expressed in nanoseconds.")
         .def("get_duration", &rs2::playback::get_duration, "Retrieves the total duration of the file.")
         .def("seek", &rs2::playback::seek, "Sets the playback to a specified time point of the played data.", "time"_a)
+        .def("seek_to_frame", &rs2::playback::seek_to_frame, "Sets the playback to the time point of a specific frame of one of the recorded streams.",
+             "stream"_a, "index"_a, "frame_number"_a)
+        .def("set_index_cache", &rs2::playback::set_index_cache, "Enables keeping the frame numbers index of the played file in a file next "
+             "to it, for later frame seeks.", "enable"_a)
+        .def("set_prefetch_budget", &rs2::playback::set_prefetch_budget, "Sets the amount of frame data the playback may read and decompress "
+             "ahead of the played frames, 0 disables reading ahead.", "bytes"_a)
+        .def("get_prefetch_budget", &rs2::playback::get_prefetch_budget, "Retrieves the amount of frame data the playback may read and "
+             "decompress ahead of the played frames.")
         .def("is_real_time", &rs2::playback::is_real_time, "Indicates if playback is in real time mode or non real time.")
         .def("set_real_time", &rs2::playback::set_real_time, "Set the playback to work in real time or non real time. In real time mode, playback will "
              "play the same way the file was recorded. If the application takes too long to handle the callback, frames may be dropped. In non real time "
              "mode, playback will wait for each callback to finish handling the data before reading the next frame. In this mode no frames will be dropped, "
              "and the application controls the framerate of playback via callback duration.", "real_time"_a)
+        .def("is_batch_mode", &rs2::playback::is_batch_mode, "Indicates if playback is in batch mode.")
+        .def("set_batch_mode", &rs2::playback::set_batch_mode, "Set the playback to work in batch mode, for offline processing of recorded data. "
+             "In batch mode, playback plays the file as fast as the application handles the frames, and never drops frames. Setting the playback "
+             "to real time ends batch mode.", "batch"_a)
+        .def("get_throughput", &rs2::playback::get_throughput, "Retrieves the frames per second and MB per second the playback delivered "
+             "since it was last started, excluding paused periods.")
         // set_playback_speed?
         .def("set_status_changed_callback", [](rs2::playback& self, std::function<void(rs2_playback_status)> callback) {
             self.set_status_changed_callback(callback);
@@ -34,7 +48,18 @@ void init_record_playback(py::module &m) {
     recorder.def(py::init<const std::string&, rs2::device>())
         .def(py::init<const std::string&, rs2::device, bool>())
         .def("pause", &rs2::recorder::pause, "Pause the recording device without stopping the actual device from streaming.")
-        .def("resume", &rs2::recorder::resume, "Unpauses the recording device, making it resume recording.");
+        .def("resume", &rs2::recorder::resume, "Unpauses the recording device, making it resume recording.")
+        .def("enable_depth_codec", &rs2::recorder::enable_depth_codec, "Encodes the depth and 16 bit infrared frames recorded from now on "
+             "with RVL, a lossless depth codec.", "enable"_a)
+        .def("set_max_cached_size", &rs2::recorder::set_max_cached_size, "Caps the frame data held in memory while waiting to be written. "
+             "Frames arriving beyond it are dropped.", "bytes"_a)
+        .def("get_statistics", &rs2::recorder::get_statistics, "Retrieves the frame data waiting to be written, the frames dropped "
+             "since recording started and the average write rate.");
+
+    py::class_<rs2::recorder::statistics> recorder_statistics(m, "recorder_statistics", "The state of a recorder's writer.");
+    recorder_statistics.def_readonly("queued_bytes", &rs2::recorder::statistics::queued_bytes, "Frame data waiting to be written, in bytes.")
+        .def_readonly("dropped_frames", &rs2::recorder::statistics::dropped_frames, "Frames dropped since recording started.")
+        .def_readonly("megabytes_per_second", &rs2::recorder::statistics::megabytes_per_second, "Average frame data written per second, in MB.");
     // filename?
     /** end rs_record_playback.hpp **/
 }
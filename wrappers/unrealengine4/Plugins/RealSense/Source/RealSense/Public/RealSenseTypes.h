@@ -143,6 +143,9 @@ enum class ERealSenseOptionType : uint8
     AUTO_GAIN_LIMIT                            , /**< Set and get auto gain limits ranging from 16 to 248. Default is 0 which means full gain. If the requested gain limit is less than 16, it will be set to 16. If the requested gain limit is greater than 248, it will be set to 248. Setting will not take effect until next streaming session. */
     AUTO_RX_SENSITIVITY                        , /**< Set and get auto receiver sensitivity.*/
     TRANSMITTER_FREQUENCY                      , /**< Change transmitter frequency, increasing effective range over sharpness. */
+    HISTOGRAM_UPDATE_INTERVAL                  , /**< Number of frames between updates of the depth colorizer's equalization histogram */
+    PROCESSING_TIME                            , /**< Average time in milliseconds a processing block takes per frame. Read-only */
+    SPARSE_POINTCLOUD                          , /**< Pointcloud output holds only the valid points, optionally with the depth pixel index of each */
 };
 
 UENUM(Blueprintable)